@@ -0,0 +1,198 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares the compact base::Error and base::ErrorOr against the previous
+ * implementation, which carried a std::string description and a
+ * std::optional next to the error, on glTF-like accessor resolution.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <optional>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Source/Base/ErrorOr.hpp"
+
+// Small enough for the document to stay in the cache, so that the error
+// handling isn't hidden behind memory accesses.
+constexpr std::size_t AccessorCount = 4096;
+constexpr std::size_t Rounds = 250;
+
+// One in this many accessors is out of range, to include the failure path.
+constexpr std::size_t FailureInterval = 64;
+
+struct LegacyError {
+    [[nodiscard]] static LegacyError
+    success() noexcept {
+        return LegacyError{};
+    }
+
+    [[nodiscard]] LegacyError() noexcept = default;
+
+    [[nodiscard]]
+    LegacyError(std::string_view libraryName, std::string_view className, std::string_view attemptedAction,
+                std::string description, std::source_location location = std::source_location::current()) noexcept
+            : m_success(false)
+            , m_libraryName(libraryName)
+            , m_className(className)
+            , m_attemptedAction(attemptedAction)
+            , m_description(std::move(description))
+            , m_sourceLocation(location) {
+    }
+
+    [[nodiscard]] explicit
+    operator bool() const noexcept {
+        return !m_success;
+    }
+
+    bool m_success{true};
+    std::string_view m_libraryName{};
+    std::string_view m_className{};
+    std::string_view m_attemptedAction{};
+    std::string m_description{};
+    std::source_location m_sourceLocation{};
+};
+
+template<typename T>
+struct LegacyErrorOr {
+    [[nodiscard]]
+    LegacyErrorOr(LegacyError &&error)
+            : m_error(std::move(error)) {
+    }
+
+    [[nodiscard]]
+    LegacyErrorOr(T &&data)
+            : m_data(std::move(data)) {
+    }
+
+    [[nodiscard]] bool
+    failed() const noexcept {
+        return !m_data.has_value();
+    }
+
+    [[nodiscard]] LegacyError
+    error() const noexcept {
+        return m_error;
+    }
+
+    [[nodiscard]] T &
+    get() noexcept {
+        return m_data.value();
+    }
+
+    LegacyError m_error{};
+    std::optional<T> m_data{};
+};
+
+struct BufferView {
+    std::size_t buffer;
+    std::size_t byteOffset;
+    std::size_t byteLength;
+};
+
+struct Accessor {
+    std::size_t bufferView;
+    std::size_t byteOffset;
+};
+
+struct ResourceInfo {
+    const Accessor *accessor;
+    std::size_t byteOffset;
+    std::size_t byteLength;
+};
+
+struct Document {
+    std::vector<std::size_t> bufferSizes{};
+    std::vector<BufferView> bufferViews{};
+    std::vector<Accessor> accessors{};
+};
+
+[[nodiscard]] static Document
+createDocument() {
+    Document document{};
+    document.bufferSizes.push_back(AccessorCount * 64);
+    for (std::size_t i = 0; i < AccessorCount; ++i) {
+        document.bufferViews.push_back({0, i * 64, 64});
+        document.accessors.push_back({i, i % FailureInterval == 0 ? std::size_t{128} : std::size_t{16}});
+    }
+    return document;
+}
+
+// The checks of the glTF loaders, written once for both implementations.
+template<typename ErrorType, template<typename> typename ErrorOrType>
+[[nodiscard]] static ErrorOrType<ResourceInfo>
+resolveResourceInfo(const Document &document, std::size_t accessorIndex) noexcept {
+    const auto &accessor = document.accessors[accessorIndex];
+    if (accessor.bufferView >= std::size(document.bufferViews))
+        return ErrorType{"Benchmark", "Accessors", "Resolve ResourceInfo", "bufferView out of range"};
+
+    const auto &bufferView = document.bufferViews[accessor.bufferView];
+    if (bufferView.buffer >= std::size(document.bufferSizes))
+        return ErrorType{"Benchmark", "Accessors", "Resolve ResourceInfo", "bufferIndex >= bufferSize"};
+
+    if (accessor.byteOffset > bufferView.byteLength)
+        return ErrorType{"Benchmark", "Accessors", "Check offsets", "Accessor ByteOffset > byteLength"};
+
+    if (bufferView.byteOffset + bufferView.byteLength > document.bufferSizes[bufferView.buffer])
+        return ErrorType{"Benchmark", "Accessors", "Resolve ResourceInfo", "Buffer view out of buffer range"};
+
+    return ResourceInfo{&accessor, bufferView.byteOffset + accessor.byteOffset, bufferView.byteLength - accessor.byteOffset};
+}
+
+// The loaders call into another translation unit for this, so the result
+// has to be returned through memory. The volatile pointer keeps the compiler
+// from inlining the call here too.
+template<typename ErrorType, template<typename> typename ErrorOrType>
+ErrorOrType<ResourceInfo> (*volatile g_resolveResourceInfo)(const Document &, std::size_t) noexcept
+        = &resolveResourceInfo<ErrorType, ErrorOrType>;
+
+template<typename ErrorType, template<typename> typename ErrorOrType>
+[[nodiscard]] static ErrorType
+sumAccessor(const Document &document, std::size_t accessorIndex, std::size_t &sum) noexcept {
+    auto resourceInfo = g_resolveResourceInfo<ErrorType, ErrorOrType>(document, accessorIndex);
+    if (resourceInfo.failed())
+        return resourceInfo.error();
+
+    sum += resourceInfo.get().byteLength;
+    return ErrorType::success();
+}
+
+template<typename ErrorType, template<typename> typename ErrorOrType>
+static void
+runBenchmark(std::string_view name, const Document &document) {
+    std::size_t sum{};
+    std::size_t failures{};
+
+    const auto result = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (std::size_t i = 0; i < AccessorCount; ++i) {
+                if (sumAccessor<ErrorType, ErrorOrType>(document, i, sum))
+                    ++failures;
+            }
+        }
+    });
+
+    benchmark::report(name, result, Rounds * AccessorCount);
+    std::printf("%-40s %10zu failures, checksum %zu\n", "", failures, sum);
+}
+
+int main() {
+    std::printf("sizeof(Error) %zu -> %zu, sizeof(ErrorOr<ResourceInfo>) %zu -> %zu, sizeof(ResourceInfo) %zu\n",
+                sizeof(LegacyError), sizeof(base::Error),
+                sizeof(LegacyErrorOr<ResourceInfo>), sizeof(base::ErrorOr<ResourceInfo>),
+                sizeof(ResourceInfo));
+
+    const auto document = createDocument();
+    for (std::size_t run = 0; run < 2; ++run) {
+        runBenchmark<LegacyError, LegacyErrorOr>("resolve accessors string + optional", document);
+        runBenchmark<base::Error, base::ErrorOr>("resolve accessors base::ErrorOr", document);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares the hop latency and the allocations per hop of the type-erased
+ * base::AnyTask chain against the statically typed base::Task<T>.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <any>
+#include <atomic>
+#include <latch>
+#include <thread>
+
+#include "Source/Base/AnyTask.hpp"
+#include "Source/Base/Task.hpp"
+#include "Source/Base/ThreadPool.hpp"
+
+constexpr std::size_t HopsPerChain = 8;
+constexpr std::size_t LatencyRounds = 20'000;
+constexpr std::size_t ConcurrentChains = 20'000;
+
+template<typename OnDone>
+void
+startAnyTaskChain(base::ThreadPool &pool, OnDone &onDone) {
+    auto task = base::AnyTask::run(base::AnyTask::create<int>([] { return 0; }), {}, pool);
+    for (std::size_t hop = 1; hop < HopsPerChain; ++hop) {
+        task = task->then([](std::any &&value) -> std::any {
+            return std::any_cast<int>(value) + 1;
+        });
+    }
+
+    task->then([&onDone](std::any &&) -> std::any {
+        onDone();
+        return {};
+    });
+}
+
+template<typename OnDone>
+void
+startTypedTaskChain(base::ThreadPool &pool, OnDone &onDone) {
+    auto task = base::Task<int>::run([] { return 0; }, pool);
+    for (std::size_t hop = 1; hop < HopsPerChain; ++hop)
+        task = std::move(task).then([](int value) { return value + 1; });
+
+    std::move(task).then([&onDone](int) {
+        onDone();
+    });
+}
+
+template<typename StartChain>
+void
+runLatencyBenchmark(std::string_view name, StartChain startChain) {
+    base::ThreadPool pool{};
+
+    const auto result = benchmark::measure([&] {
+        for (std::size_t round = 0; round < LatencyRounds; ++round) {
+            std::atomic_bool done{false};
+            auto onDone = [&done] { done.store(true, std::memory_order_release); };
+
+            startChain(pool, onDone);
+            while (!done.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+    });
+
+    benchmark::report(name, result, LatencyRounds * HopsPerChain);
+}
+
+template<typename StartChain>
+void
+runThroughputBenchmark(std::string_view name, StartChain startChain) {
+    base::ThreadPool pool{};
+
+    const auto result = benchmark::measure([&] {
+        std::latch done{static_cast<std::ptrdiff_t>(ConcurrentChains)};
+        auto onDone = [&done] { done.count_down(); };
+
+        for (std::size_t chain = 0; chain < ConcurrentChains; ++chain)
+            startChain(pool, onDone);
+        done.wait();
+    });
+
+    benchmark::report(name, result, ConcurrentChains * HopsPerChain);
+}
+
+int main() {
+    std::printf("%zu hops per chain, %zu workers\n", HopsPerChain, base::ThreadPool::defaultWorkerCount());
+
+    runLatencyBenchmark("latency    base::AnyTask", [](auto &pool, auto &onDone) { startAnyTaskChain(pool, onDone); });
+    runLatencyBenchmark("latency    base::Task<int>", [](auto &pool, auto &onDone) { startTypedTaskChain(pool, onDone); });
+
+    runThroughputBenchmark("throughput base::AnyTask", [](auto &pool, auto &onDone) { startAnyTaskChain(pool, onDone); });
+    runThroughputBenchmark("throughput base::Task<int>", [](auto &pool, auto &onDone) { startTypedTaskChain(pool, onDone); });
+}
@@ -0,0 +1,165 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares iterating over the ecs::Registry against the polymorphic entity
+ * list, a std::vector of std::unique_ptr<Entity> that is filtered with
+ * virtual calls, for 100k and 1M entities of which one in ten is a light.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Source/ECS/Components.hpp"
+#include "Source/ECS/Registry.hpp"
+
+constexpr std::array<std::size_t, 2> EntityCounts{100'000, 1'000'000};
+constexpr std::size_t LightInterval = 10;
+constexpr std::size_t Rounds = 10;
+
+class LegacyEntity {
+public:
+    LegacyEntity(std::string &&name, math::Transformation transformation) noexcept
+            : m_name(std::move(name))
+            , m_transformation(transformation) {
+    }
+
+    virtual ~LegacyEntity() noexcept = default;
+
+    [[nodiscard]] virtual bool
+    isLight() const noexcept {
+        return false;
+    }
+
+    [[nodiscard]] math::Transformation &
+    transformation() noexcept {
+        return m_transformation;
+    }
+
+private:
+    std::string m_name;
+    const void *m_modelDescriptor{};
+    math::Transformation m_transformation;
+};
+
+class LegacyPointLight final
+        : public LegacyEntity {
+public:
+    LegacyPointLight(math::Transformation transformation, float intensity) noexcept
+            : LegacyEntity("PointLight", transformation)
+            , m_intensity(intensity) {
+    }
+
+    [[nodiscard]] bool
+    isLight() const noexcept override {
+        return true;
+    }
+
+    [[nodiscard]] float
+    intensity() const noexcept {
+        return m_intensity;
+    }
+
+private:
+    math::Vector3f m_color{1.0f, 1.0f, 1.0f};
+    float m_radius{10.0f};
+    float m_intensity;
+};
+
+[[nodiscard]] static math::Transformation
+transformationOf(std::size_t i) noexcept {
+    return math::Transformation{{static_cast<float>(i), 0.0f, 0.0f}};
+}
+
+static void
+runLegacyBenchmark(std::size_t entityCount) {
+    std::vector<std::unique_ptr<LegacyEntity>> entities{};
+    entities.reserve(entityCount);
+
+    // Loading a scene also allocates other resources in between, which
+    // spreads the entities over the heap.
+    std::vector<std::unique_ptr<std::string>> interleaved{};
+    interleaved.reserve(entityCount);
+
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        if (i % LightInterval == 0)
+            entities.push_back(std::make_unique<LegacyPointLight>(transformationOf(i), 1.0f));
+        else
+            entities.push_back(std::make_unique<LegacyEntity>("Entity", transformationOf(i)));
+        interleaved.push_back(std::make_unique<std::string>(std::to_string(i)));
+    }
+
+    float intensity{};
+    const auto moveResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (const auto &entity : entities) {
+                auto &transformation = entity->transformation();
+                transformation.setTranslation(transformation.translation().add(math::Vector3f{0.0f, 1.0f, 0.0f}));
+            }
+        }
+    });
+    const auto lightResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (const auto &entity : entities) {
+                if (entity->isLight())
+                    intensity += static_cast<const LegacyPointLight &>(*entity).intensity();
+            }
+        }
+    });
+
+    benchmark::report("move all   unique_ptr<Entity> x" + std::to_string(entityCount), moveResult, Rounds * entityCount);
+    benchmark::report("sum lights unique_ptr<Entity> x" + std::to_string(entityCount), lightResult, Rounds * entityCount);
+    std::printf("%-40s %10.1f intensity\n", "", static_cast<double>(intensity));
+}
+
+static void
+runRegistryBenchmark(std::size_t entityCount) {
+    ecs::Registry registry{};
+    registry.reserve<ecs::NameComponent, ecs::TransformComponent>(entityCount);
+
+    for (std::size_t i = 0; i < entityCount; ++i) {
+        if (i % LightInterval == 0) {
+            static_cast<void>(registry.create(ecs::NameComponent{"PointLight"}, ecs::TransformComponent{transformationOf(i)},
+                                              ecs::PointLightComponent{{1.0f, 1.0f, 1.0f}, 10.0f, 1.0f, 1.0f, 0.0f, 0.0f}));
+        } else {
+            static_cast<void>(registry.create(ecs::NameComponent{"Entity"}, ecs::TransformComponent{transformationOf(i)}));
+        }
+    }
+
+    float intensity{};
+    const auto moveResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            registry.each<ecs::TransformComponent>([](ecs::TransformComponent &transform) {
+                transform.transformation.setTranslation(transform.transformation.translation().add(math::Vector3f{0.0f, 1.0f, 0.0f}));
+            });
+        }
+    });
+    const auto lightResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            registry.each<ecs::PointLightComponent>([&](const ecs::PointLightComponent &light) {
+                intensity += light.intensity;
+            });
+        }
+    });
+
+    // The light pass only visits the lights, but is reported per entity like
+    // the list, since that's the work it replaces.
+    benchmark::report("move all   ecs::Registry x" + std::to_string(entityCount), moveResult, Rounds * entityCount);
+    benchmark::report("sum lights ecs::Registry x" + std::to_string(entityCount), lightResult, Rounds * entityCount);
+    std::printf("%-40s %10.1f intensity\n", "", static_cast<double>(intensity));
+}
+
+int main() {
+    for (const auto entityCount : EntityCounts) {
+        runLegacyBenchmark(entityCount);
+        runRegistryBenchmark(entityCount);
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares the world matrix propagation of ecs::TransformGraph against a
+ * walk over a tree of heap-allocated nodes that recomputes every node, for
+ * deep and wide hierarchies of 10k to 1M nodes.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Source/Base/JobGraph.hpp"
+#include "Source/Base/ThreadPool.hpp"
+#include "Source/ECS/TransformGraph.hpp"
+
+constexpr std::array<std::size_t, 3> NodeCounts{10'000, 100'000, 1'000'000};
+
+// The deep hierarchy is a set of long chains, the wide one a tree in which
+// every node has many children.
+constexpr std::size_t DeepChainCount = 64;
+constexpr std::size_t WideChildCount = 16;
+
+// The share of nodes that move in a typical frame.
+constexpr std::size_t DirtyPermille = 10;
+
+struct LegacyNode {
+    math::Transformation local{};
+    math::Matrix4x4<float> world{};
+    std::vector<std::unique_ptr<LegacyNode>> children{};
+};
+
+// Depth-first with an explicit stack, since the chains are too deep to
+// recurse.
+static void
+legacyUpdate(LegacyNode &root, std::vector<LegacyNode *> &stack) noexcept {
+    root.world = root.local.toMatrix();
+    stack.push_back(&root);
+
+    while (!stack.empty()) {
+        auto *node = stack.back();
+        stack.pop_back();
+
+        for (auto &child : node->children) {
+            child->world = node->world.mul(child->local.toMatrix());
+            stack.push_back(child.get());
+        }
+    }
+}
+
+[[nodiscard]] static math::Transformation
+transformationOf(std::size_t i) noexcept {
+    const auto value = static_cast<float>(i % 7);
+    return math::Transformation::fromEulerAngles({value, 1.0f, 0.0f}, {0.0f, value, 0.0f});
+}
+
+[[nodiscard]] static std::vector<std::size_t>
+createParents(std::size_t nodeCount, bool deep) noexcept {
+    std::vector<std::size_t> parents(nodeCount);
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        if (deep)
+            parents[i] = i < DeepChainCount ? SIZE_MAX : i - DeepChainCount;
+        else
+            parents[i] = i == 0 ? SIZE_MAX : (i - 1) / WideChildCount;
+    }
+    return parents;
+}
+
+[[nodiscard]] static float
+checksum(const math::Matrix4x4<float> &matrix) noexcept {
+    return matrix[0][3] + matrix[1][3] + matrix[2][3];
+}
+
+static void
+runBenchmark(std::size_t nodeCount, bool deep) {
+    const std::string shape = deep ? "deep" : "wide";
+    const auto label = [&](std::string_view name) {
+        return std::string(name) + " " + shape + " x" + std::to_string(nodeCount);
+    };
+    const auto rounds = std::max<std::size_t>(1'000'000 / nodeCount, 1);
+    const auto parents = createParents(nodeCount, deep);
+
+    float sum{};
+    {
+        std::vector<LegacyNode *> nodes(nodeCount);
+        std::vector<std::unique_ptr<LegacyNode>> roots{};
+        for (std::size_t i = 0; i < nodeCount; ++i) {
+            auto node = std::make_unique<LegacyNode>();
+            node->local = transformationOf(i);
+            nodes[i] = node.get();
+            if (parents[i] == SIZE_MAX)
+                roots.push_back(std::move(node));
+            else
+                nodes[parents[i]]->children.push_back(std::move(node));
+        }
+
+        // Without dirty flags, a moved node means that everything has to
+        // be walked.
+        const auto result = benchmark::measure([&] {
+            std::vector<LegacyNode *> stack{};
+            for (std::size_t round = 0; round < rounds; ++round) {
+                for (auto &root : roots)
+                    legacyUpdate(*root, stack);
+            }
+        });
+        benchmark::report(label("pointer tree   "), result, rounds * nodeCount);
+        sum += checksum(nodes.back()->world);
+    }
+
+    ecs::TransformGraph graph{};
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        const auto parent = parents[i] == SIZE_MAX ? ecs::TransformGraph::s_noParent
+                                                   : static_cast<ecs::TransformGraph::NodeId>(parents[i]);
+        static_cast<void>(graph.add(transformationOf(i), parent));
+    }
+    graph.update();
+
+    const auto markRoots = [&] {
+        for (std::size_t i = 0; i < nodeCount && parents[i] == SIZE_MAX; ++i)
+            graph.setLocal(static_cast<ecs::TransformGraph::NodeId>(i), transformationOf(i));
+    };
+
+    const auto allResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < rounds; ++round) {
+            markRoots();
+            graph.update();
+        }
+    });
+    benchmark::report(label("graph all      "), allResult, rounds * nodeCount);
+    sum += checksum(graph.world(static_cast<ecs::TransformGraph::NodeId>(nodeCount - 1)));
+
+    std::mt19937 random{12345};
+    std::uniform_int_distribution<std::size_t> distribution{0, nodeCount - 1};
+    const auto dirtyResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < rounds; ++round) {
+            for (std::size_t i = 0; i < nodeCount * DirtyPermille / 1000; ++i) {
+                const auto node = static_cast<ecs::TransformGraph::NodeId>(distribution(random));
+                graph.setLocal(node, graph.local(node));
+            }
+            graph.update();
+        }
+    });
+    benchmark::report(label("graph 1% dirty "), dirtyResult, rounds * nodeCount);
+
+    // Like the frame graph: the top first, then the partitions in jobs.
+    auto &pool = base::ThreadPool::global();
+    const auto jobCount = pool.workerCount();
+    base::JobGraph jobGraph{};
+    const auto top = jobGraph.addJob("top", [&] {
+        markRoots();
+        graph.updateTop();
+    });
+    for (std::size_t job = 0; job < jobCount; ++job) {
+        jobGraph.addJob("partitions", [&, job] {
+            const auto count = graph.partitionCount();
+            graph.updatePartitions(count * job / jobCount, count * (job + 1) / jobCount);
+        }, {top});
+    }
+
+    const auto parallelResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < rounds; ++round)
+            jobGraph.run(pool);
+    });
+    benchmark::report(label("graph all jobs "), parallelResult, rounds * nodeCount);
+    sum += checksum(graph.world(static_cast<ecs::TransformGraph::NodeId>(nodeCount - 1)));
+
+    std::printf("%-40s %10zu partitions, checksum %.1f\n", "", graph.partitionCount(), static_cast<double>(sum));
+}
+
+int main() {
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+
+    for (const auto nodeCount : NodeCounts) {
+        runBenchmark(nodeCount, true);
+        runBenchmark(nodeCount, false);
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares the lock-free event::FunctionQueue against the previous
+ * implementation, a std::queue of std::function behind a mutex, with 1 to 16
+ * producers posting to a single consumer.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Source/Event/FunctionQueue.hpp"
+
+constexpr std::size_t FunctionsPerRun = 400'000;
+constexpr std::size_t DrainFunctions = 200'000;
+constexpr std::array<std::size_t, 5> ProducerCounts{1, 2, 4, 8, 16};
+
+class MutexFunctionQueue {
+public:
+    void
+    post(std::function<base::Error()> &&function) noexcept {
+        std::lock_guard guard{m_mutex};
+        m_functions.push(std::move(function));
+    }
+
+    [[nodiscard]] base::Error
+    processAll() noexcept {
+        std::queue<std::function<base::Error()>> queue;
+        {
+            std::lock_guard guard{m_mutex};
+            m_functions.swap(queue);
+        }
+
+        while (!queue.empty()) {
+            if (const auto error = queue.front()())
+                return error;
+            queue.pop();
+        }
+
+        return base::Error::success();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::queue<std::function<base::Error()>> m_functions;
+};
+
+struct Counter {
+    std::atomic_size_t count{0};
+    std::atomic_size_t checksum{0};
+};
+
+// A typical closure: an object pointer and two values, which is too large
+// for the small buffer of std::function.
+template<typename Queue>
+void
+postFunction(Queue &queue, Counter &counter, std::size_t a, std::size_t b) {
+    queue.post([&counter, a, b] {
+        counter.checksum.fetch_add(a ^ b, std::memory_order_relaxed);
+        counter.count.fetch_add(1, std::memory_order_relaxed);
+        return base::Error::success();
+    });
+}
+
+template<typename Queue>
+void
+runConcurrentBenchmark(std::string_view name, std::size_t producerCount) {
+    Queue queue{};
+    Counter counter{};
+    const auto functionsPerProducer = FunctionsPerRun / producerCount;
+    const auto total = functionsPerProducer * producerCount;
+
+    const auto result = benchmark::measure([&] {
+        std::vector<std::thread> producers{};
+        for (std::size_t producer = 0; producer < producerCount; ++producer) {
+            producers.emplace_back([&, producer] {
+                for (std::size_t i = 0; i < functionsPerProducer; ++i)
+                    postFunction(queue, counter, producer, i);
+            });
+        }
+
+        // Like the main loop, the consumer gives up its time slice when there
+        // is nothing to do, which matters when there are fewer cores than
+        // threads.
+        while (counter.count.load(std::memory_order_relaxed) != total) {
+            const auto before = counter.count.load(std::memory_order_relaxed);
+            if (auto error = queue.processAll())
+                std::abort();
+            if (counter.count.load(std::memory_order_relaxed) == before)
+                std::this_thread::yield();
+        }
+
+        for (auto &producer : producers)
+            producer.join();
+    });
+
+    const auto label = std::string(name) + " x" + std::to_string(producerCount);
+    benchmark::report(label, result, total);
+
+    if constexpr (requires { queue.fullCount(); })
+        std::printf("%-40s %10zu posts found the queue full\n", "", queue.fullCount());
+}
+
+template<typename Queue>
+void
+runDrainBenchmark(std::string_view name, Queue &queue) {
+    Counter counter{};
+    for (std::size_t i = 0; i < DrainFunctions; ++i)
+        postFunction(queue, counter, i, i);
+
+    const auto result = benchmark::measure([&] {
+        if (auto error = queue.processAll())
+            std::abort();
+    });
+
+    benchmark::report(name, result, DrainFunctions);
+}
+
+int main() {
+    std::printf("%zu functions per run, %u hardware threads\n", FunctionsPerRun, std::thread::hardware_concurrency());
+
+    for (const auto producerCount : ProducerCounts) {
+        runConcurrentBenchmark<MutexFunctionQueue>("post+drain mutex + std::queue", producerCount);
+        runConcurrentBenchmark<event::FunctionQueue>("post+drain event::FunctionQueue", producerCount);
+    }
+
+    {
+        MutexFunctionQueue queue{};
+        runDrainBenchmark("drain      mutex + std::queue", queue);
+    }
+    {
+        event::FunctionQueue queue{DrainFunctions};
+        runDrainBenchmark("drain      event::FunctionQueue", queue);
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares parsing a glTF file into a nlohmann::json tree, which the loader
+ * used to walk, against parsing it into a gltf::Document. It also compares
+ * reading the file into memory before parsing it against mapping it and
+ * parsing it in place. The file is given as the first argument, e.g. Sponza,
+ * and defaults to the scene in the resources. Run it from the root of the
+ * repository.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "Source/IO/FileInput.hpp"
+#include "Source/IO/Format/GLTF/Document.hpp"
+#include "Source/IO/MappedFile.hpp"
+
+constexpr std::size_t Rounds = 20;
+
+int main(int argc, char **argv) {
+    const std::string fileName = argc > 1 ? argv[1] : "Resources/Assets/Models/Scene.gltf";
+
+    std::ifstream stream{fileName, std::ios::binary};
+    if (!stream) {
+        std::printf("Failed to open \"%s\"\n", fileName.c_str());
+        return 1;
+    }
+    const std::vector<char> text{std::istreambuf_iterator<char>{stream}, {}};
+    std::printf("%s: %zu bytes\n", fileName.c_str(), std::size(text));
+
+    std::size_t sum{};
+
+    // The document keeps the text alive, so the copy it is given is part of
+    // its cost.
+    const auto parseDocument = [&] {
+        auto document = io::format::gltf::Document::parse(std::vector<char>(text));
+        if (document.failed()) {
+            std::puts("Failed to parse the document");
+            std::exit(1);
+        }
+        sum += std::size(document->nodes()) + std::size(document->accessors());
+    };
+
+    const auto readAndParse = [&] {
+        io::FileInput file{fileName};
+        auto document = io::format::gltf::Document::parse(file.read<char>(file.size()));
+        sum += std::size(document->nodes());
+    };
+
+    const auto mapAndParse = [&] {
+        io::MappedFile file{fileName};
+        auto document = io::format::gltf::Document::parseInPlace({reinterpret_cast<const char *>(file.data().data()), file.size()});
+        sum += std::size(document->nodes());
+    };
+
+    const auto parseLegacy = [&] {
+        const auto json = nlohmann::json::parse(std::begin(text), std::end(text));
+        sum += json["nodes"].size() + json["accessors"].size();
+    };
+
+    // Warm up the caches and the allocator.
+    parseLegacy();
+    parseDocument();
+
+    const auto legacyResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            parseLegacy();
+    });
+
+    const auto documentResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            parseDocument();
+    });
+
+    benchmark::report("parse nlohmann::json", legacyResult, Rounds);
+    benchmark::report("parse gltf::Document", documentResult, Rounds);
+    benchmark::reportPeakMemory("parse nlohmann::json", benchmark::measure(parseLegacy));
+    benchmark::reportPeakMemory("parse gltf::Document", benchmark::measure(parseDocument));
+
+    const auto readResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            readAndParse();
+    });
+
+    const auto mapResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            mapAndParse();
+    });
+
+    benchmark::report("read + parse", readResult, Rounds);
+    benchmark::report("map + parse in place", mapResult, Rounds);
+    benchmark::reportPeakMemory("read + parse", benchmark::measure(readAndParse));
+    benchmark::reportPeakMemory("map + parse in place", benchmark::measure(mapAndParse));
+
+    std::printf("%-40s %10zu checksum\n", "", sum);
+}
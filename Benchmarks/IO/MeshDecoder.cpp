@@ -0,0 +1,290 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Measures decoding the primitives of a glTF file into meshes, without a
+ * graphics API, both one after another and as jobs on the thread pool, and
+ * interleaving them into the vertex layout that the loader uploads, and
+ * optimizing their order for the vertex cache, of which the ACMR and ATVR
+ * before and after are reported, and generating their levels of detail, of
+ * which the triangles and the largest error are reported. The file is given as the first argument,
+ * e.g. Sponza, and defaults to the scene in the resources. Run it from the
+ * root of the repository.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <algorithm> // for std::max, std::min
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Source/Base/JobGraph.hpp"
+#include "Source/Base/ThreadPool.hpp"
+#include "Source/IO/Format/GLTF/Binary.hpp"
+#include "Source/IO/Format/GLTF/Document.hpp"
+#include "Source/IO/Format/GLTF/MeshDecoder.hpp"
+#include "Source/IO/MappedFile.hpp"
+#include "Source/Resources/InterleavedMesh.hpp"
+#include "Source/Resources/MeshOptimizer.hpp"
+#include "Source/Resources/MeshSimplifier.hpp"
+#include "ThirdParty/base64.hpp"
+
+using namespace io::format::gltf;
+
+constexpr std::size_t Rounds = 200;
+
+[[noreturn]] static void
+fail(std::string_view message) {
+    std::printf("%.*s\n", static_cast<int>(message.length()), message.data());
+    std::exit(1);
+}
+
+/**
+ * The buffers of a file, loaded like the loader does, minus the resource
+ * locators: external files are mapped next to the file, and data URIs are
+ * decoded.
+ */
+struct LoadedBuffers {
+    std::vector<io::MappedFile> files{};
+    std::vector<std::string> decoded{};
+    std::vector<std::span<const std::byte>> buffers{};
+};
+
+[[nodiscard]] static LoadedBuffers
+loadBuffers(const Document &document, std::span<const std::byte> binaryChunk, const std::string &fileName) {
+    constexpr std::string_view DataURIPrefix{"data:application/octet-stream;base64,"};
+
+    LoadedBuffers result{};
+    result.files.reserve(std::size(document.buffers()));
+    result.decoded.reserve(std::size(document.buffers()));
+
+    for (const auto &buffer : document.buffers()) {
+        if (std::empty(buffer.uri)) {
+            result.buffers.push_back(binaryChunk.first(std::min(buffer.byteLength, std::size(binaryChunk))));
+        } else if (buffer.uri.starts_with(DataURIPrefix)) {
+            auto &data = result.decoded.emplace_back();
+            if (!base64::decode(buffer.uri.substr(std::size(DataURIPrefix)), data))
+                fail("Failed to decode a data URI");
+            result.buffers.push_back(std::as_bytes(std::span{data}));
+        } else {
+            const auto path = std::filesystem::path(fileName).parent_path() / buffer.uri;
+            auto &file = result.files.emplace_back(path.string(), io::MappedFile::AccessHint::WILL_NEED);
+            if (!file)
+                fail("Failed to map a buffer");
+            result.buffers.push_back(file.data());
+        }
+    }
+
+    return result;
+}
+
+/**
+ * The layout of gle::vertexLayoutFor(), without the renderer.
+ */
+[[nodiscard]] static resources::VertexLayout
+loaderLayout(const resources::DecodedMesh &mesh) {
+    resources::VertexLayout layout{};
+    layout.add(resources::VertexAttribute::POSITION)
+          .add(resources::VertexAttribute::NORMAL)
+          .add(resources::VertexAttribute::TEXTURE_COORDINATES);
+    if (!std::empty(mesh.tangents)) {
+        layout.add(resources::VertexAttribute::TANGENT)
+              .add(resources::VertexAttribute::BITANGENT);
+    }
+    return layout;
+}
+
+int main(int argc, char **argv) {
+    const std::string fileName = argc > 1 ? argv[1] : "Resources/Assets/Models/Scene.gltf";
+
+    io::MappedFile file{fileName, io::MappedFile::AccessHint::SEQUENTIAL};
+    if (!file)
+        fail("Failed to map the file");
+
+    std::string_view text{reinterpret_cast<const char *>(file.data().data()), file.size()};
+    std::span<const std::byte> binaryChunk{};
+    if (isBinaryContainer(file.data())) {
+        auto container = parseBinaryContainer(file.data());
+        if (container.failed())
+            fail("Failed to parse the GLB container");
+        text = container->json;
+        binaryChunk = container->binary;
+    }
+
+    auto parsed = Document::parseInPlace(text);
+    if (parsed.failed())
+        fail("Failed to parse the document");
+    const auto &document = parsed.get();
+
+    const auto loaded = loadBuffers(document, binaryChunk, fileName);
+    const MeshDecoder decoder{document, loaded.buffers};
+    const auto primitives = document.primitives();
+
+    std::size_t vertexCount{};
+    std::size_t triangleCount{};
+    for (const auto &primitive : primitives) {
+        auto mesh = decoder.decode(primitive);
+        if (mesh.failed())
+            fail(mesh.error().description());
+        vertexCount += mesh->vertexCount();
+        triangleCount += mesh->triangleCount();
+    }
+    std::printf("%s: %zu primitives, %zu vertices, %zu triangles\n", fileName.c_str(),
+                std::size(primitives), vertexCount, triangleCount);
+
+    std::size_t sum{};
+    const auto decodeSerially = [&] {
+        for (const auto &primitive : primitives) {
+            auto mesh = decoder.decode(primitive);
+            sum += std::size(mesh->normals) + std::size(mesh->tangents);
+        }
+    };
+
+    // Like the loader, every primitive is a job that keeps its mesh until
+    // it would be uploaded.
+    std::vector<resources::DecodedMesh> meshes(std::size(primitives));
+    const auto decodeInParallel = [&] {
+        base::JobGraph graph{};
+        for (std::size_t i = 0; i < std::size(primitives); ++i) {
+            static_cast<void>(graph.addJob("Decode", [&decoder, &meshes, &primitives, i] {
+                meshes[i] = std::move(decoder.decode(primitives[i]).get());
+            }));
+        }
+        graph.run();
+
+        for (auto &mesh : meshes) {
+            sum += std::size(mesh.normals) + std::size(mesh.tangents);
+            mesh = {};
+        }
+    };
+
+    std::size_t interleavedBytes{};
+    const auto decodeAndInterleave = [&] {
+        interleavedBytes = 0;
+        for (const auto &primitive : primitives) {
+            auto mesh = decoder.decode(primitive);
+            const auto interleaved = resources::InterleavedMesh::interleave(mesh.get(), loaderLayout(mesh.get()));
+            interleavedBytes += std::size(interleaved.vertices);
+        }
+        sum += interleavedBytes;
+    };
+
+    resources::VertexCacheStatistics vertexCacheBefore{};
+    resources::VertexCacheStatistics vertexCacheAfter{};
+    const auto decodeInterleaveAndOptimize = [&] {
+        vertexCacheBefore = {};
+        vertexCacheAfter = {};
+        for (const auto &primitive : primitives) {
+            auto mesh = decoder.decode(primitive);
+            auto interleaved = resources::InterleavedMesh::interleave(mesh.get(), loaderLayout(mesh.get()));
+
+            const auto optimization = resources::MeshOptimization::optimize(interleaved, {});
+            optimization.apply(interleaved);
+            vertexCacheBefore += optimization.before;
+            vertexCacheAfter += optimization.after;
+            sum += std::size(interleaved.indices);
+        }
+    };
+
+    // The triangles and the largest error of all primitives at every
+    // level, where primitives with fewer levels count their coarsest one.
+    std::vector<std::size_t> levelTriangleCounts{};
+    std::vector<float> levelErrors{};
+    const auto decodeInterleaveAndSimplify = [&] {
+        levelTriangleCounts.clear();
+        levelErrors.clear();
+
+        std::vector<resources::InterleavedMesh> interleavedMeshes{};
+        for (const auto &primitive : primitives) {
+            auto mesh = decoder.decode(primitive);
+            auto interleaved = resources::InterleavedMesh::interleave(mesh.get(), loaderLayout(mesh.get()));
+            resources::MeshOptimization::optimize(interleaved, {}).apply(interleaved);
+            resources::generateLevelsOfDetail(interleaved);
+
+            const auto levelCount = std::size(interleaved.levelsOfDetail) + 1;
+            if (levelCount > std::size(levelTriangleCounts)) {
+                levelTriangleCounts.resize(levelCount);
+                levelErrors.resize(levelCount);
+            }
+            interleavedMeshes.push_back(std::move(interleaved));
+        }
+
+        for (const auto &interleaved : interleavedMeshes) {
+            const auto &levels = interleaved.levelsOfDetail;
+            const auto indexSize = resources::DecodedMesh::indexTypeSize(interleaved.indexType);
+            for (std::size_t level = 0; level < std::size(levelTriangleCounts); ++level) {
+                if (level == 0 || std::empty(levels)) {
+                    levelTriangleCounts[level] += interleaved.indexCount() / 3;
+                    continue;
+                }
+
+                const auto &levelOfDetail = levels[std::min(level, std::size(levels)) - 1];
+                levelTriangleCounts[level] += std::size(levelOfDetail.indices) / indexSize / 3;
+                levelErrors[level] = std::max(levelErrors[level], levelOfDetail.error);
+            }
+            sum += std::size(levels);
+        }
+    };
+
+    // Warm up the caches and the thread pool.
+    decodeSerially();
+    decodeInParallel();
+    decodeAndInterleave();
+    decodeInterleaveAndOptimize();
+    decodeInterleaveAndSimplify();
+
+    const auto serialResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            decodeSerially();
+    });
+
+    const auto parallelResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            decodeInParallel();
+    });
+
+    benchmark::report("decode serially", serialResult, Rounds * std::size(primitives));
+    benchmark::report("decode as jobs", parallelResult, Rounds * std::size(primitives));
+
+    const auto interleaveResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            decodeAndInterleave();
+    });
+    benchmark::report("decode + interleave", interleaveResult, Rounds * std::size(primitives));
+
+    const auto optimizeResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round)
+            decodeInterleaveAndOptimize();
+    });
+    benchmark::report("decode + interleave + optimize", optimizeResult, Rounds * std::size(primitives));
+
+    // Simplifying is much slower than the rest, so it gets fewer rounds.
+    constexpr std::size_t SimplifyRounds = Rounds / 20;
+    const auto simplifyResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < SimplifyRounds; ++round)
+            decodeInterleaveAndSimplify();
+    });
+    benchmark::report("decode + ... + levels of detail", simplifyResult, SimplifyRounds * std::size(primitives));
+
+    benchmark::reportPeakMemory("decode serially", benchmark::measure(decodeSerially));
+    benchmark::reportPeakMemory("decode + interleave", benchmark::measure(decodeAndInterleave));
+    std::printf("%-40s %10zu interleaved vertex bytes\n", "", interleavedBytes);
+    std::printf("%-40s %10.3f -> %.3f ACMR\n", "", static_cast<double>(vertexCacheBefore.averageCacheMissRatio()),
+                static_cast<double>(vertexCacheAfter.averageCacheMissRatio()));
+    std::printf("%-40s %10.3f -> %.3f ATVR\n", "", static_cast<double>(vertexCacheBefore.averageTransformToVertexRatio()),
+                static_cast<double>(vertexCacheAfter.averageTransformToVertexRatio()));
+    for (std::size_t level = 0; level < std::size(levelTriangleCounts); ++level) {
+        std::printf("%-40s %10zu triangles at level %zu, error %.5f\n", "", levelTriangleCounts[level], level,
+                    static_cast<double>(levelErrors[level]));
+    }
+
+    std::printf("%-40s %10zu workers\n", "", base::ThreadPool::global().workerCount());
+    std::printf("%-40s %10zu checksum\n", "", sum);
+}
@@ -0,0 +1,122 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Shared scaffolding for the benchmarks. Every benchmark is a separate
+ * executable consisting of a single translation unit that includes this
+ * header, since it replaces the global allocation functions to count heap
+ * allocations and the amount of live heap memory.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+#include <cstddef> // for std::size_t
+
+namespace benchmark {
+
+    inline std::atomic_size_t g_allocationCount{0};
+    inline std::atomic_size_t g_liveBytes{0};
+    inline std::atomic_size_t g_peakBytes{0};
+
+    // Every allocation is prefixed with its size, so that the unsized
+    // operator delete can subtract it from the live bytes.
+    inline constexpr std::size_t AllocationHeaderSize = alignof(std::max_align_t);
+
+    struct Result {
+        std::chrono::nanoseconds duration{};
+        std::size_t allocations{};
+
+        // The highest amount of live heap memory during the measurement, on
+        // top of what was live before it.
+        std::size_t peakBytes{};
+    };
+
+    /**
+     * Runs the function once and measures the wall time, the amount of heap
+     * allocations and the peak heap usage on all threads during that time.
+     */
+    template<typename Function>
+    [[nodiscard]] Result
+    measure(Function &&function) {
+        const auto allocationsBefore = g_allocationCount.load(std::memory_order_relaxed);
+        const auto liveBytesBefore = g_liveBytes.load(std::memory_order_relaxed);
+        g_peakBytes.store(liveBytesBefore, std::memory_order_relaxed);
+        const auto begin = std::chrono::steady_clock::now();
+
+        function();
+
+        const auto end = std::chrono::steady_clock::now();
+        return Result{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin),
+            g_allocationCount.load(std::memory_order_relaxed) - allocationsBefore,
+            g_peakBytes.load(std::memory_order_relaxed) - liveBytesBefore
+        };
+    }
+
+    /**
+     * Prints the result divided over the amount of operations, e.g. the
+     * amount of task hops.
+     */
+    inline void
+    report(std::string_view name, const Result &result, std::size_t operations) {
+        const auto ops = static_cast<double>(operations);
+        std::printf("%-40.*s %10.1f ns/op %8.2f allocations/op\n",
+                    static_cast<int>(name.length()), name.data(),
+                    static_cast<double>(result.duration.count()) / ops,
+                    static_cast<double>(result.allocations) / ops);
+    }
+
+    /**
+     * Prints the peak heap usage of a measurement that ran one operation.
+     */
+    inline void
+    reportPeakMemory(std::string_view name, const Result &result) {
+        std::printf("%-40.*s %10.1f KiB peak heap\n",
+                    static_cast<int>(name.length()), name.data(),
+                    static_cast<double>(result.peakBytes) / 1024.0);
+    }
+
+} // namespace benchmark
+
+void *
+operator new(std::size_t size) {
+    benchmark::g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    auto *base = static_cast<std::byte *>(std::malloc(benchmark::AllocationHeaderSize + size));
+    if (base == nullptr)
+        throw std::bad_alloc();
+    *reinterpret_cast<std::size_t *>(base) = size;
+
+    const auto live = benchmark::g_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = benchmark::g_peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !benchmark::g_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    return base + benchmark::AllocationHeaderSize;
+}
+
+void
+operator delete(void *pointer) noexcept {
+    if (pointer == nullptr)
+        return;
+
+    auto *base = static_cast<std::byte *>(pointer) - benchmark::AllocationHeaderSize;
+    benchmark::g_liveBytes.fetch_sub(*reinterpret_cast<std::size_t *>(base), std::memory_order_relaxed);
+    std::free(base);
+}
+
+void
+operator delete(void *pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
@@ -0,0 +1,90 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares composing the matrices of 10k changed transformations one at a
+ * time through math::Transformation against the batch kernels of every
+ * instruction set that this CPU supports, and likewise for multiplying
+ * them.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <string>
+#include <vector>
+
+#include "Source/Math/Batch.hpp"
+#include "Source/Math/Transformation.hpp"
+
+constexpr std::size_t TransformationCount = 10'000;
+constexpr std::size_t Rounds = 100;
+
+int main() {
+    std::vector<math::Vector3f> translations{};
+    std::vector<math::Quaternion<float>> rotations{};
+    std::vector<math::Vector3f> scalings{};
+    std::vector<math::Transformation> transformations{};
+    for (std::size_t i = 0; i < TransformationCount; ++i) {
+        const auto value = static_cast<float>(i % 360);
+        translations.push_back({value, 1.0f, 2.0f});
+        rotations.push_back(math::Quaternion<float>::fromEulerAngles({value, 90.0f - value, value / 2}));
+        scalings.push_back({1.0f, 2.0f, 1.0f});
+        transformations.emplace_back(translations.back(), rotations.back(), scalings.back());
+    }
+
+    std::vector<math::Matrix4x4<float>> matrices(TransformationCount);
+    std::vector<math::Matrix4x4<float>> results(TransformationCount);
+    float sum{};
+
+    const auto singleResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (std::size_t i = 0; i < TransformationCount; ++i) {
+                transformations[i].setTranslation(translations[i]);
+                matrices[i] = transformations[i].toMatrix();
+            }
+        }
+    });
+    benchmark::report("compose Transformation", singleResult, Rounds * TransformationCount);
+    sum += matrices.back()[0][0];
+
+    const auto mulResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (std::size_t i = 0; i < TransformationCount; ++i)
+                results[i] = matrices[i].mul(matrices[TransformationCount - 1 - i]);
+        }
+    });
+    benchmark::report("multiply Matrix4x4::mul", mulResult, Rounds * TransformationCount);
+    sum += results.back()[0][0];
+
+    for (const auto isa : {math::simd::Isa::SCALAR, math::simd::Isa::SSE2, math::simd::Isa::AVX2, math::simd::Isa::NEON}) {
+        const auto *kernels = math::simd::matrixKernelsFor(isa);
+        if (kernels == nullptr)
+            continue;
+
+        const auto composeResult = benchmark::measure([&] {
+            for (std::size_t round = 0; round < Rounds; ++round) {
+                kernels->composeTRS(reinterpret_cast<const float *>(translations.data()),
+                                    reinterpret_cast<const float *>(rotations.data()),
+                                    reinterpret_cast<const float *>(scalings.data()),
+                                    matrices.data(), TransformationCount);
+            }
+        });
+        sum += matrices.back()[0][0];
+
+        const auto multiplyResult = benchmark::measure([&] {
+            for (std::size_t round = 0; round < Rounds; ++round)
+                kernels->multiplyMany(matrices.data(), matrices.data(), results.data(), TransformationCount);
+        });
+        sum += results.back()[0][0];
+
+        const std::string name{math::simd::toString(isa)};
+        benchmark::report("composeTRS   " + name, composeResult, Rounds * TransformationCount);
+        benchmark::report("multiplyMany " + name, multiplyResult, Rounds * TransformationCount);
+    }
+
+    std::printf("%-40s %10.1f checksum\n", "", static_cast<double>(sum));
+}
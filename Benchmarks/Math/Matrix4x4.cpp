@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares the Matrix4x4<float> kernels of every instruction set that this
+ * CPU supports against the scalar ones, over a batch of matrices that fits
+ * in the L1 cache.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <string>
+#include <vector>
+
+#include "Source/Math/Matrix4x4.hpp"
+
+constexpr std::size_t MatrixCount = 256;
+constexpr std::size_t Rounds = 4'000;
+
+[[nodiscard]] static math::Matrix4x4<float>
+matrixOf(std::size_t index) noexcept {
+    math::Matrix4x4<float> matrix{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j)
+            matrix[i][j] = static_cast<float>((index + i * 4 + j) % 7) * 0.25f;
+        matrix[i][i] += 4.0f;
+    }
+    return matrix;
+}
+
+int main() {
+    std::printf("selected kernels: %s\n", std::string(math::simd::toString(math::simd::detectIsa())).c_str());
+
+    std::vector<math::Matrix4x4<float>> matrices(MatrixCount);
+    for (std::size_t i = 0; i < MatrixCount; ++i)
+        matrices[i] = matrixOf(i);
+    std::vector<math::Matrix4x4<float>> results(MatrixCount);
+
+    float sum{};
+    for (const auto isa : {math::simd::Isa::SCALAR, math::simd::Isa::SSE2, math::simd::Isa::AVX2, math::simd::Isa::NEON}) {
+        const auto *kernels = math::simd::matrixKernelsFor(isa);
+        if (kernels == nullptr)
+            continue;
+
+        const auto multiplyResult = benchmark::measure([&] {
+            for (std::size_t round = 0; round < Rounds; ++round) {
+                for (std::size_t i = 0; i < MatrixCount; ++i)
+                    kernels->multiply(matrices[i], matrices[(i + round) % MatrixCount], results[i]);
+            }
+        });
+        sum += results.back()[0][0];
+
+        const auto transposeResult = benchmark::measure([&] {
+            for (std::size_t round = 0; round < Rounds; ++round) {
+                for (std::size_t i = 0; i < MatrixCount; ++i)
+                    kernels->transpose(matrices[i], results[i]);
+            }
+        });
+        sum += results.back()[0][1];
+
+        const auto inverseResult = benchmark::measure([&] {
+            for (std::size_t round = 0; round < Rounds; ++round) {
+                for (std::size_t i = 0; i < MatrixCount; ++i)
+                    kernels->inverse(matrices[i], results[i]);
+            }
+        });
+        sum += results.back()[0][2];
+
+        const std::string name{math::simd::toString(isa)};
+        benchmark::report("multiply  " + name, multiplyResult, Rounds * MatrixCount);
+        benchmark::report("transpose " + name, transposeResult, Rounds * MatrixCount);
+        benchmark::report("inverse   " + name, inverseResult, Rounds * MatrixCount);
+    }
+
+    std::printf("%-40s %10.1f checksum\n", "", static_cast<double>(sum));
+}
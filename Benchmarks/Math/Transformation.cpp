@@ -0,0 +1,90 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * Compares math::Transformation::toMatrix() against the Euler angle version
+ * it replaced, which composed four matrices with six trigonometric calls,
+ * both when every transformation changed and when none did, like the static
+ * entities of a scene.
+ */
+
+#include "Benchmarks/Include.hpp"
+
+#include <string>
+#include <vector>
+
+#include "Source/Math/Transformation.hpp"
+
+constexpr std::size_t TransformationCount = 10'000;
+constexpr std::size_t Rounds = 100;
+
+struct LegacyTransformation {
+    math::Vector3f translation{};
+    math::Vector3f rotation{};
+    math::Vector3f scaling{1.0f, 1.0f, 1.0f};
+
+    [[nodiscard]] math::Matrix4x4<float>
+    toMatrix() const noexcept {
+        const auto translationMatrix = math::Matrix4x4<float>().translate(translation);
+        const auto rotationMatrix = math::Matrix4x4<float>().rotate(rotation);
+        const auto scalingMatrix = math::Matrix4x4<float>().scale(scaling);
+
+        return translationMatrix.mul(rotationMatrix.mul(scalingMatrix));
+    }
+};
+
+[[nodiscard]] static math::Vector3f
+degreesOf(std::size_t i) noexcept {
+    const auto value = static_cast<float>(i % 360);
+    return {value, 90.0f - value, value / 2};
+}
+
+[[nodiscard]] static math::Vector3f
+translationOf(std::size_t i) noexcept {
+    return {static_cast<float>(i), 1.0f, 2.0f};
+}
+
+int main() {
+    float sum{};
+
+    std::vector<LegacyTransformation> legacy(TransformationCount);
+    std::vector<math::Transformation> transformations(TransformationCount);
+    for (std::size_t i = 0; i < TransformationCount; ++i) {
+        legacy[i] = LegacyTransformation{translationOf(i), degreesOf(i), {1.0f, 2.0f, 1.0f}};
+        transformations[i] = math::Transformation::fromEulerAngles(translationOf(i), degreesOf(i), {1.0f, 2.0f, 1.0f});
+    }
+
+    const auto legacyResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (const auto &transformation : legacy)
+                sum += transformation.toMatrix()[0][0];
+        }
+    });
+
+    // Every transformation moves, so every matrix is composed again.
+    const auto changedResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (std::size_t i = 0; i < TransformationCount; ++i) {
+                transformations[i].setTranslation(translationOf(i + round));
+                sum += transformations[i].toMatrix()[0][0];
+            }
+        }
+    });
+
+    const auto cachedResult = benchmark::measure([&] {
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (const auto &transformation : transformations)
+                sum += transformation.toMatrix()[0][0];
+        }
+    });
+
+    const auto count = std::to_string(TransformationCount);
+    benchmark::report("euler toMatrix      x" + count, legacyResult, Rounds * TransformationCount);
+    benchmark::report("quaternion changed  x" + count, changedResult, Rounds * TransformationCount);
+    benchmark::report("quaternion cached   x" + count, cachedResult, Rounds * TransformationCount);
+    std::printf("%-40s %10.1f checksum\n", "", static_cast<double>(sum));
+}
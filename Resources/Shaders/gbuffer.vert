@@ -16,18 +16,18 @@ out vec2 fragment_textureCoordinates;
 out mat3 fragment_tbnMatrix;
 
 uniform mat4 u_transform;
-uniform mat4 u_projection;
-uniform mat4 u_view;
+uniform mat4 u_normalMatrix;
+uniform mat4 u_viewProjection;
 
 void main() {
     vec3 T = normalize(vec3(u_transform * vec4(vertex_tangent, 0.0)));
     vec3 B = normalize(vec3(u_transform * vec4(vertex_bitangent, 0.0)));
-    vec3 N = normalize(vec3(u_transform * vec4(vertex_normal, 0.0)));
+    vec3 N = normalize(mat3(u_normalMatrix) * vertex_normal);
     fragment_tbnMatrix = mat3(T, B, N);
 
     vec4 worldPosition = u_transform * vec4(position, 1.0);
 
-    gl_Position = u_projection * u_view * worldPosition;
+    gl_Position = u_viewProjection * worldPosition;
 
     fragment_position = worldPosition.xyz;
     fragment_normal = normalize(vertex_normal);
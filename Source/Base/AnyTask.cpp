@@ -0,0 +1,81 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * This mechanism was made because there is no std::future::then or
+ * something alike, which is a shame. Hopefully P2300R5 will make
+ * this obsolete in the future :)
+ */
+
+#include "AnyTask.hpp"
+
+#include <cassert>
+
+#include "Source/Base/ThreadPool.hpp"
+
+namespace base {
+
+    std::shared_ptr<AnyTask>
+    AnyTask::run(AnyTask &&inTask, std::any parameter) noexcept {
+        return run(std::move(inTask), std::move(parameter), ThreadPool::global());
+    }
+
+    std::shared_ptr<AnyTask>
+    AnyTask::run(AnyTask &&inTask, std::any parameter, ThreadPool &pool) noexcept {
+        auto startTask = std::make_shared<AnyTask>(std::move(inTask));
+        startTask->m_pool = &pool;
+        startTask->schedule(startTask, std::move(parameter));
+        return startTask;
+    }
+
+    void
+    AnyTask::execute(std::any &&parameter) noexcept {
+        auto result = m_function(std::move(parameter));
+
+        std::shared_ptr<AnyTask> next;
+        {
+            std::lock_guard guard{m_mutex};
+            if (m_next == nullptr) {
+                // then() hasn't been called (yet), it'll schedule the
+                // continuation with this result.
+                m_result = std::move(result);
+                return;
+            }
+
+            next = m_next;
+        }
+
+        schedule(std::move(next), std::move(result));
+    }
+
+    void
+    AnyTask::schedule(std::shared_ptr<AnyTask> task, std::any &&parameter) noexcept {
+        assert(m_pool != nullptr);
+        task->m_pool = m_pool;
+
+        m_pool->post([task = std::move(task), parameter = std::move(parameter)] () mutable {
+            task->execute(std::move(parameter));
+        });
+    }
+
+    std::shared_ptr<AnyTask>
+    AnyTask::then(std::shared_ptr<AnyTask> &&task) noexcept {
+        std::optional<std::any> result;
+        {
+            std::lock_guard guard{m_mutex};
+            assert(m_next == nullptr);
+            m_next = task;
+            result.swap(m_result);
+        }
+
+        if (result.has_value())
+            schedule(task, std::move(*result));
+
+        return task;
+    }
+
+}
@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * This mechanism was made because there is no std::future::then or
+ * something alike, which is a shame. Hopefully P2300R5 will make
+ * this obsolete in the future :)
+ */
+
+#pragma once
+
+#include <any>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace base {
+
+    class ThreadPool;
+    
+    /**
+     * A chain of functions that run one after another on a ThreadPool, where
+     * each function receives the result of the previous one.
+     *
+     * The results are type-erased through std::any, so every hop costs a few
+     * heap allocations. Prefer base::Task<T> when the types are known at
+     * compile time, which is nearly always.
+     *
+     * When a function finishes before its continuation is attached using
+     * then(), the result is parked inside the task and the continuation is
+     * posted to the pool as soon as it is attached. No thread ever waits for
+     * then() to be called.
+     */
+    struct AnyTask {
+        using FunctionType = std::function<std::any (std::any&&)>;
+        
+        [[nodiscard]] explicit
+        AnyTask(FunctionType &&function)
+                : m_function(std::move(function)) {
+        }
+
+        template<typename Result>
+        [[nodiscard]] static AnyTask
+        create(auto function) {
+            return AnyTask([func = std::function<Result ()>(function)](std::any) -> std::any {
+                return func();
+            });
+        }
+
+        /**
+         * Tasks may only be moved before they are run, so the scheduling
+         * state isn't carried over.
+         */
+        [[nodiscard]]
+        AnyTask(AnyTask &&other) noexcept
+                : m_function(std::move(other.m_function))
+                , m_next(std::move(other.m_next)) {
+        }
+
+        AnyTask &operator=(const AnyTask &) noexcept = delete;
+        AnyTask &operator=(AnyTask &&) noexcept = delete;
+
+        /**
+         * Schedules the task on the global ThreadPool.
+         */
+        static std::shared_ptr<AnyTask>
+        run(AnyTask &&, std::any) noexcept;
+
+        static std::shared_ptr<AnyTask>
+        run(AnyTask &&, std::any, ThreadPool &) noexcept;
+
+        /* discardable */ std::shared_ptr<AnyTask>
+        then(std::shared_ptr<AnyTask> &&) noexcept;
+
+        /* discardable */ std::shared_ptr<AnyTask>
+        then(AnyTask &&task) noexcept {
+            return then(std::make_shared<AnyTask>(std::move(task)));
+        }
+
+        /* discardable */ std::shared_ptr<AnyTask>
+        then(FunctionType &&function) noexcept {
+            return then(std::make_shared<AnyTask>( std::move(function)));
+        }
+
+        template<typename Result>
+        static AnyTask
+        then(auto function) {
+            return AnyTask([func = std::function<Result()>(function)](std::any) -> std::any {
+                return func();
+            });
+        }
+
+        template<typename Result, typename Parameter>
+        static AnyTask
+        then(auto function) {
+            return AnyTask([func = std::function<Result(Parameter)>(function)](std::any &&parameter) -> std::any {
+                if constexpr (std::is_same_v<Result, void>) {
+                    func(std::any_cast<Parameter&&>(std::move(parameter)));
+                    return {};
+                } else {
+                    return func(std::any_cast<Parameter&&>(std::move(parameter)));
+                }
+            });
+        }
+
+    private:
+        void
+        execute(std::any &&parameter) noexcept;
+
+        void
+        schedule(std::shared_ptr<AnyTask> task, std::any &&parameter) noexcept;
+
+        FunctionType m_function;
+
+        // Guards the fields below, since then() is called by the thread that
+        // builds the chain, whilst execute() runs on a pool worker.
+        std::mutex m_mutex{};
+        std::shared_ptr<AnyTask> m_next{};
+        std::optional<std::any> m_result{};
+        ThreadPool *m_pool{nullptr};
+    };
+    
+} // namespace base
+
@@ -0,0 +1,311 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * The coroutine counterpart of base::Task<T>, for work that reads best as
+ * straight-line code hopping between threads:
+ *
+ *     base::Async<base::Error> load() {
+ *         co_await base::resumeOn(base::ThreadPool::global());
+ *         CO_TRY_GET_VARIABLE(bytes, location.readAllBytes())
+ *         co_await event::resumeOn(mainThreadQueue);
+ *         ...
+ *     }
+ */
+
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <exception> // for std::terminate
+#include <optional>
+#include <utility>
+
+#include <cassert>
+#include <cstddef> // for std::size_t
+
+#include "Source/Base/FreeListAllocator.hpp"
+#include "Source/Base/ThreadPool.hpp"
+
+namespace base {
+
+    namespace detail {
+
+        // Coroutine frames are rounded up to a multiple of this size, and
+        // every size class up to 2 KiB has its own free list. Larger frames
+        // come from the heap.
+        inline constexpr std::size_t s_frameSizeGranularity = 128;
+        inline constexpr std::size_t s_frameSizeClassCount = 16;
+
+        template<std::size_t...Indices>
+        [[nodiscard]] consteval auto
+        createFrameAllocateFunctions(std::index_sequence<Indices...>) noexcept {
+            return std::array<void *(*)(), sizeof...(Indices)>{
+                &FreeListAllocator<(Indices + 1) * s_frameSizeGranularity>::allocate...
+            };
+        }
+
+        template<std::size_t...Indices>
+        [[nodiscard]] consteval auto
+        createFrameDeallocateFunctions(std::index_sequence<Indices...>) noexcept {
+            return std::array<void (*)(void *) noexcept, sizeof...(Indices)>{
+                &FreeListAllocator<(Indices + 1) * s_frameSizeGranularity>::deallocate...
+            };
+        }
+
+        inline constexpr auto s_frameAllocateFunctions
+                = createFrameAllocateFunctions(std::make_index_sequence<s_frameSizeClassCount>());
+        inline constexpr auto s_frameDeallocateFunctions
+                = createFrameDeallocateFunctions(std::make_index_sequence<s_frameSizeClassCount>());
+
+        [[nodiscard]] inline void *
+        allocateCoroutineFrame(std::size_t size) {
+            const auto sizeClass = (size + s_frameSizeGranularity - 1) / s_frameSizeGranularity;
+            if (sizeClass > s_frameSizeClassCount)
+                return ::operator new(size);
+            return s_frameAllocateFunctions[sizeClass - 1]();
+        }
+
+        inline void
+        deallocateCoroutineFrame(void *frame, std::size_t size) noexcept {
+            const auto sizeClass = (size + s_frameSizeGranularity - 1) / s_frameSizeGranularity;
+            if (sizeClass > s_frameSizeClassCount)
+                ::operator delete(frame);
+            else
+                s_frameDeallocateFunctions[sizeClass - 1](frame);
+        }
+
+        class AsyncPromiseBase {
+        public:
+            [[nodiscard]] static void *
+            operator new(std::size_t size) {
+                return allocateCoroutineFrame(size);
+            }
+
+            static void
+            operator delete(void *frame, std::size_t size) noexcept {
+                deallocateCoroutineFrame(frame, size);
+            }
+
+            struct FinalAwaiter {
+                [[nodiscard]] constexpr bool
+                await_ready() const noexcept {
+                    return false;
+                }
+
+                template<typename Promise>
+                [[nodiscard]] std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                    auto &promise = handle.promise();
+                    if (promise.m_detached) {
+                        handle.destroy();
+                        return std::noop_coroutine();
+                    }
+
+                    if (promise.m_continuation)
+                        return promise.m_continuation;
+                    return std::noop_coroutine();
+                }
+
+                constexpr void
+                await_resume() const noexcept {
+                }
+            };
+
+            // Async is lazy: nothing runs until it is awaited or detached.
+            [[nodiscard]] constexpr std::suspend_always
+            initial_suspend() const noexcept {
+                return {};
+            }
+
+            [[nodiscard]] constexpr FinalAwaiter
+            final_suspend() const noexcept {
+                return {};
+            }
+
+            // Errors are reported through base::Error, not through
+            // exceptions.
+            [[noreturn]] void
+            unhandled_exception() const noexcept {
+                std::terminate();
+            }
+
+            void
+            setContinuation(std::coroutine_handle<> continuation) noexcept {
+                m_continuation = continuation;
+            }
+
+            void
+            markDetached() noexcept {
+                m_detached = true;
+            }
+
+        private:
+            std::coroutine_handle<> m_continuation{};
+            bool m_detached{false};
+        };
+
+        template<typename T>
+        class AsyncResult {
+        public:
+            void
+            return_value(T value) {
+                m_result.emplace(std::move(value));
+            }
+
+            [[nodiscard]] T
+            takeResult() noexcept {
+                assert(m_result.has_value());
+                return std::move(*m_result);
+            }
+
+        private:
+            std::optional<T> m_result{};
+        };
+
+        template<>
+        class AsyncResult<void> {
+        public:
+            constexpr void
+            return_void() const noexcept {
+            }
+
+            constexpr void
+            takeResult() const noexcept {
+            }
+        };
+
+    } // namespace detail
+
+    /**
+     * A lazily started coroutine producing a T. It starts when it is either
+     * co_await'ed by another coroutine, which is resumed when it finishes, or
+     * detached, after which it cleans up after itself.
+     *
+     * Frames are allocated from per-size-class free lists.
+     */
+    template<typename T>
+    class [[nodiscard]] Async {
+    public:
+        struct promise_type : detail::AsyncPromiseBase, detail::AsyncResult<T> {
+            [[nodiscard]] Async
+            get_return_object() noexcept {
+                return Async{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+        };
+
+        using HandleType = std::coroutine_handle<promise_type>;
+
+        Async(Async &&other) noexcept
+                : m_handle(std::exchange(other.m_handle, nullptr)) {
+        }
+
+        Async(const Async &) = delete;
+
+        Async &
+        operator=(Async &&other) noexcept {
+            if (this != &other) {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+            return *this;
+        }
+
+        Async &operator=(const Async &) = delete;
+
+        ~Async() noexcept {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+        [[nodiscard]] auto
+        operator co_await() && noexcept {
+            struct Awaiter {
+                HandleType handle;
+
+                [[nodiscard]] constexpr bool
+                await_ready() const noexcept {
+                    return false;
+                }
+
+                [[nodiscard]] std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    handle.promise().setContinuation(awaiting);
+                    return handle;
+                }
+
+                T
+                await_resume() noexcept {
+                    return handle.promise().takeResult();
+                }
+            };
+
+            assert(m_handle);
+            return Awaiter{m_handle};
+        }
+
+        /**
+         * Starts the coroutine on the calling thread, without anyone waiting
+         * for it. The frame is destroyed when it finishes.
+         */
+        void
+        detach() && noexcept {
+            assert(m_handle);
+            auto handle = std::exchange(m_handle, nullptr);
+            handle.promise().markDetached();
+            handle.resume();
+        }
+
+    private:
+        [[nodiscard]] explicit
+        Async(HandleType handle) noexcept
+                : m_handle(handle) {
+        }
+
+        HandleType m_handle;
+    };
+
+    struct ThreadPoolAwaiter {
+        ThreadPool &pool;
+
+        [[nodiscard]] constexpr bool
+        await_ready() const noexcept {
+            return false;
+        }
+
+        void
+        await_suspend(std::coroutine_handle<> handle) noexcept {
+            pool.post([handle] {
+                handle.resume();
+            });
+        }
+
+        constexpr void
+        await_resume() const noexcept {
+        }
+    };
+
+    /**
+     * Continues the awaiting coroutine on a worker of the given pool.
+     */
+    [[nodiscard]] inline ThreadPoolAwaiter
+    resumeOn(ThreadPool &pool) noexcept {
+        return ThreadPoolAwaiter{pool};
+    }
+
+} // namespace base
+
+#define CO_TRY(expr) \
+    if (auto error = (expr)) \
+        co_return error;
+
+#define CO_TRY_GET_VARIABLE(variable, expression) \
+    auto tryGetVariable_##variable = (expression); \
+    if (tryGetVariable_##variable.failed()) \
+        co_return tryGetVariable_##variable.error(); \
+    auto variable = std::move(tryGetVariable_##variable.get());
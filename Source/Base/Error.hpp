@@ -9,73 +9,155 @@
 
 #pragma once
 
+#include <atomic>
 #include <source_location>
 #include <string>
+#include <string_view>
+#include <type_traits> // for std::is_convertible_v
+#include <utility> // for std::exchange, std::move, std::swap
+
+#include <cstddef> // for std::size_t
 
 namespace base {
 
+    /**
+     * The result of an operation that can fail.
+     *
+     * A successful Error is a null pointer, so creating, copying and checking
+     * it is as cheap as it gets. The details of a failure live in a
+     * reference-counted block on the heap, which is shared between copies.
+     *
+     * Descriptions that are string literals are referred to instead of
+     * copied, other descriptions are owned by that block.
+     */
     struct Error {
         [[nodiscard]] static constexpr Error
         success() noexcept {
-            return Error{true};
+            return Error{};
         }
 
         [[nodiscard]]
         Error(std::string_view libraryName, std::string_view className, 
               std::string_view attemptedAction, std::string description,
               std::source_location location = std::source_location::current()) noexcept
-            : m_libraryName(libraryName)
-            , m_className(className)
-            , m_attemptedAction(attemptedAction)
-            , m_description(std::move(description))
-            , m_sourceLocation(location) {
+            : m_data(new Data{libraryName, className, attemptedAction, std::move(description), location}) {
+        }
+
+        /**
+         * The description must be a string literal, or another array that
+         * outlives the error.
+         */
+        template<std::size_t Size>
+        [[nodiscard]]
+        Error(std::string_view libraryName, std::string_view className,
+              std::string_view attemptedAction, const char (&description)[Size],
+              std::source_location location = std::source_location::current()) noexcept
+            : m_data(new Data{libraryName, className, attemptedAction, std::string_view{description}, location}) {
+        }
+
+        [[nodiscard]] constexpr
+        Error(const Error &other) noexcept
+                : m_data(other.m_data) {
+            if (m_data)
+                m_data->referenceCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] constexpr
+        Error(Error &&other) noexcept
+                : m_data(std::exchange(other.m_data, nullptr)) {
+        }
+
+        constexpr Error &
+        operator=(const Error &other) noexcept {
+            Error copy{other};
+            std::swap(m_data, copy.m_data);
+            return *this;
+        }
+
+        constexpr Error &
+        operator=(Error &&other) noexcept {
+            std::swap(m_data, other.m_data);
+            return *this;
+        }
+
+        constexpr
+        ~Error() noexcept {
+            if (m_data && m_data->referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete m_data;
         }
 
         [[nodiscard]] constexpr std::string_view 
         libraryName() const noexcept {
-            return m_libraryName;
+            return m_data ? m_data->libraryName : std::string_view{};
         }
 
         [[nodiscard]] constexpr std::string_view
         className() const noexcept {
-            return m_className;
+            return m_data ? m_data->className : std::string_view{};
         }
 
         [[nodiscard]] constexpr std::string_view 
         attemptedAction() const noexcept {
-            return m_attemptedAction;
+            return m_data ? m_data->attemptedAction : std::string_view{};
         }
 
         [[nodiscard]] constexpr std::string_view 
         description() const noexcept {
-            return m_description;
+            if (!m_data)
+                return {};
+            if (m_data->ownedDescription.empty())
+                return m_data->staticDescription;
+            return m_data->ownedDescription;
         }
 
         [[nodiscard]] constexpr std::source_location
         sourceLocation() const noexcept {
-            return m_sourceLocation;
+            return m_data ? m_data->sourceLocation : std::source_location{};
         }
 
         [[nodiscard]] constexpr explicit
         operator bool() const noexcept { 
-            return !m_success;
+            return m_data != nullptr;
         }
 
         void
         displayErrorMessageBox() const noexcept;
 
     private:
-        constexpr explicit
-        Error(bool success)
-            : m_success(success) {
-        }
-
-        bool m_success{false};
-        std::string_view m_libraryName{};
-        std::string_view m_className{};
-        std::string_view m_attemptedAction{};
-        std::string m_description{};
-        std::source_location m_sourceLocation{};
+        struct Data {
+            [[nodiscard]]
+            Data(std::string_view inLibraryName, std::string_view inClassName, std::string_view inAttemptedAction,
+                 std::string &&description, std::source_location location) noexcept
+                    : libraryName(inLibraryName)
+                    , className(inClassName)
+                    , attemptedAction(inAttemptedAction)
+                    , ownedDescription(std::move(description))
+                    , sourceLocation(location) {
+            }
+
+            [[nodiscard]]
+            Data(std::string_view inLibraryName, std::string_view inClassName, std::string_view inAttemptedAction,
+                 std::string_view description, std::source_location location) noexcept
+                    : libraryName(inLibraryName)
+                    , className(inClassName)
+                    , attemptedAction(inAttemptedAction)
+                    , staticDescription(description)
+                    , sourceLocation(location) {
+            }
+
+            std::atomic_size_t referenceCount{1};
+            std::string_view libraryName;
+            std::string_view className;
+            std::string_view attemptedAction;
+            std::string_view staticDescription{};
+            std::string ownedDescription{};
+            std::source_location sourceLocation;
+        };
+
+        [[nodiscard]] constexpr
+        Error() noexcept = default;
+
+        Data *m_data{nullptr};
     };
 
     class FunctionErrorGenerator {
@@ -86,8 +168,21 @@ namespace base {
             , m_className(className) {
         }
 
-        [[nodiscard]] inline Error 
-        error(std::string_view attemptedAction, const char *errorDescription,
+        /**
+         * The description must be a string literal, or another array that
+         * outlives the error, since it isn't copied.
+         */
+        template<std::size_t Size>
+        [[nodiscard]] inline Error
+        error(std::string_view attemptedAction, const char (&errorDescription)[Size],
+              std::source_location location = std::source_location::current()) const noexcept {
+            return Error{m_libraryName, m_className, attemptedAction, errorDescription, location};
+        }
+
+        template<typename Pointer>
+            requires std::is_convertible_v<Pointer, const char *>
+        [[nodiscard]] inline Error
+        error(std::string_view attemptedAction, Pointer errorDescription,
               std::source_location location = std::source_location::current()) const noexcept {
             return Error{m_libraryName, m_className, attemptedAction, std::string(errorDescription), location};
         }
@@ -9,7 +9,9 @@
 
 #pragma once
 
-#include <optional>
+#include <memory> // for std::construct_at, std::destroy_at
+#include <type_traits>
+#include <utility> // for std::forward, std::move
 
 #include <cassert>
 
@@ -17,70 +19,144 @@
 
 namespace base {
 
+    /**
+     * Either a value or the error that prevented it. The two share their
+     * storage, so an ErrorOr<T> is hardly larger than a T.
+     */
     template <typename T>
     struct ErrorOr {
         [[nodiscard]] constexpr
         ErrorOr(Error &&error)
                 : m_error(std::move(error))
-                , m_data(std::nullopt) {
-            assert(error);
+                , m_hasValue(false) {
+            assert(m_error);
         }
 
         [[nodiscard]] inline constexpr
         ErrorOr(T &&data)
-                : m_error(base::Error::success())
-                , m_data(std::move(data)) {
+                : m_value(std::move(data))
+                , m_hasValue(true) {
         }
 
         [[nodiscard]] inline constexpr
         ErrorOr(const T &data)
-                : m_error(base::Error::success())
-                , m_data(data) {
+                : m_value(data)
+                , m_hasValue(true) {
+        }
+
+        [[nodiscard]] constexpr
+        ErrorOr(const ErrorOr &other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+                requires std::is_copy_constructible_v<T> {
+            constructFrom(other);
+        }
+
+        // Otherwise the conversion to Error would be used to copy.
+        ErrorOr(const ErrorOr &) requires (!std::is_copy_constructible_v<T>) = delete;
+        ErrorOr &operator=(const ErrorOr &) requires (!std::is_copy_constructible_v<T>) = delete;
+
+        [[nodiscard]] constexpr
+        ErrorOr(ErrorOr &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            constructFrom(std::move(other));
+        }
+
+        constexpr ErrorOr &
+        operator=(const ErrorOr &other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+                requires std::is_copy_constructible_v<T> {
+            if (this != &other) {
+                destroy();
+                constructFrom(other);
+            }
+            return *this;
+        }
+
+        constexpr ErrorOr &
+        operator=(ErrorOr &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (this != &other) {
+                destroy();
+                constructFrom(std::move(other));
+            }
+            return *this;
+        }
+
+        constexpr
+        ~ErrorOr() noexcept {
+            destroy();
         }
 
         [[nodiscard]] inline constexpr
         operator bool() const noexcept {
-            return m_data.has_value();
+            return m_hasValue;
         }
 
         [[nodiscard]] inline constexpr T *
         operator->() noexcept {
-            return m_data.operator->();
+            assert(m_hasValue);
+            return &m_value;
         }
 
         [[nodiscard]] inline constexpr const T *
         operator->() const noexcept {
-            return m_data.operator->();
+            assert(m_hasValue);
+            return &m_value;
         }
 
         [[nodiscard]] inline constexpr
         operator base::Error() const noexcept {
-            return m_error;
+            return error();
         }
 
         [[nodiscard]] inline constexpr Error
         error() const noexcept {
+            if (m_hasValue)
+                return Error::success();
             return m_error;
         }
 
         [[nodiscard]] inline constexpr bool
         failed() const noexcept {
-            return !m_data.has_value();
+            return !m_hasValue;
         }
 
         [[nodiscard]] inline constexpr T &
         get() noexcept {
-            return m_data.value();
+            assert(m_hasValue);
+            return m_value;
         }
 
         [[nodiscard]] inline constexpr const T &
         get() const noexcept {
-            return m_data.value();
+            assert(m_hasValue);
+            return m_value;
         }
 
     private:
-        base::Error m_error;
-        std::optional<T> m_data;
+        /**
+         * Constructs the value or error of other, which is either an
+         * ErrorOr & or an ErrorOr &&. The current one must be destroyed.
+         */
+        template<typename Other>
+        constexpr void
+        constructFrom(Other &&other) {
+            m_hasValue = other.m_hasValue;
+            if (m_hasValue)
+                std::construct_at(&m_value, std::forward<Other>(other).m_value);
+            else
+                std::construct_at(&m_error, std::forward<Other>(other).m_error);
+        }
+
+        constexpr void
+        destroy() noexcept {
+            if (m_hasValue)
+                std::destroy_at(&m_value);
+            else
+                std::destroy_at(&m_error);
+        }
+
+        union {
+            T m_value;
+            Error m_error;
+        };
+        bool m_hasValue;
     };
 
 } // namespace base
@@ -0,0 +1,136 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <new>
+
+#include <cstddef> // for std::size_t
+
+namespace base {
+
+    /**
+     * Recycles fixed-size blocks through a per-thread free list, so objects
+     * that are created and destroyed at a high rate (e.g. the shared state
+     * of a Task) don't hit the global heap in the steady state.
+     *
+     * Blocks are commonly allocated by one thread and deallocated by another,
+     * so a thread that caches too many blocks hands a batch over to a shared
+     * list, from which threads that run out take a batch back. The shared list
+     * never returns blocks to the heap, so it holds on to the peak usage.
+     */
+    template<std::size_t BlockSize, std::size_t MaxCachedBlocks = 256>
+    class FreeListAllocator {
+        struct Node {
+            Node *next;
+        };
+
+        static_assert(BlockSize >= sizeof(Node));
+        static_assert(MaxCachedBlocks >= 2);
+
+        static constexpr std::size_t s_batchSize = MaxCachedBlocks / 2;
+
+        // Trivially destructible, so it stays usable whilst the other
+        // thread_local objects of an exiting thread are destroyed.
+        struct FreeList {
+            Node *head;
+            std::size_t size;
+            bool destroyed;
+        };
+
+        struct Flusher {
+            FreeList *list;
+
+            ~Flusher() noexcept {
+                while (list->head) {
+                    auto *next = list->head->next;
+                    ::operator delete(list->head);
+                    list->head = next;
+                }
+                list->size = 0;
+                list->destroyed = true;
+            }
+        };
+
+        struct SharedList {
+            std::mutex mutex{};
+            FreeList list{};
+        };
+
+        [[nodiscard]] static FreeList &
+        freeList() noexcept {
+            thread_local FreeList list{};
+            thread_local Flusher flusher{&list};
+            static_cast<void>(flusher);
+            return list;
+        }
+
+        // Leaked, since blocks may still be deallocated during static
+        // destruction.
+        [[nodiscard]] static SharedList &
+        sharedList() noexcept {
+            static auto *list = new SharedList();
+            return *list;
+        }
+
+        static void
+        transfer(FreeList &from, FreeList &to, std::size_t count) noexcept {
+            for (; count != 0 && from.head != nullptr; --count) {
+                auto *node = from.head;
+                from.head = node->next;
+                --from.size;
+
+                node->next = to.head;
+                to.head = node;
+                ++to.size;
+            }
+        }
+
+    public:
+        [[nodiscard]] static void *
+        allocate() {
+            auto &list = freeList();
+            if (list.head == nullptr) {
+                auto &shared = sharedList();
+                std::lock_guard guard{shared.mutex};
+                transfer(shared.list, list, s_batchSize);
+            }
+
+            if (list.head == nullptr)
+                return ::operator new(BlockSize);
+
+            auto *node = list.head;
+            list.head = node->next;
+            --list.size;
+            return node;
+        }
+
+        static void
+        deallocate(void *block) noexcept {
+            auto &list = freeList();
+            if (list.destroyed) {
+                ::operator delete(block);
+                return;
+            }
+
+            auto *node = static_cast<Node *>(block);
+            node->next = list.head;
+            list.head = node;
+            ++list.size;
+
+            if (list.size > MaxCachedBlocks) {
+                auto &shared = sharedList();
+                std::lock_guard guard{shared.mutex};
+                transfer(list, shared.list, s_batchSize);
+            }
+        }
+    };
+
+} // namespace base
@@ -0,0 +1,200 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <functional> // for std::invoke
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <cassert>
+#include <cstddef> // for std::byte, std::nullptr_t, std::size_t
+
+namespace base {
+
+    enum class InplaceFunctionStorage {
+        // Callables that don't fit are rejected at compile time.
+        INLINE_ONLY,
+
+        // Callables that don't fit are allocated on the heap.
+        HEAP_FALLBACK,
+    };
+
+    template<typename Signature, std::size_t Capacity = 32,
+             InplaceFunctionStorage Storage = InplaceFunctionStorage::INLINE_ONLY>
+    class InplaceFunction;
+
+    /**
+     * A move-only replacement for std::function that stores the callable in
+     * a buffer of Capacity bytes inside the object itself, so constructing,
+     * moving and invoking it never allocates. Callables that don't fit fail
+     * to compile, unless InplaceFunctionStorage::HEAP_FALLBACK is given.
+     *
+     * Being move-only, it can also hold callables that can't be copied, such
+     * as lambdas capturing a std::unique_ptr.
+     */
+    template<typename Result, typename...Arguments, std::size_t Capacity, InplaceFunctionStorage Storage>
+    class InplaceFunction<Result(Arguments...), Capacity, Storage> {
+        template<typename Function>
+        static constexpr bool s_fitsInline = sizeof(Function) <= Capacity
+                && alignof(Function) <= alignof(void *)
+                && std::is_nothrow_move_constructible_v<Function>;
+
+        template<typename Function>
+        static constexpr bool s_isCallable = !std::is_same_v<std::remove_cvref_t<Function>, InplaceFunction>
+                && std::is_invocable_r_v<Result, std::decay_t<Function> &, Arguments...>;
+
+    public:
+        [[nodiscard]] InplaceFunction() noexcept = default;
+
+        [[nodiscard]]
+        InplaceFunction(std::nullptr_t) noexcept {
+        }
+
+        template<typename Function>
+            requires s_isCallable<Function>
+        [[nodiscard]]
+        InplaceFunction(Function &&function) noexcept {
+            construct(std::forward<Function>(function));
+        }
+
+        [[nodiscard]]
+        InplaceFunction(InplaceFunction &&other) noexcept
+                : m_operations(std::exchange(other.m_operations, nullptr)) {
+            if (m_operations)
+                m_operations->relocate(other.m_storage, m_storage);
+        }
+
+        InplaceFunction(const InplaceFunction &) = delete;
+
+        InplaceFunction &
+        operator=(InplaceFunction &&other) noexcept {
+            if (this != &other) {
+                reset();
+                m_operations = std::exchange(other.m_operations, nullptr);
+                if (m_operations)
+                    m_operations->relocate(other.m_storage, m_storage);
+            }
+            return *this;
+        }
+
+        InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+        /**
+         * Constructs the callable in place, without a temporary
+         * InplaceFunction in between.
+         */
+        template<typename Function>
+            requires s_isCallable<Function>
+        InplaceFunction &
+        operator=(Function &&function) noexcept {
+            reset();
+            construct(std::forward<Function>(function));
+            return *this;
+        }
+
+        InplaceFunction &
+        operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        ~InplaceFunction() noexcept {
+            reset();
+        }
+
+        [[nodiscard]] inline explicit
+        operator bool() const noexcept {
+            return m_operations != nullptr;
+        }
+
+        Result
+        operator()(Arguments...arguments) {
+            assert(m_operations != nullptr);
+            return m_operations->invoke(m_storage, std::forward<Arguments>(arguments)...);
+        }
+
+        void
+        reset() noexcept {
+            if (m_operations)
+                std::exchange(m_operations, nullptr)->destroy(m_storage);
+        }
+
+    private:
+        struct Operations {
+            Result (*invoke)(void *, Arguments &&...);
+            void (*relocate)(void *from, void *to) noexcept;
+            void (*destroy)(void *) noexcept;
+        };
+
+        template<typename Function>
+        struct InlineOperations {
+            [[nodiscard]] static Function &
+            get(void *storage) noexcept {
+                return *std::launder(static_cast<Function *>(storage));
+            }
+
+            static constexpr Operations s_operations{
+                [](void *storage, Arguments &&...arguments) -> Result {
+                    return std::invoke(get(storage), std::forward<Arguments>(arguments)...);
+                },
+                [](void *from, void *to) noexcept {
+                    ::new (to) Function(std::move(get(from)));
+                    get(from).~Function();
+                },
+                [](void *storage) noexcept {
+                    get(storage).~Function();
+                }
+            };
+        };
+
+        template<typename Function>
+        struct HeapOperations {
+            [[nodiscard]] static Function *&
+            get(void *storage) noexcept {
+                return *std::launder(static_cast<Function **>(storage));
+            }
+
+            static constexpr Operations s_operations{
+                [](void *storage, Arguments &&...arguments) -> Result {
+                    return std::invoke(*get(storage), std::forward<Arguments>(arguments)...);
+                },
+                [](void *from, void *to) noexcept {
+                    ::new (to) Function *(get(from));
+                },
+                [](void *storage) noexcept {
+                    delete get(storage);
+                }
+            };
+        };
+
+        template<typename Function>
+        void
+        construct(Function &&function) noexcept {
+            using Stored = std::decay_t<Function>;
+
+            if constexpr (s_fitsInline<Stored>) {
+                ::new (static_cast<void *>(m_storage)) Stored(std::forward<Function>(function));
+                m_operations = &InlineOperations<Stored>::s_operations;
+            } else {
+                static_assert(Storage == InplaceFunctionStorage::HEAP_FALLBACK,
+                              "The callable doesn't fit in the InplaceFunction; increase its capacity");
+                static_assert(Capacity >= sizeof(Stored *));
+
+                ::new (static_cast<void *>(m_storage)) Stored *(new Stored(std::forward<Function>(function)));
+                m_operations = &HeapOperations<Stored>::s_operations;
+            }
+        }
+
+        const Operations *m_operations{nullptr};
+        alignas(void *) std::byte m_storage[Capacity];
+    };
+
+} // namespace base
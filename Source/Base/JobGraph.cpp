@@ -0,0 +1,212 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "JobGraph.hpp"
+
+#include <algorithm>
+#include <utility> // for std::exchange
+
+#include <cassert>
+#include <cstdio>
+
+namespace base {
+
+    JobGraph::JobId
+    JobGraph::addJob(std::string name, JobFunction &&function, std::vector<JobId> dependencies,
+                     Affinity affinity) noexcept {
+        const JobId id = m_jobs.size();
+
+        for (const auto dependency : dependencies) {
+            assert(dependency < id);
+            m_jobs[dependency].dependents.push_back(id);
+        }
+
+        m_jobs.push_back(Job{std::move(name), std::move(function), affinity, std::move(dependencies)});
+        return id;
+    }
+
+    void
+    JobGraph::clear() noexcept {
+        m_jobs.clear();
+    }
+
+    std::vector<JobGraph::JobId>
+    JobGraph::criticalPath() const noexcept {
+        if (m_jobs.empty())
+            return {};
+
+        // Dependencies always precede their dependents, so the jobs are
+        // already in topological order.
+        std::vector<std::chrono::nanoseconds> pathDuration(m_jobs.size());
+        std::vector<JobId> predecessor(m_jobs.size());
+
+        for (JobId id = 0; id < m_jobs.size(); ++id) {
+            predecessor[id] = id;
+            std::chrono::nanoseconds longestDependency{};
+
+            for (const auto dependency : m_jobs[id].dependencies) {
+                if (pathDuration[dependency] >= longestDependency) {
+                    longestDependency = pathDuration[dependency];
+                    predecessor[id] = dependency;
+                }
+            }
+
+            pathDuration[id] = longestDependency + m_jobs[id].timing.duration;
+        }
+
+        auto id = static_cast<JobId>(std::distance(std::begin(pathDuration),
+                std::max_element(std::begin(pathDuration), std::end(pathDuration))));
+
+        std::vector<JobId> path{id};
+        while (predecessor[id] != id) {
+            id = predecessor[id];
+            path.push_back(id);
+        }
+
+        std::reverse(std::begin(path), std::end(path));
+        return path;
+    }
+
+    void
+    JobGraph::dispatch(JobId id) noexcept {
+        if (m_jobs[id].affinity == Affinity::ANY_THREAD) {
+            m_pool->post([this, id] {
+                execute(id);
+            });
+            return;
+        }
+
+        // runAsync() has no calling thread to run it on.
+        assert(!m_continuation);
+
+        {
+            std::lock_guard guard{m_callingThreadMutex};
+            m_callingThreadJobs.push_back(id);
+        }
+        m_callingThreadWakeUp.notify_one();
+    }
+
+    void
+    JobGraph::execute(JobId id) noexcept {
+        auto &job = m_jobs[id];
+
+        const auto start = std::chrono::steady_clock::now();
+        job.function();
+        const auto end = std::chrono::steady_clock::now();
+
+        job.timing.start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_runStart);
+        job.timing.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+        for (const auto dependent : job.dependents) {
+            if (m_remainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                dispatch(dependent);
+        }
+
+        finishOne();
+    }
+
+    void
+    JobGraph::finishOne() noexcept {
+        std::coroutine_handle<> continuation{};
+        {
+            // Notified whilst holding the lock, since run() may return and
+            // the graph may be destroyed as soon as the lock is released.
+            std::lock_guard guard{m_callingThreadMutex};
+            if (--m_unfinishedJobs != 0)
+                return;
+
+            m_totalDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - m_runStart);
+            if (!m_continuation) {
+                m_callingThreadWakeUp.notify_one();
+                return;
+            }
+            continuation = std::exchange(m_continuation, {});
+        }
+
+        // The graph may be destroyed by the continuation.
+        continuation.resume();
+    }
+
+    void
+    JobGraph::printCriticalPath(std::string_view prefix) const noexcept {
+        const auto toMilliseconds = [](std::chrono::nanoseconds duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+
+        const auto path = criticalPath();
+
+        std::chrono::nanoseconds pathDuration{};
+        for (const auto id : path)
+            pathDuration += m_jobs[id].timing.duration;
+
+        std::printf("%.*s critical path %.3f ms of %.3f ms:", static_cast<int>(prefix.length()), prefix.data(),
+                    toMilliseconds(pathDuration), toMilliseconds(m_totalDuration));
+
+        for (const auto id : path)
+            std::printf(" %s (%.3f ms)", m_jobs[id].name.c_str(), toMilliseconds(m_jobs[id].timing.duration));
+        std::putchar('\n');
+    }
+
+    void
+    JobGraph::run(ThreadPool &pool) noexcept {
+        if (m_jobs.empty())
+            return;
+
+        start(pool, {});
+
+        std::unique_lock lock{m_callingThreadMutex};
+        while (true) {
+            m_callingThreadWakeUp.wait(lock, [this] {
+                return m_unfinishedJobs == 0 || m_nextCallingThreadJob != m_callingThreadJobs.size();
+            });
+
+            if (m_nextCallingThreadJob == m_callingThreadJobs.size())
+                break;
+
+            const auto id = m_callingThreadJobs[m_nextCallingThreadJob++];
+            lock.unlock();
+            execute(id);
+            lock.lock();
+        }
+    }
+
+    void
+    JobGraph::start(ThreadPool &pool, std::coroutine_handle<> continuation) noexcept {
+        assert(!m_jobs.empty());
+
+        if (m_remainingDependenciesCapacity < m_jobs.size()) {
+            m_remainingDependencies = std::make_unique<std::atomic_size_t[]>(m_jobs.size());
+            m_remainingDependenciesCapacity = m_jobs.size();
+            m_callingThreadJobs.reserve(m_jobs.size());
+        }
+
+        for (JobId id = 0; id < m_jobs.size(); ++id)
+            m_remainingDependencies[id].store(m_jobs[id].dependencies.size(), std::memory_order_relaxed);
+
+        m_pool = &pool;
+        m_continuation = continuation;
+        m_callingThreadJobs.clear();
+        m_nextCallingThreadJob = 0;
+        m_runStart = std::chrono::steady_clock::now();
+
+        // One more than the jobs, so that the run can't finish, and the
+        // continuation can't destroy the graph, whilst this is still
+        // dispatching.
+        m_unfinishedJobs = m_jobs.size() + 1;
+
+        for (JobId id = 0; id < m_jobs.size(); ++id) {
+            if (m_jobs[id].dependencies.empty())
+                dispatch(id);
+        }
+
+        finishOne();
+    }
+
+} // namespace base
@@ -0,0 +1,204 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+
+#include "Source/Base/InplaceFunction.hpp"
+#include "Source/Base/ThreadPool.hpp"
+
+namespace base {
+
+    /**
+     * A set of jobs with dependencies between them, that is declared once and
+     * then run as often as needed, e.g. once per frame. A job starts as soon
+     * as all of its dependencies have finished, so a job that a lot of others
+     * depend on acts as a barrier.
+     *
+     * Jobs that must run on the thread that calls run() (e.g. because they
+     * need the graphics context) are marked with Affinity::CALLING_THREAD,
+     * the other jobs are posted to the thread pool.
+     *
+     * Dependencies have to be added before their dependents, which keeps the
+     * graph acyclic by construction.
+     */
+    class JobGraph {
+    public:
+        using JobId = std::size_t;
+        using JobFunction = InplaceFunction<void(), 32>;
+
+        enum class Affinity {
+            ANY_THREAD,
+            CALLING_THREAD,
+        };
+
+        struct JobTiming {
+            // Relative to the start of the run.
+            std::chrono::nanoseconds start{};
+            std::chrono::nanoseconds duration{};
+        };
+
+        [[nodiscard]] JobGraph() noexcept = default;
+
+        JobGraph(JobGraph &&) = delete;
+        JobGraph(const JobGraph &) = delete;
+
+        JobId
+        addJob(std::string name, JobFunction &&function, std::vector<JobId> dependencies = {},
+               Affinity affinity = Affinity::ANY_THREAD) noexcept;
+
+        /**
+         * Removes all jobs, so that the graph can be declared again.
+         */
+        void
+        clear() noexcept;
+
+        /**
+         * The longest chain of dependent jobs in the last run, measured by
+         * their durations. This is what bounds the duration of the run,
+         * regardless of the amount of threads.
+         */
+        [[nodiscard]] std::vector<JobId>
+        criticalPath() const noexcept;
+
+        [[nodiscard]] inline bool
+        empty() const noexcept {
+            return m_jobs.empty();
+        }
+
+        [[nodiscard]] inline const std::string &
+        name(JobId id) const noexcept {
+            return m_jobs[id].name;
+        }
+
+        /**
+         * Prints the critical path of the last run on a single line.
+         */
+        void
+        printCriticalPath(std::string_view prefix) const noexcept;
+
+        /**
+         * Runs all jobs and returns when they're finished. The calling
+         * thread runs the jobs with Affinity::CALLING_THREAD in the meantime.
+         */
+        void
+        run(ThreadPool &pool = ThreadPool::global()) noexcept;
+
+        struct RunAwaiter {
+            JobGraph &graph;
+            ThreadPool &pool;
+
+            [[nodiscard]] inline bool
+            await_ready() const noexcept {
+                return graph.empty();
+            }
+
+            inline void
+            await_suspend(std::coroutine_handle<> handle) noexcept {
+                graph.start(pool, handle);
+            }
+
+            constexpr void
+            await_resume() const noexcept {
+            }
+        };
+
+        /**
+         * Like run(), but instead of blocking the calling thread, the
+         * awaiting coroutine is resumed on the worker that finishes the last
+         * job. It can therefore be awaited from a worker of the pool itself.
+         * There is no calling thread, so every job must have
+         * Affinity::ANY_THREAD.
+         */
+        [[nodiscard]] inline RunAwaiter
+        runAsync(ThreadPool &pool = ThreadPool::global()) noexcept {
+            return RunAwaiter{*this, pool};
+        }
+
+        [[nodiscard]] inline std::size_t
+        size() const noexcept {
+            return m_jobs.size();
+        }
+
+        [[nodiscard]] inline const JobTiming &
+        timing(JobId id) const noexcept {
+            return m_jobs[id].timing;
+        }
+
+        [[nodiscard]] inline std::chrono::nanoseconds
+        totalDuration() const noexcept {
+            return m_totalDuration;
+        }
+
+    private:
+        struct Job {
+            std::string name;
+            JobFunction function;
+            Affinity affinity;
+
+            std::vector<JobId> dependencies{};
+            std::vector<JobId> dependents{};
+
+            JobTiming timing{};
+        };
+
+        void
+        dispatch(JobId id) noexcept;
+
+        void
+        execute(JobId id) noexcept;
+
+        /**
+         * Counts a job, or the dispatching of the first jobs, as finished,
+         * and finishes the run when it was the last one.
+         */
+        void
+        finishOne() noexcept;
+
+        /**
+         * Dispatches the jobs without dependencies. The continuation, when
+         * given, is resumed when the run is finished.
+         */
+        void
+        start(ThreadPool &pool, std::coroutine_handle<> continuation) noexcept;
+
+        std::vector<Job> m_jobs{};
+
+        // Not part of Job, since atomics can't be moved when m_jobs grows.
+        std::unique_ptr<std::atomic_size_t[]> m_remainingDependencies{};
+        std::size_t m_remainingDependenciesCapacity{0};
+
+        ThreadPool *m_pool{nullptr};
+        std::chrono::steady_clock::time_point m_runStart{};
+        std::chrono::nanoseconds m_totalDuration{};
+
+        std::mutex m_callingThreadMutex{};
+        std::condition_variable m_callingThreadWakeUp{};
+        // Every job is queued at most once per run, so this never grows
+        // beyond the size of the graph.
+        std::vector<JobId> m_callingThreadJobs{};
+        std::size_t m_nextCallingThreadJob{0};
+        std::size_t m_unfinishedJobs{0};
+
+        // Of runAsync(), or null during run().
+        std::coroutine_handle<> m_continuation{};
+    };
+
+} // namespace base
@@ -0,0 +1,100 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "RangeAllocator.hpp"
+
+#include <algorithm> // for std::lower_bound
+
+#include <cassert>
+
+namespace base {
+
+    std::optional<std::size_t>
+    RangeAllocator::allocate(std::size_t size, std::size_t alignment) noexcept {
+        assert(size != 0);
+        assert(alignment != 0);
+
+        for (auto it = std::begin(m_freeRanges); it != std::end(m_freeRanges); ++it) {
+            const auto offset = (it->offset + alignment - 1) / alignment * alignment;
+            const auto padding = offset - it->offset;
+            if (padding > it->size || it->size - padding < size)
+                continue;
+
+            const Range rest{offset + size, it->size - padding - size};
+            if (padding != 0) {
+                // The padding stays free in front of the range.
+                it->size = padding;
+                if (rest.size != 0)
+                    m_freeRanges.insert(std::next(it), rest);
+            } else if (rest.size != 0) {
+                *it = rest;
+            } else {
+                m_freeRanges.erase(it);
+            }
+
+            return offset;
+        }
+
+        return std::nullopt;
+    }
+
+    void
+    RangeAllocator::free(std::size_t offset, std::size_t size) noexcept {
+        assert(size != 0);
+        assert(offset + size <= m_capacity);
+
+        auto next = std::lower_bound(std::begin(m_freeRanges), std::end(m_freeRanges), offset,
+                                     [] (const Range &range, std::size_t value) { return range.offset < value; });
+        assert(next == std::end(m_freeRanges) || offset + size <= next->offset);
+
+        const bool mergesWithPrevious = next != std::begin(m_freeRanges) && std::prev(next)->offset + std::prev(next)->size == offset;
+        const bool mergesWithNext = next != std::end(m_freeRanges) && offset + size == next->offset;
+
+        if (mergesWithPrevious && mergesWithNext) {
+            std::prev(next)->size += size + next->size;
+            m_freeRanges.erase(next);
+        } else if (mergesWithPrevious) {
+            std::prev(next)->size += size;
+        } else if (mergesWithNext) {
+            next->offset = offset;
+            next->size += size;
+        } else {
+            m_freeRanges.insert(next, {offset, size});
+        }
+    }
+
+    std::size_t
+    RangeAllocator::freeSize() const noexcept {
+        std::size_t size{0};
+        for (const auto &range : m_freeRanges)
+            size += range.size;
+        return size;
+    }
+
+    void
+    RangeAllocator::grow(std::size_t capacity) noexcept {
+        assert(capacity >= m_capacity);
+        if (capacity == m_capacity)
+            return;
+
+        const auto oldCapacity = m_capacity;
+        m_capacity = capacity;
+        free(oldCapacity, capacity - oldCapacity);
+    }
+
+    void
+    RangeAllocator::reset(std::size_t size) noexcept {
+        assert(size <= m_capacity);
+
+        m_freeRanges.clear();
+        if (size != m_capacity)
+            m_freeRanges.push_back({size, m_capacity - size});
+    }
+
+} // namespace base
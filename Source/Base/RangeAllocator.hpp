@@ -0,0 +1,89 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+
+namespace base {
+
+    /**
+     * Hands out ranges of a linear resource that it doesn't touch itself,
+     * e.g. of a buffer on the GPU, with a first-fit free list. The free
+     * ranges are sorted by offset, and neighbouring ones are merged when a
+     * range is freed, so the list stays as short as the fragmentation.
+     */
+    class RangeAllocator {
+    public:
+        struct Range {
+            std::size_t offset;
+            std::size_t size;
+        };
+
+        [[nodiscard]] inline explicit
+        RangeAllocator(std::size_t capacity = 0) noexcept {
+            if (capacity != 0)
+                m_freeRanges.push_back({0, capacity});
+            m_capacity = capacity;
+        }
+
+        /**
+         * Returns the offset of a range of the size, aligned to the
+         * alignment, or nothing when no free range is large enough.
+         */
+        [[nodiscard]] std::optional<std::size_t>
+        allocate(std::size_t size, std::size_t alignment = 1) noexcept;
+
+        /**
+         * Returns a range that was allocated before.
+         */
+        void
+        free(std::size_t offset, std::size_t size) noexcept;
+
+        /**
+         * Adds space to the end, e.g. after the resource was reallocated.
+         */
+        void
+        grow(std::size_t capacity) noexcept;
+
+        /**
+         * Marks [0, size) as allocated and the rest as free, e.g. after the
+         * allocations were compacted to the front.
+         */
+        void
+        reset(std::size_t size) noexcept;
+
+        [[nodiscard]] inline std::size_t
+        capacity() const noexcept {
+            return m_capacity;
+        }
+
+        [[nodiscard]] inline std::span<const Range>
+        freeRanges() const noexcept {
+            return m_freeRanges;
+        }
+
+        [[nodiscard]] std::size_t
+        freeSize() const noexcept;
+
+        [[nodiscard]] inline std::size_t
+        usedSize() const noexcept {
+            return m_capacity - freeSize();
+        }
+
+    private:
+        std::vector<Range> m_freeRanges{};
+        std::size_t m_capacity{0};
+    };
+
+} // namespace base
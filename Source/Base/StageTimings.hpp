@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <utility> // for std::move
+#include <vector>
+
+#include <cstdio> // for std::printf
+
+namespace base {
+
+    /**
+     * The durations of the consecutive stages of a longer operation, e.g.
+     * loading a scene, which are printed as one breakdown when it is done.
+     * The stages may run on different threads, but not at the same time.
+     *
+     * Details, like the summed durations of the jobs within a stage, are
+     * printed under the stage they're added to, and don't count towards the
+     * total.
+     */
+    class StageTimings {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Ends the current stage, if any, and starts the next one.
+         */
+        void
+        start(std::string name) noexcept {
+            stop();
+            m_entries.push_back({std::move(name), {}, false});
+            m_current = m_entries.size() - 1;
+            m_stageStart = Clock::now();
+        }
+
+        /**
+         * Ends the current stage, e.g. before waiting for something that
+         * shouldn't be accounted to any stage.
+         */
+        void
+        stop() noexcept {
+            if (m_current == NoStage)
+                return;
+            m_entries[m_current].duration = Clock::now() - m_stageStart;
+            m_current = NoStage;
+        }
+
+        void
+        addDetail(std::string name, std::chrono::nanoseconds duration) noexcept {
+            m_entries.push_back({std::move(name), duration, true});
+        }
+
+        [[nodiscard]] std::chrono::nanoseconds
+        total() const noexcept {
+            std::chrono::nanoseconds total{};
+            for (const auto &entry : m_entries) {
+                if (!entry.isDetail)
+                    total += entry.duration;
+            }
+            return total;
+        }
+
+        void
+        print(std::string_view prefix) const noexcept {
+            const auto toMilliseconds = [](std::chrono::nanoseconds duration) {
+                return std::chrono::duration<double, std::milli>(duration).count();
+            };
+
+            for (const auto &entry : m_entries) {
+                std::printf("%.*s %s%-*s %10.3f ms\n", static_cast<int>(prefix.length()), prefix.data(),
+                            entry.isDetail ? "  " : "", entry.isDetail ? 38 : 40, entry.name.c_str(),
+                            toMilliseconds(entry.duration));
+            }
+            std::printf("%.*s %-40s %10.3f ms\n", static_cast<int>(prefix.length()), prefix.data(),
+                        "Total", toMilliseconds(total()));
+        }
+
+    private:
+        static constexpr std::size_t NoStage = static_cast<std::size_t>(-1);
+
+        struct Entry {
+            std::string name;
+            std::chrono::nanoseconds duration;
+            bool isDetail;
+        };
+
+        std::vector<Entry> m_entries{};
+        std::size_t m_current{NoStage};
+        Clock::time_point m_stageStart{};
+    };
+
+} // namespace base
@@ -6,81 +6,295 @@
  * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
  * All Rights Reserved.
  *
- * This mechanism was made because there is no std::future::then or
- * something alike, which is a shame. Hopefully P2300R5 will make
- * this obsolete in the future :)
+ * The statically typed sibling of base::AnyTask. The types flowing through
+ * the chain are known at compile time, so a hop doesn't need std::any or
+ * std::function: every task is a single pooled block holding the function
+ * inline next to its result.
  */
 
 #pragma once
 
-#include <any>
-#include <functional>
+#include <atomic>
+#include <functional> // for std::invoke
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant> // for std::monostate
+
+#include <cassert>
+#include <cstddef> // for std::size_t
+
+#include "Source/Base/FreeListAllocator.hpp"
+#include "Source/Base/InplaceFunction.hpp"
+#include "Source/Base/ThreadPool.hpp"
 
 namespace base {
-    
-    struct Task {
-        using FunctionType = std::function<std::any (std::any&&)>;
-        
-        [[nodiscard]] explicit
-        Task(FunctionType &&function)
-                : m_function(std::move(function)) {
+
+    template<typename T>
+    class Task;
+
+    namespace detail {
+
+        // Tasks of void are stored as std::monostate, so that the state
+        // doesn't need a specialization.
+        template<typename T>
+        using TaskValue = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        template<typename T, typename Function>
+        struct ContinuationResult {
+            using type = std::invoke_result_t<Function &, T &&>;
+        };
+
+        template<typename Function>
+        struct ContinuationResult<void, Function> {
+            using type = std::invoke_result_t<Function &>;
+        };
+
+        template<typename Function, typename...Arguments>
+        [[nodiscard]] inline TaskValue<std::invoke_result_t<Function &, Arguments...>>
+        invokeTaskFunction(Function &function, Arguments &&...arguments) {
+            if constexpr (std::is_void_v<std::invoke_result_t<Function &, Arguments...>>) {
+                std::invoke(function, std::forward<Arguments>(arguments)...);
+                return {};
+            } else {
+                return std::invoke(function, std::forward<Arguments>(arguments)...);
+            }
         }
 
-        template<typename Result>
-        [[nodiscard]] static Task
-        create(auto function) {
-            return Task([func = std::function<Result ()>(function)](std::any) -> std::any {
-                return func();
+        /**
+         * The reference-counted state shared by a Task handle, the job that
+         * runs it and the task that continues it.
+         */
+        class TaskStateBase {
+        public:
+            [[nodiscard]] explicit
+            TaskStateBase(ThreadPool &pool) noexcept
+                    : m_pool(&pool) {
+            }
+
+            TaskStateBase(TaskStateBase &&) = delete;
+            TaskStateBase(const TaskStateBase &) = delete;
+
+            virtual
+            ~TaskStateBase() noexcept {
+                if (m_next)
+                    m_next->release();
+            }
+
+            void
+            addReference() noexcept {
+                m_referenceCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void
+            release() noexcept {
+                if (m_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    delete this;
+            }
+
+            /**
+             * Attaches the task that consumes the result of this one, taking
+             * over the reference of the caller. The continuation is scheduled
+             * immediately if the result is already available.
+             */
+            void
+            attachNext(TaskStateBase *next) noexcept {
+                assert(m_next == nullptr);
+                m_next = next;
+
+                if (m_flags.fetch_or(s_hasNext, std::memory_order_acq_rel) & s_hasResult)
+                    next->schedule();
+            }
+
+            [[nodiscard]] inline ThreadPool &
+            pool() noexcept {
+                return *m_pool;
+            }
+
+            void
+            schedule() noexcept {
+                addReference();
+
+                // Capturing only the pointer keeps the job within the small
+                // buffer of ThreadPool::JobType.
+                m_pool->post([this] {
+                    execute();
+                    release();
+                });
+            }
+
+        protected:
+            virtual void
+            execute() noexcept = 0;
+
+            /**
+             * Called by execute() after the result has been stored. Either
+             * this call or attachNext() schedules the continuation, whichever
+             * comes last.
+             */
+            void
+            publishResult() noexcept {
+                if (m_flags.fetch_or(s_hasResult, std::memory_order_acq_rel) & s_hasNext)
+                    m_next->schedule();
+            }
+
+        private:
+            static constexpr unsigned s_hasResult = 1;
+            static constexpr unsigned s_hasNext = 2;
+
+            ThreadPool *m_pool;
+            std::atomic_size_t m_referenceCount{1};
+            std::atomic_uint m_flags{0};
+            TaskStateBase *m_next{nullptr};
+        };
+
+        template<typename T>
+        class TaskState final : public TaskStateBase {
+        public:
+            using ValueType = TaskValue<T>;
+
+            // Fits a continuation capturing the previous task and a few
+            // references, which is what nearly every continuation looks like.
+            static constexpr std::size_t s_inlineCapacity = 64;
+
+            using TaskStateBase::TaskStateBase;
+
+            [[nodiscard]] static void *
+            operator new(std::size_t size) {
+                assert(size == sizeof(TaskState));
+                static_cast<void>(size);
+                return FreeListAllocator<sizeof(TaskState)>::allocate();
+            }
+
+            static void
+            operator delete(void *block) noexcept {
+                FreeListAllocator<sizeof(TaskState)>::deallocate(block);
+            }
+
+            template<typename Function>
+            void
+            setProducer(Function &&function) {
+                m_producer = std::forward<Function>(function);
+            }
+
+            /**
+             * Moves the result out. Only the continuation may call this, and
+             * only after it has been scheduled.
+             */
+            [[nodiscard]] ValueType
+            takeResult() noexcept {
+                assert(m_result.has_value());
+                return std::move(*m_result);
+            }
+
+        private:
+            void
+            execute() noexcept override {
+                m_result.emplace(m_producer());
+
+                // This releases the previous task, which isn't needed anymore.
+                m_producer.reset();
+
+                publishResult();
+            }
+
+            InplaceFunction<ValueType(), s_inlineCapacity, InplaceFunctionStorage::HEAP_FALLBACK> m_producer{};
+            std::optional<ValueType> m_result{};
+        };
+
+    } // namespace detail
+
+    /**
+     * A handle to a function that runs on a ThreadPool, producing a T. Call
+     * then() to continue with a function receiving that T on the same pool;
+     * its return type determines the type of the next task.
+     *
+     *     socket.bind(address)
+     *         .then([](base::Error error) { return error ? 0 : 1; })
+     *         .then([](int status) { ... });
+     *
+     * When a task finishes before its continuation is attached, the result is
+     * parked inside the task, and the continuation is posted as soon as it is
+     * attached. Dropping a handle doesn't cancel or wait for the task.
+     */
+    template<typename T>
+    class Task {
+    public:
+        using ValueType = T;
+
+        template<typename Function>
+        static Task
+        run(Function &&function, ThreadPool &pool = ThreadPool::global()) {
+            auto *state = new detail::TaskState<T>(pool);
+            state->setProducer([function = std::forward<Function>(function)]() mutable -> detail::TaskValue<T> {
+                return detail::invokeTaskFunction(function);
             });
+            state->schedule();
+            return Task{state};
         }
 
         [[nodiscard]]
-        Task(Task &&) noexcept = default;
+        Task(Task &&other) noexcept
+                : m_state(std::exchange(other.m_state, nullptr)) {
+        }
 
-        Task &operator=(const Task &) noexcept = delete;
-        Task &operator=(Task &&) noexcept = default;
+        Task(const Task &) = delete;
 
-        static std::shared_ptr<Task>
-        run(Task &&, std::any) noexcept;
+        Task &
+        operator=(Task &&other) noexcept {
+            if (this != &other) {
+                if (m_state)
+                    m_state->release();
+                m_state = std::exchange(other.m_state, nullptr);
+            }
+            return *this;
+        }
 
-        /* discardable */ std::shared_ptr<Task>
-        then(std::shared_ptr<Task> &&) noexcept;
+        Task &operator=(const Task &) = delete;
 
-        /* discardable */ std::shared_ptr<Task>
-        then(Task &&task) noexcept {
-            return then(std::make_shared<Task>(std::move(task)));
+        ~Task() noexcept {
+            if (m_state)
+                m_state->release();
         }
 
-        /* discardable */ std::shared_ptr<Task>
-        then(FunctionType &&function) noexcept {
-            return then(std::make_shared<Task>( std::move(function)));
-        }
+        /**
+         * Continues this task with the given function, which receives the
+         * result of this task (or nothing, when T is void). A task can only
+         * be continued once, hence this consumes the handle.
+         */
+        template<typename Function>
+        /* discardable */ Task<typename detail::ContinuationResult<T, Function>::type>
+        then(Function &&function) && {
+            using NextType = typename detail::ContinuationResult<T, Function>::type;
+            assert(m_state != nullptr);
 
-        template<typename Result>
-        static Task
-        then(auto function) {
-            return Task([func = std::function<Result()>(function)](std::any) -> std::any {
-                return func();
-            });
-        }
+            auto *previous = m_state;
+            auto *next = new detail::TaskState<NextType>(previous->pool());
 
-        template<typename Result, typename Parameter>
-        static Task
-        then(auto function) {
-            return Task([func = std::function<Result(Parameter)>(function)](std::any &&parameter) -> std::any {
-                if constexpr (std::is_same_v<Result, void>) {
-                    func(std::any_cast<Parameter&&>(std::move(parameter)));
-                    return {};
+            next->setProducer([previousTask = std::move(*this), function = std::forward<Function>(function)]() mutable
+                                      -> detail::TaskValue<NextType> {
+                if constexpr (std::is_void_v<T>) {
+                    return detail::invokeTaskFunction(function);
                 } else {
-                    return func(std::any_cast<Parameter&&>(std::move(parameter)));
+                    return detail::invokeTaskFunction(function, previousTask.m_state->takeResult());
                 }
             });
+
+            next->addReference();
+            previous->attachNext(next);
+            return Task<NextType>{next};
         }
 
     private:
-        FunctionType m_function;
-        std::shared_ptr<Task> m_next{};
+        template<typename>
+        friend class Task;
+
+        [[nodiscard]] explicit
+        Task(detail::TaskState<T> *state) noexcept
+                : m_state(state) {
+        }
+
+        detail::TaskState<T> *m_state;
     };
-    
-} // namespace base
 
+} // namespace base
@@ -0,0 +1,182 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <Windows.h>
+    #include <processthreadsapi.h>
+#endif // _WIN32
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+#include <cassert>
+
+namespace base {
+
+    thread_local const ThreadPool *t_currentPool{nullptr};
+    thread_local std::size_t t_currentWorkerIndex{0};
+
+    ThreadPool::ThreadPool(std::size_t workerCount) noexcept {
+        assert(workerCount != 0);
+
+        m_workers.reserve(workerCount);
+        for (std::size_t i = 0; i < workerCount; ++i)
+            m_workers.push_back(std::make_unique<Worker>());
+
+        // The workers are only started when all deques exist, since they
+        // immediately start looking into each other's queues.
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            m_workers[i]->thread = std::thread([this, i] {
+#ifdef _WIN32
+                SetThreadDescription(GetCurrentThread(), L"base::ThreadPool worker");
+#endif // _WIN32
+                workerLoop(i);
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool() noexcept {
+        {
+            std::lock_guard guard{m_sleepMutex};
+            m_stopping = true;
+        }
+        m_wakeUp.notify_all();
+
+        for (auto &worker : m_workers) {
+            if (worker->thread.joinable())
+                worker->thread.join();
+        }
+    }
+
+    std::size_t
+    ThreadPool::defaultWorkerCount() noexcept {
+        // Leave one core for the main thread, which does the rendering.
+        const auto hardwareThreads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+        return std::max<std::size_t>(hardwareThreads, 2) - 1;
+    }
+
+    ThreadPool &
+    ThreadPool::global() noexcept {
+        static auto *pool = new ThreadPool();
+        return *pool;
+    }
+
+    bool
+    ThreadPool::isWorkerThread() const noexcept {
+        return t_currentPool == this;
+    }
+
+    void
+    ThreadPool::post(JobType &&job) noexcept {
+        const auto workerIndex = isWorkerThread()
+                ? t_currentWorkerIndex
+                : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+        {
+            auto &worker = *m_workers[workerIndex];
+            std::lock_guard guard{worker.mutex};
+            worker.jobs.push_back(std::move(job));
+        }
+
+        m_pendingJobs.fetch_add(1, std::memory_order_release);
+
+        // Acquiring the sleep mutex orders this notification after a worker
+        // that just found nothing has started waiting, so no wakeup is lost.
+        { std::lock_guard guard{m_sleepMutex}; }
+        m_wakeUp.notify_one();
+    }
+
+    std::size_t
+    ThreadPool::queueDepth() const noexcept {
+        return m_pendingJobs.load(std::memory_order_relaxed);
+    }
+
+    ThreadPoolStatistics
+    ThreadPool::statistics() const noexcept {
+        ThreadPoolStatistics statistics{};
+        statistics.workers.reserve(m_workers.size());
+
+        for (const auto &worker : m_workers) {
+            ThreadPoolStatistics::Worker entry{};
+            {
+                std::lock_guard guard{worker->mutex};
+                entry.queueDepth = worker->jobs.size();
+            }
+            entry.executedJobs = worker->executedJobs.load(std::memory_order_relaxed);
+            entry.stolenJobs = worker->stolenJobs.load(std::memory_order_relaxed);
+
+            statistics.totalQueueDepth += entry.queueDepth;
+            statistics.totalExecutedJobs += entry.executedJobs;
+            statistics.totalStolenJobs += entry.stolenJobs;
+            statistics.workers.push_back(entry);
+        }
+
+        return statistics;
+    }
+
+    bool
+    ThreadPool::tryPop(std::size_t workerIndex, JobType &job) noexcept {
+        auto &worker = *m_workers[workerIndex];
+        std::lock_guard guard{worker.mutex};
+        if (worker.jobs.empty())
+            return false;
+
+        job = std::move(worker.jobs.back());
+        worker.jobs.pop_back();
+        return true;
+    }
+
+    bool
+    ThreadPool::trySteal(std::size_t thiefIndex, JobType &job) noexcept {
+        for (std::size_t offset = 1; offset < m_workers.size(); ++offset) {
+            auto &victim = *m_workers[(thiefIndex + offset) % m_workers.size()];
+
+            std::unique_lock lock{victim.mutex, std::try_to_lock};
+            if (!lock.owns_lock() || victim.jobs.empty())
+                continue;
+
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            m_workers[thiefIndex]->stolenJobs.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    void
+    ThreadPool::workerLoop(std::size_t workerIndex) noexcept {
+        t_currentPool = this;
+        t_currentWorkerIndex = workerIndex;
+
+        auto &self = *m_workers[workerIndex];
+        JobType job{};
+
+        while (true) {
+            if (tryPop(workerIndex, job) || trySteal(workerIndex, job)) {
+                m_pendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+                job();
+                job = nullptr;
+                self.executedJobs.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock lock{m_sleepMutex};
+            if (m_stopping && m_pendingJobs.load(std::memory_order_acquire) == 0)
+                return;
+
+            m_wakeUp.wait(lock, [this] {
+                return m_stopping || m_pendingJobs.load(std::memory_order_acquire) != 0;
+            });
+        }
+    }
+
+} // namespace base
@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+
+#include "Source/Base/InplaceFunction.hpp"
+
+namespace base {
+
+    struct ThreadPoolStatistics {
+        struct Worker {
+            std::size_t queueDepth{};
+            std::size_t executedJobs{};
+            std::size_t stolenJobs{};
+        };
+
+        std::vector<Worker> workers{};
+
+        std::size_t totalQueueDepth{};
+        std::size_t totalExecutedJobs{};
+        std::size_t totalStolenJobs{};
+    };
+
+    /**
+     * A fixed-size pool of worker threads. Every worker owns a deque of jobs:
+     * the worker itself pushes and pops at the back (LIFO, which keeps
+     * continuations hot in the cache), whilst idle workers steal from the
+     * front of other deques.
+     *
+     * Jobs posted from outside the pool are distributed round-robin.
+     */
+    class ThreadPool {
+    public:
+        // Fits the jobs of Task, Async and JobGraph, which capture a pointer
+        // or two.
+        using JobType = InplaceFunction<void(), 32, InplaceFunctionStorage::HEAP_FALLBACK>;
+
+        [[nodiscard]] explicit
+        ThreadPool(std::size_t workerCount = defaultWorkerCount()) noexcept;
+
+        ThreadPool(ThreadPool &&) = delete;
+        ThreadPool(const ThreadPool &) = delete;
+
+        /**
+         * Runs all jobs that are still queued and joins the workers.
+         */
+        ~ThreadPool() noexcept;
+
+        [[nodiscard]] static std::size_t
+        defaultWorkerCount() noexcept;
+
+        /**
+         * The pool that is used by base::Task and friends. It is created on
+         * first use and deliberately never destroyed, since jobs may block
+         * indefinitely (e.g. on a socket) and would otherwise hang exit.
+         */
+        [[nodiscard]] static ThreadPool &
+        global() noexcept;
+
+        /**
+         * Returns whether or not the calling thread is a worker of this pool.
+         */
+        [[nodiscard]] bool
+        isWorkerThread() const noexcept;
+
+        void
+        post(JobType &&job) noexcept;
+
+        /**
+         * Returns the amount of jobs that are queued but haven't started yet.
+         */
+        [[nodiscard]] std::size_t
+        queueDepth() const noexcept;
+
+        [[nodiscard]] ThreadPoolStatistics
+        statistics() const noexcept;
+
+        [[nodiscard]] inline std::size_t
+        workerCount() const noexcept {
+            return m_workers.size();
+        }
+
+    private:
+        struct Worker {
+            mutable std::mutex mutex{};
+            std::deque<JobType> jobs{};
+
+            std::atomic_size_t executedJobs{};
+            std::atomic_size_t stolenJobs{};
+
+            std::thread thread{};
+        };
+
+        [[nodiscard]] bool
+        tryPop(std::size_t workerIndex, JobType &job) noexcept;
+
+        [[nodiscard]] bool
+        trySteal(std::size_t thiefIndex, JobType &job) noexcept;
+
+        void
+        workerLoop(std::size_t workerIndex) noexcept;
+
+        std::vector<std::unique_ptr<Worker>> m_workers{};
+
+        std::atomic_size_t m_pendingJobs{};
+        std::atomic_size_t m_nextWorker{};
+        std::atomic_bool m_stopping{false};
+
+        std::mutex m_sleepMutex{};
+        std::condition_variable m_wakeUp{};
+    };
+
+} // namespace base
@@ -23,50 +23,37 @@ namespace devices::cast {
     base::Error
     CastManager::initialize() noexcept {
 #if 0
-        base::Task::run(m_multiCastSocket.joinMultiCastGroup(network::common_socket_address::ssdpMulticast), {})
-            ->then([&](std::any result) -> std::any {
-                if (const auto error = std::any_cast<base::Error>(result)) {
+        m_multiCastSocket.joinMultiCastGroup(network::common_socket_address::ssdpMulticast)
+            .then([&](base::Error error) {
+                if (error) {
                     error.displayErrorMessageBox();
-                    return {};
+                    return;
                 }
 
                 fmt::print("[CAST] CONNECTED!!!!");
-
-                return {};
-            })
-            ->then([&] (const std::any &) -> std::any {
                 startUniCastSocket();
-                return {};
-            })
-            ->then(m_multiCastSocket.write(
-                "M-SEARCH * HTTP/1.1\r\n"
-                "HOST: 239.255.255.250:1900\r\n"
-                "MAN: \"ssdp:discover\"\r\n"
-                "MX: 30\r\n"
-                "ST: ssdp:all\r\n"
-                "\r\n"))
-            ->then([&](const std::any &param) -> std::any {
-                if (auto error = std::any_cast<base::Error>(param)) {
-                    error.displayErrorMessageBox();
-                    return error;
-                }
-
-                while (true) {
-                    TRY_GET_VARIABLE(data, m_multiCastSocket.readSynchronously())
-                    fmt::print("DATA: {}\n", data);
-                }
-
-                return {};
-            })
-            ->then([&](const std::any &param) -> std::any {
-                if (auto error = std::any_cast<base::Error>(param)) {
-                    error.displayErrorMessageBox();
-                    return error;
-                }
 
-                return {};
-            })
-        ;
+                m_multiCastSocket.write(
+                        "M-SEARCH * HTTP/1.1\r\n"
+                        "HOST: 239.255.255.250:1900\r\n"
+                        "MAN: \"ssdp:discover\"\r\n"
+                        "MX: 30\r\n"
+                        "ST: ssdp:all\r\n"
+                        "\r\n")
+                    .then([&](base::Error writeError) -> base::Error {
+                        if (writeError)
+                            return writeError;
+
+                        while (true) {
+                            TRY_GET_VARIABLE(data, m_multiCastSocket.readSynchronously())
+                            fmt::print("DATA: {}\n", data);
+                        }
+                    })
+                    .then([](base::Error readError) {
+                        if (readError)
+                            readError.displayErrorMessageBox();
+                    });
+            });
 #endif
 
         return base::Error::success();
@@ -74,31 +61,23 @@ namespace devices::cast {
 
     void
     CastManager::startUniCastSocket() noexcept {
-        base::Task::run(m_uniCastSocket.bind(network::SocketAddress{
+        m_uniCastSocket.bind(network::SocketAddress{
             network::IPv4Address(192, 168, 1, 106),
             //m_multiCastSocket.multiCastInterface().value(),
             network::common_ports::ssdp
-        }), {})
-            ->then([&](const std::any &param) -> std::any {
-                if (auto error = std::any_cast<base::Error>(param)) {
-                    error.displayErrorMessageBox();
+        })
+            .then([&](base::Error error) -> base::Error {
+                if (error)
                     return error;
-                }
 
                 while (true) {
                     TRY_GET_VARIABLE(data, m_uniCastSocket.readSynchronously())
                     fmt::print("UNI DATA: {}\n", data);
                 }
-
-                return {};
             })
-            ->then([&](const std::any& param) -> std::any {
-                if (auto error = std::any_cast<base::Error>(param)) {
+            .then([](base::Error error) {
+                if (error)
                     error.displayErrorMessageBox();
-                    return error;
-                }
-
-                return {};
             });
     }
 
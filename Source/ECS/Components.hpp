@@ -0,0 +1,58 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ *
+ * The components of the ecs::Registry. They are plain data, the systems that
+ * iterate over them contain the behavior.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "Source/Math/Transformation.hpp"
+#include "Source/Math/Vector.hpp"
+
+namespace resources {
+
+    class ModelDescriptor;
+
+} // namespace resources
+
+namespace ecs {
+
+    struct NameComponent {
+        std::string name;
+    };
+
+    struct TransformComponent {
+        math::Transformation transformation{};
+    };
+
+    /**
+     * An entity with a model. Entities without one simply don't have this
+     * component, instead of having a null model descriptor.
+     */
+    struct RenderableComponent {
+        const resources::ModelDescriptor *modelDescriptor;
+    };
+
+    struct PointLightComponent {
+        math::Vector3f color;
+        float radius;
+        float intensity;
+        float attenuationConstant;
+        float attenuationLinear;
+        float attenuationExponent;
+    };
+
+    struct CameraComponent {
+        math::Vector3f forward{0.0f, 0.0f, 1.0f};
+        math::Vector3f up{0.0f, 1.0f, 0.0f};
+    };
+
+} // namespace ecs
@@ -8,6 +8,7 @@
 
 #include <string>
 
+#include "Source/ECS/EntityHandle.hpp"
 #include "Source/ECS/Forward.hpp"
 #include "Source/ECS/Node.hpp"
 #include "Source/Math/Transformation.hpp"
@@ -21,6 +22,9 @@ namespace ecs {
         const resources::ModelDescriptor *m_modelDescriptor{};
         math::Transformation m_transformation{};
 
+        friend class EntityList;
+        EntityHandle m_handle{};
+
     public:
         [[nodiscard]] inline explicit
         Entity(std::string &&name, const resources::ModelDescriptor *modelDescriptor,
@@ -38,6 +42,15 @@ namespace ecs {
             , m_transformation(transformation) {
         }
 
+        /**
+         * The handle in the EntityList, which is invalid when the entity
+         * isn't in a list.
+         */
+        [[nodiscard]] inline constexpr EntityHandle
+        handle() const noexcept {
+            return m_handle;
+        }
+
         [[nodiscard]] bool
         isEntity() const noexcept final {
             return true;
@@ -0,0 +1,37 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace ecs {
+
+    /**
+     * Refers to an entity of an EntityList. The index is that of a slot, which
+     * keeps pointing to the entity when the list is compacted. The generation
+     * of the slot is incremented when its entity is removed, so a handle to a
+     * removed entity is detected, even when the slot is reused.
+     */
+    struct EntityHandle {
+        static constexpr std::uint32_t s_invalidIndex = UINT32_MAX;
+
+        std::uint32_t index{s_invalidIndex};
+        std::uint32_t generation{0};
+
+        [[nodiscard]] inline constexpr explicit
+        operator bool() const noexcept {
+            return index != s_invalidIndex;
+        }
+
+        [[nodiscard]] constexpr bool
+        operator==(const EntityHandle &) const noexcept = default;
+    };
+
+} // namespace ecs
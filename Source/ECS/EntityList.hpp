@@ -6,42 +6,93 @@
 
 #pragma once
 
+#include <algorithm> // for std::find
+#include <initializer_list>
+#include <iterator> // for std::distance
 #include <memory>
+#include <utility> // for std::forward, std::move
 #include <vector>
 
 #include <cassert>
 #include <cstddef> // for std::size_t
+#include <cstdint>
 
 #include "Source/ECS/Entity.hpp"
+#include "Source/ECS/EntityHandle.hpp"
 #include "Source/ECS/Forward.hpp"
 
 namespace ecs {
 
+    /**
+     * The entities are kept contiguous, and are addressed by an EntityHandle
+     * through a table of slots, so looking up an entity is O(1). Removing an
+     * entity moves the last one into its place, so the order of the entities
+     * isn't stable.
+     *
+     * The children of a removed entity are given the parent of that entity,
+     * so that no entity is left pointing to a destroyed parent. That takes a
+     * pass over the entities, which is only made when a removed entity has
+     * children.
+     *
+     * Every modification is a single update for the Graphics APIs, including
+     * the bulk operations (insert, removeIf and clearExcept).
+     */
     class EntityList {
         friend class Scene;
 
+        struct Slot {
+            // The index into m_entities, when the slot is in use.
+            std::uint32_t entityIndex;
+            std::uint32_t generation;
+        };
+
         std::vector<std::unique_ptr<Entity>> m_entities;
 
+        std::vector<Slot> m_slots{};
+        std::vector<std::uint32_t> m_freeSlots{};
+
         /**
          * Useful for Graphics APIs that need to rebuild / repack the entity
          * list internally.
          */
         std::size_t m_updateCount{0};
 
+        // Only changed when entities are added or removed.
+        std::size_t m_structureUpdateCount{0};
+
+        inline void
+        commitStructureUpdate() noexcept {
+            ++m_updateCount;
+            ++m_structureUpdateCount;
+        }
+
     public:
         inline Entity *
         add(std::unique_ptr<Entity> &&entity) noexcept {
-            m_entities.push_back(std::move(entity));
-            ++m_updateCount;
-            return m_entities.back().get();
+            auto *result = append(std::move(entity));
+            commitStructureUpdate();
+            return result;
+        }
+
+        /**
+         * Removes all entities except for the given ones.
+         */
+        inline std::size_t
+        clearExcept(std::initializer_list<EntityHandle> keep) noexcept {
+            return removeIf([keep] (const Entity &entity) {
+                return std::find(std::begin(keep), std::end(keep), entity.handle()) == std::end(keep);
+            });
+        }
+
+        [[nodiscard]] inline bool
+        contains(EntityHandle handle) const noexcept {
+            return handle.index < std::size(m_slots) && m_slots[handle.index].generation == handle.generation;
         }
 
         template<typename...Args>
         inline Entity *
         create(Args &&...args) noexcept {
-            m_entities.push_back(std::make_unique<Entity>(args...));
-            ++m_updateCount;
-            return m_entities.back().get();
+            return add(std::make_unique<Entity>(std::forward<Args>(args)...));
         }
 
         [[nodiscard]] inline std::vector<std::unique_ptr<Entity>> &
@@ -59,23 +110,169 @@ namespace ecs {
             ++m_updateCount;
         }
 
+        /**
+         * Returns null when the entity of the handle was removed.
+         */
+        [[nodiscard]] inline Entity *
+        get(EntityHandle handle) const noexcept {
+            if (!contains(handle))
+                return nullptr;
+            return m_entities[m_slots[handle.index].entityIndex].get();
+        }
+
+        /**
+         * Moves the entities of the range, e.g. of std::move_iterators, to
+         * the end of the list.
+         */
+        template<typename Iterator>
+        inline void
+        insert(Iterator begin, Iterator end) noexcept {
+            m_entities.reserve(std::size(m_entities) + static_cast<std::size_t>(std::distance(begin, end)));
+            for (auto it = begin; it != end; ++it)
+                static_cast<void>(append(std::unique_ptr<Entity>(*it)));
+            commitStructureUpdate();
+        }
+
         inline void
         remove(Entity *entity) noexcept {
-            auto it = std::find_if(std::begin(m_entities), std::end(m_entities),
-                                  [entity] (const std::unique_ptr<Entity> &vEntity) {
-                return vEntity.get() == entity;
-            });
+            assert(entity != nullptr);
+            [[maybe_unused]] const auto removed = remove(entity->handle());
+            assert(removed);
+        }
 
-            assert(it != std::end(m_entities));
+        /**
+         * Returns false when the entity was already removed.
+         */
+        inline bool
+        remove(EntityHandle handle) noexcept {
+            if (!contains(handle))
+                return false;
 
-            m_entities.erase(it);
-            ++m_updateCount;
+            const auto index = m_slots[handle.index].entityIndex;
+
+            // Destroyed after its children have been reparented.
+            const auto removed = std::move(m_entities[index]);
+            releaseSlot(*removed);
+            if (index + 1 != std::size(m_entities)) {
+                m_entities[index] = std::move(m_entities.back());
+                m_slots[m_entities[index]->m_handle.index].entityIndex = index;
+            }
+            m_entities.pop_back();
+
+            if (removed->childCount() != 0)
+                reparentOrphans();
+            removed->setParent(nullptr);
+
+            commitStructureUpdate();
+            return true;
+        }
+
+        /**
+         * Removes the entities for which the predicate returns true, in a
+         * single pass that keeps the order of the remaining entities. Returns
+         * the amount of entities that were removed.
+         */
+        template<typename Predicate>
+        inline std::size_t
+        removeIf(Predicate &&predicate) noexcept {
+            // Destroyed after their children have been reparented.
+            std::vector<std::unique_ptr<Entity>> removedEntities{};
+
+            bool hasOrphans{false};
+
+            std::uint32_t kept{0};
+            for (auto &entity : m_entities) {
+                if (predicate(static_cast<const Entity &>(*entity))) {
+                    releaseSlot(*entity);
+                    hasOrphans = hasOrphans || entity->childCount() != 0;
+                    removedEntities.push_back(std::move(entity));
+                    continue;
+                }
+
+                m_slots[entity->m_handle.index].entityIndex = kept;
+                if (&m_entities[kept] != &entity)
+                    m_entities[kept] = std::move(entity);
+                ++kept;
+            }
+
+            const auto removed = std::size(m_entities) - kept;
+            m_entities.resize(kept);
+            if (removed != 0) {
+                if (hasOrphans)
+                    reparentOrphans();
+
+                // The removed entities may be each other's parents, so they
+                // are unparented before any of them is destroyed.
+                for (auto &entity : removedEntities)
+                    entity->setParent(nullptr);
+                commitStructureUpdate();
+            }
+            return removed;
+        }
+
+        /**
+         * Like updateCount(), but only changes when entities are added or
+         * removed, not when they update.
+         */
+        [[nodiscard]] inline constexpr std::size_t
+        structureUpdateCount() const noexcept {
+            return m_structureUpdateCount;
         }
 
         [[nodiscard]] inline constexpr std::size_t
         updateCount() const noexcept {
             return m_updateCount;
         }
+
+    private:
+        [[nodiscard]] inline Entity *
+        append(std::unique_ptr<Entity> &&entity) noexcept {
+            assert(entity != nullptr);
+
+            std::uint32_t slot;
+            if (m_freeSlots.empty()) {
+                slot = static_cast<std::uint32_t>(std::size(m_slots));
+                m_slots.push_back({0, 0});
+            } else {
+                slot = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+
+            m_slots[slot].entityIndex = static_cast<std::uint32_t>(std::size(m_entities));
+            entity->m_handle = {slot, m_slots[slot].generation};
+
+            m_entities.push_back(std::move(entity));
+            return m_entities.back().get();
+        }
+
+        /**
+         * Gives every entity of which the parent was removed the closest
+         * ancestor that wasn't. The removed entities are recognized by their
+         * released handle, so they must still be alive.
+         */
+        inline void
+        reparentOrphans() noexcept {
+            const auto isRemoved = [] (const Node *node) {
+                return node->isEntity() && !static_cast<const Entity *>(node)->handle();
+            };
+
+            for (auto &entity : m_entities) {
+                auto *parent = entity->parent();
+                if (parent == nullptr || !isRemoved(parent))
+                    continue;
+
+                while (parent != nullptr && isRemoved(parent))
+                    parent = parent->parent();
+                entity->setParent(parent);
+            }
+        }
+
+        inline void
+        releaseSlot(Entity &entity) noexcept {
+            ++m_slots[entity.m_handle.index].generation;
+            m_freeSlots.push_back(entity.m_handle.index);
+            entity.m_handle = {};
+        }
     };
 
-} // namespace ecs
\ No newline at end of file
+} // namespace ecs
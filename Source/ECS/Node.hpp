@@ -11,6 +11,8 @@
 
 #include <functional>
 
+#include <cstddef> // for std::size_t
+
 namespace ecs {
 
     enum class DidUpdate {
@@ -22,11 +24,24 @@ namespace ecs {
         [[nodiscard]] inline constexpr explicit
         Node(Node *parent = nullptr) noexcept
                 : m_parent(parent) {
+            if (parent != nullptr)
+                ++parent->m_childCount;
         }
         
         virtual
         ~Node() noexcept = default;
 
+        /**
+         * The amount of nodes that have this node as their parent. Children
+         * that are destroyed whilst they still have this parent are counted
+         * nonetheless, so it is exact only when they are unparented first,
+         * like the EntityList does.
+         */
+        [[nodiscard]] inline constexpr std::size_t
+        childCount() const noexcept {
+            return m_childCount;
+        }
+
         [[nodiscard]] virtual bool
         isCamera() const noexcept {
             return false;
@@ -63,11 +78,16 @@ namespace ecs {
 
         inline constexpr void
         setParent(Node *parent) noexcept {
+            if (m_parent != nullptr)
+                --m_parent->m_childCount;
+            if (parent != nullptr)
+                ++parent->m_childCount;
             m_parent = parent;
         }
 
     private:
         Node *m_parent;
+        std::size_t m_childCount{0};
     };
 
 } // namespace ecs
\ No newline at end of file
@@ -0,0 +1,142 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Registry.hpp"
+
+#include <atomic>
+#include <bit> // for std::countr_zero, std::popcount
+
+namespace ecs {
+
+    namespace detail {
+
+        std::size_t
+        allocateComponentTypeIndex() noexcept {
+            static std::atomic_size_t s_nextIndex{0};
+
+            const auto index = s_nextIndex.fetch_add(1, std::memory_order_relaxed);
+            assert(index < sizeof(ComponentMask) * 8);
+            return index;
+        }
+
+    } // namespace detail
+
+    Registry::Registry() noexcept {
+        static_cast<void>(createArchetype(0, {}));
+    }
+
+    detail::Archetype &
+    Registry::createArchetype(ComponentMask mask, std::vector<std::unique_ptr<detail::ColumnBase>> &&columns) noexcept {
+        assert(static_cast<std::size_t>(std::popcount(mask)) == std::size(columns));
+
+        auto &archetype = *m_archetypes.emplace_back(new detail::Archetype{mask, std::move(columns)});
+        m_archetypesByMask.emplace(mask, &archetype);
+        return archetype;
+    }
+
+    detail::Archetype &
+    Registry::createArchetypeWith(detail::Archetype &source, std::size_t typeIndex,
+                                  std::unique_ptr<detail::ColumnBase> &&column) noexcept {
+        const auto mask = source.mask | (ComponentMask{1} << typeIndex);
+
+        std::vector<std::unique_ptr<detail::ColumnBase>> columns;
+        columns.reserve(static_cast<std::size_t>(std::popcount(mask)));
+        for (auto bits = mask; bits != 0; bits &= bits - 1) {
+            const auto index = static_cast<std::size_t>(std::countr_zero(bits));
+            if (index == typeIndex)
+                columns.push_back(std::move(column));
+            else
+                columns.push_back(source.columnAt(index).createEmpty());
+        }
+
+        return createArchetype(mask, std::move(columns));
+    }
+
+    detail::Archetype &
+    Registry::createArchetypeWithout(detail::Archetype &source, std::size_t typeIndex) noexcept {
+        const auto mask = source.mask & ~(ComponentMask{1} << typeIndex);
+
+        std::vector<std::unique_ptr<detail::ColumnBase>> columns;
+        columns.reserve(static_cast<std::size_t>(std::popcount(mask)));
+        for (auto bits = mask; bits != 0; bits &= bits - 1)
+            columns.push_back(source.columnAt(static_cast<std::size_t>(std::countr_zero(bits))).createEmpty());
+
+        return createArchetype(mask, std::move(columns));
+    }
+
+    void
+    Registry::destroy(EntityId entity) noexcept {
+        assert(contains(entity));
+        auto &record = m_records[entity.index];
+
+        removeRow(*record.archetype, record.row);
+        record.archetype = nullptr;
+        ++record.generation;
+        m_freeIndices.push_back(entity.index);
+    }
+
+    detail::Archetype *
+    Registry::findArchetype(ComponentMask mask) noexcept {
+        const auto it = m_archetypesByMask.find(mask);
+        if (it == std::end(m_archetypesByMask))
+            return nullptr;
+        return it->second;
+    }
+
+    EntityId
+    Registry::insert(detail::Archetype &archetype) noexcept {
+        EntityId entity{};
+        if (m_freeIndices.empty()) {
+            entity.index = static_cast<std::uint32_t>(std::size(m_records));
+            m_records.push_back({nullptr, 0, 0});
+        } else {
+            entity.index = m_freeIndices.back();
+            m_freeIndices.pop_back();
+        }
+
+        auto &record = m_records[entity.index];
+        entity.generation = record.generation;
+        archetype.entities.push_back(entity);
+        record.archetype = &archetype;
+        record.row = std::size(archetype.entities) - 1;
+        return entity;
+    }
+
+    void
+    Registry::moveEntity(EntityId entity, detail::Archetype &destination) noexcept {
+        auto &record = m_records[entity.index];
+        auto &source = *record.archetype;
+
+        for (auto bits = source.mask & destination.mask; bits != 0; bits &= bits - 1) {
+            const auto index = static_cast<std::size_t>(std::countr_zero(bits));
+            source.columnAt(index).moveRowTo(record.row, destination.columnAt(index));
+        }
+
+        removeRow(source, record.row);
+
+        destination.entities.push_back(entity);
+        record.archetype = &destination;
+        record.row = std::size(destination.entities) - 1;
+    }
+
+    void
+    Registry::removeRow(detail::Archetype &archetype, std::size_t row) noexcept {
+        for (auto &column : archetype.columns)
+            column->swapRemove(row);
+
+        const auto last = archetype.entities.back();
+        archetype.entities[row] = last;
+        archetype.entities.pop_back();
+
+        // The last entity took the place of the removed one.
+        if (row != std::size(archetype.entities))
+            m_records[last.index].row = row;
+    }
+
+} // namespace ecs
@@ -0,0 +1,369 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <bit> // for std::popcount
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility> // for std::forward, std::move
+#include <vector>
+
+#include <cassert>
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+namespace ecs {
+
+    /**
+     * Every component type has a bit in the mask, so there can be at most 64
+     * component types.
+     */
+    using ComponentMask = std::uint64_t;
+
+    /**
+     * The generation detects ids of destroyed entities, like EntityHandle.
+     */
+    struct EntityId {
+        std::uint32_t index;
+        std::uint32_t generation;
+
+        [[nodiscard]] constexpr bool
+        operator==(const EntityId &) const noexcept = default;
+    };
+
+    namespace detail {
+
+        [[nodiscard]] std::size_t
+        allocateComponentTypeIndex() noexcept;
+
+        template<typename Component>
+        [[nodiscard]] inline std::size_t
+        componentTypeIndex() noexcept {
+            static const std::size_t s_index = allocateComponentTypeIndex();
+            return s_index;
+        }
+
+        template<typename Component>
+        [[nodiscard]] inline ComponentMask
+        componentBit() noexcept {
+            return ComponentMask{1} << componentTypeIndex<Component>();
+        }
+
+        /**
+         * The type-erased operations on a column, for moving entities between
+         * archetypes. Iterating goes through the typed Column directly.
+         */
+        class ColumnBase {
+        public:
+            virtual ~ColumnBase() noexcept = default;
+
+            [[nodiscard]] virtual std::unique_ptr<ColumnBase>
+            createEmpty() const noexcept = 0;
+
+            /**
+             * Appends the component of the row to the destination column,
+             * which has the same type. The row itself is left as is.
+             */
+            virtual void
+            moveRowTo(std::size_t row, ColumnBase &destination) noexcept = 0;
+
+            /**
+             * Removes the row by moving the last row into its place.
+             */
+            virtual void
+            swapRemove(std::size_t row) noexcept = 0;
+        };
+
+        template<typename Component>
+        class Column final
+                : public ColumnBase {
+        public:
+            [[nodiscard]] std::unique_ptr<ColumnBase>
+            createEmpty() const noexcept override {
+                return std::make_unique<Column>();
+            }
+
+            void
+            moveRowTo(std::size_t row, ColumnBase &destination) noexcept override {
+                static_cast<Column &>(destination).data.push_back(std::move(data[row]));
+            }
+
+            void
+            swapRemove(std::size_t row) noexcept override {
+                if (row + 1 != std::size(data))
+                    data[row] = std::move(data.back());
+                data.pop_back();
+            }
+
+            std::vector<Component> data{};
+        };
+
+        /**
+         * The entities that have exactly the same set of components. Every
+         * component type has its own contiguous column, and row i of every
+         * column belongs to entities[i].
+         */
+        struct Archetype {
+            [[nodiscard]] inline ColumnBase &
+            columnAt(std::size_t typeIndex) noexcept {
+                assert(mask & (ComponentMask{1} << typeIndex));
+                const auto lowerBits = mask & ((ComponentMask{1} << typeIndex) - 1);
+                return *columns[static_cast<std::size_t>(std::popcount(lowerBits))];
+            }
+
+            template<typename Component>
+            [[nodiscard]] inline std::vector<Component> &
+            column() noexcept {
+                return static_cast<Column<Component> &>(columnAt(componentTypeIndex<Component>())).data;
+            }
+
+            ComponentMask mask;
+
+            // Ordered by component type index, so the position of a column is
+            // the amount of bits in the mask below that of its type.
+            std::vector<std::unique_ptr<ColumnBase>> columns;
+
+            std::vector<EntityId> entities{};
+        };
+
+    } // namespace detail
+
+    /**
+     * Stores the components of entities by archetype: entities with the same
+     * set of components share an archetype, which keeps each component type in
+     * a contiguous array. Iterating over the entities with some components
+     * visits the matching archetypes and walks their arrays in order, without
+     * a virtual call or pointer indirection per entity.
+     *
+     * Adding or removing a component moves the components of the entity to
+     * another archetype, so pointers to components are only valid until the
+     * next structural change (create, destroy, add or remove), which also
+     * mustn't happen during each().
+     *
+     * The engine doesn't use it yet, so it isn't part of LavenderCore: the
+     * tests and benchmarks that use it compile Registry.cpp themselves.
+     */
+    class Registry {
+    public:
+        [[nodiscard]]
+        Registry() noexcept;
+
+        Registry(Registry &&) noexcept = default;
+        Registry(const Registry &) = delete;
+
+        Registry &operator=(Registry &&) noexcept = default;
+        Registry &operator=(const Registry &) = delete;
+
+        template<typename Component>
+        Component &
+        add(EntityId entity, Component &&component) noexcept {
+            using Type = std::remove_cvref_t<Component>;
+            const auto bit = detail::componentBit<Type>();
+
+            assert(contains(entity));
+            auto &record = m_records[entity.index];
+            if (record.archetype->mask & bit) {
+                auto &existing = record.archetype->column<Type>()[record.row];
+                existing = std::forward<Component>(component);
+                return existing;
+            }
+
+            detail::Archetype *destination = findArchetype(record.archetype->mask | bit);
+            if (destination == nullptr) {
+                destination = &createArchetypeWith(*record.archetype, detail::componentTypeIndex<Type>(),
+                                                   std::make_unique<detail::Column<Type>>());
+            }
+
+            moveEntity(entity, *destination);
+            auto &column = destination->column<Type>();
+            column.push_back(std::forward<Component>(component));
+            return column.back();
+        }
+
+        [[nodiscard]] std::size_t
+        archetypeCount() const noexcept {
+            return std::size(m_archetypes);
+        }
+
+        /**
+         * Returns the amount of entities that have at least these components.
+         */
+        template<typename...Components>
+        [[nodiscard]] std::size_t
+        count() const noexcept {
+            const ComponentMask required = (detail::componentBit<Components>() | ... | ComponentMask{0});
+
+            std::size_t result{0};
+            for (const auto &archetype : m_archetypes) {
+                if ((archetype->mask & required) == required)
+                    result += std::size(archetype->entities);
+            }
+            return result;
+        }
+
+        template<typename...Components>
+        EntityId
+        create(Components &&...components) noexcept {
+            detail::Archetype &archetype = archetypeFor<std::remove_cvref_t<Components>...>();
+            (archetype.column<std::remove_cvref_t<Components>>().push_back(std::forward<Components>(components)), ...);
+            return insert(archetype);
+        }
+
+        [[nodiscard]] inline bool
+        contains(EntityId entity) const noexcept {
+            return entity.index < std::size(m_records) && m_records[entity.index].generation == entity.generation
+                && m_records[entity.index].archetype != nullptr;
+        }
+
+        void
+        destroy(EntityId entity) noexcept;
+
+        /**
+         * Invokes the function for every entity that has at least these
+         * components, with references to them. The function can take the
+         * EntityId as its first parameter.
+         */
+        template<typename...Components, typename Function>
+        void
+        each(Function &&function) noexcept {
+            const ComponentMask required = (detail::componentBit<Components>() | ... | ComponentMask{0});
+
+            for (const auto &archetype : m_archetypes) {
+                if ((archetype->mask & required) != required || archetype->entities.empty())
+                    continue;
+
+                eachInArchetype<Components...>(function, *archetype, archetype->column<Components>().data()...);
+            }
+        }
+
+        template<typename Component>
+        [[nodiscard]] Component *
+        get(EntityId entity) noexcept {
+            if (!contains(entity))
+                return nullptr;
+
+            const auto &record = m_records[entity.index];
+            if (!(record.archetype->mask & detail::componentBit<Component>()))
+                return nullptr;
+            return &record.archetype->column<Component>()[record.row];
+        }
+
+        template<typename Component>
+        [[nodiscard]] bool
+        has(EntityId entity) const noexcept {
+            return contains(entity) && (m_records[entity.index].archetype->mask & detail::componentBit<Component>());
+        }
+
+        template<typename Component>
+        void
+        remove(EntityId entity) noexcept {
+            const auto bit = detail::componentBit<Component>();
+
+            assert(contains(entity));
+            auto &record = m_records[entity.index];
+            if (!(record.archetype->mask & bit))
+                return;
+
+            detail::Archetype *destination = findArchetype(record.archetype->mask & ~bit);
+            if (destination == nullptr)
+                destination = &createArchetypeWithout(*record.archetype, detail::componentTypeIndex<Component>());
+
+            moveEntity(entity, *destination);
+        }
+
+        /**
+         * Reserves the storage of the archetype with exactly these
+         * components, e.g. before creating many entities at once.
+         */
+        template<typename...Components>
+        void
+        reserve(std::size_t capacity) noexcept {
+            detail::Archetype &archetype = archetypeFor<Components...>();
+            archetype.entities.reserve(capacity);
+            (archetype.column<Components>().reserve(capacity), ...);
+        }
+
+        [[nodiscard]] std::size_t
+        size() const noexcept {
+            return std::size(m_records) - std::size(m_freeIndices);
+        }
+
+    private:
+        struct EntityRecord {
+            // Null when the entity was destroyed.
+            detail::Archetype *archetype;
+            std::size_t row;
+            std::uint32_t generation;
+        };
+
+        template<typename...Components>
+        [[nodiscard]] detail::Archetype &
+        archetypeFor() noexcept {
+            const ComponentMask mask = (detail::componentBit<Components>() | ... | ComponentMask{0});
+            if (auto *archetype = findArchetype(mask))
+                return *archetype;
+
+            std::vector<std::unique_ptr<detail::ColumnBase>> columns(sizeof...(Components));
+            ((columns[static_cast<std::size_t>(std::popcount(mask & (detail::componentBit<Components>() - 1)))]
+                    = std::make_unique<detail::Column<Components>>()), ...);
+            return createArchetype(mask, std::move(columns));
+        }
+
+        [[nodiscard]] detail::Archetype &
+        createArchetype(ComponentMask mask, std::vector<std::unique_ptr<detail::ColumnBase>> &&columns) noexcept;
+
+        [[nodiscard]] detail::Archetype &
+        createArchetypeWith(detail::Archetype &source, std::size_t typeIndex,
+                            std::unique_ptr<detail::ColumnBase> &&column) noexcept;
+
+        [[nodiscard]] detail::Archetype &
+        createArchetypeWithout(detail::Archetype &source, std::size_t typeIndex) noexcept;
+
+        template<typename...Components, typename Function>
+        static void
+        eachInArchetype(Function &function, const detail::Archetype &archetype, Components *...columns) noexcept {
+            const auto size = std::size(archetype.entities);
+            for (std::size_t row = 0; row < size; ++row) {
+                if constexpr (std::is_invocable_v<Function &, EntityId, Components &...>)
+                    function(archetype.entities[row], columns[row]...);
+                else
+                    function(columns[row]...);
+            }
+        }
+
+        [[nodiscard]] detail::Archetype *
+        findArchetype(ComponentMask mask) noexcept;
+
+        /**
+         * Allocates an id for the entity whose components were just appended
+         * to the archetype.
+         */
+        [[nodiscard]] EntityId
+        insert(detail::Archetype &archetype) noexcept;
+
+        /**
+         * Moves the components that the destination has, after which the
+         * caller appends the components that the source didn't have.
+         */
+        void
+        moveEntity(EntityId entity, detail::Archetype &destination) noexcept;
+
+        void
+        removeRow(detail::Archetype &archetype, std::size_t row) noexcept;
+
+        std::vector<std::unique_ptr<detail::Archetype>> m_archetypes{};
+        std::unordered_map<ComponentMask, detail::Archetype *> m_archetypesByMask{};
+
+        std::vector<EntityRecord> m_records{};
+        std::vector<std::uint32_t> m_freeIndices{};
+    };
+
+} // namespace ecs
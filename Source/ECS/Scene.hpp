@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <iterator> // for std::make_move_iterator
 #include <utility> // for std::move
 
 #include "Source/ECS/EntityList.hpp"
@@ -19,8 +20,9 @@ namespace ecs {
         [[nodiscard]] inline explicit
         Scene(EntityList &&entityList) noexcept
                 : m_entityList(std::move(entityList)) {
+            // Entities that are parented to other entities keep their parent.
             for (auto &entity : m_entityList.m_entities) {
-                if (entity != nullptr)
+                if (entity != nullptr && entity->parent() == nullptr)
                     entity->setParent(this);
             }
         }
@@ -37,16 +39,16 @@ namespace ecs {
 
         inline void
         import(Scene &&scene) noexcept {
-            const auto size = std::size(std::data(scene.entityList()));
+            auto &entities = scene.m_entityList.m_entities;
             const auto start = std::size(m_entityList.m_entities);
-            m_entityList.m_entities.reserve(start + size);
-            for (std::size_t i = 0; i < size; ++i) {
-                m_entityList.m_entities.push_back(std::move(scene.m_entityList.m_entities[i]));
+            m_entityList.insert(std::make_move_iterator(std::begin(entities)), std::make_move_iterator(std::end(entities)));
+            entities.clear();
 
-                if (m_entityList.m_entities.back() != nullptr)
-                    m_entityList.m_entities.back()->setParent(this);
+            for (auto i = start; i < std::size(m_entityList.m_entities); ++i) {
+                auto &entity = m_entityList.m_entities[i];
+                if (entity->parent() == nullptr || entity->parent() == &scene)
+                    entity->setParent(this);
             }
-            m_entityList.forceUpdateIncrement();
         }
 
         [[nodiscard]] bool
@@ -62,15 +64,25 @@ namespace ecs {
 
         void
         fireUpdate(float deltaTime) noexcept {
-            bool changed = false;
+            if (fireUpdate(deltaTime, 0, std::size(m_entityList.data())) == ecs::DidUpdate::YES)
+                m_entityList.forceUpdateIncrement();
+        }
 
-            for (auto &entity : m_entityList.data()) {
-                if (entity->onUpdate(deltaTime) == ecs::DidUpdate::YES)
-                    changed = true;
+        /**
+         * Updates the entities in [begin, end) only, so that separate ranges
+         * can be updated concurrently. It is up to the caller to call
+         * EntityList::forceUpdateIncrement() when any of them did update.
+         */
+        [[nodiscard]] DidUpdate
+        fireUpdate(float deltaTime, std::size_t begin, std::size_t end) noexcept {
+            auto didUpdate = DidUpdate::NO;
+
+            for (auto i = begin; i < end; ++i) {
+                if (m_entityList.m_entities[i]->onUpdate(deltaTime) == DidUpdate::YES)
+                    didUpdate = DidUpdate::YES;
             }
 
-            if (changed)
-                m_entityList.forceUpdateIncrement();
+            return didUpdate;
         }
 
     private:
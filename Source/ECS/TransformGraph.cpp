@@ -0,0 +1,302 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "TransformGraph.hpp"
+
+#include <algorithm> // for std::max
+#include <span>
+#include <utility> // for std::move
+
+#include "Source/Math/Affine.hpp"
+#include "Source/Math/Batch.hpp"
+
+namespace ecs {
+
+    TransformGraph::NodeId
+    TransformGraph::add(const math::Transformation &local, NodeId parent) noexcept {
+        assert(parent == s_noParent || parent < size());
+
+        const auto node = static_cast<NodeId>(size());
+        const auto slot = static_cast<std::uint32_t>(std::size(m_worlds));
+
+        m_parents.push_back(parent);
+        m_slots.push_back(slot);
+
+        m_parentSlots.push_back(parent == s_noParent ? s_noSlot : m_slots[parent]);
+        m_translations.push_back(local.translation());
+        m_rotations.push_back(local.rotation());
+        m_scalings.push_back(local.scaling());
+        m_localMatrices.emplace_back();
+        m_worlds.emplace_back();
+        m_normalMatrices.emplace_back();
+        m_dirty.push_back(true);
+        m_changed.push_back(false);
+
+        m_layoutIsStale = true;
+        return node;
+    }
+
+    void
+    TransformGraph::breakParentCycles() noexcept {
+        enum class State : std::uint8_t {
+            UNVISITED, ON_PATH, DONE
+        };
+        std::vector<State> states(size(), State::UNVISITED);
+
+        for (NodeId start = 0; start < size(); ++start) {
+            auto node = start;
+            while (node != s_noParent && states[node] == State::UNVISITED) {
+                states[node] = State::ON_PATH;
+                node = m_parents[node];
+            }
+
+            // The walk up from start ran into itself.
+            const auto cycleNode = node != s_noParent && states[node] == State::ON_PATH ? node : s_noParent;
+
+            for (node = start; node != s_noParent && states[node] == State::ON_PATH; node = m_parents[node])
+                states[node] = State::DONE;
+
+            if (cycleNode != s_noParent) {
+                m_parents[cycleNode] = s_noParent;
+                m_dirty[m_slots[cycleNode]] = true;
+            }
+        }
+    }
+
+    void
+    TransformGraph::clear() noexcept {
+        m_parents.clear();
+        m_slots.clear();
+        m_parentSlots.clear();
+        m_translations.clear();
+        m_rotations.clear();
+        m_scalings.clear();
+        m_localMatrices.clear();
+        m_worlds.clear();
+        m_normalMatrices.clear();
+        m_dirty.clear();
+        m_changed.clear();
+        m_topEnd = 0;
+        m_partitionEnds.clear();
+        m_layoutIsStale = false;
+    }
+
+    void
+    TransformGraph::composeLocalMatrices(std::size_t begin, std::size_t end) noexcept {
+        const std::span translations{m_translations};
+        const std::span rotations{m_rotations};
+        const std::span scalings{m_scalings};
+        const std::span localMatrices{m_localMatrices};
+
+        for (auto slot = begin; slot < end;) {
+            if (!m_dirty[slot]) {
+                ++slot;
+                continue;
+            }
+
+            auto runEnd = slot + 1;
+            while (runEnd < end && m_dirty[runEnd])
+                ++runEnd;
+
+            const auto count = runEnd - slot;
+            math::composeTRS(translations.subspan(slot, count), rotations.subspan(slot, count),
+                             scalings.subspan(slot, count), localMatrices.subspan(slot, count));
+            slot = runEnd;
+        }
+    }
+
+    void
+    TransformGraph::computeNormalMatrices(std::size_t begin, std::size_t end) noexcept {
+        const std::span worlds{m_worlds};
+        const std::span normalMatrices{m_normalMatrices};
+
+        for (auto slot = begin; slot < end;) {
+            if (!m_changed[slot]) {
+                ++slot;
+                continue;
+            }
+
+            auto runEnd = slot + 1;
+            while (runEnd < end && m_changed[runEnd])
+                ++runEnd;
+
+            const auto count = runEnd - slot;
+            math::normalMatrices(worlds.subspan(slot, count), normalMatrices.subspan(slot, count));
+            slot = runEnd;
+        }
+    }
+
+    void
+    TransformGraph::rebuildLayout() noexcept {
+        breakParentCycles();
+
+        const auto nodeCount = size();
+
+        // The children of node i are children[childrenBegin[i], childrenBegin[i + 1]).
+        std::vector<std::uint32_t> childrenBegin(nodeCount + 1, 0);
+        for (const auto parent : m_parents) {
+            if (parent != s_noParent)
+                ++childrenBegin[parent + 1];
+        }
+        for (std::size_t i = 0; i < nodeCount; ++i)
+            childrenBegin[i + 1] += childrenBegin[i];
+
+        std::vector<NodeId> children(nodeCount);
+        {
+            auto position = childrenBegin;
+            for (NodeId node = 0; node < nodeCount; ++node) {
+                if (m_parents[node] != s_noParent)
+                    children[position[m_parents[node]]++] = node;
+            }
+        }
+
+        std::vector<NodeId> order{};
+        order.reserve(nodeCount);
+        for (NodeId node = 0; node < nodeCount; ++node) {
+            if (m_parents[node] == s_noParent)
+                order.push_back(node);
+        }
+
+        // Walk down level by level until a level is wide enough to be split
+        // into partitions. Everything above it is the top.
+        std::size_t levelBegin = 0;
+        while (levelBegin != std::size(order)) {
+            const auto levelEnd = std::size(order);
+            if (nodeCount >= s_minimumPartitionedSize && levelEnd - levelBegin >= s_targetPartitionCount)
+                break;
+
+            for (auto i = levelBegin; i < levelEnd; ++i) {
+                const auto node = order[i];
+                order.insert(std::end(order), children.data() + childrenBegin[node], children.data() + childrenBegin[node + 1]);
+            }
+            levelBegin = levelEnd;
+        }
+
+        m_topEnd = levelBegin;
+        m_partitionEnds.clear();
+
+        // Append the subtrees of that level one by one, each in
+        // breadth-first order, and close a partition whenever it is large
+        // enough.
+        const std::vector<NodeId> subtreeRoots(std::begin(order) + static_cast<std::ptrdiff_t>(m_topEnd), std::end(order));
+        order.resize(m_topEnd);
+
+        const auto partitionSize = std::max<std::size_t>((nodeCount - m_topEnd) / s_targetPartitionCount, 1);
+        auto partitionBegin = m_topEnd;
+        for (const auto root : subtreeRoots) {
+            auto subtreeBegin = std::size(order);
+            order.push_back(root);
+            for (; subtreeBegin != std::size(order); ++subtreeBegin) {
+                const auto node = order[subtreeBegin];
+                order.insert(std::end(order), children.data() + childrenBegin[node], children.data() + childrenBegin[node + 1]);
+            }
+
+            if (std::size(order) - partitionBegin >= partitionSize) {
+                m_partitionEnds.push_back(std::size(order));
+                partitionBegin = std::size(order);
+            }
+        }
+        if (partitionBegin != std::size(order))
+            m_partitionEnds.push_back(std::size(order));
+
+        assert(std::size(order) == nodeCount);
+
+        // Move the per-slot data into the new order.
+        std::vector<std::uint32_t> slots(nodeCount);
+        for (std::size_t slot = 0; slot < nodeCount; ++slot)
+            slots[order[slot]] = static_cast<std::uint32_t>(slot);
+
+        std::vector<std::uint32_t> parentSlots(nodeCount);
+        std::vector<math::Vector3f> translations(nodeCount);
+        std::vector<math::Quaternion<float>> rotations(nodeCount);
+        std::vector<math::Vector3f> scalings(nodeCount);
+        std::vector<math::Matrix4x4<float>> localMatrices(nodeCount);
+        std::vector<math::Matrix4x4<float>> worlds(nodeCount);
+        std::vector<math::Matrix4x4<float>> normalMatrices(nodeCount);
+        std::vector<std::uint8_t> dirty(nodeCount);
+        for (std::size_t slot = 0; slot < nodeCount; ++slot) {
+            const auto node = order[slot];
+            const auto previousSlot = m_slots[node];
+            parentSlots[slot] = m_parents[node] == s_noParent ? s_noSlot : slots[m_parents[node]];
+            translations[slot] = m_translations[previousSlot];
+            rotations[slot] = m_rotations[previousSlot];
+            scalings[slot] = m_scalings[previousSlot];
+            localMatrices[slot] = m_localMatrices[previousSlot];
+            worlds[slot] = m_worlds[previousSlot];
+            normalMatrices[slot] = m_normalMatrices[previousSlot];
+            dirty[slot] = m_dirty[previousSlot];
+        }
+
+        m_slots = std::move(slots);
+        m_parentSlots = std::move(parentSlots);
+        m_translations = std::move(translations);
+        m_rotations = std::move(rotations);
+        m_scalings = std::move(scalings);
+        m_localMatrices = std::move(localMatrices);
+        m_worlds = std::move(worlds);
+        m_normalMatrices = std::move(normalMatrices);
+        m_dirty = std::move(dirty);
+        m_layoutIsStale = false;
+    }
+
+    void
+    TransformGraph::setParent(NodeId node, NodeId parent) noexcept {
+        assert(parent == s_noParent || parent < size());
+
+        m_parents[node] = parent;
+        m_dirty[m_slots[node]] = true;
+        m_layoutIsStale = true;
+    }
+
+    void
+    TransformGraph::update() noexcept {
+        updateTop();
+        updatePartitions(0, partitionCount());
+    }
+
+    void
+    TransformGraph::updatePartitions(std::size_t begin, std::size_t end) noexcept {
+        assert(!m_layoutIsStale);
+        assert(end <= partitionCount());
+
+        for (auto partition = begin; partition < end; ++partition) {
+            const auto first = partition == 0 ? m_topEnd : m_partitionEnds[partition - 1];
+            updateRange(first, m_partitionEnds[partition]);
+        }
+    }
+
+    void
+    TransformGraph::updateRange(std::size_t begin, std::size_t end) noexcept {
+        composeLocalMatrices(begin, end);
+
+        for (auto slot = begin; slot < end; ++slot) {
+            const auto parentSlot = m_parentSlots[slot];
+            const bool parentChanged = parentSlot != s_noSlot && m_changed[parentSlot];
+            if (!m_dirty[slot] && !parentChanged) {
+                m_changed[slot] = false;
+                continue;
+            }
+
+            const auto &localMatrix = m_localMatrices[slot];
+            m_worlds[slot] = parentSlot == s_noSlot ? localMatrix : m_worlds[parentSlot].mul(localMatrix);
+            m_dirty[slot] = false;
+            m_changed[slot] = true;
+        }
+
+        computeNormalMatrices(begin, end);
+    }
+
+    void
+    TransformGraph::updateTop() noexcept {
+        if (m_layoutIsStale)
+            rebuildLayout();
+        updateRange(0, m_topEnd);
+    }
+
+} // namespace ecs
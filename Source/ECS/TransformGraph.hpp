@@ -0,0 +1,215 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <cassert>
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+#include "Source/Math/Matrix4x4.hpp"
+#include "Source/Math/Quaternion.hpp"
+#include "Source/Math/Transformation.hpp"
+#include "Source/Math/Vector.hpp"
+
+namespace ecs {
+
+    /**
+     * A hierarchy of transformations, which computes the world matrix of
+     * every node from its local transformation and the world matrix of its
+     * parent.
+     *
+     * The nodes are stored in breadth-first order, so a parent always comes
+     * before its children and an update is a single linear pass over the
+     * arrays. Only the nodes whose local transformation was set, and their
+     * descendants, are recomputed. The local transformations are stored as
+     * separate arrays, so the local matrices of consecutive dirty nodes are
+     * composed with a single math::composeTRS() call, and likewise for the
+     * normal matrices of the world matrices that changed.
+     *
+     * For large hierarchies, the upper levels form the top of the layout,
+     * and the subtrees below it are grouped into partitions, each stored
+     * contiguously in breadth-first order. After updateTop(), the partitions
+     * don't depend on each other, so they can be updated concurrently.
+     */
+    class TransformGraph {
+    public:
+        using NodeId = std::uint32_t;
+
+        static constexpr NodeId s_noParent = UINT32_MAX;
+
+        /**
+         * The amount of partitions that the layout aims for, which bounds
+         * the amount of jobs an update can be split over.
+         */
+        static constexpr std::size_t s_targetPartitionCount = 64;
+
+        /**
+         * Smaller graphs aren't partitioned, since the jobs would cost more
+         * than they save.
+         */
+        static constexpr std::size_t s_minimumPartitionedSize = 4096;
+
+        NodeId
+        add(const math::Transformation &local, NodeId parent = s_noParent) noexcept;
+
+        void
+        clear() noexcept;
+
+        [[nodiscard]] inline math::Transformation
+        local(NodeId node) const noexcept {
+            const auto slot = m_slots[node];
+            return math::Transformation{m_translations[slot], m_rotations[slot], m_scalings[slot]};
+        }
+
+        /**
+         * The normal matrix of the world matrix, as of the last update. See
+         * math::normalMatrix().
+         */
+        [[nodiscard]] inline const math::Matrix4x4<float> &
+        normalMatrix(NodeId node) const noexcept {
+            return m_normalMatrices[m_slots[node]];
+        }
+
+        [[nodiscard]] inline NodeId
+        parent(NodeId node) const noexcept {
+            return m_parents[node];
+        }
+
+        /**
+         * The amount of partitions in the current layout, which is only
+         * valid after updateTop().
+         */
+        [[nodiscard]] inline std::size_t
+        partitionCount() const noexcept {
+            return std::size(m_partitionEnds);
+        }
+
+        /**
+         * Sets the local transformation of the node. Can be called
+         * concurrently for different nodes, but not during an update.
+         */
+        inline void
+        setLocal(NodeId node, const math::Transformation &local) noexcept {
+            const auto slot = m_slots[node];
+            m_translations[slot] = local.translation();
+            m_rotations[slot] = local.rotation();
+            m_scalings[slot] = local.scaling();
+            m_dirty[slot] = true;
+        }
+
+        /**
+         * A parent that is a descendant of the node creates a cycle, which
+         * the next layout breaks by making one of the nodes of the cycle a
+         * root.
+         */
+        void
+        setParent(NodeId node, NodeId parent) noexcept;
+
+        /**
+         * Like setLocal(), but leaves the node clean when the transformation
+         * didn't change. Returns whether it did.
+         */
+        inline bool
+        syncLocal(NodeId node, const math::Transformation &local) noexcept {
+            const auto slot = m_slots[node];
+            if (m_translations[slot] == local.translation() && m_rotations[slot] == local.rotation()
+                    && m_scalings[slot] == local.scaling())
+                return false;
+
+            setLocal(node, local);
+            return true;
+        }
+
+        [[nodiscard]] inline std::size_t
+        size() const noexcept {
+            return std::size(m_parents);
+        }
+
+        /**
+         * Updates all world matrices on the calling thread.
+         */
+        void
+        update() noexcept;
+
+        /**
+         * Rebuilds the layout when nodes were added or reparented, and
+         * updates the top of the hierarchy. Must precede updatePartitions().
+         */
+        void
+        updateTop() noexcept;
+
+        /**
+         * Updates the partitions in [begin, end). Disjoint ranges can be
+         * updated concurrently.
+         */
+        void
+        updatePartitions(std::size_t begin, std::size_t end) noexcept;
+
+        /**
+         * The world matrix as of the last update.
+         */
+        [[nodiscard]] inline const math::Matrix4x4<float> &
+        world(NodeId node) const noexcept {
+            return m_worlds[m_slots[node]];
+        }
+
+    private:
+        static constexpr std::uint32_t s_noSlot = UINT32_MAX;
+
+        /**
+         * Nodes in a cycle of parents can't be reached from a root, so they
+         * would be left out of the layout.
+         */
+        void
+        breakParentCycles() noexcept;
+
+        void
+        rebuildLayout() noexcept;
+
+        void
+        composeLocalMatrices(std::size_t begin, std::size_t end) noexcept;
+
+        void
+        computeNormalMatrices(std::size_t begin, std::size_t end) noexcept;
+
+        void
+        updateRange(std::size_t begin, std::size_t end) noexcept;
+
+        // Indexed by NodeId.
+        std::vector<NodeId> m_parents{};
+        std::vector<std::uint32_t> m_slots{};
+
+        // Indexed by slot, i.e. in the order of the layout.
+        std::vector<std::uint32_t> m_parentSlots{};
+        std::vector<math::Vector3f> m_translations{};
+        std::vector<math::Quaternion<float>> m_rotations{};
+        std::vector<math::Vector3f> m_scalings{};
+        std::vector<math::Matrix4x4<float>> m_localMatrices{};
+        std::vector<math::Matrix4x4<float>> m_worlds{};
+        std::vector<math::Matrix4x4<float>> m_normalMatrices{};
+
+        // Not std::vector<bool>, since partitions are written concurrently.
+        std::vector<std::uint8_t> m_dirty{};
+
+        // Whether the world matrix changed in the current update, which
+        // forces the children to be recomputed.
+        std::vector<std::uint8_t> m_changed{};
+
+        // The slots of partition i are [end of partition i - 1, m_partitionEnds[i]),
+        // and the first one starts at m_topEnd.
+        std::size_t m_topEnd{0};
+        std::vector<std::size_t> m_partitionEnds{};
+
+        bool m_layoutIsStale{false};
+    };
+
+} // namespace ecs
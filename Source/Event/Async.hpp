@@ -0,0 +1,95 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "Source/Base/Async.hpp"
+#include "Source/Event/FunctionQueue.hpp"
+
+namespace event {
+
+    namespace detail {
+
+        template<typename T>
+        using WaitForResultType = std::conditional_t<std::is_void_v<T>, bool, T>;
+
+        template<typename T>
+        base::Async<void>
+        awaitAndSignal(base::Async<T> async, std::atomic_bool &finished, std::optional<WaitForResultType<T>> &result) {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(async);
+                result.emplace(true);
+            } else {
+                result.emplace(co_await std::move(async));
+            }
+            finished.store(true, std::memory_order_release);
+        }
+
+    } // namespace detail
+
+    struct FunctionQueueAwaiter {
+        FunctionQueue &queue;
+
+        [[nodiscard]] constexpr bool
+        await_ready() const noexcept {
+            return false;
+        }
+
+        void
+        await_suspend(std::coroutine_handle<> handle) noexcept {
+            queue.post([handle] {
+                handle.resume();
+                return base::Error::success();
+            });
+        }
+
+        constexpr void
+        await_resume() const noexcept {
+        }
+    };
+
+    /**
+     * Continues the awaiting coroutine on the thread that processes the
+     * queue, e.g. Lavender::mainThreadQueue for work that needs the graphics
+     * context.
+     */
+    [[nodiscard]] inline FunctionQueueAwaiter
+    resumeOn(FunctionQueue &queue) noexcept {
+        return FunctionQueueAwaiter{queue};
+    }
+
+    /**
+     * Runs the coroutine to completion from synchronous code, processing the
+     * queue on the calling thread in the meantime, so that the coroutine can
+     * resume on it.
+     */
+    template<typename T>
+    [[nodiscard]] T
+    waitFor(base::Async<T> &&async, FunctionQueue &queue) noexcept {
+        std::atomic_bool finished{false};
+        std::optional<detail::WaitForResultType<T>> result{};
+        detail::awaitAndSignal(std::move(async), finished, result).detach();
+
+        while (!finished.load(std::memory_order_acquire)) {
+            queue.processAll().displayErrorMessageBox();
+            std::this_thread::yield();
+        }
+
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*result);
+    }
+
+} // namespace event
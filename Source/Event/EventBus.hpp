@@ -0,0 +1,236 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <concepts> // for std::copy_constructible
+#include <memory>
+#include <mutex>
+#include <utility> // for std::move
+#include <vector>
+
+#include <cstddef> // for std::size_t
+
+#include "Source/Base/Error.hpp"
+#include "Source/Base/InplaceFunction.hpp"
+#include "Source/Event/FunctionQueue.hpp"
+
+namespace event {
+
+    template<typename EventType>
+    class EventBus;
+
+    namespace detail {
+
+        template<typename EventType>
+        using BusHandler = base::InplaceFunction<base::Error(EventType &), 32>;
+
+        template<typename EventType>
+        struct Subscription {
+            [[nodiscard]]
+            Subscription(BusHandler<EventType> &&inHandler, FunctionQueue *inDeliveryQueue) noexcept
+                    : handler(std::move(inHandler))
+                    , deliveryQueue(inDeliveryQueue) {
+            }
+
+            // Invoked concurrently when the events are fired on multiple
+            // threads, so the callable has to be thread-safe then.
+            mutable BusHandler<EventType> handler;
+
+            // When not null, the event is copied and handled on the thread
+            // that processes this queue.
+            FunctionQueue *deliveryQueue;
+
+            std::atomic_bool active{true};
+        };
+
+    } // namespace detail
+
+    /**
+     * Identifies a subscription to an EventBus, with which it can be removed
+     * again.
+     */
+    template<typename EventType>
+    class SubscriptionToken {
+    public:
+        [[nodiscard]] SubscriptionToken() noexcept = default;
+
+        [[nodiscard]] inline explicit
+        operator bool() const noexcept {
+            return m_subscription != nullptr;
+        }
+
+    private:
+        friend class EventBus<EventType>;
+
+        [[nodiscard]] explicit
+        SubscriptionToken(std::shared_ptr<detail::Subscription<EventType>> subscription) noexcept
+                : m_subscription(std::move(subscription)) {
+        }
+
+        std::shared_ptr<detail::Subscription<EventType>> m_subscription{};
+    };
+
+    /**
+     * A multicast event that can be subscribed to and fired from any thread.
+     *
+     * The handlers are kept in an immutable list, which invoke() reads
+     * without locking. Subscribing publishes a new copy of the list (RCU),
+     * and unsubscribing only marks the subscription as inactive, which is
+     * O(1). The inactive subscriptions are left out of the next copy, which
+     * happens at the latest when half of the list is inactive.
+     *
+     * A handler that is being invoked when it is unsubscribed on another
+     * thread can still finish. Handlers that are subscribed with a
+     * FunctionQueue are delivered on the thread that processes that queue,
+     * where they are skipped when unsubscribed in the meantime.
+     */
+    template<typename EventType>
+    class EventBus {
+    public:
+        using FunctionType = base::Error(EventType &);
+        using HandlerType = detail::BusHandler<EventType>;
+        using Token = SubscriptionToken<EventType>;
+
+        [[nodiscard]]
+        EventBus() noexcept
+                : m_subscriptions(std::make_shared<const SubscriptionList>()) {
+        }
+
+        EventBus(EventBus &&) = delete;
+        EventBus(const EventBus &) = delete;
+
+        /**
+         * Subscribes for the lifetime of the bus.
+         */
+        inline void
+        operator+=(HandlerType handler) noexcept {
+            static_cast<void>(subscribe(std::move(handler)));
+        }
+
+        /**
+         * Fires the event. The handlers without a delivery queue are invoked
+         * on the calling thread, and the first error of those is returned.
+         */
+        [[nodiscard]] base::Error
+        invoke(EventType &event) noexcept {
+            m_firedEventsCount.fetch_add(1, std::memory_order_relaxed);
+
+            const auto subscriptions = m_subscriptions.load(std::memory_order_acquire);
+            for (const auto &subscription : *subscriptions) {
+                if (!subscription->active.load(std::memory_order_relaxed))
+                    continue;
+
+                if (subscription->deliveryQueue == nullptr) {
+                    if (auto error = subscription->handler(event))
+                        return error;
+                } else {
+                    deliver(subscription, event);
+                }
+            }
+
+            return base::Error::success();
+        }
+
+        [[nodiscard]] inline std::size_t
+        firedEventsCount() const noexcept {
+            return m_firedEventsCount.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * The amount of subscriptions in the published list, which includes
+         * the inactive subscriptions that haven't been left out yet.
+         */
+        [[nodiscard]] std::size_t
+        publishedSize() const noexcept {
+            return std::size(*m_subscriptions.load(std::memory_order_acquire));
+        }
+
+        [[nodiscard]] Token
+        subscribe(HandlerType handler) noexcept {
+            return add(std::make_shared<Subscription>(std::move(handler), nullptr));
+        }
+
+        /**
+         * Subscribes a handler that is invoked on the thread that processes
+         * the given queue, with a copy of the event. Its error is returned
+         * by FunctionQueue::processAll().
+         */
+        [[nodiscard]] Token
+        subscribe(HandlerType handler, FunctionQueue &deliveryQueue) noexcept
+                requires std::copy_constructible<EventType> {
+            return add(std::make_shared<Subscription>(std::move(handler), &deliveryQueue));
+        }
+
+        void
+        unsubscribe(Token &token) noexcept {
+            if (!token.m_subscription)
+                return;
+
+            if (std::exchange(token.m_subscription, nullptr)->active.exchange(false, std::memory_order_relaxed)) {
+                std::lock_guard guard{m_writeMutex};
+                ++m_inactiveCount;
+                if (m_inactiveCount * 2 > std::size(*m_subscriptions.load(std::memory_order_relaxed)))
+                    publish(nullptr);
+            }
+        }
+
+    private:
+        using Subscription = detail::Subscription<EventType>;
+        using SubscriptionList = std::vector<std::shared_ptr<Subscription>>;
+
+        [[nodiscard]] Token
+        add(std::shared_ptr<Subscription> &&subscription) noexcept {
+            std::lock_guard guard{m_writeMutex};
+            publish(subscription);
+            return Token{std::move(subscription)};
+        }
+
+        static void
+        deliver(const std::shared_ptr<Subscription> &subscription, const EventType &event) noexcept {
+            if constexpr (std::copy_constructible<EventType>) {
+                subscription->deliveryQueue->post([subscription, event = EventType(event)]() mutable {
+                    if (!subscription->active.load(std::memory_order_relaxed))
+                        return base::Error::success();
+                    return subscription->handler(event);
+                });
+            }
+        }
+
+        /**
+         * Publishes a copy of the list without the inactive subscriptions,
+         * with the given subscription added when it isn't null. The write
+         * mutex must be held.
+         */
+        void
+        publish(const std::shared_ptr<Subscription> &added) noexcept {
+            const auto current = m_subscriptions.load(std::memory_order_relaxed);
+
+            auto next = std::make_shared<SubscriptionList>();
+            next->reserve(std::size(*current) + 1);
+            for (const auto &subscription : *current) {
+                if (subscription->active.load(std::memory_order_relaxed))
+                    next->push_back(subscription);
+            }
+            if (added)
+                next->push_back(added);
+
+            m_inactiveCount = 0;
+            m_subscriptions.store(std::move(next), std::memory_order_release);
+        }
+
+        std::atomic<std::shared_ptr<const SubscriptionList>> m_subscriptions;
+        std::atomic_size_t m_firedEventsCount{0};
+
+        std::mutex m_writeMutex{};
+        std::size_t m_inactiveCount{0};
+    };
+
+} // namespace event
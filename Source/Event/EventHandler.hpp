@@ -9,10 +9,11 @@
 
 #pragma once
 
-#include <functional>
+#include <utility> // for std::move
 #include <vector>
 
 #include "Source/Base/Error.hpp"
+#include "Source/Base/InplaceFunction.hpp"
 
 namespace event {
 
@@ -20,17 +21,20 @@ namespace event {
     class EventHandler {
     public:
         using FunctionType = base::Error(EventType &);
-        using HandlerType = std::function<FunctionType>;
+
+        // Handlers capture a pointer or two, so they fit inline and invoking
+        // them never allocates.
+        using HandlerType = base::InplaceFunction<FunctionType, 32>;
 
         [[nodiscard]] inline
         EventHandler() noexcept = default;
         
         EventHandler(EventHandler &&) noexcept = default;
-        EventHandler(const EventHandler &) noexcept = default;
+        EventHandler(const EventHandler &) noexcept = delete;
 
         inline void 
         operator+=(HandlerType handler) noexcept {
-            m_handlers.push_back(std::forward<HandlerType>(handler));
+            m_handlers.push_back(std::move(handler));
         }
 
         [[nodiscard]] inline base::Error
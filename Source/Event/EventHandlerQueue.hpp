@@ -9,60 +9,205 @@
 
 #pragma once
 
-#include <functional>
-#include <queue>
+#include <algorithm> // for std::max, std::min
+#include <bit> // for std::bit_ceil
+#include <memory> // for std::allocator, std::construct_at, std::destroy_at
+#include <utility> // for std::move
 #include <vector>
 
+#include <cstddef> // for std::size_t
+
+#include "Source/Base/ArrayView.hpp"
 #include "Source/Base/Error.hpp"
+#include "Source/Base/InplaceFunction.hpp"
 
 namespace event {
 
-    template<typename EventType>
+    /**
+     * The default coalescing policy, which keeps every event.
+     *
+     * A policy has a static tryCoalesce(EventType &previous, const EventType &)
+     * that returns true when the second event was merged into the previous
+     * one, which is the most recent event that hasn't been dispatched yet.
+     */
+    struct NoCoalescing {
+        template<typename EventType>
+        [[nodiscard]] static constexpr bool
+        tryCoalesce(EventType &, const EventType &) noexcept {
+            return false;
+        }
+    };
+
+    /**
+     * Queues events until processAll() is called, which dispatches them in
+     * batches.
+     *
+     * The events are stored in a ring buffer with a fixed capacity, so
+     * queueing doesn't allocate. The events that don't fit are dropped, which
+     * droppedCount() reports. The CoalescingPolicy (see NoCoalescing) can merge
+     * an event into the previous one instead of queueing it, e.g. for mouse
+     * moves, which coalescedCount() reports.
+     *
+     * A batch is a contiguous range of the ring, which is handed to every
+     * handler in turn: batch handlers receive it as a whole, event handlers
+     * are invoked for every event of it. This means a handler sees all the
+     * events of a batch before the next handler sees the first one.
+     *
+     * The queue is not thread-safe.
+     */
+    template<typename EventType, typename CoalescingPolicy = NoCoalescing>
     class EventHandlerQueue {
     public:
+        static constexpr std::size_t s_defaultCapacity = 256;
+
         using FunctionType = base::Error(EventType &);
-        using HandlerType = std::function<FunctionType>;
+        using BatchFunctionType = base::Error(base::ArrayView<EventType>);
 
-        [[nodiscard]]
-        EventHandlerQueue() noexcept = default;
+        using HandlerType = base::InplaceFunction<FunctionType, 32>;
+        using BatchHandlerType = base::InplaceFunction<BatchFunctionType, 32>;
+
+        [[nodiscard]] explicit
+        EventHandlerQueue(std::size_t capacity = s_defaultCapacity) noexcept
+                : m_capacity(std::bit_ceil(std::max(capacity, std::size_t{1})))
+                , m_events(std::allocator<EventType>{}.allocate(m_capacity)) {
+        }
 
         EventHandlerQueue(EventHandlerQueue &&) noexcept = delete;
         EventHandlerQueue(const EventHandlerQueue &) noexcept = delete;
 
-        inline void 
+        ~EventHandlerQueue() noexcept {
+            while (m_head != m_tail)
+                std::destroy_at(&m_events[m_head++ & (m_capacity - 1)]);
+            std::allocator<EventType>{}.deallocate(m_events, m_capacity);
+        }
+
+        inline void
         operator+=(HandlerType handler) noexcept {
-            m_handlers.push_back(std::forward<HandlerType>(handler));
+            m_handlers.push_back(std::move(handler));
+        }
+
+        inline void
+        addBatchHandler(BatchHandlerType handler) noexcept {
+            m_batchHandlers.push_back(std::move(handler));
         }
 
-        void
+        /**
+         * Queues the event, merges it into the previous one, or drops it when
+         * the queue is full. Returns false when it was dropped.
+         */
+        bool
         invokeLater(EventType &&event) noexcept {
             ++m_firedEventsCount;
-            m_queue.push(std::move(event));
+
+            // Events that are being dispatched can't be changed anymore.
+            const auto undispatched = std::max(m_head, m_dispatchEnd);
+            if (m_tail != undispatched && CoalescingPolicy::tryCoalesce(m_events[(m_tail - 1) & (m_capacity - 1)], event)) {
+                ++m_coalescedCount;
+                return true;
+            }
+
+            if (m_tail - m_head == m_capacity) {
+                ++m_droppedCount;
+                return false;
+            }
+
+            std::construct_at(&m_events[m_tail & (m_capacity - 1)], std::move(event));
+            ++m_tail;
+            return true;
         }
 
+        /**
+         * Dispatches the queued events. When a handler fails, its error is
+         * returned, the rest of that batch is discarded and the events after
+         * it are left in the queue.
+         */
         [[nodiscard]] base::Error
         processAll() noexcept {
-            while (!m_queue.empty()) {
-                auto event = m_queue.front();
-                m_queue.pop();
-                for (auto& handler : m_handlers) {
-                    if (auto error = handler(event))
-                        return error;
-                }
+            // Events queued by the handlers wait for the next call.
+            const auto end = m_tail;
+            m_dispatchEnd = end;
+
+            while (m_head != end) {
+                const auto begin = m_head & (m_capacity - 1);
+                const auto size = std::min(end - m_head, m_capacity - begin);
+                base::ArrayView<EventType> batch{&m_events[begin], size};
+
+                auto error = dispatch(batch);
+
+                for (auto &event : batch)
+                    std::destroy_at(&event);
+                m_head += size;
+
+                if (error)
+                    return error;
             }
 
             return base::Error::success();
         }
 
-        [[nodiscard]] constexpr std::size_t 
+        [[nodiscard]] constexpr std::size_t
+        capacity() const noexcept {
+            return m_capacity;
+        }
+
+        /**
+         * The amount of events that were merged into a previous event.
+         */
+        [[nodiscard]] constexpr std::size_t
+        coalescedCount() const noexcept {
+            return m_coalescedCount;
+        }
+
+        /**
+         * The amount of events that were dropped because the queue was full.
+         */
+        [[nodiscard]] constexpr std::size_t
+        droppedCount() const noexcept {
+            return m_droppedCount;
+        }
+
+        [[nodiscard]] constexpr std::size_t
         firedEventsCount() const noexcept {
             return m_firedEventsCount;
         }
 
+        [[nodiscard]] constexpr std::size_t
+        size() const noexcept {
+            return m_tail - m_head;
+        }
+
     private:
+        [[nodiscard]] base::Error
+        dispatch(base::ArrayView<EventType> batch) noexcept {
+            for (auto &handler : m_batchHandlers) {
+                if (auto error = handler(batch))
+                    return error;
+            }
+
+            for (auto &handler : m_handlers) {
+                for (auto &event : batch) {
+                    if (auto error = handler(event))
+                        return error;
+                }
+            }
+
+            return base::Error::success();
+        }
+
         std::vector<HandlerType> m_handlers{};
-        std::queue<EventType> m_queue{};
+        std::vector<BatchHandlerType> m_batchHandlers{};
+
+        // The positions only ever increase, the index into the ring is the
+        // position modulo the capacity.
+        std::size_t m_capacity;
+        EventType *m_events;
+        std::size_t m_head{0};
+        std::size_t m_tail{0};
+        std::size_t m_dispatchEnd{0};
+
         std::size_t m_firedEventsCount{};
+        std::size_t m_coalescedCount{};
+        std::size_t m_droppedCount{};
     };
 
 } // namespace event
@@ -9,34 +9,128 @@
 
 #include "FunctionQueue.hpp"
 
+#include "Source/Base/ScopeGuard.hpp"
+
+#include <bit>
+#include <iterator>
+
+#include <cassert>
+
 namespace event {
 
-    FunctionQueue::FunctionQueue() noexcept = default;
-    FunctionQueue::~FunctionQueue() noexcept = default;
+    FunctionQueue::FunctionQueue(std::size_t capacity) noexcept
+            : m_slots(std::make_unique<Slot[]>(std::bit_ceil(capacity)))
+            , m_mask(std::bit_ceil(capacity) - 1)
+            , m_consumerThread(std::this_thread::get_id()) {
+        assert(capacity != 0);
 
-    void
-    FunctionQueue::post(std::function<base::Error()> &&function) noexcept {
-        std::lock_guard guard{ m_mutex };
-        m_functions.push(std::move(function));
+        for (std::size_t i = 0; i < this->capacity(); ++i)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
     }
 
+    FunctionQueue::~FunctionQueue() noexcept = default;
+
     base::Error
     FunctionQueue::processAll() noexcept {
-        std::queue<std::function<base::Error()>> queue;
+        m_consumerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+        // Functions that are posted by the functions themselves are left for
+        // the next call, otherwise a function that reposts itself would
+        // never let this return.
+        const auto end = m_enqueuePosition.load(std::memory_order_acquire);
+        const auto begin = m_dequeuePosition;
+
+        // The consumer thread only posts to the overflow when the ring is
+        // full or the overflow isn't empty, so these were posted after its
+        // functions in the ring.
+        std::size_t overflowCount{};
         {
-            std::lock_guard guard{ m_mutex };
-            m_functions.swap(queue);
+            std::lock_guard guard{m_overflowMutex};
+            overflowCount = std::size(m_overflow);
         }
 
-        while (!queue.empty()) {
-            if (const auto error = queue.front()())
+        base::ScopeGuard wakeProducers{[&] {
+            if (m_dequeuePosition != begin)
+                wakeWaitingProducers();
+        }};
+
+        while (m_dequeuePosition != end) {
+            auto &slot = m_slots[m_dequeuePosition & m_mask];
+
+            // The slot is claimed, but the producer is still constructing the
+            // function.
+            if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+                break;
+
+            auto error = slot.function();
+            slot.function.reset();
+            slot.sequence.store(m_dequeuePosition + capacity(), std::memory_order_release);
+            ++m_dequeuePosition;
+
+            if (error)
                 return error;
+        }
+
+        // Functions of the consumer thread may still be waiting behind the
+        // slot that is being constructed, so these have to go first.
+        if (m_dequeuePosition != end)
+            return base::Error::success();
 
-            queue.pop();
+        return processOverflow(overflowCount);
+    }
+
+    base::Error
+    FunctionQueue::processOverflow(std::size_t count) noexcept {
+        if (count == 0)
+            return base::Error::success();
+
+        std::vector<FunctionType> overflow{};
+        {
+            std::lock_guard guard{m_overflowMutex};
+            if (count == std::size(m_overflow)) {
+                overflow.swap(m_overflow);
+            } else {
+                const auto last = std::next(std::begin(m_overflow), static_cast<std::ptrdiff_t>(count));
+                overflow.assign(std::make_move_iterator(std::begin(m_overflow)), std::make_move_iterator(last));
+                m_overflow.erase(std::begin(m_overflow), last);
+            }
+        }
+
+        for (auto it = std::begin(overflow); it != std::end(overflow); ++it) {
+            if (auto error = (*it)()) {
+                std::lock_guard guard{m_overflowMutex};
+                m_overflow.insert(std::begin(m_overflow), std::make_move_iterator(std::next(it)),
+                                  std::make_move_iterator(std::end(overflow)));
+                return error;
+            }
         }
 
+        std::lock_guard guard{m_overflowMutex};
+        if (m_overflow.empty())
+            m_hasOverflow.store(false, std::memory_order_relaxed);
         return base::Error::success();
     }
 
+    void
+    FunctionQueue::waitForRoom() noexcept {
+        m_waitingProducers.fetch_add(1);
+
+        // The generation is loaded before checking whether the queue is
+        // full, so that processing in between makes the wait return
+        // immediately.
+        const auto generation = m_consumedGeneration.load();
+        const auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+        if (m_slots[position & m_mask].sequence.load(std::memory_order_acquire) < position)
+            m_consumedGeneration.wait(generation);
+
+        m_waitingProducers.fetch_sub(1);
+    }
+
+    void
+    FunctionQueue::wakeWaitingProducers() noexcept {
+        m_consumedGeneration.fetch_add(1);
+        if (m_waitingProducers.load() != 0)
+            m_consumedGeneration.notify_all();
+    }
 
 } // namespace event
@@ -9,29 +9,224 @@
 
 #pragma once
 
-#include <functional>
+#include <atomic>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef> // for std::size_t
 
 #include "Source/Base/Error.hpp"
+#include "Source/Base/InplaceFunction.hpp"
 
 namespace event {
 
+    /**
+     * A bounded multi-producer, single-consumer queue of functions that are
+     * to be run on a specific thread, e.g. the main thread.
+     *
+     * Posting is lock-free: producers claim a slot of the ring with a CAS and
+     * construct the function in it, without allocating when it's small. When
+     * the ring is full, tryPost() fails and post() blocks until the consumer
+     * has made room, except on the consumer thread itself, which can't wait for
+     * itself and uses an unbounded overflow list instead. fullCount() reports
+     * how often that happened.
+     *
+     * The functions of a single thread run in the order they were posted.
+     * For the consumer thread, this is kept by posting to the overflow list
+     * for as long as it isn't empty, which is processed after the ring.
+     *
+     * The consumer thread is the one that last called processAll(), or the
+     * one that constructed the queue before that.
+     */
     class FunctionQueue {
     public:
-        [[nodiscard]]
-        FunctionQueue() noexcept;
+        static constexpr std::size_t s_defaultCapacity = 1024;
+
+        // Closures larger than 40 bytes are rare enough to be allowed on the
+        // heap.
+        using FunctionType = base::InplaceFunction<base::Error(), 40, base::InplaceFunctionStorage::HEAP_FALLBACK>;
+
+        [[nodiscard]] explicit
+        FunctionQueue(std::size_t capacity = s_defaultCapacity) noexcept;
+
+        FunctionQueue(FunctionQueue &&) = delete;
+        FunctionQueue(const FunctionQueue &) = delete;
+
         ~FunctionQueue() noexcept;
 
+        [[nodiscard]] inline std::size_t
+        capacity() const noexcept {
+            return m_mask + 1;
+        }
+
+        /**
+         * The amount of times a post found the queue to be full.
+         */
+        [[nodiscard]] inline std::size_t
+        fullCount() const noexcept {
+            return m_fullCount.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Posts the function, waiting for room when the queue is full (see
+         * above).
+         */
+        template<typename Function>
         void
-        post(std::function<base::Error ()> &&) noexcept;
+        post(Function &&function) noexcept {
+            if (mustPostOverflow()) {
+                postOverflow(std::forward<Function>(function));
+                return;
+            }
+
+            if (tryClaimAndConstruct<Function>(function))
+                return;
+
+            m_fullCount.fetch_add(1, std::memory_order_relaxed);
+            if (isConsumerThread()) {
+                postOverflow(std::forward<Function>(function));
+                return;
+            }
 
+            while (!tryClaimAndConstruct<Function>(function))
+                waitForRoom();
+        }
+
+        /**
+         * Processes the functions that were posted before the call. When a
+         * function fails, its error is returned and the functions after it
+         * are left in the queue.
+         */
         [[nodiscard]] base::Error
         processAll() noexcept;
 
+        /**
+         * Returns false without waiting when the queue is full, in which case
+         * the function isn't moved from. On the consumer thread, this posts
+         * to a non-empty overflow list (see above).
+         */
+        template<typename Function>
+        [[nodiscard]] bool
+        tryPost(Function &&function) noexcept {
+            if (mustPostOverflow()) {
+                postOverflow(std::forward<Function>(function));
+                return true;
+            }
+
+            if (tryClaimAndConstruct<Function>(function))
+                return true;
+
+            m_fullCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
     private:
-        std::mutex m_mutex;
-        std::queue<std::function<base::Error()>> m_functions;
+        // Keeps the producer and consumer positions, and neighbouring slots,
+        // from sharing a cache line.
+        static constexpr std::size_t s_cacheLineSize = 64;
+
+        struct alignas(s_cacheLineSize) Slot {
+            // Equal to the position when the slot is free for the producer
+            // of that position, and one past it when the function is ready
+            // for the consumer.
+            std::atomic_size_t sequence{};
+            FunctionType function{};
+        };
+
+        /**
+         * Forwards the function only when a slot was claimed. Function is
+         * the deduced type of the forwarding reference of the caller.
+         */
+        template<typename Function>
+        [[nodiscard]] bool
+        tryClaimAndConstruct(std::remove_reference_t<Function> &function) noexcept {
+            auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+            while (true) {
+                auto &slot = m_slots[position & m_mask];
+                const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+                if (sequence == position) {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        slot.function = std::forward<Function>(function);
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (sequence < position) {
+                    // The consumer hasn't freed this slot since the previous
+                    // lap.
+                    return false;
+                } else {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        [[nodiscard]] inline bool
+        isConsumerThread() const noexcept {
+            return m_consumerThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+        }
+
+        /**
+         * Whether the function has to go after the functions in the overflow
+         * list, which is only the case on the consumer thread.
+         */
+        [[nodiscard]] inline bool
+        mustPostOverflow() const noexcept {
+            return m_hasOverflow.load(std::memory_order_relaxed) && isConsumerThread();
+        }
+
+        template<typename Function>
+        void
+        postOverflow(Function &&function) noexcept {
+            FunctionType queuedFunction{std::forward<Function>(function)};
+
+            std::lock_guard guard{m_overflowMutex};
+            m_overflow.push_back(std::move(queuedFunction));
+            m_hasOverflow.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * Processes the first count functions of the overflow list.
+         */
+        [[nodiscard]] base::Error
+        processOverflow(std::size_t count) noexcept;
+
+        /**
+         * Blocks until the consumer has processed functions, when the queue
+         * is (still) full.
+         */
+        void
+        waitForRoom() noexcept;
+
+        void
+        wakeWaitingProducers() noexcept;
+
+        std::unique_ptr<Slot[]> m_slots;
+        std::size_t m_mask;
+
+        alignas(s_cacheLineSize) std::atomic_size_t m_enqueuePosition{0};
+        alignas(s_cacheLineSize) std::size_t m_dequeuePosition{0};
+        std::atomic<std::thread::id> m_consumerThread;
+
+        // Incremented by the consumer after processing, for producers that
+        // wait for room.
+        std::atomic_size_t m_consumedGeneration{0};
+        std::atomic_size_t m_waitingProducers{0};
+
+        std::atomic_size_t m_fullCount{0};
+
+        std::mutex m_overflowMutex{};
+        std::vector<FunctionType> m_overflow{};
+
+        // Stays set whilst the overflow is being processed, until it is
+        // empty, so that the functions posted in the meantime are ordered
+        // after the remaining ones.
+        std::atomic_bool m_hasOverflow{false};
     };
 
 } // namespace event
@@ -13,6 +13,11 @@ GraphicsAPI::loadGLTFScene([[maybe_unused]] std::string_view fileName) noexcept
     return {nullptr};
 }
 
+base::Async<base::ErrorOr<std::unique_ptr<ecs::Scene>>>
+GraphicsAPI::loadGLTFSceneAsync(std::string fileName, [[maybe_unused]] event::FunctionQueue &mainThreadQueue) noexcept {
+    co_return loadGLTFScene(fileName);
+}
+
 #ifdef LAVENDER_BUILD_DEBUG
 void
 GraphicsAPI::onDebugKey(input::KeyboardUpdate) noexcept {
@@ -13,17 +13,23 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 
 #include <cstdint>
 
+#include "Source/Base/Async.hpp"
 #include "Source/Base/Debug.hpp"
 #include "Source/Base/ErrorOr.hpp"
 #include "Source/ECS/Forward.hpp"
 #include "Source/Event/EventHandler.hpp"
+#include "Source/Event/FunctionQueue.hpp"
+#include "Source/Math/Matrix4x4.hpp"
 #include "Source/Math/Size2D.hpp"
 #include "Source/Input/Forward.hpp"
 #include "Source/Input/KeyboardUpdate.hpp"
 #include "Source/Interface/Forward.hpp"
+#include "Source/Resources/DrawList.hpp"
 #include "Source/Resources/ModelDescriptor.hpp"
 #include "Source/Resources/ModelGeometry.hpp"
 #include "Source/Resources/ResourceLocateEvent.hpp"
@@ -96,6 +102,14 @@ public:
     [[nodiscard]] virtual base::ErrorOr<std::unique_ptr<ecs::Scene>>
     loadGLTFScene(std::string_view fileName) noexcept;
 
+    /**
+     * Loads the scene without blocking the calling thread. The parts that
+     * need the graphics context are run on the thread that processes the
+     * given queue, which is also where the coroutine finishes.
+     */
+    [[nodiscard]] virtual base::Async<base::ErrorOr<std::unique_ptr<ecs::Scene>>>
+    loadGLTFSceneAsync(std::string fileName, event::FunctionQueue &mainThreadQueue) noexcept;
+
 #ifdef LAVENDER_BUILD_DEBUG
     virtual void
     onDebugKey(input::KeyboardUpdate) noexcept;
@@ -104,8 +118,37 @@ public:
     virtual inline void
     onResize(math::Size2D<std::uint32_t>) noexcept {}
 
+    /**
+     * The projection of the camera, see
+     * math::createPerspectiveProjectionMatrix(), with which the entities
+     * outside of the view are culled. Empty when it isn't known.
+     */
+    [[nodiscard]] virtual inline std::optional<math::Matrix4x4<float>>
+    projectionMatrix() const noexcept {
+        return std::nullopt;
+    }
+
+    /**
+     * The height in pixels of an object that is one unit high at a distance
+     * of one unit from the camera, with which distances in the world can be
+     * projected to the screen, e.g. to select levels of detail. Zero when it
+     * isn't known.
+     */
+    [[nodiscard]] virtual inline float
+    projectionScale() const noexcept {
+        return 0.0f;
+    }
+
     virtual void
-    renderEntities() = 0;
+    renderEntities(const resources::DrawList &) = 0;
+
+    /**
+     * Releases the models that aren't used by an entity of the scene
+     * anymore, e.g. after the scene was cleared, together with their
+     * geometry. The resources that are left over may be compacted.
+     */
+    virtual inline void
+    unloadUnusedModels() noexcept {}
 
     /**
      * Returns an immutable reference to the descriptor.
@@ -30,7 +30,10 @@ namespace io {
         REGISTER_ERROR(CFILE_TELL_ERROR) \
         \
         ANNOUNCE_SECTION("POSIX Specific Errors") \
-        REGISTER_ERROR(POSIX_STAT_ERROR)
+        REGISTER_ERROR(POSIX_STAT_ERROR) \
+        \
+        ANNOUNCE_SECTION("Memory Mapping Errors") \
+        REGISTER_ERROR(MAPPING_FAILED)
 
 #define REGISTER_ERROR(error) error,
         IO_ITERATE_ERRORS(REGISTER_ERROR, IO_IGNORE_SECTION_ANNOUNCEMENTS)
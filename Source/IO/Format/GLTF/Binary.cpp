@@ -0,0 +1,89 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#define FMT_HEADER_ONLY
+
+#include "Binary.hpp"
+
+#include <cstdint>
+
+#include <fmt/core.h>
+
+namespace io::format::gltf {
+
+    constexpr std::uint32_t BinaryMagic = 0x46546C67; // "glTF"
+    constexpr std::uint32_t BinaryVersion = 2;
+    constexpr std::uint32_t ChunkTypeJSON = 0x4E4F534A; // "JSON"
+    constexpr std::uint32_t ChunkTypeBIN = 0x004E4942; // "BIN\0"
+
+    constexpr std::size_t HeaderSize = 12;
+    constexpr std::size_t ChunkHeaderSize = 8;
+
+    // The fields are little endian, regardless of the platform.
+    [[nodiscard]] static std::uint32_t
+    readUInt32(std::span<const std::byte> data, std::size_t offset) noexcept {
+        return static_cast<std::uint32_t>(data[offset])
+             | static_cast<std::uint32_t>(data[offset + 1]) << 8
+             | static_cast<std::uint32_t>(data[offset + 2]) << 16
+             | static_cast<std::uint32_t>(data[offset + 3]) << 24;
+    }
+
+    bool
+    isBinaryContainer(std::span<const std::byte> data) noexcept {
+        return std::size(data) >= 4 && readUInt32(data, 0) == BinaryMagic;
+    }
+
+    base::ErrorOr<BinaryContainer>
+    parseBinaryContainer(std::span<const std::byte> data) noexcept {
+        base::FunctionErrorGenerator errors{"IOGLTFLibrary", "Binary"};
+
+        if (std::size(data) < HeaderSize || !isBinaryContainer(data))
+            return errors.error("Parse GLB header", "Not a binary glTF file");
+
+        if (const auto version = readUInt32(data, 4); version != BinaryVersion)
+            return errors.error("Parse GLB header", fmt::format("Unsupported version: {}", version));
+
+        const std::size_t length = readUInt32(data, 8);
+        if (length > std::size(data))
+            return errors.error("Parse GLB header", fmt::format("File is truncated: {} of {} bytes", std::size(data), length));
+        data = data.first(length);
+
+        BinaryContainer container{};
+        std::size_t offset = HeaderSize;
+        for (std::size_t chunkIndex = 0; offset < length; ++chunkIndex) {
+            if (length - offset < ChunkHeaderSize)
+                return errors.error("Parse GLB chunk", "Chunk header is truncated");
+
+            const std::size_t chunkLength = readUInt32(data, offset);
+            const auto chunkType = readUInt32(data, offset + 4);
+            offset += ChunkHeaderSize;
+
+            if (chunkLength > length - offset)
+                return errors.error("Parse GLB chunk", "Chunk extends past the end of the file");
+            const auto chunk = data.subspan(offset, chunkLength);
+            offset += chunkLength;
+
+            // The JSON chunk comes first, optionally followed by a single
+            // BIN chunk. Chunks of other types are ignored.
+            if (chunkIndex == 0) {
+                if (chunkType != ChunkTypeJSON)
+                    return errors.error("Parse GLB chunk", "The first chunk isn't a JSON chunk");
+                container.json = {reinterpret_cast<const char *>(chunk.data()), chunkLength};
+            } else if (chunkIndex == 1 && chunkType == ChunkTypeBIN) {
+                container.binary = chunk;
+            }
+        }
+
+        if (std::empty(container.json))
+            return errors.error("Parse GLB chunk", "File has no JSON chunk");
+
+        return container;
+    }
+
+} // namespace io::format::gltf
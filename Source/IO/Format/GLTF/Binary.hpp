@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <span>
+#include <string_view>
+
+#include <cstddef> // for std::byte
+
+#include "Source/Base/ErrorOr.hpp"
+
+namespace io::format::gltf {
+
+    /**
+     * The chunks of a binary glTF (GLB) file, as views into the file.
+     *
+     * https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#binary-gltf-layout
+     */
+    struct BinaryContainer {
+        std::string_view json{};
+
+        // The contents of the buffer without a URI, which might be followed
+        // by up to three bytes of padding. Empty when the file has no BIN
+        // chunk.
+        std::span<const std::byte> binary{};
+    };
+
+    /**
+     * Checks whether the data starts with the magic of a GLB file, as
+     * opposed to the JSON of a .gltf file.
+     */
+    [[nodiscard]] bool
+    isBinaryContainer(std::span<const std::byte> data) noexcept;
+
+    [[nodiscard]] base::ErrorOr<BinaryContainer>
+    parseBinaryContainer(std::span<const std::byte> data) noexcept;
+
+} // namespace io::format::gltf
@@ -11,20 +11,11 @@
 
 #include <sstream>
 
-#include <nlohmann/json.hpp>
-
 namespace io::format::gltf {
 
     base::ErrorOr<ComponentType>
-    gltf::convertComponentType(const nlohmann::json &json) noexcept {
+    convertComponentType(std::uint64_t value) noexcept {
         base::FunctionErrorGenerator errors{"IOFormatLibrary", "IOGLTFLibrary"};
-        if (!json.is_number())
-            return errors.error("Convert ComponentType", "JSON-type isn't number");
-
-        if (!json.is_number_unsigned())
-            return errors.error("Convert ComponentType", "JSON-type is number, but isn't an unsigned integer");
-
-        auto value = json.get<std::size_t>();
         switch (value) {
 #define CHECK_TYPE(enumeration, value, _dataType) case value: return ComponentType::enumeration;
             LAVENDER_IO_FORMAT_ITERATE_GLTF_COMPONENT_TYPES(CHECK_TYPE)
@@ -12,8 +12,7 @@
 #include <string_view>
 
 #include <cstddef> // for std::size_t
-
-#include <nlohmann/json.hpp>
+#include <cstdint>
 
 #include "Source/Base/ErrorOr.hpp"
 
@@ -41,7 +40,7 @@ namespace io::format::gltf {
     }
     
     [[nodiscard]] base::ErrorOr<ComponentType>
-    convertComponentType(const nlohmann::json& json) noexcept;
+    convertComponentType(std::uint64_t value) noexcept;
 
     [[nodiscard]] constexpr std::size_t
     componentTypeGetDataTypeSize(ComponentType componentType) {
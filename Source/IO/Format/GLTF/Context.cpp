@@ -11,8 +11,9 @@
 
 #include "Context.hpp"
 
+#include <filesystem>
+
 #include <fmt/core.h>
-#include <nlohmann/json.hpp>
 
 #include "Source/GraphicsAPI.hpp"
 #include "Source/IO/Format/GLTF/ResourceInfo.hpp"
@@ -21,11 +22,10 @@
 
 namespace io::format::gltf {
 
-    Context::Context(GraphicsAPI &graphicsAPI, std::string_view fileName, nlohmann::json &&json, std::vector<std::string> &&buffers) noexcept
+    Context::Context(GraphicsAPI &graphicsAPI, std::string_view fileName, Source &&source) noexcept
             : m_graphicsAPI(graphicsAPI)
             , m_fileName(fileName)
-            , m_json(std::move(json))
-            , m_buffers(std::move(buffers)) {
+            , m_source(std::move(source)) {
     }
 
     Context::~Context() noexcept = default;
@@ -83,24 +83,24 @@ namespace io::format::gltf {
     }
 
     base::ErrorOr<ResourceInfo>
-    Context::resolveResourceInfo(std::size_t bufferViewIndex, const nlohmann::json &accessor) noexcept {
+    Context::resolveResourceInfo(std::size_t bufferViewIndex) noexcept {
         base::FunctionErrorGenerator errors{ "OpenGLCore", "GLTFLoader" };
 
-        const auto &bufferView = m_json["bufferViews"][bufferViewIndex];
-
-        const auto bufferIndex = bufferView["buffer"].get<std::size_t>();
-        const auto &buffer = m_buffers[bufferIndex];
+        const auto &bufferView = m_source.document.bufferViews()[bufferViewIndex];
 
-        const auto byteLength = bufferView["byteLength"].get<std::size_t>();
-        const auto byteOffset = bufferView["byteOffset"].get<std::size_t>();
+        const std::size_t bufferIndex = bufferView.buffer;
+        const auto byteLength = bufferView.byteLength;
+        const auto byteOffset = bufferView.byteOffset;
 
-        if (bufferIndex >= std::size(m_buffers)) {
+        if (bufferIndex >= std::size(m_source.buffers)) {
 #ifndef NDEBUG
-            std::printf("GLTFLoader: resolveResourceInfo: bufferIndex(%zu) >= buffersSize(%zu)\n", bufferIndex, std::size(m_buffers));
+            std::printf("GLTFLoader: resolveResourceInfo: bufferIndex(%zu) >= buffersSize(%zu)\n", bufferIndex, std::size(m_source.buffers));
 #endif // NDEBUG
             return errors.error("Resolve ResourceInfo", "bufferIndex >= bufferSize");
         }
 
+        const auto buffer = m_source.buffers[bufferIndex];
+
 //        if (byteOffset < 0 || byteLength <= 0) {
 //#ifndef NDEBUG
 //#endif // NDEBUG
@@ -117,12 +117,11 @@ namespace io::format::gltf {
         }
 
         return ResourceInfo{
-            accessor,
             buffer,
             bufferView,
             byteOffset,
             byteLength,
-            base::ArrayView{buffer.data() + byteOffset, static_cast<std::size_t>(byteLength)}
+            base::ArrayView{reinterpret_cast<const char *>(buffer.data() + byteOffset), static_cast<std::size_t>(byteLength)}
         };
     }
 
@@ -10,13 +10,15 @@
 #pragma once
 
 #include <memory>
-#include <string>
+#include <span>
 #include <string_view>
 #include <vector>
 
-#include <nlohmann/json.hpp>
+#include <cstddef> // for std::byte
 
 #include "Source/Base/ErrorOr.hpp"
+#include "Source/IO/Format/GLTF/Document.hpp"
+#include "Source/IO/Format/GLTF/Source.hpp"
 #include "Source/Resources/MaterialDescriptor.hpp"
 #include "Source/Resources/ResourceLocation.hpp"
 
@@ -28,18 +30,23 @@ namespace io::format::gltf {
 
     struct Context {
         [[nodiscard]]
-        Context(GraphicsAPI &graphicsAPI, std::string_view fileName, nlohmann::json &&json, std::vector<std::string> &&buffers) noexcept;
+        Context(GraphicsAPI &graphicsAPI, std::string_view fileName, Source &&source) noexcept;
 
         ~Context() noexcept;
 
-        [[nodiscard]] constexpr const std::vector<std::string> &
+        [[nodiscard]] std::span<const std::span<const std::byte>>
         buffers() const noexcept {
-            return m_buffers;
+            return m_source.buffers;
         }
 
         [[nodiscard]] base::ErrorOr<resources::MaterialDescriptor *>
         createMaterialDescriptor() noexcept;
 
+        [[nodiscard]] constexpr const Document &
+        document() const noexcept {
+            return m_source.document;
+        }
+
         [[nodiscard]] constexpr std::string_view
         fileName() const noexcept {
             return m_fileName;
@@ -50,11 +57,6 @@ namespace io::format::gltf {
             return m_graphicsAPI;
         }
 
-        [[nodiscard]] constexpr const nlohmann::json &
-        json() const noexcept {
-            return m_json;
-        }
-
         [[nodiscard]] base::ErrorOr<std::unique_ptr<resources::ResourceLocation>>
         loadURI(std::string_view) noexcept;
 
@@ -64,14 +66,13 @@ namespace io::format::gltf {
         }
 
         [[nodiscard]] base::ErrorOr<ResourceInfo>
-        resolveResourceInfo(std::size_t bufferViewIndex, const nlohmann::json& accessor) noexcept;
+        resolveResourceInfo(std::size_t bufferViewIndex) noexcept;
 
     private:
         GraphicsAPI &m_graphicsAPI;
 
         std::string_view m_fileName{};
-        nlohmann::json m_json;
-        std::vector<std::string> m_buffers{};
+        Source m_source;
         std::vector<resources::MaterialDescriptor *> m_materials{};
     };
     
@@ -0,0 +1,714 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#define FMT_HEADER_ONLY
+
+#include "Document.hpp"
+
+#include <fmt/core.h>
+
+#include "Source/IO/Format/JSON/Reader.hpp"
+
+namespace io::format::gltf {
+
+    class DocumentParser {
+    public:
+        [[nodiscard]] inline explicit
+        DocumentParser(Document &document, std::string_view text) noexcept
+                : m_document(document)
+                , m_reader(text) {
+        }
+
+        [[nodiscard]] base::Error
+        parse() noexcept {
+            if (!parseRoot()) {
+                if (m_error)
+                    return m_error;
+                return base::Error{"IOGLTFLibrary", "Document", "Parse JSON",
+                                   fmt::format("{} at offset {}", m_reader.error(), m_reader.errorOffset())};
+            }
+
+            m_document.m_decodedStrings = m_reader.takeDecodedStrings();
+            return base::Error::success();
+        }
+
+    private:
+        template<typename T>
+        using ElementParser = bool (DocumentParser::*)(T &);
+
+        [[nodiscard]] bool
+        fail(base::Error &&error) noexcept {
+            m_error = std::move(error);
+            return m_reader.fail("Invalid document");
+        }
+
+        template<typename T>
+        [[nodiscard]] bool
+        parseArray(std::vector<T> &elements, ElementParser<T> parseElement) noexcept {
+            if (!m_reader.beginArray())
+                return false;
+
+            while (m_reader.nextElement()) {
+                if (!(this->*parseElement)(elements.emplace_back()))
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseAccessor(Accessor &accessor) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "bufferView") {
+                    succeeded = readIndex(accessor.bufferView);
+                } else if (key == "byteOffset") {
+                    succeeded = m_reader.readUnsigned(accessor.byteOffset);
+                } else if (key == "componentType") {
+                    std::uint64_t value{};
+                    succeeded = m_reader.readUnsigned(value);
+                    if (succeeded) {
+                        auto componentType = convertComponentType(value);
+                        if (componentType.failed())
+                            return fail(std::move(componentType.error()));
+                        accessor.componentType = componentType.get();
+                    }
+                } else if (key == "count") {
+                    succeeded = m_reader.readUnsigned(accessor.count);
+                } else if (key == "normalized") {
+                    succeeded = m_reader.readBool(accessor.normalized);
+                } else if (key == "type") {
+                    succeeded = readAccessorType(accessor.type);
+                } else {
+                    succeeded = m_reader.skipValue();
+                }
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseBuffer(Buffer &buffer) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "byteLength")
+                    succeeded = m_reader.readUnsigned(buffer.byteLength);
+                else if (key == "uri")
+                    succeeded = m_reader.readString(buffer.uri);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseBufferView(BufferView &bufferView) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "buffer")
+                    succeeded = readIndex(bufferView.buffer);
+                else if (key == "byteLength")
+                    succeeded = m_reader.readUnsigned(bufferView.byteLength);
+                else if (key == "byteOffset")
+                    succeeded = m_reader.readUnsigned(bufferView.byteOffset);
+                else if (key == "byteStride")
+                    succeeded = m_reader.readUnsigned(bufferView.byteStride);
+                else if (key == "target")
+                    succeeded = m_reader.readUnsigned(bufferView.target);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseChildren(Node &node) noexcept {
+            node.firstChild = static_cast<std::uint32_t>(std::size(m_document.m_children));
+            if (!parseArray(m_document.m_children, &DocumentParser::readIndex))
+                return false;
+            node.childCount = static_cast<std::uint32_t>(std::size(m_document.m_children)) - node.firstChild;
+            return true;
+        }
+
+        /**
+         * The "extensions" object of the root.
+         */
+        [[nodiscard]] bool
+        parseExtensions() noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                if (key != "KHR_lights_punctual") {
+                    if (!m_reader.skipValue())
+                        return false;
+                    continue;
+                }
+
+                if (!m_reader.beginObject())
+                    return false;
+                while (m_reader.nextKey(key)) {
+                    const auto succeeded = key == "lights"
+                            ? parseArray(m_document.m_lights, &DocumentParser::parseLight)
+                            : m_reader.skipValue();
+                    if (!succeeded)
+                        return false;
+                }
+                if (m_reader.failed())
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseImage(Image &image) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "bufferView")
+                    succeeded = readIndex(image.bufferView);
+                else if (key == "mimeType")
+                    succeeded = m_reader.readString(image.mimeType);
+                else if (key == "name")
+                    succeeded = m_reader.readString(image.name);
+                else if (key == "uri")
+                    succeeded = m_reader.readString(image.uri);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseLight(Light &light) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "color")
+                    succeeded = readFloats(&light.color.x(), 3);
+                else if (key == "intensity")
+                    succeeded = m_reader.readFloat(light.intensity);
+                else if (key == "name")
+                    succeeded = m_reader.readString(light.name);
+                else if (key == "range")
+                    succeeded = m_reader.readFloat(light.range);
+                else if (key == "type")
+                    succeeded = m_reader.readString(light.type);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+
+            if (m_reader.failed())
+                return false;
+            if (light.type.empty())
+                return m_reader.fail("KHR_lights_punctual light without a type");
+            return true;
+        }
+
+        [[nodiscard]] bool
+        parseMaterial(Material &material) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "name") {
+                    succeeded = m_reader.readString(material.name);
+                } else if (key == "normalTexture") {
+                    succeeded = parseTextureInfo(material.normalTexture);
+                } else if (key == "pbrMetallicRoughness") {
+                    if (!m_reader.beginObject())
+                        return false;
+                    while (m_reader.nextKey(key)) {
+                        const auto succeededInner = key == "baseColorTexture"
+                                ? parseTextureInfo(material.baseColorTexture)
+                                : m_reader.skipValue();
+                        if (!succeededInner)
+                            return false;
+                    }
+                    succeeded = !m_reader.failed();
+                } else {
+                    succeeded = m_reader.skipValue();
+                }
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseMesh(Mesh &mesh) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "name") {
+                    succeeded = m_reader.readString(mesh.name);
+                } else if (key == "primitives") {
+                    mesh.firstPrimitive = static_cast<std::uint32_t>(std::size(m_document.m_primitives));
+                    succeeded = parseArray(m_document.m_primitives, &DocumentParser::parsePrimitive);
+                    mesh.primitiveCount = static_cast<std::uint32_t>(std::size(m_document.m_primitives)) - mesh.firstPrimitive;
+                } else {
+                    succeeded = m_reader.skipValue();
+                }
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseNode(Node &node) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "children") {
+                    succeeded = parseChildren(node);
+                } else if (key == "extensions") {
+                    succeeded = parseNodeExtensions(node);
+                } else if (key == "mesh") {
+                    succeeded = readIndex(node.mesh);
+                } else if (key == "name") {
+                    succeeded = m_reader.readString(node.name);
+                } else if (key == "rotation") {
+                    // In x, y, z, w order, like math::Quaternion.
+                    float rotation[4];
+                    succeeded = readFloats(rotation, 4);
+                    node.rotation = math::Quaternion<float>{rotation[0], rotation[1], rotation[2], rotation[3]}.normalizeCopy();
+                } else if (key == "scale") {
+                    succeeded = readFloats(&node.scale.x(), 3);
+                } else if (key == "skin") {
+                    succeeded = readIndex(node.skin);
+                } else if (key == "translation") {
+                    succeeded = readFloats(&node.translation.x(), 3);
+                } else {
+                    succeeded = m_reader.skipValue();
+                }
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseNodeExtensions(Node &node) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                if (key != "KHR_lights_punctual") {
+                    if (!m_reader.skipValue())
+                        return false;
+                    continue;
+                }
+
+                if (!m_reader.beginObject())
+                    return false;
+                while (m_reader.nextKey(key)) {
+                    const auto succeeded = key == "light" ? readIndex(node.light) : m_reader.skipValue();
+                    if (!succeeded)
+                        return false;
+                }
+                if (m_reader.failed())
+                    return false;
+                if (node.light == NoIndex)
+                    return m_reader.fail("KHR_lights_punctual without a light");
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parsePrimitive(Primitive &primitive) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "attributes")
+                    succeeded = parsePrimitiveAttributes(primitive);
+                else if (key == "indices")
+                    succeeded = readIndex(primitive.indices);
+                else if (key == "material")
+                    succeeded = readIndex(primitive.material);
+                else if (key == "mode")
+                    succeeded = m_reader.readUnsigned(primitive.mode);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parsePrimitiveAttributes(Primitive &primitive) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "POSITION")
+                    succeeded = readIndex(primitive.position);
+                else if (key == "NORMAL")
+                    succeeded = readIndex(primitive.normal);
+                else if (key == "TEXCOORD_0")
+                    succeeded = readIndex(primitive.textureCoordinates);
+                else if (key == "TANGENT")
+                    succeeded = readIndex(primitive.tangent);
+                else if (key == "JOINTS_0")
+                    succeeded = readIndex(primitive.joints);
+                else if (key == "WEIGHTS_0")
+                    succeeded = readIndex(primitive.weights);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseRoot() noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "accessors")
+                    succeeded = parseArray(m_document.m_accessors, &DocumentParser::parseAccessor);
+                else if (key == "bufferViews")
+                    succeeded = parseArray(m_document.m_bufferViews, &DocumentParser::parseBufferView);
+                else if (key == "buffers")
+                    succeeded = parseArray(m_document.m_buffers, &DocumentParser::parseBuffer);
+                else if (key == "extensions")
+                    succeeded = parseExtensions();
+                else if (key == "images")
+                    succeeded = parseArray(m_document.m_images, &DocumentParser::parseImage);
+                else if (key == "materials")
+                    succeeded = parseArray(m_document.m_materials, &DocumentParser::parseMaterial);
+                else if (key == "meshes")
+                    succeeded = parseArray(m_document.m_meshes, &DocumentParser::parseMesh);
+                else if (key == "nodes")
+                    succeeded = parseArray(m_document.m_nodes, &DocumentParser::parseNode);
+                else if (key == "samplers")
+                    succeeded = parseArray(m_document.m_samplers, &DocumentParser::parseSampler);
+                else if (key == "textures")
+                    succeeded = parseArray(m_document.m_textures, &DocumentParser::parseTexture);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed() && m_reader.finish();
+        }
+
+        [[nodiscard]] bool
+        parseSampler(Sampler &sampler) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "magFilter")
+                    succeeded = m_reader.readUnsigned(sampler.magFilter);
+                else if (key == "minFilter")
+                    succeeded = m_reader.readUnsigned(sampler.minFilter);
+                else if (key == "wrapS")
+                    succeeded = m_reader.readUnsigned(sampler.wrapS);
+                else if (key == "wrapT")
+                    succeeded = m_reader.readUnsigned(sampler.wrapT);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        parseTexture(Texture &texture) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                bool succeeded;
+                if (key == "sampler")
+                    succeeded = readIndex(texture.sampler);
+                else if (key == "source")
+                    succeeded = readIndex(texture.source);
+                else
+                    succeeded = m_reader.skipValue();
+
+                if (!succeeded)
+                    return false;
+            }
+            return !m_reader.failed();
+        }
+
+        // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-textureinfo
+        [[nodiscard]] bool
+        parseTextureInfo(std::uint32_t &textureIndex) noexcept {
+            if (!m_reader.beginObject())
+                return false;
+
+            std::string_view key;
+            while (m_reader.nextKey(key)) {
+                const auto succeeded = key == "index" ? readIndex(textureIndex) : m_reader.skipValue();
+                if (!succeeded)
+                    return false;
+            }
+
+            if (m_reader.failed())
+                return false;
+            if (textureIndex == NoIndex)
+                return m_reader.fail("textureInfo.index is missing, which is required by the glTF 2.0 specification");
+            return true;
+        }
+
+        [[nodiscard]] bool
+        readAccessorType(AccessorType &type) noexcept {
+            std::string_view value;
+            if (!m_reader.readString(value))
+                return false;
+
+            if (value == "SCALAR")
+                type = AccessorType::SCALAR;
+            else if (value == "VEC2")
+                type = AccessorType::VEC2;
+            else if (value == "VEC3")
+                type = AccessorType::VEC3;
+            else if (value == "VEC4")
+                type = AccessorType::VEC4;
+            else if (value == "MAT2")
+                type = AccessorType::MAT2;
+            else if (value == "MAT3")
+                type = AccessorType::MAT3;
+            else if (value == "MAT4")
+                type = AccessorType::MAT4;
+            else
+                return m_reader.fail("Unknown accessor.type");
+            return true;
+        }
+
+        /**
+         * Reads an array of exactly the given amount of numbers.
+         */
+        [[nodiscard]] bool
+        readFloats(float *values, std::size_t count) noexcept {
+            if (!m_reader.beginArray())
+                return false;
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!m_reader.nextElement())
+                    return m_reader.fail("Too few elements in the array");
+                if (!m_reader.readFloat(values[i]))
+                    return false;
+            }
+
+            if (m_reader.nextElement())
+                return m_reader.fail("Too many elements in the array");
+            return !m_reader.failed();
+        }
+
+        [[nodiscard]] bool
+        readIndex(std::uint32_t &index) noexcept {
+            if (!m_reader.readUnsigned(index))
+                return false;
+            if (index == NoIndex)
+                return m_reader.fail("Index out of range");
+            return true;
+        }
+
+        Document &m_document;
+        json::Reader m_reader;
+        base::Error m_error{base::Error::success()};
+    };
+
+    /**
+     * Checks that the nodes form disjoint strict trees: every node has at
+     * most one parent, and no node is its own ancestor.
+     *
+     * https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#nodes-and-hierarchy
+     */
+    [[nodiscard]] static base::Error
+    validateHierarchy(const Document &document) noexcept {
+        base::FunctionErrorGenerator errors{"IOGLTFLibrary", "Document"};
+        const auto nodes = document.nodes();
+
+        std::vector<std::uint8_t> hasParent(std::size(nodes));
+        for (const auto &node : nodes) {
+            for (const auto child : document.children(node)) {
+                if (hasParent[child])
+                    return errors.error("Validate document", "node is the child of multiple nodes");
+                hasParent[child] = true;
+            }
+        }
+
+        // With a single parent per node, the nodes that can't be reached
+        // from a root are part of, or below, a cycle.
+        std::vector<std::uint32_t> pending{};
+        for (std::uint32_t node = 0; node < std::size(nodes); ++node) {
+            if (!hasParent[node])
+                pending.push_back(node);
+        }
+
+        std::size_t reachedCount{0};
+        while (!pending.empty()) {
+            const auto node = pending.back();
+            pending.pop_back();
+            ++reachedCount;
+
+            const auto children = document.children(nodes[node]);
+            pending.insert(std::end(pending), std::begin(children), std::end(children));
+        }
+
+        if (reachedCount != std::size(nodes))
+            return errors.error("Validate document", "node.children forms a cycle");
+        return base::Error::success();
+    }
+
+    /**
+     * Checks that every index refers to an existing element.
+     */
+    [[nodiscard]] static base::Error
+    validate(const Document &document) noexcept {
+        base::FunctionErrorGenerator errors{"IOGLTFLibrary", "Document"};
+
+        const auto isValid = [] (std::uint32_t index, auto elements) {
+            return index == NoIndex || index < std::size(elements);
+        };
+
+        for (const auto &accessor : document.accessors()) {
+            if (!isValid(accessor.bufferView, document.bufferViews()))
+                return errors.error("Validate document", "accessor.bufferView out of bounds");
+        }
+
+        for (const auto &bufferView : document.bufferViews()) {
+            if (bufferView.buffer == NoIndex || !isValid(bufferView.buffer, document.buffers()))
+                return errors.error("Validate document", "bufferView.buffer missing or out of bounds");
+        }
+
+        for (const auto &image : document.images()) {
+            if (!isValid(image.bufferView, document.bufferViews()))
+                return errors.error("Validate document", "image.bufferView out of bounds");
+        }
+
+        for (const auto &material : document.materials()) {
+            if (!isValid(material.baseColorTexture, document.textures()) || !isValid(material.normalTexture, document.textures()))
+                return errors.error("Validate document", "material texture out of bounds");
+        }
+
+        for (const auto &mesh : document.meshes()) {
+            for (const auto &primitive : document.primitives(mesh)) {
+                if (primitive.position == NoIndex)
+                    return errors.error("Validate document", "mesh.primitive.attributes.POSITION missing");
+
+                for (const auto accessor : {primitive.position, primitive.normal, primitive.textureCoordinates,
+                                            primitive.tangent, primitive.joints, primitive.weights, primitive.indices}) {
+                    if (!isValid(accessor, document.accessors()))
+                        return errors.error("Validate document", "mesh.primitive accessor out of bounds");
+                }
+
+                if (!isValid(primitive.material, document.materials()))
+                    return errors.error("Validate document", "mesh.primitive.material out of bounds");
+            }
+        }
+
+        for (const auto &node : document.nodes()) {
+            if (!isValid(node.mesh, document.meshes()))
+                return errors.error("Validate document", "node.mesh out of bounds");
+            if (!isValid(node.light, document.lights()))
+                return errors.error("Validate document", "node KHR_lights_punctual light out of bounds");
+            for (const auto child : document.children(node)) {
+                if (!isValid(child, document.nodes()))
+                    return errors.error("Validate document", "node.children index out of bounds");
+            }
+        }
+
+        TRY(validateHierarchy(document))
+
+        for (const auto &texture : document.textures()) {
+            if (!isValid(texture.sampler, document.samplers()) || !isValid(texture.source, document.images()))
+                return errors.error("Validate document", "texture.sampler or texture.source out of bounds");
+        }
+
+        return base::Error::success();
+    }
+
+    base::ErrorOr<Document>
+    Document::parse(std::vector<char> &&text) noexcept {
+        Document document{};
+        document.m_text = std::move(text);
+
+        TRY(DocumentParser(document, {document.m_text.data(), std::size(document.m_text)}).parse())
+        TRY(validate(document))
+        return {std::move(document)};
+    }
+
+    base::ErrorOr<Document>
+    Document::parseInPlace(std::string_view text) noexcept {
+        Document document{};
+
+        TRY(DocumentParser(document, text).parse())
+        TRY(validate(document))
+        return {std::move(document)};
+    }
+
+} // namespace io::format::gltf
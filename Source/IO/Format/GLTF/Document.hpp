@@ -0,0 +1,293 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+#include "Source/Base/ErrorOr.hpp"
+#include "Source/IO/Format/GLTF/ComponentType.hpp"
+#include "Source/Math/Quaternion.hpp"
+#include "Source/Math/Vector.hpp"
+
+namespace io::format::gltf {
+
+    /**
+     * The value of an index that is absent, e.g. Node::mesh of a node
+     * without a mesh.
+     */
+    inline constexpr std::uint32_t NoIndex = UINT32_MAX;
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#_accessor_type
+    enum class AccessorType
+            : std::uint8_t {
+        SCALAR,
+        VEC2,
+        VEC3,
+        VEC4,
+        MAT2,
+        MAT3,
+        MAT4,
+    };
+
+    [[nodiscard]] constexpr std::size_t
+    accessorTypeComponentCount(AccessorType type) noexcept {
+        switch (type) {
+            case AccessorType::SCALAR: return 1;
+            case AccessorType::VEC2: return 2;
+            case AccessorType::VEC3: return 3;
+            case AccessorType::VEC4: return 4;
+            case AccessorType::MAT2: return 4;
+            case AccessorType::MAT3: return 9;
+            case AccessorType::MAT4: return 16;
+        }
+        return 0;
+    }
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-accessor
+    struct Accessor {
+        std::size_t byteOffset{0};
+        std::size_t count{0};
+        std::uint32_t bufferView{NoIndex};
+        ComponentType componentType{ComponentType::FLOAT};
+        AccessorType type{AccessorType::SCALAR};
+        bool normalized{false};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-buffer
+    struct Buffer {
+        // Empty for the binary chunk of a GLB file.
+        std::string_view uri{};
+        std::size_t byteLength{0};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-bufferview
+    struct BufferView {
+        std::size_t byteOffset{0};
+        std::size_t byteLength{0};
+        std::uint32_t buffer{NoIndex};
+
+        // Zero when the elements are tightly packed.
+        std::uint32_t byteStride{0};
+
+        // Zero when not specified.
+        std::uint32_t target{0};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-image
+    struct Image {
+        std::string_view name{};
+        std::string_view uri{};
+        std::string_view mimeType{};
+        std::uint32_t bufferView{NoIndex};
+    };
+
+    // https://github.com/KhronosGroup/glTF/blob/main/extensions/2.0/Khronos/KHR_lights_punctual/README.md
+    struct Light {
+        std::string_view name{};
+        std::string_view type{};
+        math::Vector3f color{1.0f, 1.0f, 1.0f};
+        float intensity{1.0f};
+
+        // Zero when the range is infinite.
+        float range{0.0f};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-material
+    struct Material {
+        std::string_view name{};
+
+        // Indices of textures.
+        std::uint32_t baseColorTexture{NoIndex};
+        std::uint32_t normalTexture{NoIndex};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-mesh-primitive
+    struct Primitive {
+        // Indices of the accessors of the attributes.
+        std::uint32_t position{NoIndex};
+        std::uint32_t normal{NoIndex};
+        std::uint32_t textureCoordinates{NoIndex};
+        std::uint32_t tangent{NoIndex};
+        std::uint32_t joints{NoIndex};
+        std::uint32_t weights{NoIndex};
+
+        std::uint32_t indices{NoIndex};
+        std::uint32_t material{NoIndex};
+
+        // TRIANGLES by default.
+        std::uint32_t mode{4};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-mesh
+    struct Mesh {
+        std::string_view name{};
+
+        // The primitives are [firstPrimitive, firstPrimitive + primitiveCount)
+        // of Document::primitives().
+        std::uint32_t firstPrimitive{0};
+        std::uint32_t primitiveCount{0};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-node
+    struct Node {
+        std::string_view name{};
+
+        math::Vector3f translation{};
+        math::Quaternion<float> rotation{math::Quaternion<float>::identity()};
+        math::Vector3f scale{1.0f, 1.0f, 1.0f};
+
+        std::uint32_t mesh{NoIndex};
+        std::uint32_t skin{NoIndex};
+
+        // KHR_lights_punctual
+        std::uint32_t light{NoIndex};
+
+        // The children are [firstChild, firstChild + childCount) of
+        // Document::children().
+        std::uint32_t firstChild{0};
+        std::uint32_t childCount{0};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-sampler
+    struct Sampler {
+        // Zero when not specified.
+        std::uint32_t magFilter{0};
+        std::uint32_t minFilter{0};
+
+        // REPEAT by default.
+        std::uint32_t wrapS{10497};
+        std::uint32_t wrapT{10497};
+    };
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-texture
+    struct Texture {
+        std::uint32_t sampler{NoIndex};
+        std::uint32_t source{NoIndex};
+    };
+
+    /**
+     * The parts of a glTF document that the engine uses, in flat arrays that
+     * refer to each other by index.
+     *
+     * The document is read in a single pass with json::Reader, without
+     * building a JSON tree. The strings are views into the text. After
+     * parsing, every index is checked to be in bounds, so they can be used
+     * without checking them again.
+     */
+    class Document {
+    public:
+        /**
+         * Parses the text, which the document keeps alive.
+         */
+        [[nodiscard]] static base::ErrorOr<Document>
+        parse(std::vector<char> &&text) noexcept;
+
+        /**
+         * Parses the text without copying it, e.g. the JSON chunk of a
+         * mapped GLB file. The text has to outlive the document.
+         */
+        [[nodiscard]] static base::ErrorOr<Document>
+        parseInPlace(std::string_view text) noexcept;
+
+        [[nodiscard]] inline std::span<const Accessor>
+        accessors() const noexcept {
+            return m_accessors;
+        }
+
+        [[nodiscard]] inline std::span<const BufferView>
+        bufferViews() const noexcept {
+            return m_bufferViews;
+        }
+
+        [[nodiscard]] inline std::span<const Buffer>
+        buffers() const noexcept {
+            return m_buffers;
+        }
+
+        [[nodiscard]] inline std::span<const std::uint32_t>
+        children(const Node &node) const noexcept {
+            return std::span{m_children}.subspan(node.firstChild, node.childCount);
+        }
+
+        [[nodiscard]] inline std::span<const Image>
+        images() const noexcept {
+            return m_images;
+        }
+
+        [[nodiscard]] inline std::span<const Light>
+        lights() const noexcept {
+            return m_lights;
+        }
+
+        [[nodiscard]] inline std::span<const Material>
+        materials() const noexcept {
+            return m_materials;
+        }
+
+        [[nodiscard]] inline std::span<const Mesh>
+        meshes() const noexcept {
+            return m_meshes;
+        }
+
+        [[nodiscard]] inline std::span<const Node>
+        nodes() const noexcept {
+            return m_nodes;
+        }
+
+        [[nodiscard]] inline std::span<const Primitive>
+        primitives() const noexcept {
+            return m_primitives;
+        }
+
+        [[nodiscard]] inline std::span<const Primitive>
+        primitives(const Mesh &mesh) const noexcept {
+            return std::span{m_primitives}.subspan(mesh.firstPrimitive, mesh.primitiveCount);
+        }
+
+        [[nodiscard]] inline std::span<const Sampler>
+        samplers() const noexcept {
+            return m_samplers;
+        }
+
+        [[nodiscard]] inline std::span<const Texture>
+        textures() const noexcept {
+            return m_textures;
+        }
+
+    private:
+        friend class DocumentParser;
+
+        // Only moved after parsing, which keeps the views into them valid.
+        // The text is empty when it is owned by the caller.
+        std::vector<char> m_text{};
+        std::deque<std::string> m_decodedStrings{};
+
+        std::vector<Accessor> m_accessors{};
+        std::vector<BufferView> m_bufferViews{};
+        std::vector<Buffer> m_buffers{};
+        std::vector<std::uint32_t> m_children{};
+        std::vector<Image> m_images{};
+        std::vector<Light> m_lights{};
+        std::vector<Material> m_materials{};
+        std::vector<Mesh> m_meshes{};
+        std::vector<Node> m_nodes{};
+        std::vector<Primitive> m_primitives{};
+        std::vector<Sampler> m_samplers{};
+        std::vector<Texture> m_textures{};
+    };
+
+} // namespace io::format::gltf
@@ -11,9 +11,11 @@
 
 #include "ImageLoader.hpp"
 
+#include <filesystem>
+
 #include <fmt/core.h>
-#include <nlohmann/json.hpp>
 
+#include "Source/Event/Async.hpp"
 #include "Source/GraphicsAPI.hpp"
 #include "Source/IO/Format/GLTF/Context.hpp"
 #include "Source/IO/Format/GLTF/ResourceInfo.hpp"
@@ -22,55 +24,53 @@
 
 namespace io::format::gltf {
         
-    ImageLoader::ImageLoader(Context &context) noexcept
+    ImageLoader::ImageLoader(Context &context, event::FunctionQueue &mainThreadQueue) noexcept
             : m_context(context)
-            , m_gltfImages(context.json()["images"]) {
+            , m_mainThreadQueue(mainThreadQueue) {
     }
 
-    ImageLoader::~ImageLoader() noexcept = default;
+    ImageLoader::~ImageLoader() noexcept {
+        // The image coroutines refer to this loader.
+        assert(m_pendingRequests == 0);
+    }
 
     base::Error
     ImageLoader::preLoadAll() noexcept {
-        image::BulkImageLoaderBulkRequestGuard guard{ m_imageLoader };
-
-        for (std::size_t imageIndex = 0; imageIndex < m_gltfImages.size(); ++imageIndex) {
-            if (auto error = requestImageLoad(imageIndex).error())
-                return error;
+        for (std::size_t imageIndex = 0; imageIndex < std::size(m_context.document().images()); ++imageIndex) {
+            TRY(requestImageLoad(imageIndex))
         }
 
         return base::Error::success();
     }
 
-    base::ErrorOr<ImageLoader::RequestTag>
+    base::Error
     ImageLoader::requestImageLoad(std::size_t imageIndex) noexcept {
         base::FunctionErrorGenerator errors{ "IOGLTFLibrary", "ImageLoader" };
 
-        if (auto it = m_requestMap.find(imageIndex); it != m_requestMap.end())
-            return it->second;
+        if (m_requests.contains(imageIndex))
+            return base::Error::success();
 
-        auto &image = m_gltfImages.at(imageIndex);
+        const auto images = m_context.document().images();
+        if (imageIndex >= std::size(images))
+            return errors.error("Request image load", fmt::format("Image index {} out of bounds", imageIndex));
+        const auto &image = images[imageIndex];
 
         std::unique_ptr<resources::ResourceLocation> resourceLocation;
 
-        if (auto bufferViewIt = image.find("bufferView"); bufferViewIt != image.end()) {
-            TRY_GET_VARIABLE(resourceInfo, m_context.resolveResourceInfo(bufferViewIt->get<std::size_t>(), *bufferViewIt))
+        if (image.bufferView != NoIndex) {
+            TRY_GET_VARIABLE(resourceInfo, m_context.resolveResourceInfo(image.bufferView))
                 resourceLocation = std::make_unique<resources::MemoryNonOwningResourceLocation>(
                     resourceInfo.dataView, false
             );
         }
-        else if (auto uriIt = image.find("uri"); uriIt != image.end()) {
-            if (!uriIt->is_string()) {
-                return errors.error("Load image URI", fmt::format("URI is not a string: {}", uriIt->dump()));
-            }
-
-            const auto sv = uriIt->get<std::string_view>();
-            TRY_GET_VARIABLE(buffer, m_context.loadURI(sv))
+        else if (!image.uri.empty()) {
+            TRY_GET_VARIABLE(buffer, m_context.loadURI(image.uri))
             resourceLocation = std::move(buffer);
         }
-        else if (auto imageNameIt = image.find("name"); imageNameIt != image.end()) {
+        else if (!image.name.empty()) {
             resources::ResourceLocateEvent resourceLocateEvent{
                 resources::ResourceLocateEvent::ResourceType::IMAGE,
-                imageNameIt->get<std::string_view>()
+                image.name
             };
 
             resourceLocateEvent.suggestDirectory(std::filesystem::path(m_context.fileName()).parent_path().string());
@@ -84,42 +84,60 @@ namespace io::format::gltf {
 
         assert(resourceLocation != nullptr);
 
-        TRY_GET_VARIABLE(requestTag, m_imageLoader.requestImageLoad(std::move(resourceLocation)))
-        m_requestMap[imageIndex] = requestTag;
-        return requestTag;
+        m_requests.emplace(imageIndex, Request{});
+        ++m_pendingRequests;
+        loadImage(imageIndex, std::move(resourceLocation)).detach();
+        return base::Error::success();
     }
 
+    base::Async<void>
+    ImageLoader::loadImage(std::size_t imageIndex, std::unique_ptr<resources::ResourceLocation> resourceLocation) noexcept {
+        const auto tag = static_cast<RequestTag>(imageIndex);
+        auto image = co_await image::BulkImageLoader::decodeAsync(tag, std::move(resourceLocation));
+        co_await event::resumeOn(m_mainThreadQueue);
+
+        auto &request = m_requests.at(imageIndex);
+        request.image.emplace(std::move(image));
+
+        if (request.image->failed()) {
+            // A missing texture shouldn't prevent the rest of the scene
+            // from loading.
+            request.image->error().displayErrorMessageBox();
+        } else {
+            for (auto &callback : request.callbacks)
+                recordError(callback(tag, request.image->get()));
+        }
+        request.callbacks.clear();
 
-    base::Error
-    ImageLoader::subscribeImageLoad(std::size_t imageIndex, DeferredCallback callback) noexcept {
-        TRY_GET_VARIABLE(request, requestImageLoad(imageIndex))
-        return m_imageLoader.attachDeferredCallback(request, std::move(callback));
+        if (--m_pendingRequests == 0 && m_waiter)
+            std::exchange(m_waiter, nullptr).resume();
+    }
+
+    void
+    ImageLoader::recordError(base::Error &&error) noexcept {
+        if (error && !m_firstError)
+            m_firstError = std::move(error);
     }
 
     base::Error
-    ImageLoader::waitForAll() noexcept {
-        std::size_t imagesQueued{};
-        std::size_t imagesFinished{};
-        while (true) {
-            TRY(m_imageLoader.invokeDeferredCallbacks())
-
-#ifdef GLTF_DEBUG_WAITING_FOR_TEXTURE_LOADING
-            const auto oldQueued = imagesQueued;
-            const auto oldFinished = imagesFinished;
-#endif // GLTF_DEBUG_WAITING_FOR_TEXTURE_LOADING
-
-            imagesQueued = m_imageLoader.imagesCurrentlyQueued();
-            imagesFinished = m_imageLoader.imagesFinished();
-            if (imagesQueued == imagesFinished)
-                break;
-
-#ifdef GLTF_DEBUG_WAITING_FOR_TEXTURE_LOADING
-            if ((imagesQueued - imagesFinished) != (oldQueued - oldFinished))
-                fmt::print("[GLTF] Still waiting for {} images...\n", (imagesQueued - imagesFinished));
-#endif // GLTF_DEBUG_WAITING_FOR_TEXTURE_LOADING
+    ImageLoader::subscribeImageLoad(std::size_t imageIndex, DeferredCallback callback) noexcept {
+        TRY(requestImageLoad(imageIndex))
+
+        auto &request = m_requests.at(imageIndex);
+        if (!request.image.has_value()) {
+            request.callbacks.push_back(std::move(callback));
+            return base::Error::success();
         }
 
-        return base::Error::success();
+        if (request.image->failed())
+            return base::Error::success();
+        return callback(static_cast<RequestTag>(imageIndex), request.image->get());
     }
-    
+
+    base::Async<base::Error>
+    ImageLoader::waitForAll() noexcept {
+        co_await WaitForAllAwaiter{*this};
+        co_return m_firstError;
+    }
+
 } // namespace io::format::gltf
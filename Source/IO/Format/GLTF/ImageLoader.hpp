@@ -9,47 +9,93 @@
 
 #pragma once
 
+#include <coroutine>
 #include <map>
+#include <optional>
 #include <vector>
 
-#include <nlohmann/json_fwd.hpp>
-
+#include "Source/Base/Async.hpp"
 #include "Source/Base/Error.hpp"
+#include "Source/Event/FunctionQueue.hpp"
 #include "Source/IO/Format/Image/BulkImageLoader.hpp"
 
 namespace io::format::gltf {
 
     struct Context;
 
+    /**
+     * Loads the images of a glTF document. The images are read and decoded on
+     * the worker pool, after which the subscribed callbacks run on the thread
+     * that processes the given queue, which is where the textures can be
+     * created.
+     *
+     * Apart from the decoding, everything happens on that thread, which
+     * therefore must also be the thread that calls into the loader.
+     */
     struct ImageLoader {
+        using Image = image::BulkImageLoader::Image;
         using RequestTag = image::BulkImageLoader::ImageRequestTag;
-        using RequestMap = std::map<std::size_t, RequestTag>;
-        using DeferredCallback = std::function<base::Error(image::BulkImageLoader::ImageRequestTag, image::BulkImageLoader::Image &)>;
+        using DeferredCallback = image::BulkImageLoader::DeferredCallback;
 
-        [[nodiscard]] explicit
-        ImageLoader(Context &) noexcept;
+        [[nodiscard]]
+        ImageLoader(Context &, event::FunctionQueue &mainThreadQueue) noexcept;
 
         ~ImageLoader() noexcept;
 
         [[nodiscard]] base::Error
         preLoadAll() noexcept;
 
-        [[nodiscard]] base::ErrorOr<RequestTag>
+        [[nodiscard]] base::Error
         requestImageLoad(std::size_t imageIndex) noexcept;
 
         [[nodiscard]] base::Error
         subscribeImageLoad(std::size_t imageIndex, DeferredCallback callback) noexcept;
 
-        [[nodiscard]] base::Error
+        /**
+         * Completes when every requested image has been decoded and handed to
+         * its callbacks, returning the first error of those callbacks. It has
+         * to be awaited before the loader is destroyed.
+         */
+        [[nodiscard]] base::Async<base::Error>
         waitForAll() noexcept;
 
     private:
-        Context &m_context;
+        struct Request {
+            std::optional<base::ErrorOr<Image>> image{};
+            std::vector<DeferredCallback> callbacks{};
+        };
+
+        struct WaitForAllAwaiter {
+            ImageLoader &loader;
+
+            [[nodiscard]] bool
+            await_ready() const noexcept {
+                return loader.m_pendingRequests == 0;
+            }
 
-        const nlohmann::json &m_gltfImages;
+            void
+            await_suspend(std::coroutine_handle<> handle) noexcept {
+                loader.m_waiter = handle;
+            }
+
+            constexpr void
+            await_resume() const noexcept {
+            }
+        };
+
+        [[nodiscard]] base::Async<void>
+        loadImage(std::size_t imageIndex, std::unique_ptr<resources::ResourceLocation>) noexcept;
+
+        void
+        recordError(base::Error &&) noexcept;
+
+        Context &m_context;
+        event::FunctionQueue &m_mainThreadQueue;
 
-        image::BulkImageLoader m_imageLoader{};
-        RequestMap m_requestMap{};
+        std::map<std::size_t, Request> m_requests{};
+        std::size_t m_pendingRequests{0};
+        std::coroutine_handle<> m_waiter{};
+        base::Error m_firstError{base::Error::success()};
     };
 
 } // namespace io::format::gltf
@@ -0,0 +1,271 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#define FMT_HEADER_ONLY
+
+#include "MeshDecoder.hpp"
+
+#include <cstdint> // for std::uintptr_t
+#include <cstring> // for std::memcpy
+
+#include <fmt/core.h>
+
+namespace io::format::gltf {
+
+    constexpr base::FunctionErrorGenerator errors{"IOGLTFLibrary", "MeshDecoder"};
+
+    static_assert(sizeof(math::Vector2f) == 2 * sizeof(float));
+    static_assert(sizeof(math::Vector3f) == 3 * sizeof(float));
+
+    base::ErrorOr<resources::DecodedMesh>
+    MeshDecoder::decode(const Primitive &primitive) const noexcept {
+        if (primitive.mode != 4)
+            return errors.error("Decode primitive", fmt::format("Mode isn't TRIANGLES (4), but: {}", primitive.mode));
+
+        resources::DecodedMesh mesh{};
+
+        TRY_GET_VARIABLE(positionData, resolveAttribute(primitive.position, AccessorType::VEC3, "POSITION"))
+        TRY_GET_VARIABLE(positions, viewAttribute(positionData, mesh.storage.positions))
+        mesh.positions = positions;
+
+        TRY_GET_VARIABLE(textureCoordinateData, resolveAttribute(primitive.textureCoordinates, AccessorType::VEC2, "TEXCOORD_0"))
+        TRY_GET_VARIABLE(textureCoordinates, viewAttribute(textureCoordinateData, mesh.storage.textureCoordinates))
+        if (std::size(textureCoordinates) != std::size(positions))
+            return errors.error("Verify sizes", fmt::format("Texture coordinates size ({}) != vertices size ({})", std::size(textureCoordinates), std::size(positions)));
+        mesh.textureCoordinates = textureCoordinates;
+
+        TRY(decodeIndices(primitive, mesh))
+
+        if (primitive.normal == NoIndex) {
+            generateNormals(mesh);
+        } else {
+            TRY_GET_VARIABLE(normalData, resolveAttribute(primitive.normal, AccessorType::VEC3, "NORMAL"))
+            TRY_GET_VARIABLE(normals, viewAttribute(normalData, mesh.storage.normals))
+            if (std::size(normals) != std::size(positions))
+                return errors.error("Verify sizes", fmt::format("Normals size ({}) != vertices size ({})", std::size(normals), std::size(positions)));
+            mesh.normals = normals;
+        }
+
+        if (!needsTangents(primitive))
+            return mesh;
+
+        if (primitive.tangent != NoIndex) {
+            TRY(decodeTangents(primitive.tangent, mesh))
+        } else {
+            generateTangents(mesh);
+        }
+        return mesh;
+    }
+
+    bool
+    MeshDecoder::needsTangents(const Primitive &primitive) const noexcept {
+        return primitive.material != NoIndex
+            && m_document.materials()[primitive.material].baseColorTexture != NoIndex;
+    }
+
+    base::ErrorOr<MeshDecoder::AccessorData>
+    MeshDecoder::resolveAccessor(std::uint32_t accessorIndex, std::string_view name) const noexcept {
+        if (accessorIndex >= std::size(m_document.accessors()))
+            return errors.error("Resolve accessor", fmt::format("Primitive has no {} accessor", name));
+
+        const auto &accessor = m_document.accessors()[accessorIndex];
+        if (accessor.bufferView == NoIndex)
+            return errors.error("Resolve accessor", "Accessors without a bufferView aren't supported");
+
+        const auto &bufferView = m_document.bufferViews()[accessor.bufferView];
+        if (bufferView.buffer >= std::size(m_buffers))
+            return errors.error("Resolve accessor", fmt::format("Buffer #{} of {} isn't loaded", bufferView.buffer, name));
+
+        const auto buffer = m_buffers[bufferView.buffer];
+        if (bufferView.byteOffset > std::size(buffer) || bufferView.byteLength > std::size(buffer) - bufferView.byteOffset)
+            return errors.error("Resolve accessor", fmt::format("Buffer view of {} is out of the range of its buffer", name));
+        if (accessor.byteOffset > bufferView.byteLength)
+            return errors.error("Resolve accessor", fmt::format("Accessor byteOffset > byteLength: {} > {}", accessor.byteOffset, bufferView.byteLength));
+
+        return AccessorData{
+            accessor,
+            buffer.subspan(bufferView.byteOffset + accessor.byteOffset, bufferView.byteLength - accessor.byteOffset),
+            bufferView.byteStride
+        };
+    }
+
+    base::ErrorOr<MeshDecoder::AccessorData>
+    MeshDecoder::resolveAttribute(std::uint32_t accessorIndex, AccessorType type, std::string_view name) const noexcept {
+        TRY_GET_VARIABLE(data, resolveAccessor(accessorIndex, name))
+
+        if (data.accessor.type != type)
+            return errors.error("Verify accessor information", fmt::format("Unexpected accessor type for {}", name));
+        if (data.accessor.componentType != ComponentType::FLOAT)
+            return errors.error("Verify accessor information", fmt::format("Component type of {} isn't FLOAT, but: {}", name, toString(data.accessor.componentType)));
+
+        return data;
+    }
+
+    /**
+     * Returns the attribute as a tightly packed array. Attributes that are
+     * interleaved or aren't aligned for T are gathered into the storage.
+     */
+    template<typename T>
+    base::ErrorOr<std::span<const T>>
+    MeshDecoder::viewAttribute(const AccessorData &data, std::vector<T> &storage) noexcept {
+        const std::size_t count = data.accessor.count;
+        const std::size_t stride = data.byteStride != 0 ? data.byteStride : sizeof(T);
+        if (count != 0 && stride * (count - 1) + sizeof(T) > std::size(data.bytes))
+            return errors.error("Verify accessor information", "Accessor extends past its buffer view");
+
+        const auto *bytes = data.bytes.data();
+        if (stride == sizeof(T) && reinterpret_cast<std::uintptr_t>(bytes) % alignof(T) == 0)
+            return std::span<const T>{reinterpret_cast<const T *>(bytes), count};
+
+        storage.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+            std::memcpy(&storage[i], bytes + i * stride, sizeof(T));
+        return std::span<const T>{storage};
+    }
+
+    base::Error
+    MeshDecoder::decodeIndices(const Primitive &primitive, resources::DecodedMesh &mesh) const noexcept {
+        if (primitive.indices == NoIndex) {
+            if (std::size(mesh.positions) % 3 != 0)
+                return errors.error("Verify vertices", "Vertex count of non-indexed primitive isn't a multiple of 3");
+            return base::Error::success();
+        }
+
+        TRY_GET_VARIABLE(data, resolveAccessor(primitive.indices, "indices"))
+
+        if (data.accessor.type != AccessorType::SCALAR)
+            return errors.error("Check accessor type", "Unexpected value: not a SCALAR");
+
+        switch (data.accessor.componentType) {
+            case ComponentType::UNSIGNED_BYTE:
+                mesh.indexType = resources::DecodedMesh::IndexType::UNSIGNED_BYTE;
+                break;
+            case ComponentType::UNSIGNED_SHORT:
+                mesh.indexType = resources::DecodedMesh::IndexType::UNSIGNED_SHORT;
+                break;
+            case ComponentType::UNSIGNED_INT:
+                mesh.indexType = resources::DecodedMesh::IndexType::UNSIGNED_INT;
+                break;
+            default:
+                return errors.error("Check accessor type", fmt::format("Invalid index component type: {}", toString(data.accessor.componentType)));
+        }
+
+        // Indices are never interleaved, so the byteStride is ignored.
+        const std::size_t byteLength = data.accessor.count * resources::DecodedMesh::indexTypeSize(mesh.indexType);
+        if (byteLength > std::size(data.bytes))
+            return errors.error("Verify accessor information", "Indices extend past their buffer view");
+        if (data.accessor.count % 3 != 0)
+            return errors.error("Verify indices", "Index count isn't a multiple of 3");
+
+        mesh.indices = data.bytes.first(byteLength);
+
+        // Every index is checked once here, so the normals and tangents can
+        // be generated from them, and the graphics API doesn't have to.
+        for (std::size_t i = 0; i < data.accessor.count; ++i) {
+            if (const auto index = mesh.index(i); index >= std::size(mesh.positions))
+                return errors.error("Verify indices", fmt::format("Index out of bounds: index={} (#{}) vertices.size={}", index, i, std::size(mesh.positions)));
+        }
+
+        return base::Error::success();
+    }
+
+    base::Error
+    MeshDecoder::decodeTangents(std::uint32_t accessorIndex, resources::DecodedMesh &mesh) const noexcept {
+        TRY_GET_VARIABLE(data, resolveAttribute(accessorIndex, AccessorType::VEC4, "TANGENT"))
+
+        std::vector<math::Vector4f> storage{};
+        TRY_GET_VARIABLE(tangents, viewAttribute(data, storage))
+
+        if (std::size(tangents) != std::size(mesh.normals))
+            return errors.error("Verify sizes", fmt::format("Normals size ({}) != tangents size ({})", std::size(mesh.normals), std::size(tangents)));
+
+        mesh.storage.tangents.resize(std::size(tangents));
+        mesh.storage.bitangents.resize(std::size(tangents));
+        for (std::size_t i = 0; i < std::size(tangents); ++i) {
+            const auto &tangent = tangents[i];
+
+            // The w component is the handedness of the bitangent.
+            mesh.storage.tangents[i] = tangent.xyz();
+            mesh.storage.bitangents[i] = mesh.normals[i].cross(tangent.xyz()) * tangent.w();
+        }
+
+        mesh.tangents = mesh.storage.tangents;
+        mesh.bitangents = mesh.storage.bitangents;
+        return base::Error::success();
+    }
+
+    /**
+     * Generates smooth normals by summing the normals of the triangles that
+     * share a vertex. The sums aren't normalized until the end, so larger
+     * triangles weigh more.
+     */
+    void
+    MeshDecoder::generateNormals(resources::DecodedMesh &mesh) noexcept {
+        auto &normals = mesh.storage.normals;
+        normals.assign(std::size(mesh.positions), math::Vector3f{});
+
+        mesh.forEachTriangle([&] (std::size_t a, std::size_t b, std::size_t c) {
+            const auto &v0 = mesh.positions[a];
+            const auto normal = (mesh.positions[b] - v0).cross(mesh.positions[c] - v0);
+            for (const auto index : {a, b, c})
+                normals[index] = normals[index] + normal;
+        });
+
+        for (auto &normal : normals) {
+            if (normal.length() > 0.0f)
+                normal = normal.normalizeCopy();
+        }
+
+        mesh.normals = normals;
+    }
+
+    void
+    MeshDecoder::generateTangents(resources::DecodedMesh &mesh) noexcept {
+        auto &tangents = mesh.storage.tangents;
+        auto &bitangents = mesh.storage.bitangents;
+        tangents.assign(std::size(mesh.positions), math::Vector3f{});
+        bitangents.assign(std::size(mesh.positions), math::Vector3f{});
+
+        mesh.forEachTriangle([&] (std::size_t a, std::size_t b, std::size_t c) {
+            const auto &v0 = mesh.positions[a];
+            const auto &uv0 = mesh.textureCoordinates[a];
+
+            const auto deltaVertices1 = mesh.positions[b] - v0;
+            const auto deltaVertices2 = mesh.positions[c] - v0;
+
+            const auto deltaUV1 = mesh.textureCoordinates[b] - uv0;
+            const auto deltaUV2 = mesh.textureCoordinates[c] - uv0;
+
+            // Degenerate texture coordinates don't define a direction.
+            const auto determinant = deltaUV1.x() * deltaUV2.y() - deltaUV1.y() * deltaUV2.x();
+            if (determinant == 0.0f)
+                return;
+
+            const auto r = 1.0f / determinant;
+            const auto tangent = (deltaVertices1 * deltaUV2.y() - deltaVertices2 * deltaUV1.y()) * r;
+            const auto bitangent = (deltaVertices2 * deltaUV1.x() - deltaVertices1 * deltaUV2.x()) * r;
+
+            for (const auto index : {a, b, c}) {
+                tangents[index] = tangents[index] + tangent;
+                bitangents[index] = bitangents[index] + bitangent;
+            }
+        });
+
+        for (std::size_t i = 0; i < std::size(tangents); ++i) {
+            if (tangents[i].length() > 0.0f)
+                tangents[i] = tangents[i].normalizeCopy();
+            if (bitangents[i].length() > 0.0f)
+                bitangents[i] = bitangents[i].normalizeCopy();
+        }
+
+        mesh.tangents = tangents;
+        mesh.bitangents = bitangents;
+    }
+
+} // namespace io::format::gltf
@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <cstddef> // for std::byte
+#include <cstdint>
+
+#include "Source/Base/ErrorOr.hpp"
+#include "Source/IO/Format/GLTF/Document.hpp"
+#include "Source/Resources/DecodedMesh.hpp"
+
+namespace io::format::gltf {
+
+    /**
+     * Decodes the primitives of a document into meshes that any graphics
+     * API can upload: the accessors are resolved and verified, and the
+     * normals and tangents that the file doesn't contain are generated.
+     *
+     * The decoder only reads the document and the buffers, which have to
+     * outlive the meshes it returns, so primitives can be decoded in
+     * parallel.
+     */
+    class MeshDecoder {
+    public:
+        [[nodiscard]] inline
+        MeshDecoder(const Document &document, std::span<const std::span<const std::byte>> buffers) noexcept
+                : m_document(document)
+                , m_buffers(buffers) {
+        }
+
+        [[nodiscard]] base::ErrorOr<resources::DecodedMesh>
+        decode(const Primitive &) const noexcept;
+
+        /**
+         * The tangents are only used for normal mapping the base color
+         * texture, so they aren't decoded for other materials.
+         */
+        [[nodiscard]] bool
+        needsTangents(const Primitive &) const noexcept;
+
+    private:
+        // The bytes of an accessor, which start at its first element.
+        struct AccessorData {
+            const Accessor &accessor;
+            std::span<const std::byte> bytes;
+
+            // Zero when the elements are tightly packed.
+            std::size_t byteStride;
+        };
+
+        [[nodiscard]] base::ErrorOr<AccessorData>
+        resolveAccessor(std::uint32_t accessorIndex, std::string_view name) const noexcept;
+
+        [[nodiscard]] base::ErrorOr<AccessorData>
+        resolveAttribute(std::uint32_t accessorIndex, AccessorType, std::string_view name) const noexcept;
+
+        template<typename T>
+        [[nodiscard]] static base::ErrorOr<std::span<const T>>
+        viewAttribute(const AccessorData &, std::vector<T> &storage) noexcept;
+
+        [[nodiscard]] base::Error
+        decodeIndices(const Primitive &, resources::DecodedMesh &) const noexcept;
+
+        [[nodiscard]] base::Error
+        decodeTangents(std::uint32_t accessorIndex, resources::DecodedMesh &) const noexcept;
+
+        static void
+        generateNormals(resources::DecodedMesh &) noexcept;
+
+        static void
+        generateTangents(resources::DecodedMesh &) noexcept;
+
+        const Document &m_document;
+        std::span<const std::span<const std::byte>> m_buffers;
+    };
+
+} // namespace io::format::gltf
@@ -9,21 +9,21 @@
 
 #pragma once
 
-#include <nlohmann/json.hpp>
+#include <span>
+
+#include <cstddef> // for std::byte
 
 #include "Source/Base/ArrayView.hpp"
+#include "Source/IO/Format/GLTF/Document.hpp"
 
 namespace io::format::gltf {
 
     struct ResourceInfo {
-        // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-accessor
-        const nlohmann::json &accessor;
-
         // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-buffer
-        const std::string &buffer;
+        std::span<const std::byte> buffer;
 
         //https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-bufferview
-        const nlohmann::json& bufferView;
+        const BufferView &bufferView;
 
         std::size_t byteOffset;
         std::size_t byteLength;
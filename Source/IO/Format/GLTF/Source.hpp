@@ -0,0 +1,42 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <cstddef> // for std::byte
+
+#include "Source/IO/Format/GLTF/Document.hpp"
+#include "Source/IO/MappedFile.hpp"
+#include "Source/Resources/ResourceView.hpp"
+
+namespace io::format::gltf {
+
+    /**
+     * A glTF file and the contents of the buffers it references.
+     */
+    struct Source {
+        // The .gltf or .glb file. The document and the binary chunk of a GLB
+        // file are used in place.
+        MappedFile file{};
+
+        Document document{};
+
+        // The buffers with a URI: external files are mapped, and data URIs
+        // are decoded into storage that the view owns.
+        std::vector<resources::ResourceView> ownedBuffers{};
+
+        // The contents of every buffer of the document, by index. These are
+        // views into the file or into ownedBuffers.
+        std::vector<std::span<const std::byte>> buffers{};
+    };
+
+} // namespace io::format::gltf
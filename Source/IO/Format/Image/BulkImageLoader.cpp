@@ -38,7 +38,7 @@ namespace io::image {
     void SetThreadName(DWORD dwThreadID, const char* threadName);
 #endif
 
-    using DeferredCallback = std::function<base::Error(TagType, BulkImageLoader::Image &)>;
+    using DeferredCallback = BulkImageLoader::DeferredCallback;
 
     struct BulkImageRequestData {
         BulkImageRequestData(BulkImageLoader::ImageRequestTag tag) noexcept
@@ -47,58 +47,13 @@ namespace io::image {
 
         void
         addDeferredCallback(DeferredCallback &&callback) noexcept {
-            m_deferredCallbacks.push_back(callback);
+            m_deferredCallbacks.push_back(std::move(callback));
         }
 
         [[nodiscard]] base::Error
         load(std::unique_ptr<resources::ResourceLocation> resourceLocation) noexcept {
-            base::FunctionErrorGenerator errors{ "IOLibrary", "BulkImageRequestData" };
-
-            TRY_GET_VARIABLE(memoryData, resourceLocation->readAllBytes());
-            int width{}, height{}, channelCount{4};
-            auto *data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(memoryData.data()), static_cast<int>(memoryData.size()), &width, &height, &channelCount, STBI_default);
-
-            if (data == nullptr)
-                return errors.error("stbi_load_from_memory", fmt::format("Failed to load from resources::MemoryResourceLocation: {}", stbi_failure_reason()));
-
-            if (!data)
-                return errors.error("Verify data", "Illegal Condition: data is still null");
-
-            ColorModel colorModel;
-            switch (channelCount) {
-                case 1:
-                    colorModel = ColorModel::GREYSCALE;
-                    break;
-                case 2:
-                    colorModel = ColorModel::GREYSCALE_PLUS_ALPHA;
-                    break;
-                case 3:
-                    colorModel = ColorModel::RGB;
-                    break;
-                case 4:
-                    colorModel = ColorModel::RGBA;
-                    break;
-                default:
-                    return errors.error("Verify data", fmt::format("Incorrect channelCount: {}, value should be 1 to 4 inclusive.", channelCount));
-            }
-                
-
-            if (width <= 0) 
-                return errors.error("Verify data", fmt::format("Incorrect image width: {}", width));
-
-            if (height <= 0) 
-                return errors.error("Verify data", fmt::format("Incorrect image height: {}", height));
-
-            //std::printf("Loaded image @ %p\n", static_cast<const void *>(data));
-            
-            m_image = BulkImageLoader::Image(m_tag, nullptr, 
-                ImageView{
-                    base::ArrayView{ reinterpret_cast<char*>(data), static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * static_cast<std::size_t>(channelCount) },
-                    colorModel,
-                    static_cast<std::size_t>(width),
-                    static_cast<std::size_t>(height),
-                }
-            );
+            TRY_GET_VARIABLE(image, BulkImageLoader::decode(m_tag, *resourceLocation))
+            m_image = std::move(image);
             return base::Error::success();
         }
 
@@ -239,6 +194,66 @@ namespace io::image {
 
     BulkImageLoader::~BulkImageLoader() noexcept = default;
 
+    base::ErrorOr<BulkImageLoader::Image>
+    BulkImageLoader::decode(ImageRequestTag tag, const resources::ResourceLocation &resourceLocation) noexcept {
+        base::FunctionErrorGenerator errors{ "IOLibrary", "BulkImageLoader" };
+
+        // The encoded image is decoded front to back once, and the view is
+        // released as soon as it is decoded.
+        TRY_GET_VARIABLE(memoryData, resourceLocation.mapView(io::MappedFile::AccessHint::SEQUENTIAL))
+        int width{}, height{}, channelCount{4};
+        auto *data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(memoryData.data()), static_cast<int>(memoryData.size()), &width, &height, &channelCount, STBI_default);
+
+        if (data == nullptr)
+            return errors.error("stbi_load_from_memory", fmt::format("Failed to load from resources::MemoryResourceLocation: {}", stbi_failure_reason()));
+
+        if (!data)
+            return errors.error("Verify data", "Illegal Condition: data is still null");
+
+        ColorModel colorModel;
+        switch (channelCount) {
+            case 1:
+                colorModel = ColorModel::GREYSCALE;
+                break;
+            case 2:
+                colorModel = ColorModel::GREYSCALE_PLUS_ALPHA;
+                break;
+            case 3:
+                colorModel = ColorModel::RGB;
+                break;
+            case 4:
+                colorModel = ColorModel::RGBA;
+                break;
+            default:
+                return errors.error("Verify data", fmt::format("Incorrect channelCount: {}, value should be 1 to 4 inclusive.", channelCount));
+        }
+            
+
+        if (width <= 0) 
+            return errors.error("Verify data", fmt::format("Incorrect image width: {}", width));
+
+        if (height <= 0) 
+            return errors.error("Verify data", fmt::format("Incorrect image height: {}", height));
+
+        //std::printf("Loaded image @ %p\n", static_cast<const void *>(data));
+        
+        return Image(tag, nullptr, 
+            ImageView{
+                base::ArrayView{ reinterpret_cast<char*>(data), static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * static_cast<std::size_t>(channelCount) },
+                colorModel,
+                static_cast<std::size_t>(width),
+                static_cast<std::size_t>(height),
+            }
+        );
+    }
+
+    base::Async<base::ErrorOr<BulkImageLoader::Image>>
+    BulkImageLoader::decodeAsync(ImageRequestTag tag, std::unique_ptr<resources::ResourceLocation> resourceLocation,
+                                 base::ThreadPool &pool) noexcept {
+        co_await base::resumeOn(pool);
+        co_return decode(tag, *resourceLocation);
+    }
+
     base::ErrorOr<BulkImageLoader::ImageRequestTag>
     BulkImageLoader::requestImageLoad(std::unique_ptr<resources::ResourceLocation> inLocation) noexcept {
         auto tag = m_data->newTag();
@@ -248,18 +263,18 @@ namespace io::image {
         //fmt::print("Requesting image load #{}\n", tag);
         const auto beginLoad = std::chrono::high_resolution_clock::now();
         
-        auto thread = std::thread([beginLoad, m_data = m_data.get(), &request](std::unique_ptr<resources::ResourceLocation> resourceLocation, event::EventHandler<FinishLoadEvent> eventHandler) {
+        auto thread = std::thread([this, beginLoad, m_data = m_data.get(), &request](std::unique_ptr<resources::ResourceLocation> resourceLocation) {
             auto error = request.load(std::move(resourceLocation));
 
             FinishLoadEvent event{request.tag(), std::move(error)};
-            eventHandler.invoke(event).displayErrorMessageBox();
+            onFinishLoad.invoke(event).displayErrorMessageBox();
             
             request.markFinished();
             ++m_data->finishedImages;
 
             static_cast<void>(beginLoad);
             //fmt::print("Requesting image load #{} took {} ms\n", request.tag(), std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - beginLoad).count());
-        }, std::move(inLocation), event::EventHandler(onFinishLoad));
+        }, std::move(inLocation));
 
 #ifdef _WIN32
         static std::size_t s_bulkImageLoaderId;
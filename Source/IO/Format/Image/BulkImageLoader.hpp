@@ -12,9 +12,11 @@
 #include <memory>
 
 #include "Source/Base/ArrayView.hpp"
+#include "Source/Base/Async.hpp"
 #include "Source/Base/Error.hpp"
+#include "Source/Base/InplaceFunction.hpp"
 #include "Source/Event/Event.hpp"
-#include "Source/Event/EventHandler.hpp"
+#include "Source/Event/EventBus.hpp"
 #include "Source/IO/Format/Image/ImageView.hpp"
 #include "Source/Resources/ResourceLocation.hpp"
 
@@ -69,6 +71,9 @@ namespace io::image {
             ImageView m_imageView;
         };
 
+        // Big enough for a texture sampler and a few pointers.
+        using DeferredCallback = base::InplaceFunction<base::Error(ImageRequestTag, Image &), 64>;
+
         struct FinishLoadEvent : event::Event {
             [[nodiscard]]
             FinishLoadEvent(ImageRequestTag tag, base::Error &&error) noexcept
@@ -95,10 +100,28 @@ namespace io::image {
 
         ~BulkImageLoader() noexcept;
 
-        event::EventHandler<FinishLoadEvent> onFinishLoad{};
+        /**
+         * Fired on the loader thread of the image. Subscribe with a
+         * FunctionQueue to handle it on another thread instead.
+         */
+        event::EventBus<FinishLoadEvent> onFinishLoad{};
+
+        /**
+         * Decodes the image on the calling thread.
+         */
+        [[nodiscard]] static base::ErrorOr<Image>
+        decode(ImageRequestTag, const resources::ResourceLocation &) noexcept;
+
+        /**
+         * Reads and decodes the image on a worker of the pool. The awaiting
+         * coroutine resumes on that worker.
+         */
+        [[nodiscard]] static base::Async<base::ErrorOr<Image>>
+        decodeAsync(ImageRequestTag, std::unique_ptr<resources::ResourceLocation>,
+                    base::ThreadPool &pool = base::ThreadPool::global()) noexcept;
 
         [[nodiscard]] base::Error
-        attachDeferredCallback(ImageRequestTag, std::function<base::Error(ImageRequestTag, Image &)>) noexcept;
+        attachDeferredCallback(ImageRequestTag, DeferredCallback) noexcept;
 
         [[nodiscard]] std::size_t
         imagesCurrentlyQueued() const noexcept;
@@ -0,0 +1,344 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Reader.hpp"
+
+#include <charconv> // for std::from_chars
+
+namespace io::format::json {
+
+    [[nodiscard]] static constexpr bool
+    isNumberCharacter(char character) noexcept {
+        return (character >= '0' && character <= '9') || character == '-' || character == '+'
+            || character == '.' || character == 'e' || character == 'E';
+    }
+
+    [[nodiscard]] static constexpr int
+    hexDigitValue(char character) noexcept {
+        if (character >= '0' && character <= '9')
+            return character - '0';
+        if (character >= 'a' && character <= 'f')
+            return character - 'a' + 10;
+        if (character >= 'A' && character <= 'F')
+            return character - 'A' + 10;
+        return -1;
+    }
+
+    static void
+    appendUTF8(std::string &string, std::uint32_t codePoint) noexcept {
+        if (codePoint < 0x80) {
+            string += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            string += static_cast<char>(0xC0 | (codePoint >> 6));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            string += static_cast<char>(0xE0 | (codePoint >> 12));
+            string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            string += static_cast<char>(0xF0 | (codePoint >> 18));
+            string += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            string += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            string += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    bool
+    Reader::beginArray() noexcept {
+        if (!consume('[', "Expected an array"))
+            return false;
+        m_atFirstMember = true;
+        return true;
+    }
+
+    bool
+    Reader::beginObject() noexcept {
+        if (!consume('{', "Expected an object"))
+            return false;
+        m_atFirstMember = true;
+        return true;
+    }
+
+    bool
+    Reader::consume(char character, const char *message) noexcept {
+        if (peek() != character)
+            return fail(message);
+        ++m_position;
+        return true;
+    }
+
+    bool
+    Reader::decodeString(std::size_t begin, std::string_view &value) noexcept {
+        std::string decoded{m_text.substr(begin, m_position - begin)};
+
+        while (m_position < std::size(m_text)) {
+            const auto character = m_text[m_position++];
+            if (character == '"') {
+                value = m_decodedStrings.emplace_back(std::move(decoded));
+                return true;
+            }
+
+            if (static_cast<unsigned char>(character) < 0x20)
+                return fail("Control character in string");
+
+            if (character != '\\') {
+                decoded += character;
+                continue;
+            }
+
+            if (m_position == std::size(m_text))
+                break;
+
+            switch (m_text[m_position++]) {
+                case '"': decoded += '"'; break;
+                case '\\': decoded += '\\'; break;
+                case '/': decoded += '/'; break;
+                case 'b': decoded += '\b'; break;
+                case 'f': decoded += '\f'; break;
+                case 'n': decoded += '\n'; break;
+                case 'r': decoded += '\r'; break;
+                case 't': decoded += '\t'; break;
+                case 'u': {
+                    const auto readCodeUnit = [&] (std::uint32_t &codeUnit) {
+                        if (std::size(m_text) - m_position < 4)
+                            return false;
+                        codeUnit = 0;
+                        for (std::size_t i = 0; i < 4; ++i) {
+                            const auto digit = hexDigitValue(m_text[m_position++]);
+                            if (digit < 0)
+                                return false;
+                            codeUnit = codeUnit << 4 | static_cast<std::uint32_t>(digit);
+                        }
+                        return true;
+                    };
+
+                    std::uint32_t codePoint{};
+                    if (!readCodeUnit(codePoint))
+                        return fail("Invalid \\u escape sequence");
+
+                    if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+                        return fail("Unpaired low surrogate");
+
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                        std::uint32_t low{};
+                        if (m_text.substr(m_position, 2) != "\\u")
+                            return fail("Unpaired high surrogate");
+                        m_position += 2;
+                        if (!readCodeUnit(low) || low < 0xDC00 || low > 0xDFFF)
+                            return fail("Unpaired high surrogate");
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+
+                    appendUTF8(decoded, codePoint);
+                    break;
+                }
+                default:
+                    return fail("Invalid escape sequence");
+            }
+        }
+
+        return fail("Unterminated string");
+    }
+
+    bool
+    Reader::fail(const char *message) noexcept {
+        if (m_error == nullptr) {
+            m_error = message;
+            m_errorOffset = m_position;
+        }
+        return false;
+    }
+
+    bool
+    Reader::finish() noexcept {
+        static_cast<void>(peek());
+        if (m_position != std::size(m_text))
+            return fail("Unexpected data after the document");
+        return !failed();
+    }
+
+    bool
+    Reader::nextElement() noexcept {
+        const auto character = peek();
+        if (character == ']') {
+            ++m_position;
+            m_atFirstMember = false;
+            return false;
+        }
+
+        if (m_atFirstMember) {
+            m_atFirstMember = false;
+            return true;
+        }
+
+        return consume(',', "Expected ',' or ']'");
+    }
+
+    bool
+    Reader::nextKey(std::string_view &key) noexcept {
+        const auto character = peek();
+        if (character == '}') {
+            ++m_position;
+            m_atFirstMember = false;
+            return false;
+        }
+
+        if (m_atFirstMember)
+            m_atFirstMember = false;
+        else if (!consume(',', "Expected ',' or '}'"))
+            return false;
+
+        return readString(key) && consume(':', "Expected ':' after the key");
+    }
+
+    std::string_view
+    Reader::numberToken() noexcept {
+        static_cast<void>(peek());
+        const auto begin = m_position;
+        while (m_position < std::size(m_text) && isNumberCharacter(m_text[m_position]))
+            ++m_position;
+        return m_text.substr(begin, m_position - begin);
+    }
+
+    char
+    Reader::peek() noexcept {
+        while (m_position < std::size(m_text)) {
+            const auto character = m_text[m_position];
+            if (character != ' ' && character != '\n' && character != '\r' && character != '\t')
+                return character;
+            ++m_position;
+        }
+        return '\0';
+    }
+
+    bool
+    Reader::readBool(bool &value) noexcept {
+        static_cast<void>(peek());
+        if (m_text.substr(m_position, 4) == "true") {
+            m_position += 4;
+            value = true;
+            return true;
+        }
+        if (m_text.substr(m_position, 5) == "false") {
+            m_position += 5;
+            value = false;
+            return true;
+        }
+        return fail("Expected a boolean");
+    }
+
+    bool
+    Reader::readFloat(float &value) noexcept {
+        const auto token = numberToken();
+        const auto *end = token.data() + std::size(token);
+        const auto result = std::from_chars(token.data(), end, value);
+        if (token.empty() || result.ec != std::errc{} || result.ptr != end)
+            return fail("Expected a number");
+        return true;
+    }
+
+    bool
+    Reader::readString(std::string_view &value) noexcept {
+        if (!consume('"', "Expected a string"))
+            return false;
+
+        const auto begin = m_position;
+        for (; m_position < std::size(m_text); ++m_position) {
+            const auto character = m_text[m_position];
+            if (character == '"') {
+                value = m_text.substr(begin, m_position - begin);
+                ++m_position;
+                return true;
+            }
+
+            if (character == '\\')
+                return decodeString(begin, value);
+
+            if (static_cast<unsigned char>(character) < 0x20)
+                return fail("Control character in string");
+        }
+
+        return fail("Unterminated string");
+    }
+
+    bool
+    Reader::readUnsigned(std::uint64_t &value) noexcept {
+        const auto token = numberToken();
+        const auto *end = token.data() + std::size(token);
+        const auto result = std::from_chars(token.data(), end, value);
+        if (token.empty() || result.ec != std::errc{} || result.ptr != end)
+            return fail("Expected an unsigned integer");
+        return true;
+    }
+
+    bool
+    Reader::skipString() noexcept {
+        if (!consume('"', "Expected a string"))
+            return false;
+
+        for (; m_position < std::size(m_text); ++m_position) {
+            const auto character = m_text[m_position];
+            if (character == '"') {
+                ++m_position;
+                return true;
+            }
+            if (character == '\\')
+                ++m_position;
+        }
+
+        return fail("Unterminated string");
+    }
+
+    bool
+    Reader::skipValue() noexcept {
+        const auto skipLiteral = [this] (std::string_view literal) {
+            if (m_text.substr(m_position, std::size(literal)) != literal)
+                return fail("Invalid literal");
+            m_position += std::size(literal);
+            return true;
+        };
+
+        switch (peek()) {
+            case '"':
+                return skipString();
+            case '{':
+            case '[': {
+                std::size_t depth{0};
+                while (m_position < std::size(m_text)) {
+                    const auto character = m_text[m_position];
+                    if (character == '"') {
+                        if (!skipString())
+                            return false;
+                        continue;
+                    }
+
+                    ++m_position;
+                    if (character == '{' || character == '[') {
+                        ++depth;
+                    } else if (character == '}' || character == ']') {
+                        if (--depth == 0)
+                            return true;
+                    }
+                }
+                return fail("Unterminated object or array");
+            }
+            case 't':
+                return skipLiteral("true");
+            case 'f':
+                return skipLiteral("false");
+            case 'n':
+                return skipLiteral("null");
+            default:
+                if (numberToken().empty())
+                    return fail("Expected a value");
+                return true;
+        }
+    }
+
+} // namespace io::format::json
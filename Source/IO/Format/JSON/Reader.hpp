@@ -0,0 +1,175 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <concepts> // for std::unsigned_integral
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility> // for std::move
+
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+namespace io::format::json {
+
+    /**
+     * A pull parser that reads a JSON text in place, without building a
+     * tree. The caller walks the document in the order it is written, and
+     * skips the values it isn't interested in.
+     *
+     * Strings are views into the text, except for those containing escape
+     * sequences, which are decoded into storage owned by the reader (see
+     * takeDecodedStrings()).
+     *
+     * Every function returns false on an error, after which the reader stays
+     * failed. nextKey() and nextElement() also return false at the end of
+     * the object or array, so loops over them have to check failed()
+     * afterwards.
+     */
+    class Reader {
+    public:
+        [[nodiscard]] inline explicit
+        Reader(std::string_view text) noexcept
+                : m_text(text) {
+        }
+
+        /**
+         * Consumes the '[' of an array, after which the elements are
+         * iterated with nextElement().
+         */
+        [[nodiscard]] bool
+        beginArray() noexcept;
+
+        /**
+         * Consumes the '{' of an object, after which the members are
+         * iterated with nextKey().
+         */
+        [[nodiscard]] bool
+        beginObject() noexcept;
+
+        [[nodiscard]] inline constexpr const char *
+        error() const noexcept {
+            return m_error;
+        }
+
+        /**
+         * The offset into the text at which the error was found.
+         */
+        [[nodiscard]] inline constexpr std::size_t
+        errorOffset() const noexcept {
+            return m_errorOffset;
+        }
+
+        /**
+         * Fails the reader at the current position, for errors in the
+         * contents of the document rather than in its syntax. Returns false.
+         */
+        [[nodiscard]] bool
+        fail(const char *message) noexcept;
+
+        [[nodiscard]] inline constexpr bool
+        failed() const noexcept {
+            return m_error != nullptr;
+        }
+
+        /**
+         * Checks that nothing but whitespace follows the value that was
+         * read last.
+         */
+        [[nodiscard]] bool
+        finish() noexcept;
+
+        /**
+         * Advances to the next element of the array, or consumes the ']'
+         * and returns false when there are none left.
+         */
+        [[nodiscard]] bool
+        nextElement() noexcept;
+
+        /**
+         * Reads the key of the next member of the object, after which its
+         * value has to be read or skipped. Consumes the '}' and returns false
+         * when there are none left.
+         */
+        [[nodiscard]] bool
+        nextKey(std::string_view &key) noexcept;
+
+        [[nodiscard]] bool
+        readBool(bool &value) noexcept;
+
+        [[nodiscard]] bool
+        readFloat(float &value) noexcept;
+
+        [[nodiscard]] bool
+        readString(std::string_view &value) noexcept;
+
+        [[nodiscard]] bool
+        readUnsigned(std::uint64_t &value) noexcept;
+
+        template<std::unsigned_integral T>
+        [[nodiscard]] inline bool
+        readUnsigned(T &value) noexcept {
+            std::uint64_t wide{};
+            if (!readUnsigned(wide))
+                return false;
+            if (wide > std::numeric_limits<T>::max())
+                return fail("Integer out of range");
+            value = static_cast<T>(wide);
+            return true;
+        }
+
+        /**
+         * Skips the next value, including everything nested in it. Nested
+         * values are only checked for balanced brackets and valid strings.
+         */
+        [[nodiscard]] bool
+        skipValue() noexcept;
+
+        /**
+         * The storage of the strings that contained escape sequences, which
+         * the views returned by readString() refer to.
+         */
+        [[nodiscard]] inline std::deque<std::string>
+        takeDecodedStrings() noexcept {
+            return std::move(m_decodedStrings);
+        }
+
+    private:
+        [[nodiscard]] bool
+        consume(char character, const char *message) noexcept;
+
+        [[nodiscard]] bool
+        decodeString(std::size_t begin, std::string_view &value) noexcept;
+
+        [[nodiscard]] std::string_view
+        numberToken() noexcept;
+
+        [[nodiscard]] char
+        peek() noexcept;
+
+        [[nodiscard]] bool
+        skipString() noexcept;
+
+        std::string_view m_text;
+        std::size_t m_position{0};
+
+        // Whether an array or object was just opened, so the next element or
+        // member isn't preceded by a comma.
+        bool m_atFirstMember{false};
+
+        const char *m_error{nullptr};
+        std::size_t m_errorOffset{0};
+
+        std::deque<std::string> m_decodedStrings{};
+    };
+
+} // namespace io::format::json
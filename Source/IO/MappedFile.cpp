@@ -0,0 +1,195 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "MappedFile.hpp"
+
+#ifdef IO_MAPPEDFILE_USE_POSIX
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#else
+#   define WIN32_LEAN_AND_MEAN
+#   include <Windows.h>
+#endif
+
+#include <utility> // for std::exchange
+
+#include <cerrno>
+
+namespace io {
+
+#ifdef IO_MAPPEDFILE_USE_POSIX
+    [[nodiscard]] static Error
+    associateOpenErrnoWithIOError(int error) noexcept {
+        switch (error) {
+            case ENOENT:
+                return Error::FILE_NOT_FOUND;
+            case EFAULT:
+            case EISDIR:
+            case ENAMETOOLONG:
+                return Error::INVALID_FILE_NAME;
+            case EACCES:
+                return Error::ACCESS_DENIED;
+            default:
+                return Error::UNKNOWN_OPEN_ERROR;
+        }
+    }
+
+    [[nodiscard]] static int
+    translateAccessHint(MappedFile::AccessHint hint) noexcept {
+        switch (hint) {
+            case MappedFile::AccessHint::SEQUENTIAL:
+                return MADV_SEQUENTIAL;
+            case MappedFile::AccessHint::RANDOM:
+                return MADV_RANDOM;
+            case MappedFile::AccessHint::WILL_NEED:
+                return MADV_WILLNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+
+    MappedFile::MappedFile(std::string_view fileName, AccessHint hint) noexcept {
+        const int file = open(std::data(fileName), O_RDONLY);
+        if (file == -1) {
+            m_error = associateOpenErrnoWithIOError(errno);
+            return;
+        }
+
+        struct stat status{};
+        if (fstat(file, &status) == -1) {
+            m_error = Error::POSIX_STAT_ERROR;
+            static_cast<void>(close(file));
+            return;
+        }
+
+        const auto size = static_cast<std::size_t>(status.st_size);
+        if (size != 0) {
+            // The mapping keeps its own reference to the file, so the
+            // descriptor isn't needed after this.
+            auto *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data == MAP_FAILED) {
+                m_error = Error::MAPPING_FAILED;
+            } else {
+                m_data = static_cast<const std::byte *>(data);
+                m_size = size;
+
+                // The hint is only advice, so failing to give it isn't an
+                // error.
+                if (hint != AccessHint::NORMAL)
+                    static_cast<void>(madvise(data, size, translateAccessHint(hint)));
+            }
+        }
+
+        static_cast<void>(close(file));
+    }
+#else
+    [[nodiscard]] static Error
+    associateOpenErrorWithIOError(DWORD error) noexcept {
+        switch (error) {
+            case ERROR_FILE_NOT_FOUND:
+            case ERROR_PATH_NOT_FOUND:
+                return Error::FILE_NOT_FOUND;
+            case ERROR_INVALID_NAME:
+                return Error::INVALID_FILE_NAME;
+            case ERROR_ACCESS_DENIED:
+                return Error::ACCESS_DENIED;
+            default:
+                return Error::UNKNOWN_OPEN_ERROR;
+        }
+    }
+
+    // Mapped views have no equivalent of madvise(), but the cache manager
+    // takes these flags of the file into account when it reads ahead.
+    [[nodiscard]] static DWORD
+    translateAccessHint(MappedFile::AccessHint hint) noexcept {
+        switch (hint) {
+            case MappedFile::AccessHint::SEQUENTIAL:
+            case MappedFile::AccessHint::WILL_NEED:
+                return FILE_FLAG_SEQUENTIAL_SCAN;
+            case MappedFile::AccessHint::RANDOM:
+                return FILE_FLAG_RANDOM_ACCESS;
+            default:
+                return FILE_ATTRIBUTE_NORMAL;
+        }
+    }
+
+    MappedFile::MappedFile(std::string_view fileName, AccessHint hint) noexcept {
+        HANDLE file = CreateFileA(std::data(fileName), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, translateAccessHint(hint), nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            m_error = associateOpenErrorWithIOError(GetLastError());
+            return;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size)) {
+            m_error = Error::MAPPING_FAILED;
+            CloseHandle(file);
+            return;
+        }
+
+        if (size.QuadPart != 0) {
+            // The view keeps the mapping and the file open, so the handles
+            // aren't needed after this.
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void *data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (data == nullptr) {
+                m_error = Error::MAPPING_FAILED;
+            } else {
+                m_data = static_cast<const std::byte *>(data);
+                m_size = static_cast<std::size_t>(size.QuadPart);
+            }
+
+            if (mapping != nullptr)
+                CloseHandle(mapping);
+        }
+
+        CloseHandle(file);
+    }
+#endif
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+            , m_error(other.m_error) {
+    }
+
+    MappedFile &
+    MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_error = other.m_error;
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() noexcept {
+        unmap();
+    }
+
+    void
+    MappedFile::unmap() noexcept {
+        if (m_data == nullptr)
+            return;
+
+#ifdef IO_MAPPEDFILE_USE_POSIX
+        static_cast<void>(munmap(const_cast<std::byte *>(m_data), m_size));
+#else
+        UnmapViewOfFile(m_data);
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+} // namespace io
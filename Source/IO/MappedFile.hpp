@@ -0,0 +1,104 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <span>
+#include <string_view>
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#   define IO_MAPPEDFILE_USE_POSIX
+#endif
+
+#include <cstddef> // for std::size_t, std::byte
+
+#include "Source/IO/Error.hpp"
+
+namespace io {
+
+    /**
+     * A file that is mapped read-only into the address space, so that its
+     * contents can be used in place instead of being read into a buffer.
+     * The pages are loaded by the operating system when they are touched,
+     * and are shared with its file cache.
+     *
+     * Moving the object doesn't move the mapping, so views into data() stay
+     * valid until the last owner is destroyed.
+     */
+    class MappedFile {
+    public:
+        /**
+         * How the contents will be read, which the operating system uses to
+         * decide how far to read ahead and which pages to evict first.
+         */
+        enum class AccessHint {
+            NORMAL,
+
+            // Read once from front to back, e.g. while decoding an image.
+            SEQUENTIAL,
+
+            // Read out of order, so reading ahead would be wasted.
+            RANDOM,
+
+            // All of it is needed soon, e.g. to upload it to the GPU, so it
+            // is read in right away.
+            WILL_NEED,
+        };
+
+        [[nodiscard]] MappedFile() noexcept = default;
+
+        /**
+         * Note: this function assumes the std::string_view's end is a NUL
+         *       byte.
+         */
+        [[nodiscard]] explicit
+        MappedFile(std::string_view fileName, AccessHint hint = AccessHint::NORMAL) noexcept;
+
+        [[nodiscard]]
+        MappedFile(MappedFile &&) noexcept;
+
+        MappedFile &
+        operator=(MappedFile &&) noexcept;
+
+        ~MappedFile() noexcept;
+
+        /**
+         * Returns whether or not the file was mapped successfully. Empty
+         * files are valid, but have no mapping.
+         */
+        [[nodiscard]] inline constexpr
+        operator bool() const noexcept {
+            return m_error == Error::NO_ERROR;
+        }
+
+        [[nodiscard]] inline constexpr std::span<const std::byte>
+        data() const noexcept {
+            return {m_data, m_size};
+        }
+
+        [[nodiscard]] inline constexpr Error
+        error() const noexcept {
+            return m_error;
+        }
+
+        [[nodiscard]] inline constexpr std::size_t
+        size() const noexcept {
+            return m_size;
+        }
+
+    private:
+        void
+        unmap() noexcept;
+
+        const std::byte *m_data{nullptr};
+        std::size_t m_size{0};
+        Error m_error{Error::NO_ERROR};
+    };
+
+} // namespace io
@@ -33,4 +33,21 @@ namespace input {
         float moveY{};
     };
 
+    /**
+     * The coalescing policy for an event::EventHandlerQueue of mouse updates,
+     * which merges consecutive moves into one. Button updates are kept, so
+     * the moves before and after a click stay separate.
+     */
+    struct CoalesceMouseMoves {
+        [[nodiscard]] static constexpr bool
+        tryCoalesce(MouseUpdate &previous, const MouseUpdate &update) noexcept {
+            if (previous.button != MouseButton::NONE || update.button != MouseButton::NONE)
+                return false;
+
+            previous.moveX += update.moveX;
+            previous.moveY += update.moveY;
+            return true;
+        }
+    };
+
 } // namespace input
\ No newline at end of file
@@ -16,7 +16,7 @@ namespace interface {
     public:
         [[nodiscard]] explicit
         Camera(math::Vector3f position = {}) noexcept
-                : Entity("Camera", nullptr, {position, {}, {}}) {
+                : Entity("Camera", nullptr, math::Transformation{position}) {
         }
 
         [[nodiscard]] bool
@@ -49,16 +49,19 @@ namespace interface {
         bool updated{false};
 
         const float moveHorizontal = resolveDirection(m_controller->moveRight, m_controller->moveLeft) * deltaTime;
-        transformation().translation.y() += resolveDirection(m_controller->moveUp, m_controller->moveDown) * deltaTime;
+        const float moveVertical = resolveDirection(m_controller->moveUp, m_controller->moveDown) * deltaTime;
         const float moveDepth = resolveDirection(m_controller->moveForward, m_controller->moveBackward) * deltaTime;
 
+        if (moveVertical != 0)
+            transformation().setTranslation(transformation().translation().add(math::Vector3f{0.0f, moveVertical, 0.0f}));
+
         if (moveHorizontal != 0) {
-            transformation().translation = transformation().translation.add(left().mul(moveHorizontal));
+            transformation().setTranslation(transformation().translation().add(left().mul(moveHorizontal)));
             updated = true;
         }
 
         if (moveDepth != 0) {
-            transformation().translation = transformation().translation.add(forward().mul(moveDepth));
+            transformation().setTranslation(transformation().translation().add(forward().mul(moveDepth)));
             updated = true;
         }
 
@@ -76,8 +79,7 @@ namespace interface {
 
     math::Matrix4x4<float>
     FreeCamera::viewMatrix() const noexcept {
-        return createCameraViewMatrix(m_forward, m_up)
-                .mul(math::Matrix4x4<float>{}.translate({-position().x(), -position().y(), -position().z()}));
+        return createCameraViewMatrix(m_forward, m_up, position());
     }
 
     math::Vector3f
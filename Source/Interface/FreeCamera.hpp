@@ -37,9 +37,14 @@ namespace interface {
             return m_forward;
         }
 
+        [[nodiscard]] inline constexpr math::Vector3f
+        forward() const noexcept {
+            return m_forward;
+        }
+
         [[nodiscard]] inline math::Vector3f
         position() const noexcept {
-            return transformation().translation;
+            return transformation().translation();
         }
 
         [[nodiscard]] inline constexpr math::Vector3f
@@ -9,11 +9,14 @@
 
 #include "Lavender.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <random>
+#include <utility>
 
 #include "Source/Base/About.hpp"
 #include "Source/ECS/PointLight.hpp"
+#include "Source/Math/Projection.hpp"
 #include "Source/Input/Bluetooth/Win32BluetoothManager.hpp"
 #include "Source/OpenGL/GLCore.hpp"
 #include "Source/Resources/FileResourceLocation.hpp"
@@ -31,15 +34,107 @@
 #   include "Source/Window/Win32Core.hpp"
 #endif
 
-base::Error
-Lavender::processEvents() noexcept {
-    return mainThreadQueue.processAll();
+// The per-entity stages of a frame are only split into multiple jobs when
+// there are enough entities to make that worthwhile.
+constexpr std::size_t MinimumEntitiesPerChunk = 256;
+
+[[nodiscard]] static std::pair<std::size_t, std::size_t>
+chunkRange(std::size_t chunk, std::size_t chunkCount, std::size_t size) noexcept {
+    return {size * chunk / chunkCount, size * (chunk + 1) / chunkCount};
 }
 
 void
-Lavender::update(double deltaTime) noexcept {
-    m_scene.fireUpdate(static_cast<float>(deltaTime));
-    m_controller.rotateYaw = 0;
+Lavender::buildFrameGraph(std::size_t chunkCount) noexcept {
+    using Affinity = base::JobGraph::Affinity;
+
+    m_frameGraph.clear();
+    m_frameGraphChunkCount = chunkCount;
+
+    // The queue runs continuations that modify the scene (e.g. importScene),
+    // so everything else has to wait for it.
+    const auto processInput = m_frameGraph.addJob("input", [this] {
+        if (auto error = processEvents())
+            error.displayErrorMessageBox();
+
+        m_drawList.reset(m_scene.entityList());
+        m_entitiesDidUpdate.store(false, std::memory_order_relaxed);
+    }, {}, Affinity::CALLING_THREAD);
+
+    std::vector<base::JobGraph::JobId> updates{};
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        updates.push_back(m_frameGraph.addJob(fmt::format("update #{}", chunk), [this, chunk, chunkCount] {
+            const auto [begin, end] = chunkRange(chunk, chunkCount, m_drawList.entityCount());
+            if (m_scene.fireUpdate(m_deltaTime, begin, end) == ecs::DidUpdate::YES)
+                m_entitiesDidUpdate.store(true, std::memory_order_relaxed);
+            m_drawList.syncTransformations(begin, end);
+        }, {processInput}));
+    }
+
+    // Barrier: the camera has moved and the controller deltas are consumed.
+    // The top of the transform hierarchy can only be computed when all
+    // entities have updated, since their parents can be in any chunk.
+    const auto updatesFinished = m_frameGraph.addJob("updates finished", [this] {
+        if (m_entitiesDidUpdate.load(std::memory_order_relaxed))
+            m_scene.entityList().forceUpdateIncrement();
+        m_controller.rotateYaw = 0;
+        m_drawList.prepareTransformations();
+
+        if (const auto projection = m_graphicsAPI->projectionMatrix())
+            m_drawList.setFrustum(math::extractFrustumPlanes(math::createViewProjectionMatrix(*projection, m_camera->viewMatrix())));
+        else
+            m_drawList.setFrustum(std::nullopt);
+    }, std::move(updates));
+
+    std::vector<base::JobGraph::JobId> transformations{};
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        transformations.push_back(m_frameGraph.addJob(fmt::format("transformations #{}", chunk), [this, chunk, chunkCount] {
+            const auto [begin, end] = chunkRange(chunk, chunkCount, m_drawList.transformPartitionCount());
+            m_drawList.propagateTransformations(begin, end);
+        }, {updatesFinished}));
+    }
+
+    // The entities are culled and the lights are placed by their world
+    // matrices, of which those of a chunk of entities can be in any
+    // partition.
+    std::vector<base::JobGraph::JobId> drawListDependencies{};
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        drawListDependencies.push_back(m_frameGraph.addJob(fmt::format("visibility #{}", chunk), [this, chunk, chunkCount] {
+            const auto [begin, end] = chunkRange(chunk, chunkCount, m_drawList.entityCount());
+            m_drawList.determineVisibility(begin, end);
+        }, transformations));
+    }
+
+    const auto lightBinning = m_frameGraph.addJob("light binning", [this] {
+        m_drawList.binLights(m_camera->transformation().translation());
+    }, std::move(transformations));
+
+    const auto drawList = m_frameGraph.addJob("draw list", [this] {
+        m_drawList.buildCommands(resources::LevelOfDetailSelection{
+            .viewPosition = m_camera->transformation().translation(),
+            .projectionScale = m_graphicsAPI->projectionScale(),
+        });
+    }, std::move(drawListDependencies));
+
+    m_frameGraph.addJob("render", [this] {
+        render();
+    }, {lightBinning, drawList}, Affinity::CALLING_THREAD);
+}
+
+base::Async<void>
+Lavender::importScene(std::string fileName) noexcept {
+    auto scene = co_await m_graphicsAPI->loadGLTFSceneAsync(std::move(fileName), mainThreadQueue);
+    if (scene.failed()) {
+        scene.error().displayErrorMessageBox();
+        co_return;
+    }
+
+    m_scene.import(std::move(*scene.get()));
+}
+
+base::Error
+Lavender::processEvents() noexcept {
+    TRY(m_mouseUpdates.processAll())
+    return mainThreadQueue.processAll();
 }
 
 base::Error
@@ -67,7 +162,7 @@ Lavender::refreshTitle(const std::string &graphicsModeName) noexcept {
 
 void
 Lavender::render() noexcept {
-    m_graphicsAPI->renderEntities();
+    m_graphicsAPI->renderEntities(m_drawList);
 }
 
 void
@@ -77,10 +172,23 @@ Lavender::renderFirstFrameAsLavenderIsLoading() noexcept {
     if (m_windowAPI->shouldClose())
         return;
 
+    m_drawList.build(m_scene.entityList(), m_camera->transformation().translation());
     render();
     m_windowAPI->postLoop();
 }
 
+void
+Lavender::runFrame(double deltaTime) noexcept {
+    const auto entityCount = std::size(m_scene.entityList().data());
+    const auto chunkCount = std::clamp<std::size_t>(entityCount / MinimumEntitiesPerChunk, 1,
+                                                    base::ThreadPool::global().workerCount());
+    if (chunkCount != m_frameGraphChunkCount)
+        buildFrameGraph(chunkCount);
+
+    m_deltaTime = static_cast<float>(deltaTime);
+    m_frameGraph.run();
+}
+
 base::Error
 Lavender::run() {
     base::FunctionErrorGenerator errors{"LavenderCore", "Lavender"};
@@ -116,16 +224,9 @@ Lavender::run() {
 
     m_windowAPI->onDragEnter += [&](input::DragEnterEvent &event) -> base::Error {
         event.allowDrop();
-        std::size_t index = 0;
-        while (index < m_scene.entityList().data().size()) {
-            auto &entity = *m_scene.entityList().data()[index];
-            if (entity.name() == "Camera")
-                ++index;
-            else {
-                fmt::print("Deleting entity \"{}\" @ {:p}\n", entity.name(), static_cast<const void *>(&entity));
-                m_scene.entityList().remove(&entity);
-            }
-        }
+        const auto removed = m_scene.entityList().clearExcept({m_camera->handle()});
+        fmt::print("Deleted {} entities\n", removed);
+        m_graphicsAPI->unloadUnusedModels();
         return base::Error::success();
     };
 
@@ -141,9 +242,7 @@ Lavender::run() {
         const auto &locations = event.data().asFileLocations();
         assert(!locations.empty());
 
-        TRY_GET_VARIABLE(scene, m_graphicsAPI->loadGLTFScene(locations.front()))
-        m_scene.import(std::move(*scene));
-
+        importScene(std::string(locations.front())).detach();
         return base::Error::success();
     };
 
@@ -291,20 +390,16 @@ Lavender::run() {
             } else {
                 temp -= 1;
                 std::printf("[Lavender] FPS: %hu (deltaTime=%f)\n", frameCount, deltaTime);
+                m_frameGraph.printCriticalPath("[Lavender]");
             }
             frameCount = 0;
         }
 
-        if (auto error = processEvents())
-            error.displayErrorMessageBox();
-
-        update(deltaTime);
-
         m_windowAPI->preLoop();
         if (m_windowAPI->shouldClose())
             break;
 
-        render();
+        runFrame(deltaTime);
         m_windowAPI->postLoop();
     }
 
@@ -370,24 +465,29 @@ Lavender::setupController() noexcept {
         return base::Error::success();
     };
     
-    m_windowAPI->registerMouseCallback([&](const input::MouseUpdate &update) {
+    m_windowAPI->registerMouseCallback([&](input::MouseUpdate update) {
+        m_mouseUpdates.invokeLater(std::move(update));
+    });
+
+    m_mouseUpdates += [&](const input::MouseUpdate &update) -> base::Error {
         if (m_windowAPI->mouseGrabbed() == input::MouseGrabbed::NO) {
             if (update.button == input::MouseButton::LEFT && update.isPressed)
                 m_windowAPI->setMouseGrabbed(input::MouseGrabbed::YES);
-            return;
+            return base::Error::success();
         }
 
         if (update.button == input::MouseButton::RIGHT && update.isPressed) {
             m_windowAPI->setMouseGrabbed(input::MouseGrabbed::NO);
-            return;
+            return base::Error::success();
         }
 
         if (update.button != input::MouseButton::NONE)
-            return;
+            return base::Error::success();
 
         m_controller.rotatePitch -= update.moveX;
         m_controller.rotateYaw -= update.moveY;
-    });
+        return base::Error::success();
+    };
 }
 
 void
@@ -6,14 +6,22 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <string>
 
+#include <cstddef> // for std::size_t
+
+#include "Source/Base/Async.hpp"
 #include "Source/Base/Error.hpp"
+#include "Source/Base/JobGraph.hpp"
 #include "Source/Devices/DeviceManager.hpp"
 #include "Source/ECS/Scene.hpp"
+#include "Source/Event/EventHandlerQueue.hpp"
 #include "Source/Event/FunctionQueue.hpp"
 #include "Source/Input/Controller.hpp"
 #include "Source/Interface/FreeCamera.hpp"
+#include "Source/Resources/DrawList.hpp"
 #include "Source/Window/WindowAPI.hpp"
 #include "Source/GraphicsAPI.hpp"
 
@@ -32,11 +40,36 @@ class Lavender {
     input::Controller m_controller{};
     interface::FreeCamera *m_camera{};
 
+    // The window can report many mouse moves per frame, which are merged and
+    // handled by the input job.
+    event::EventHandlerQueue<input::MouseUpdate, input::CoalesceMouseMoves> m_mouseUpdates{};
+
     std::optional<ecs::Scene> m_currentlyImportingScene;
     ecs::Scene m_scene{ecs::EntityList{}};
     ecs::Entity *m_mainEntity{nullptr};
     devices::DeviceManager m_deviceManager{};
 
+    base::JobGraph m_frameGraph{};
+    std::size_t m_frameGraphChunkCount{0};
+    resources::DrawList m_drawList{};
+    float m_deltaTime{};
+    std::atomic_bool m_entitiesDidUpdate{false};
+
+    /**
+     * Declares the jobs of a frame, with the per-entity stages split into
+     * the given amount of chunks. This only has to happen again when the
+     * amount of chunks changes.
+     */
+    void
+    buildFrameGraph(std::size_t chunkCount) noexcept;
+
+    /**
+     * Loads the glTF scene in the background, and imports it into the
+     * current scene on the main thread when it's done.
+     */
+    [[nodiscard]] base::Async<void>
+    importScene(std::string fileName) noexcept;
+
     [[nodiscard]] base::Error
     processEvents() noexcept;
 
@@ -50,13 +83,13 @@ class Lavender {
     renderFirstFrameAsLavenderIsLoading() noexcept;
 
     void
-    setupController() noexcept;
+    runFrame(double deltaTime) noexcept;
 
     void
-    setupLights() noexcept;
+    setupController() noexcept;
 
     void
-    update(double deltaTime) noexcept;
+    setupLights() noexcept;
 
 public:
     event::FunctionQueue mainThreadQueue{};
@@ -0,0 +1,106 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <span>
+
+#include <cassert>
+
+#include "Source/Math/Matrix4x4.hpp"
+#include "Source/Math/Vector.hpp"
+
+/**
+ * Specialized routines for affine matrices, i.e. matrices of which the last
+ * row is (0, 0, 0, 1), like those of math::Transformation. They only need
+ * the cross products of the columns of the upper 3x3, which is far cheaper
+ * than a general inverse.
+ */
+namespace math {
+
+    namespace detail {
+
+        // The rows of the inverse of the upper 3x3 are the cross products of
+        // its columns, divided by the determinant.
+        struct AdjugateRows {
+            Vector3f row0;
+            Vector3f row1;
+            Vector3f row2;
+            float inverseDeterminant;
+        };
+
+        [[nodiscard]] inline AdjugateRows
+        adjugateRows(const Matrix4x4<float> &matrix) noexcept {
+            const Vector3f column0{matrix[0][0], matrix[1][0], matrix[2][0]};
+            const Vector3f column1{matrix[0][1], matrix[1][1], matrix[2][1]};
+            const Vector3f column2{matrix[0][2], matrix[1][2], matrix[2][2]};
+
+            const auto row0 = column1.cross(column2);
+            return {row0, column2.cross(column0), column0.cross(column1), 1.0f / column0.dot(row0)};
+        }
+
+    } // namespace detail
+
+    /**
+     * Inverts an affine matrix with an invertible upper 3x3.
+     */
+    [[nodiscard]] inline Matrix4x4<float>
+    affineInverse(const Matrix4x4<float> &matrix) noexcept {
+        const auto adjugate = detail::adjugateRows(matrix);
+        const auto row0 = adjugate.row0.mul(adjugate.inverseDeterminant);
+        const auto row1 = adjugate.row1.mul(adjugate.inverseDeterminant);
+        const auto row2 = adjugate.row2.mul(adjugate.inverseDeterminant);
+
+        const Vector3f translation{matrix[0][3], matrix[1][3], matrix[2][3]};
+
+        Matrix4x4<float> result{};
+        result.m_data = std::array<std::array<float, 4>, 4>{{
+            {row0.x(), row0.y(), row0.z(), -row0.dot(translation)},
+            {row1.x(), row1.y(), row1.z(), -row1.dot(translation)},
+            {row2.x(), row2.y(), row2.z(), -row2.dot(translation)},
+            {0, 0, 0, 1}
+        }};
+        return result;
+    }
+
+    /**
+     * The inverse transpose of the upper 3x3, which transforms normals so
+     * they stay perpendicular to the surface under non-uniform scaling. It
+     * is stored in the upper 3x3 of an affine matrix without translation,
+     * so it can be uploaded like the other matrices.
+     */
+    [[nodiscard]] inline Matrix4x4<float>
+    normalMatrix(const Matrix4x4<float> &matrix) noexcept {
+        const auto adjugate = detail::adjugateRows(matrix);
+        const auto column0 = adjugate.row0.mul(adjugate.inverseDeterminant);
+        const auto column1 = adjugate.row1.mul(adjugate.inverseDeterminant);
+        const auto column2 = adjugate.row2.mul(adjugate.inverseDeterminant);
+
+        Matrix4x4<float> result{};
+        result.m_data = std::array<std::array<float, 4>, 4>{{
+            {column0.x(), column1.x(), column2.x(), 0},
+            {column0.y(), column1.y(), column2.y(), 0},
+            {column0.z(), column1.z(), column2.z(), 0},
+            {0, 0, 0, 1}
+        }};
+        return result;
+    }
+
+    /**
+     * Computes result[i] = normalMatrix(matrices[i]). The loop has no
+     * branches, so the compiler can vectorize it.
+     */
+    inline void
+    normalMatrices(std::span<const Matrix4x4<float>> matrices, std::span<Matrix4x4<float>> result) noexcept {
+        assert(std::size(result) == std::size(matrices));
+        for (std::size_t i = 0; i < std::size(matrices); ++i)
+            result[i] = normalMatrix(matrices[i]);
+    }
+
+} // namespace math
@@ -0,0 +1,94 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <span>
+
+#include <cassert>
+
+#include "Source/Math/Matrix4x4.hpp"
+#include "Source/Math/Quaternion.hpp"
+#include "Source/Math/SIMD.hpp"
+#include "Source/Math/Vector.hpp"
+
+/**
+ * Matrix operations over whole arrays at once, for updating the matrices
+ * of a scene per chunk instead of per entity. They don't share any state,
+ * so disjoint ranges can be processed concurrently, e.g. by the jobs of a
+ * parallel for.
+ */
+namespace math {
+
+    /**
+     * Writes T * R * S directly: the columns of the rotation matrix of the
+     * unit quaternion scaled by the scaling, with the translation in the
+     * last column.
+     */
+    inline constexpr void
+    composeTRS(const Vector3f &translation, const Quaternion<float> &rotation, const Vector3f &scaling,
+               Matrix4x4<float> &result) noexcept {
+        const auto x = rotation.x();
+        const auto y = rotation.y();
+        const auto z = rotation.z();
+        const auto w = rotation.w();
+
+        const auto xx = x * x, yy = y * y, zz = z * z;
+        const auto xy = x * y, xz = x * z, yz = y * z;
+        const auto wx = w * x, wy = w * y, wz = w * z;
+
+        const auto sx = scaling.x();
+        const auto sy = scaling.y();
+        const auto sz = scaling.z();
+
+        result.m_data = std::array<std::array<float, 4>, 4>{{
+            {(1 - 2 * (yy + zz)) * sx, 2 * (xy - wz) * sy,       2 * (xz + wy) * sz,       translation.x()},
+            {2 * (xy + wz) * sx,       (1 - 2 * (xx + zz)) * sy, 2 * (yz - wx) * sz,       translation.y()},
+            {2 * (xz - wy) * sx,       2 * (yz + wx) * sy,       (1 - 2 * (xx + yy)) * sz, translation.z()},
+            {0,                        0,                        0,                        1}
+        }};
+    }
+
+    /**
+     * Composes result[i] from translations[i], rotations[i] and
+     * scalings[i], like the function above.
+     */
+    inline void
+    composeTRS(std::span<const Vector3f> translations, std::span<const Quaternion<float>> rotations,
+               std::span<const Vector3f> scalings, std::span<Matrix4x4<float>> result) noexcept {
+        assert(std::size(rotations) == std::size(translations));
+        assert(std::size(scalings) == std::size(translations));
+        assert(std::size(result) == std::size(translations));
+        if (std::empty(result))
+            return;
+
+        static_assert(sizeof(Vector3f) == 3 * sizeof(float));
+        static_assert(sizeof(Quaternion<float>) == 4 * sizeof(float));
+        simd::matrixKernels().composeTRS(reinterpret_cast<const float *>(translations.data()),
+                                         reinterpret_cast<const float *>(rotations.data()),
+                                         reinterpret_cast<const float *>(scalings.data()),
+                                         result.data(), std::size(result));
+    }
+
+    /**
+     * Computes result[i] = a[i] * b[i]. The result must not overlap the
+     * input.
+     */
+    inline void
+    multiplyMany(std::span<const Matrix4x4<float>> a, std::span<const Matrix4x4<float>> b,
+                 std::span<Matrix4x4<float>> result) noexcept {
+        assert(std::size(b) == std::size(a));
+        assert(std::size(result) == std::size(a));
+        if (std::empty(result))
+            return;
+        simd::matrixKernels().multiplyMany(a.data(), b.data(), result.data(), std::size(result));
+    }
+
+} // namespace math
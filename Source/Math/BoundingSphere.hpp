@@ -0,0 +1,68 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <algorithm> // for std::max, std::min
+#include <array>
+#include <span>
+
+#include <cmath>
+
+#include "Source/Math/Vector.hpp"
+
+namespace math {
+
+    struct BoundingSphere {
+        Vector3f center{};
+        float radius{0.0f};
+
+        /**
+         * Encloses the points in a sphere around the center of their
+         * bounding box, which is looser than the smallest enclosing sphere,
+         * but takes only two passes over the points.
+         */
+        [[nodiscard]] inline static BoundingSphere
+        enclosing(std::span<const Vector3f> points) noexcept {
+            if (std::empty(points))
+                return {};
+
+            auto minimum = points.front();
+            auto maximum = points.front();
+            for (const auto &point : points) {
+                minimum = Vector3f{std::min(minimum.x(), point.x()), std::min(minimum.y(), point.y()), std::min(minimum.z(), point.z())};
+                maximum = Vector3f{std::max(maximum.x(), point.x()), std::max(maximum.y(), point.y()), std::max(maximum.z(), point.z())};
+            }
+
+            const auto center = minimum.add(maximum).mul(0.5f);
+            float radiusSquared{0.0f};
+            for (const auto &point : points) {
+                const auto difference = point.subtract(center);
+                radiusSquared = std::max(radiusSquared, difference.dot(difference));
+            }
+            return {center, std::sqrt(radiusSquared)};
+        }
+
+        /**
+         * Whether the sphere isn't completely behind any of the planes of a
+         * frustum, see extractFrustumPlanes(). Spheres just outside of the
+         * corners of the frustum pass as well, which only costs drawing
+         * them.
+         */
+        [[nodiscard]] inline bool
+        intersectsFrustum(const std::array<Vector4f, 6> &planes) const noexcept {
+            for (const auto &plane : planes) {
+                if (plane.xyz().dot(center) + plane.w() < -radius)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+} // namespace math
@@ -33,6 +33,16 @@ math::createCameraViewMatrix(Vector3f inForward, Vector3f inUp) noexcept {
     return matrix;
 }
 
+math::Matrix4x4<float>
+math::createCameraViewMatrix(Vector3f forward, Vector3f up, Vector3f position) noexcept {
+    auto matrix = createCameraViewMatrix(forward, up);
+
+    for (std::size_t row = 0; row < 3; ++row)
+        matrix[row][3] = -(matrix[row][0] * position.x() + matrix[row][1] * position.y() + matrix[row][2] * position.z());
+
+    return matrix;
+}
+
 math::Matrix4x4<float>
 math::createPerspectiveProjectionMatrix(float fov, float width, float height, float zNear, float zFar) noexcept {
     const auto tanHalfFOV = std::tan(toRadians(fov / 2));
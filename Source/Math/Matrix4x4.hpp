@@ -7,17 +7,24 @@
 #pragma once
 
 #include <array>
+#include <type_traits> // for std::is_constant_evaluated, std::is_same_v
 
 #include <cmath>
 #include <cstdint>
 
 #include "Source/Math/Math.hpp"
+#include "Source/Math/SIMD.hpp"
 #include "Source/Math/Vector.hpp"
 
 namespace math {
 
+    /**
+     * Float matrices are aligned to 16 bytes, so that every row fits in a
+     * single SIMD register. Their mul(), transpose() and inverse() use the
+     * kernels of math::simd.
+     */
     template<typename Type>
-    class Matrix4x4 {
+    class alignas(std::is_same_v<Type, float> ? 16 : alignof(std::array<std::array<Type, 4>, 4>)) Matrix4x4 {
     public:
         std::array<std::array<Type, 4>, 4> m_data{};
 
@@ -97,8 +104,82 @@ namespace math {
             return *this;
         }
 
+        /**
+         * Returns the inverse of the matrix, which must be invertible.
+         */
+        [[nodiscard]] inline constexpr Matrix4x4
+        inverse() const noexcept {
+            if constexpr (std::is_same_v<Type, float>) {
+                if (!std::is_constant_evaluated()) {
+                    Matrix4x4 result;
+                    simd::matrixKernels().inverse(*this, result);
+                    return result;
+                }
+            }
+            return scalarInverse();
+        }
+
         [[nodiscard]] inline constexpr Matrix4x4
         mul(const Matrix4x4<Type> &other) const noexcept {
+            if constexpr (std::is_same_v<Type, float>) {
+                if (!std::is_constant_evaluated()) {
+                    Matrix4x4 result;
+                    simd::matrixKernels().multiply(*this, other, result);
+                    return result;
+                }
+            }
+            return scalarMul(other);
+        }
+
+        /**
+         * The portable implementations, which the SIMD kernels must agree
+         * with.
+         */
+        [[nodiscard]] inline constexpr Matrix4x4
+        scalarInverse() const noexcept {
+            const auto &m = m_data;
+
+            // The 2x2 determinants of the upper and lower two rows.
+            const auto s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+            const auto s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+            const auto s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+            const auto s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+            const auto s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+            const auto s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+            const auto c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+            const auto c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+            const auto c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+            const auto c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+            const auto c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+            const auto c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+            const auto inverseDeterminant = Type(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+            Matrix4x4 result{};
+            result.m_data = std::array<std::array<Type, 4>, 4>{{
+                {( m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * inverseDeterminant,
+                 (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * inverseDeterminant,
+                 ( m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * inverseDeterminant,
+                 (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * inverseDeterminant},
+                {(-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * inverseDeterminant,
+                 ( m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * inverseDeterminant,
+                 (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * inverseDeterminant,
+                 ( m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * inverseDeterminant},
+                {( m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * inverseDeterminant,
+                 (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * inverseDeterminant,
+                 ( m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * inverseDeterminant,
+                 (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * inverseDeterminant},
+                {(-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * inverseDeterminant,
+                 ( m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * inverseDeterminant,
+                 (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * inverseDeterminant,
+                 ( m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * inverseDeterminant}
+            }};
+            return result;
+        }
+
+        [[nodiscard]] inline constexpr Matrix4x4
+        scalarMul(const Matrix4x4<Type> &other) const noexcept {
             Matrix4x4<Type> result{};
 
             for (std::size_t x = 0; x < 4; ++x) {
@@ -112,11 +193,40 @@ namespace math {
 
             return result;
         }
+
+        [[nodiscard]] inline constexpr Matrix4x4
+        scalarTranspose() const noexcept {
+            Matrix4x4<Type> result{};
+            for (std::size_t x = 0; x < 4; ++x) {
+                for (std::size_t y = 0; y < 4; ++y)
+                    result[x][y] = m_data[y][x];
+            }
+            return result;
+        }
+
+        [[nodiscard]] inline constexpr Matrix4x4
+        transpose() const noexcept {
+            if constexpr (std::is_same_v<Type, float>) {
+                if (!std::is_constant_evaluated()) {
+                    Matrix4x4 result;
+                    simd::matrixKernels().transpose(*this, result);
+                    return result;
+                }
+            }
+            return scalarTranspose();
+        }
     };
 
     [[nodiscard]] Matrix4x4<float>
     createCameraViewMatrix(Vector3f forward, Vector3f up) noexcept;
 
+    /**
+     * Like the function above, followed by a translation by -position, but
+     * without multiplying the matrices.
+     */
+    [[nodiscard]] Matrix4x4<float>
+    createCameraViewMatrix(Vector3f forward, Vector3f up, Vector3f position) noexcept;
+
     [[nodiscard]] Matrix4x4<float>
     createPerspectiveProjectionMatrix(float fov, float width, float height, float zNear, float zFar) noexcept;
 
@@ -0,0 +1,78 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <cassert>
+
+#include "Source/Math/Matrix4x4.hpp"
+#include "Source/Math/Vector.hpp"
+
+namespace math {
+
+    /**
+     * Computes projection * view, for a projection of
+     * createPerspectiveProjectionMatrix(). Only its five non-zero elements
+     * are used, so every row of the result is at most two scaled rows of
+     * the view matrix.
+     */
+    [[nodiscard]] inline Matrix4x4<float>
+    createViewProjectionMatrix(const Matrix4x4<float> &projection, const Matrix4x4<float> &view) noexcept {
+        assert(projection[0][1] == 0 && projection[0][2] == 0 && projection[0][3] == 0);
+        assert(projection[1][0] == 0 && projection[1][2] == 0 && projection[1][3] == 0);
+        assert(projection[2][0] == 0 && projection[2][1] == 0);
+        assert(projection[3][0] == 0 && projection[3][1] == 0 && projection[3][2] == 1 && projection[3][3] == 0);
+
+        Matrix4x4<float> result{};
+        for (std::size_t column = 0; column < 4; ++column) {
+            result[0][column] = projection[0][0] * view[0][column];
+            result[1][column] = projection[1][1] * view[1][column];
+            result[2][column] = projection[2][2] * view[2][column] + projection[2][3] * view[3][column];
+            result[3][column] = view[2][column];
+        }
+        return result;
+    }
+
+    enum class FrustumPlane {
+        LEFT,
+        RIGHT,
+        BOTTOM,
+        TOP,
+        NEAR,
+        FAR,
+    };
+
+    /**
+     * Extracts the planes of the view frustum from a view-projection matrix
+     * (Gribb & Hartmann), indexed by FrustumPlane. A plane (a, b, c, d) is
+     * normalized, and points inside the frustum have a positive distance
+     * a * x + b * y + c * z + d to it.
+     */
+    [[nodiscard]] inline std::array<Vector4f, 6>
+    extractFrustumPlanes(const Matrix4x4<float> &viewProjection) noexcept {
+        const auto row = [&] (std::size_t index) {
+            return Vector4f{viewProjection[index][0], viewProjection[index][1],
+                            viewProjection[index][2], viewProjection[index][3]};
+        };
+
+        const auto w = row(3);
+        std::array<Vector4f, 6> planes{
+            w.add(row(0)), w.subtract(row(0)),
+            w.add(row(1)), w.subtract(row(1)),
+            w.add(row(2)), w.subtract(row(2)),
+        };
+
+        for (auto &plane : planes)
+            plane = plane.div(plane.xyz().length());
+        return planes;
+    }
+
+} // namespace math
@@ -10,6 +10,7 @@
 
 #include <cmath>
 
+#include "Source/Math/Math.hpp"
 #include "Source/Math/Vector.hpp"
 
 namespace math {
@@ -29,6 +30,31 @@ namespace math {
                 : m_data{x, y, z, w} {
         }
 
+        [[nodiscard]] inline constexpr bool
+        operator==(const Quaternion &) const noexcept = default;
+
+        /**
+         * Creates the rotation of Matrix4x4::rotate() for the same Euler
+         * angles in degrees, i.e. around the x-axis first, then y, then z.
+         */
+        [[nodiscard]] inline static Quaternion
+        fromEulerAngles(const Vector<Type, 3> &degrees) noexcept {
+            const auto halfX = toRadians(degrees.x()) / 2;
+            const auto halfY = toRadians(degrees.y()) / 2;
+            const auto halfZ = toRadians(degrees.z()) / 2;
+
+            // Matrix4x4::rotate() turns the other way around the y-axis.
+            const Quaternion rx{std::sin(halfX), 0, 0, std::cos(halfX)};
+            const Quaternion ry{0, -std::sin(halfY), 0, std::cos(halfY)};
+            const Quaternion rz{0, 0, std::sin(halfZ), std::cos(halfZ)};
+            return rz.mul(ry.mul(rx));
+        }
+
+        [[nodiscard]] inline static constexpr Quaternion
+        identity() noexcept {
+            return {0, 0, 0, 1};
+        }
+
         [[nodiscard]] inline constexpr Type
         x() const noexcept {
             return m_data[0];
@@ -49,6 +75,17 @@ namespace math {
             return m_data[3];
         }
 
+        [[nodiscard]] inline Type
+        length() const noexcept {
+            return std::sqrt(x() * x() + y() * y() + z() * z() + w() * w());
+        }
+
+        [[nodiscard]] inline Quaternion
+        normalizeCopy() const noexcept {
+            const auto length = this->length();
+            return {x() / length, y() / length, z() / length, w() / length};
+        }
+
         [[nodiscard]] inline Quaternion
         conjugate() const noexcept {
             return {-x(), -y(), -z(), w()};
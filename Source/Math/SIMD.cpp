@@ -0,0 +1,468 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "SIMD.hpp"
+
+#include "Source/Math/Batch.hpp"
+#include "Source/Math/Matrix4x4.hpp"
+
+#ifdef LAVENDER_MATH_SIMD_AVX2
+#   include <immintrin.h>
+#   ifdef _MSC_VER
+#       include <intrin.h> // for __cpuid, __cpuidex
+#   endif
+#endif
+
+namespace math::simd {
+
+    namespace scalar {
+
+        static void
+        multiply(const Matrix4x4<float> &a, const Matrix4x4<float> &b, Matrix4x4<float> &result) noexcept {
+            result = a.scalarMul(b);
+        }
+
+        static void
+        transpose(const Matrix4x4<float> &matrix, Matrix4x4<float> &result) noexcept {
+            result = matrix.scalarTranspose();
+        }
+
+        static void
+        inverse(const Matrix4x4<float> &matrix, Matrix4x4<float> &result) noexcept {
+            result = matrix.scalarInverse();
+        }
+
+        static void
+        composeTRS(const float *translations, const float *rotations, const float *scalings,
+                   Matrix4x4<float> *result, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto *t = translations + i * 3;
+                const auto *r = rotations + i * 4;
+                const auto *s = scalings + i * 3;
+                math::composeTRS({t[0], t[1], t[2]}, {r[0], r[1], r[2], r[3]}, {s[0], s[1], s[2]}, result[i]);
+            }
+        }
+
+        static void
+        multiplyMany(const Matrix4x4<float> *a, const Matrix4x4<float> *b,
+                     Matrix4x4<float> *result, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; ++i)
+                result[i] = a[i].scalarMul(b[i]);
+        }
+
+        constexpr MatrixKernels Kernels{Isa::SCALAR, &multiply, &transpose, &inverse, &composeTRS, &multiplyMany};
+
+    } // namespace scalar
+
+#ifdef LAVENDER_MATH_SIMD_SSE2
+    namespace sse2 {
+
+        [[nodiscard]] static inline __m128
+        load(const Matrix4x4<float> &matrix, std::size_t row) noexcept {
+            return _mm_load_ps(matrix[row].data());
+        }
+
+        static inline void
+        store(Matrix4x4<float> &matrix, std::size_t row, __m128 value) noexcept {
+            _mm_store_ps(matrix[row].data(), value);
+        }
+
+        template<int Lane>
+        [[nodiscard]] static inline __m128
+        broadcast(__m128 value) noexcept {
+            return _mm_shuffle_ps(value, value, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+        }
+
+        static inline void
+        multiply(const Matrix4x4<float> &a, const Matrix4x4<float> &b, Matrix4x4<float> &result) noexcept {
+            const auto b0 = load(b, 0);
+            const auto b1 = load(b, 1);
+            const auto b2 = load(b, 2);
+            const auto b3 = load(b, 3);
+
+            // Row i of the result is the sum of a[i][k] * row k of b, summed
+            // in the same order as the scalar loop.
+            for (std::size_t row = 0; row < 4; ++row) {
+                const auto rowOfA = load(a, row);
+                auto sum = _mm_mul_ps(broadcast<0>(rowOfA), b0);
+                sum = _mm_add_ps(sum, _mm_mul_ps(broadcast<1>(rowOfA), b1));
+                sum = _mm_add_ps(sum, _mm_mul_ps(broadcast<2>(rowOfA), b2));
+                sum = _mm_add_ps(sum, _mm_mul_ps(broadcast<3>(rowOfA), b3));
+                store(result, row, sum);
+            }
+        }
+
+        static void
+        transpose(const Matrix4x4<float> &matrix, Matrix4x4<float> &result) noexcept {
+            auto row0 = load(matrix, 0);
+            auto row1 = load(matrix, 1);
+            auto row2 = load(matrix, 2);
+            auto row3 = load(matrix, 3);
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+            store(result, 0, row0);
+            store(result, 1, row1);
+            store(result, 2, row2);
+            store(result, 3, row3);
+        }
+
+        template<int X, int Y, int Z, int W>
+        [[nodiscard]] static inline __m128
+        swizzle(__m128 value) noexcept {
+            return _mm_shuffle_ps(value, value, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        template<int X, int Y, int Z, int W>
+        [[nodiscard]] static inline __m128
+        shuffle(__m128 a, __m128 b) noexcept {
+            return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        // The helpers below treat a register as a 2x2 matrix {x y; z w}.
+
+        // A * B
+        [[nodiscard]] static inline __m128
+        multiply2x2(__m128 a, __m128 b) noexcept {
+            return _mm_add_ps(_mm_mul_ps(a, swizzle<0, 3, 0, 3>(b)),
+                              _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+        }
+
+        // adjugate(A) * B
+        [[nodiscard]] static inline __m128
+        adjugateMultiply2x2(__m128 a, __m128 b) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(a), b),
+                              _mm_mul_ps(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+        }
+
+        // A * adjugate(B)
+        [[nodiscard]] static inline __m128
+        multiplyAdjugate2x2(__m128 a, __m128 b) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(a, swizzle<3, 0, 3, 0>(b)),
+                              _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+        }
+
+        /**
+         * Inverts the matrix blockwise, as the 2x2 matrices {A B; C D}.
+         */
+        static void
+        inverse(const Matrix4x4<float> &matrix, Matrix4x4<float> &result) noexcept {
+            const auto row0 = load(matrix, 0);
+            const auto row1 = load(matrix, 1);
+            const auto row2 = load(matrix, 2);
+            const auto row3 = load(matrix, 3);
+
+            const auto a = _mm_movelh_ps(row0, row1);
+            const auto b = _mm_movehl_ps(row1, row0);
+            const auto c = _mm_movelh_ps(row2, row3);
+            const auto d = _mm_movehl_ps(row3, row2);
+
+            // The determinants |A|, |B|, |C| and |D|.
+            const auto determinants = _mm_sub_ps(
+                _mm_mul_ps(shuffle<0, 2, 0, 2>(row0, row2), shuffle<1, 3, 1, 3>(row1, row3)),
+                _mm_mul_ps(shuffle<1, 3, 1, 3>(row0, row2), shuffle<0, 2, 0, 2>(row1, row3))
+            );
+            const auto determinantA = swizzle<0, 0, 0, 0>(determinants);
+            const auto determinantB = swizzle<1, 1, 1, 1>(determinants);
+            const auto determinantC = swizzle<2, 2, 2, 2>(determinants);
+            const auto determinantD = swizzle<3, 3, 3, 3>(determinants);
+
+            const auto adjugateDC = adjugateMultiply2x2(d, c);
+            const auto adjugateAB = adjugateMultiply2x2(a, b);
+
+            // The adjugates of the blocks of the inverse {X Y; Z W}.
+            auto x = _mm_sub_ps(_mm_mul_ps(determinantD, a), multiply2x2(b, adjugateDC));
+            auto w = _mm_sub_ps(_mm_mul_ps(determinantA, d), multiply2x2(c, adjugateAB));
+            auto y = _mm_sub_ps(_mm_mul_ps(determinantB, c), multiplyAdjugate2x2(d, adjugateAB));
+            auto z = _mm_sub_ps(_mm_mul_ps(determinantC, b), multiplyAdjugate2x2(a, adjugateDC));
+
+            // |M| = |A| |D| + |B| |C| - tr(adjugate(A) B adjugate(D) C)
+            auto trace = _mm_mul_ps(adjugateAB, swizzle<0, 2, 1, 3>(adjugateDC));
+            trace = _mm_add_ps(trace, swizzle<1, 0, 3, 2>(trace));
+            trace = _mm_add_ps(trace, swizzle<2, 3, 0, 1>(trace));
+            const auto determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(determinantA, determinantD),
+                                                           _mm_mul_ps(determinantB, determinantC)),
+                                                trace);
+
+            const auto inverseDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+            x = _mm_mul_ps(x, inverseDeterminant);
+            y = _mm_mul_ps(y, inverseDeterminant);
+            z = _mm_mul_ps(z, inverseDeterminant);
+            w = _mm_mul_ps(w, inverseDeterminant);
+
+            // Undo the adjugates while putting the blocks back into rows.
+            store(result, 0, shuffle<3, 1, 3, 1>(x, y));
+            store(result, 1, shuffle<2, 0, 2, 0>(x, y));
+            store(result, 2, shuffle<3, 1, 3, 1>(z, w));
+            store(result, 3, shuffle<2, 0, 2, 0>(z, w));
+        }
+
+        static void
+        multiplyMany(const Matrix4x4<float> *a, const Matrix4x4<float> *b,
+                     Matrix4x4<float> *result, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; ++i)
+                multiply(a[i], b[i], result[i]);
+        }
+
+        // Four lanes don't outweigh deinterleaving the input without
+        // gathers, so composing uses the scalar kernel.
+        constexpr MatrixKernels Kernels{Isa::SSE2, &multiply, &transpose, &inverse, &scalar::composeTRS, &multiplyMany};
+
+    } // namespace sse2
+#endif // LAVENDER_MATH_SIMD_SSE2
+
+#ifdef LAVENDER_MATH_SIMD_AVX2
+    namespace avx2 {
+
+        /**
+         * Computes two rows of the result per register.
+         */
+        LAVENDER_MATH_TARGET_AVX2 static inline void
+        multiply(const Matrix4x4<float> &a, const Matrix4x4<float> &b, Matrix4x4<float> &result) noexcept {
+            const auto b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[0].data()));
+            const auto b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[1].data()));
+            const auto b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[2].data()));
+            const auto b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[3].data()));
+
+            for (std::size_t row = 0; row < 4; row += 2) {
+                const auto rows = _mm256_loadu_ps(a[row].data());
+                auto sum = _mm256_mul_ps(_mm256_permute_ps(rows, 0x00), b0);
+                sum = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0x55), b1, sum);
+                sum = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xAA), b2, sum);
+                sum = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xFF), b3, sum);
+                _mm256_storeu_ps(result[row].data(), sum);
+            }
+        }
+
+        LAVENDER_MATH_TARGET_AVX2 static void
+        multiplyMany(const Matrix4x4<float> *a, const Matrix4x4<float> *b,
+                     Matrix4x4<float> *result, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; ++i)
+                multiply(a[i], b[i], result[i]);
+        }
+
+        // Transposes the rows r[0..7], i.e. row i gets lane i of every input.
+        LAVENDER_MATH_TARGET_AVX2 static inline void
+        transpose8x8(__m256 *r) noexcept {
+            const auto t0 = _mm256_unpacklo_ps(r[0], r[1]);
+            const auto t1 = _mm256_unpackhi_ps(r[0], r[1]);
+            const auto t2 = _mm256_unpacklo_ps(r[2], r[3]);
+            const auto t3 = _mm256_unpackhi_ps(r[2], r[3]);
+            const auto t4 = _mm256_unpacklo_ps(r[4], r[5]);
+            const auto t5 = _mm256_unpackhi_ps(r[4], r[5]);
+            const auto t6 = _mm256_unpacklo_ps(r[6], r[7]);
+            const auto t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+            const auto u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            const auto u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            const auto u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            const auto u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            const auto u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+            const auto u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+            const auto u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+            const auto u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+            r[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+            r[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+            r[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+            r[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+            r[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+            r[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+            r[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+            r[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+        }
+
+        /**
+         * Composes eight matrices at a time, with every lane holding one
+         * transformation, and transposes the elements into the matrices.
+         */
+        LAVENDER_MATH_TARGET_AVX2 static void
+        composeTRS(const float *translations, const float *rotations, const float *scalings,
+                   Matrix4x4<float> *result, std::size_t count) noexcept {
+            const auto stride3 = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+            const auto stride4 = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+            const auto one = _mm256_set1_ps(1.0f);
+            const auto two = _mm256_set1_ps(2.0f);
+
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const auto *t = translations + i * 3;
+                const auto *r = rotations + i * 4;
+                const auto *s = scalings + i * 3;
+
+                const auto x = _mm256_i32gather_ps(r + 0, stride4, 4);
+                const auto y = _mm256_i32gather_ps(r + 1, stride4, 4);
+                const auto z = _mm256_i32gather_ps(r + 2, stride4, 4);
+                const auto w = _mm256_i32gather_ps(r + 3, stride4, 4);
+
+                const auto sx = _mm256_i32gather_ps(s + 0, stride3, 4);
+                const auto sy = _mm256_i32gather_ps(s + 1, stride3, 4);
+                const auto sz = _mm256_i32gather_ps(s + 2, stride3, 4);
+
+                const auto xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+                const auto xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+                const auto wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+                // The first and last eight elements of the matrices.
+                __m256 upper[8] = {
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                    _mm256_i32gather_ps(t + 0, stride3, 4),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                    _mm256_i32gather_ps(t + 1, stride3, 4),
+                };
+                __m256 lower[8] = {
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+                    _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+                    _mm256_i32gather_ps(t + 2, stride3, 4),
+                    _mm256_setzero_ps(),
+                    _mm256_setzero_ps(),
+                    _mm256_setzero_ps(),
+                    one,
+                };
+
+                transpose8x8(upper);
+                transpose8x8(lower);
+                for (std::size_t lane = 0; lane < 8; ++lane) {
+                    _mm256_storeu_ps(result[i + lane][0].data(), upper[lane]);
+                    _mm256_storeu_ps(result[i + lane][2].data(), lower[lane]);
+                }
+            }
+
+            scalar::composeTRS(translations + i * 3, rotations + i * 4, scalings + i * 3, result + i, count - i);
+        }
+
+        [[nodiscard]] static bool
+        isSupported() noexcept {
+#ifdef _MSC_VER
+            int registers[4];
+            __cpuid(registers, 1);
+            const bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+            const bool hasFMA = (registers[2] & (1 << 12)) != 0;
+            if (!hasOSXSave || !hasFMA)
+                return false;
+
+            // The OS must save the YMM registers.
+            if ((_xgetbv(0) & 0x6) != 0x6)
+                return false;
+
+            __cpuidex(registers, 7, 0);
+            return (registers[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }
+
+        // Transposing and inverting don't gain from the wider registers.
+        constexpr MatrixKernels Kernels{Isa::AVX2, &multiply, &sse2::transpose, &sse2::inverse, &composeTRS, &multiplyMany};
+
+    } // namespace avx2
+#endif // LAVENDER_MATH_SIMD_AVX2
+
+#ifdef LAVENDER_MATH_SIMD_NEON
+    namespace neon {
+
+        static inline void
+        multiply(const Matrix4x4<float> &a, const Matrix4x4<float> &b, Matrix4x4<float> &result) noexcept {
+            const auto b0 = vld1q_f32(b[0].data());
+            const auto b1 = vld1q_f32(b[1].data());
+            const auto b2 = vld1q_f32(b[2].data());
+            const auto b3 = vld1q_f32(b[3].data());
+
+            for (std::size_t row = 0; row < 4; ++row) {
+                const auto rowOfA = vld1q_f32(a[row].data());
+                auto sum = vmulq_laneq_f32(b0, rowOfA, 0);
+                sum = vaddq_f32(sum, vmulq_laneq_f32(b1, rowOfA, 1));
+                sum = vaddq_f32(sum, vmulq_laneq_f32(b2, rowOfA, 2));
+                sum = vaddq_f32(sum, vmulq_laneq_f32(b3, rowOfA, 3));
+                vst1q_f32(result[row].data(), sum);
+            }
+        }
+
+        static void
+        transpose(const Matrix4x4<float> &matrix, Matrix4x4<float> &result) noexcept {
+            const auto rows01 = vtrnq_f32(vld1q_f32(matrix[0].data()), vld1q_f32(matrix[1].data()));
+            const auto rows23 = vtrnq_f32(vld1q_f32(matrix[2].data()), vld1q_f32(matrix[3].data()));
+            vst1q_f32(result[0].data(), vcombine_f32(vget_low_f32(rows01.val[0]), vget_low_f32(rows23.val[0])));
+            vst1q_f32(result[1].data(), vcombine_f32(vget_low_f32(rows01.val[1]), vget_low_f32(rows23.val[1])));
+            vst1q_f32(result[2].data(), vcombine_f32(vget_high_f32(rows01.val[0]), vget_high_f32(rows23.val[0])));
+            vst1q_f32(result[3].data(), vcombine_f32(vget_high_f32(rows01.val[1]), vget_high_f32(rows23.val[1])));
+        }
+
+        static void
+        multiplyMany(const Matrix4x4<float> *a, const Matrix4x4<float> *b,
+                     Matrix4x4<float> *result, std::size_t count) noexcept {
+            for (std::size_t i = 0; i < count; ++i)
+                multiply(a[i], b[i], result[i]);
+        }
+
+        constexpr MatrixKernels Kernels{Isa::NEON, &multiply, &transpose, &scalar::inverse, &scalar::composeTRS, &multiplyMany};
+
+    } // namespace neon
+#endif // LAVENDER_MATH_SIMD_NEON
+
+    Isa
+    detectIsa() noexcept {
+#if defined(LAVENDER_MATH_SIMD_AVX2)
+        if (avx2::isSupported())
+            return Isa::AVX2;
+#endif
+#if defined(LAVENDER_MATH_SIMD_SSE2)
+        return Isa::SSE2;
+#elif defined(LAVENDER_MATH_SIMD_NEON)
+        return Isa::NEON;
+#else
+        return Isa::SCALAR;
+#endif
+    }
+
+    const MatrixKernels *
+    matrixKernelsFor(Isa isa) noexcept {
+        switch (isa) {
+            case Isa::SCALAR:
+                return &scalar::Kernels;
+            case Isa::SSE2:
+#ifdef LAVENDER_MATH_SIMD_SSE2
+                return &sse2::Kernels;
+#else
+                return nullptr;
+#endif
+            case Isa::AVX2:
+#ifdef LAVENDER_MATH_SIMD_AVX2
+                return avx2::isSupported() ? &avx2::Kernels : nullptr;
+#else
+                return nullptr;
+#endif
+            case Isa::NEON:
+#ifdef LAVENDER_MATH_SIMD_NEON
+                return &neon::Kernels;
+#else
+                return nullptr;
+#endif
+        }
+
+        return nullptr;
+    }
+
+    std::string_view
+    toString(Isa isa) noexcept {
+        switch (isa) {
+            case Isa::SCALAR: return "scalar";
+            case Isa::SSE2: return "SSE2";
+            case Isa::AVX2: return "AVX2";
+            case Isa::NEON: return "NEON";
+        }
+
+        return "(invalid)";
+    }
+
+} // namespace math::simd
@@ -0,0 +1,133 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <cmath> // for std::sqrt
+#include <cstddef> // for std::size_t
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define LAVENDER_MATH_SIMD_SSE2
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#   include <arm_neon.h>
+#   define LAVENDER_MATH_SIMD_NEON
+#endif
+
+// The AVX2 kernels are compiled in on x86-64, and only used when the CPU
+// supports them. Translation units that define them include <immintrin.h>.
+#if defined(LAVENDER_MATH_SIMD_SSE2) && (defined(__x86_64__) || defined(_M_X64))
+#   define LAVENDER_MATH_SIMD_AVX2
+#   ifdef _MSC_VER
+#       define LAVENDER_MATH_TARGET_AVX2
+#   else
+#       define LAVENDER_MATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#   endif
+#endif
+
+namespace math {
+
+    template<typename Type>
+    class Matrix4x4;
+
+} // namespace math
+
+/**
+ * The SIMD kernels of the float vectors and matrices.
+ *
+ * SSE2 and NEON are part of the baseline of x86-64 and AArch64, so the
+ * Vector4f operations use them directly. The Matrix4x4<float> kernels are
+ * larger and can use instructions that not every CPU has, e.g. AVX2 with
+ * FMA, so they are picked once, at the first use, for the CPU it runs on.
+ *
+ * The SSE2 and NEON kernels sum in the same order as the scalar code, and
+ * give the same results, except for inverse(). The AVX2 kernels fuse the
+ * multiplications and additions, so they can be a few ULPs off.
+ */
+namespace math::simd {
+
+    enum class Isa {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON,
+    };
+
+    struct MatrixKernels {
+        Isa isa;
+
+        void (*multiply)(const Matrix4x4<float> &, const Matrix4x4<float> &, Matrix4x4<float> &result) noexcept;
+        void (*transpose)(const Matrix4x4<float> &, Matrix4x4<float> &result) noexcept;
+        void (*inverse)(const Matrix4x4<float> &, Matrix4x4<float> &result) noexcept;
+
+        // The kernels behind Source/Math/Batch.hpp. The translations and
+        // scalings are packed as xyz, and the rotations as quaternions in
+        // xyzw order.
+        void (*composeTRS)(const float *translations, const float *rotations, const float *scalings,
+                           Matrix4x4<float> *result, std::size_t count) noexcept;
+        void (*multiplyMany)(const Matrix4x4<float> *, const Matrix4x4<float> *,
+                             Matrix4x4<float> *result, std::size_t count) noexcept;
+    };
+
+    /**
+     * The best instruction set that the CPU supports and Lavender was
+     * compiled with kernels for.
+     */
+    [[nodiscard]] Isa
+    detectIsa() noexcept;
+
+    /**
+     * Returns null when the kernels of the instruction set weren't compiled
+     * in, or the CPU doesn't support them.
+     */
+    [[nodiscard]] const MatrixKernels *
+    matrixKernelsFor(Isa) noexcept;
+
+    [[nodiscard]] inline const MatrixKernels &
+    matrixKernels() noexcept {
+        static const MatrixKernels &kernels = *matrixKernelsFor(detectIsa());
+        return kernels;
+    }
+
+    [[nodiscard]] std::string_view
+    toString(Isa) noexcept;
+
+    [[nodiscard]] inline float
+    dot4(const float *a, const float *b) noexcept {
+#if defined(LAVENDER_MATH_SIMD_SSE2)
+        const auto products = _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+        auto sum = _mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1, 1, 1, 1)));
+        sum = _mm_add_ss(sum, _mm_movehl_ps(products, products));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(products, products, _MM_SHUFFLE(3, 3, 3, 3)));
+        return _mm_cvtss_f32(sum);
+#elif defined(LAVENDER_MATH_SIMD_NEON)
+        const auto products = vmulq_f32(vld1q_f32(a), vld1q_f32(b));
+        return vgetq_lane_f32(products, 0) + vgetq_lane_f32(products, 1)
+             + vgetq_lane_f32(products, 2) + vgetq_lane_f32(products, 3);
+#else
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+#endif
+    }
+
+    inline void
+    normalize4(float *vector) noexcept {
+        const auto length = std::sqrt(dot4(vector, vector));
+#if defined(LAVENDER_MATH_SIMD_SSE2)
+        _mm_storeu_ps(vector, _mm_div_ps(_mm_loadu_ps(vector), _mm_set1_ps(length)));
+#elif defined(LAVENDER_MATH_SIMD_NEON)
+        vst1q_f32(vector, vdivq_f32(vld1q_f32(vector), vdupq_n_f32(length)));
+#else
+        for (std::size_t i = 0; i < 4; ++i)
+            vector[i] /= length;
+#endif
+    }
+
+} // namespace math::simd
@@ -6,27 +6,110 @@
 
 #pragma once
 
+#include "Source/Math/Batch.hpp"
 #include "Source/Math/Matrix4x4.hpp"
+#include "Source/Math/Quaternion.hpp"
 #include "Source/Math/Vector.hpp"
 
 namespace math {
 
-    struct Transformation {
-        Vector<float, 3> translation{};
-        Vector<float, 3> rotation{};
-        Vector<float, 3> scaling{1.0f, 1.0f, 1.0f};
+    /**
+     * A translation, rotation and scaling, which are applied in the reverse
+     * order. The rotation is a unit quaternion.
+     *
+     * The matrix is cached, and only composed again after the transformation
+     * was changed. Because toMatrix() fills in that cache, it must not be
+     * called concurrently on the same object.
+     */
+    class Transformation {
+    public:
+        [[nodiscard]] inline constexpr
+        Transformation() noexcept = default;
 
-        [[nodiscard]] Matrix4x4<float>
-        toMatrix() const noexcept {
-            // TODO maybe its better to only calculate this when something
-            //      changes, and cache the result of that.
+        [[nodiscard]] inline constexpr explicit
+        Transformation(const Vector<float, 3> &inTranslation,
+                       const Quaternion<float> &inRotation = Quaternion<float>::identity(),
+                       const Vector<float, 3> &inScaling = {1.0f, 1.0f, 1.0f}) noexcept
+                : m_translation(inTranslation)
+                , m_rotation(inRotation)
+                , m_scaling(inScaling) {
+        }
+
+        /**
+         * Creates a transformation with the rotation in Euler angles, in
+         * degrees, like Matrix4x4::rotate().
+         */
+        [[nodiscard]] inline static Transformation
+        fromEulerAngles(const Vector<float, 3> &translation, const Vector<float, 3> &degrees,
+                        const Vector<float, 3> &scaling = {1.0f, 1.0f, 1.0f}) noexcept {
+            return Transformation{translation, Quaternion<float>::fromEulerAngles(degrees), scaling};
+        }
+
+        /**
+         * Compares the transformations, but not whether their matrices were
+         * cached.
+         */
+        [[nodiscard]] inline constexpr bool
+        operator==(const Transformation &other) const noexcept {
+            return m_translation == other.m_translation
+                && m_rotation == other.m_rotation
+                && m_scaling == other.m_scaling;
+        }
+
+        [[nodiscard]] inline constexpr const Quaternion<float> &
+        rotation() const noexcept {
+            return m_rotation;
+        }
+
+        [[nodiscard]] inline constexpr const Vector<float, 3> &
+        scaling() const noexcept {
+            return m_scaling;
+        }
+
+        inline void
+        setEulerRotation(const Vector<float, 3> &degrees) noexcept {
+            setRotation(Quaternion<float>::fromEulerAngles(degrees));
+        }
+
+        inline constexpr void
+        setRotation(const Quaternion<float> &rotation) noexcept {
+            m_rotation = rotation;
+            m_matrixIsStale = true;
+        }
 
-            const auto translationMatrix = Matrix4x4<float>().translate(translation);
-            const auto rotationMatrix = Matrix4x4<float>().rotate(rotation);
-            const auto scalingMatrix = Matrix4x4<float>().scale(scaling);
+        inline constexpr void
+        setScaling(const Vector<float, 3> &scaling) noexcept {
+            m_scaling = scaling;
+            m_matrixIsStale = true;
+        }
 
-            return translationMatrix.mul(rotationMatrix.mul(scalingMatrix));
+        inline constexpr void
+        setTranslation(const Vector<float, 3> &translation) noexcept {
+            m_translation = translation;
+            m_matrixIsStale = true;
         }
+
+        [[nodiscard]] inline const Matrix4x4<float> &
+        toMatrix() const noexcept {
+            if (m_matrixIsStale) {
+                composeTRS(m_translation, m_rotation, m_scaling, m_matrix);
+                m_matrixIsStale = false;
+            }
+            return m_matrix;
+        }
+
+        [[nodiscard]] inline constexpr const Vector<float, 3> &
+        translation() const noexcept {
+            return m_translation;
+        }
+
+    private:
+        Vector<float, 3> m_translation{};
+        Quaternion<float> m_rotation{Quaternion<float>::identity()};
+        Vector<float, 3> m_scaling{1.0f, 1.0f, 1.0f};
+
+        mutable Matrix4x4<float> m_matrix{};
+        mutable bool m_matrixIsStale{true};
     };
 
 } // namespace math
@@ -7,19 +7,28 @@
 #pragma once
 
 #include <array>
+#include <type_traits> // for std::is_same_v
 
 #include <cmath>
 
 #include "Source/Math/Math.hpp"
+#include "Source/Math/SIMD.hpp"
 
 namespace math {
 
     template <typename T, typename F>
     concept Convertibles = std::is_same_v<T, F>;
 
+    template <typename Type, std::size_t Dimensions>
+    inline constexpr bool isSimdVector = std::is_same_v<Type, float> && Dimensions == 4;
+
+    /**
+     * Vector4f is aligned to 16 bytes, so it fits a SIMD register, and uses
+     * the math::simd kernels for dot(), length() and normalize().
+     */
     template <typename Type, std::size_t Dimensions>
         requires(Dimensions >= 2)
-    class Vector {
+    class alignas(isSimdVector<Type, Dimensions> ? 16 : alignof(std::array<Type, Dimensions>)) Vector {
         std::array<Type, Dimensions> m_data{};
 
     public:
@@ -29,6 +38,9 @@ namespace math {
         Vector &operator=(Vector &&) = default;
         Vector &operator=(const Vector &) = default;
 
+        [[nodiscard]] constexpr bool
+        operator==(const Vector &) const noexcept = default;
+
         template <Convertibles<Type>... CType>
         [[nodiscard]] inline constexpr
         Vector(CType... values) noexcept
@@ -160,6 +172,9 @@ namespace math {
 
         [[nodiscard]] inline Type
         dot(const Vector<Type, Dimensions> &other) const noexcept {
+            if constexpr (isSimdVector<Type, Dimensions>)
+                return simd::dot4(m_data.data(), other.m_data.data());
+
             Type total = 0;
             for (std::size_t i = 0; i < Dimensions; ++i)
                 total += this->m_data[i] * other.m_data[i];
@@ -168,6 +183,9 @@ namespace math {
 
         [[nodiscard]] inline Type
         length() const noexcept {
+            if constexpr (isSimdVector<Type, Dimensions>)
+                return std::sqrt(simd::dot4(m_data.data(), m_data.data()));
+
             Type total = 0;
             for (std::size_t i = 0; i < Dimensions; ++i)
                 total += m_data[i] * m_data[i];
@@ -176,6 +194,11 @@ namespace math {
 
         [[nodiscard]] inline Vector<Type, Dimensions> &
         normalize() noexcept {
+            if constexpr (isSimdVector<Type, Dimensions>) {
+                simd::normalize4(m_data.data());
+                return *this;
+            }
+
             const auto length = this->length();
 
             for (std::size_t i = 0; i < Dimensions; ++i)
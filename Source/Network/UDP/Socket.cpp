@@ -149,11 +149,11 @@ namespace network::udp {
         }
     }
 
-    base::Task
+    base::Task<base::Error>
     Socket::bind(SocketAddress address) noexcept {
         m_localAddress = address;
 
-        return base::Task::create<base::Error>([this] {
+        return base::Task<base::Error>::run([this] {
             TRY(doCreateSocket())
             TRY(setReuseSocket(m_socket))
             TRY(doBind())
@@ -161,17 +161,17 @@ namespace network::udp {
         });
     }
 
-    base::Task
+    base::Task<base::Error>
     Socket::connect(SocketAddress address) noexcept {
         return connect(address, SocketAddress{ IPv4Address{0, 0, 0, 0}, Port{0} });
     }
 
-    base::Task
+    base::Task<base::Error>
     Socket::connect(SocketAddress remoteAddress, SocketAddress localAddress) noexcept {
         m_remoteAddress = remoteAddress;
         m_localAddress = localAddress;
         
-        return base::Task::create<base::Error>([this] {
+        return base::Task<base::Error>::run([this] {
             if (m_remoteAddress->port().value() == 0)
                 return errors.error("Validate SocketAddress", "Port is 0");
 
@@ -291,13 +291,13 @@ namespace network::udp {
         return base::Error::success();
     }
 
-    base::Task
+    base::Task<base::Error>
     Socket::joinMultiCastGroup(SocketAddress address) noexcept {
         m_localAddress = {IPv4Address{0, 0, 0, 0}, address.port()};
         m_multiCastGroup = address;
         m_remoteAddress = address;
 
-        return base::Task::create<base::Error>([this] {
+        return base::Task<base::Error>::run([this] {
             if (m_multiCastGroup->port().value() == 0)
                 return errors.error("Validate SocketAddress", "Port is 0");
 
@@ -330,9 +330,9 @@ namespace network::udp {
         return base::Error::success();
     }
 
-    base::Task
+    base::Task<base::ErrorOr<std::string>>
     Socket::read(const std::size_t bytes) noexcept {
-        return base::Task::create<base::Error>([&] () -> base::ErrorOr<std::string> {
+        return base::Task<base::ErrorOr<std::string>>::run([this, bytes] () -> base::ErrorOr<std::string> {
             std::string data(bytes, '\0');
 
             std::size_t index = 0;
@@ -370,9 +370,9 @@ namespace network::udp {
         return {std::move(data)};
     }
 
-    base::Task
+    base::Task<base::Error>
     Socket::write(std::string_view data) noexcept {
-        return base::Task::create<base::Error>([dataOwner = std::string(data), this]() -> base::Error {
+        return base::Task<base::Error>::run([dataOwner = std::string(data), this]() -> base::Error {
             std::string_view data{dataOwner};
             sockaddr_in groupSock{
                 .sin_family = AF_INET,
@@ -25,20 +25,24 @@
 
 namespace network::udp {
 
+    /**
+     * The functions returning a base::Task are already running on the global
+     * ThreadPool when they return.
+     */
     class Socket {
     public:
         ~Socket() noexcept;
 
-        [[nodiscard]] base::Task
+        [[nodiscard]] base::Task<base::Error>
         bind(SocketAddress) noexcept;
 
-        [[nodiscard]] base::Task
+        [[nodiscard]] base::Task<base::Error>
         connect(SocketAddress remoteAddress) noexcept;
 
-        [[nodiscard]] base::Task
+        [[nodiscard]] base::Task<base::Error>
         connect(SocketAddress remoteAddress, SocketAddress localAddress) noexcept;
 
-        [[nodiscard]] base::Task
+        [[nodiscard]] base::Task<base::Error>
         joinMultiCastGroup(SocketAddress) noexcept;
 
         [[nodiscard]] base::Error
@@ -49,13 +53,13 @@ namespace network::udp {
             return m_multiCastInterface;
         }
 
-        [[nodiscard]] base::Task
+        [[nodiscard]] base::Task<base::ErrorOr<std::string>>
         read(std::size_t bytes) noexcept;
 
         [[nodiscard]] base::ErrorOr<std::string>
         readSynchronously() noexcept;
 
-        [[nodiscard]] base::Task
+        [[nodiscard]] base::Task<base::Error>
         write(std::string_view) noexcept;
 
     private:
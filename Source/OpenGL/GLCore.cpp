@@ -10,7 +10,10 @@
 
 #include "Source/OpenGL/GLCore.hpp"
 
+#include <algorithm> // for std::find_if, std::sort, std::unique
+#include <array>
 #include <type_traits>
+#include <unordered_set>
 
 #define FMT_HEADER_ONLY
 #include <fmt/core.h>
@@ -18,9 +21,11 @@
 #include <GL/glew.h>
 
 #include "Source/ECS/EntityList.hpp"
+#include "Source/ECS/Scene.hpp"
 #include "Source/Interface/Camera.hpp"
 #include "Source/OpenGL/DebugMessenger.hpp"
 #include "Source/OpenGL/Renderer/DeferredRenderer.hpp"
+#include "Source/Resources/InterleavedMesh.hpp"
 #include "Source/Resources/MaterialDescriptor.hpp"
 #include "Source/Window/WindowAPI.hpp"
 
@@ -313,6 +318,13 @@ namespace gle {
             } else if (event.key() == input::KeyboardKey::NUMPAD3) {
                 onGraphicsModeChange.invoke("RenderMode: DiffuseColorBuffer").displayErrorMessageBox();
                 m_renderer->renderMode(RenderMode::DEBUG_COLOR);
+            } else if (event.key() == input::KeyboardKey::NUMPAD9) {
+                m_optimizeMeshes = !m_optimizeMeshes;
+                fmt::print("[GL] Meshes that are imported from now on are {}optimized\n", m_optimizeMeshes ? "" : "not ");
+            } else if (event.key() == input::KeyboardKey::NUMPAD8) {
+                m_generateLevelsOfDetail = !m_generateLevelsOfDetail;
+                fmt::print("[GL] Meshes that are imported from now on {} levels of detail\n",
+                           m_generateLevelsOfDetail ? "get" : "don't get");
             }
 
             return base::Error::success();
@@ -378,11 +390,21 @@ namespace gle {
         m_renderer->onResize(size);
     }
 
+    std::optional<math::Matrix4x4<float>>
+    Core::projectionMatrix() const noexcept {
+        return m_renderer->projectionMatrix();
+    }
+
+    float
+    Core::projectionScale() const noexcept {
+        return m_renderer->projectionScale();
+    }
+
     void
-    Core::renderEntities() noexcept {
+    Core::renderEntities(const resources::DrawList &drawList) noexcept {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        m_renderer->render();
+        m_renderer->render(drawList);
 
         GLenum err;
         while ((err = glGetError()) != GL_NO_ERROR) {
@@ -391,6 +413,83 @@ namespace gle {
         }
     }
 
+    void
+    Core::unloadUnusedModels() noexcept {
+        if (m_loadingSceneCount != 0)
+            return;
+
+        std::unordered_set<const resources::ModelDescriptor *> usedModels{};
+        for (const auto &entity : m_scene->entityList().data()) {
+            if (entity->modelDescriptor() != nullptr)
+                usedModels.insert(entity->modelDescriptor());
+        }
+
+        const auto modelCount = std::size(m_modelDescriptors);
+        std::erase_if(m_modelDescriptors, [&] (const auto &model) { return !usedModels.contains(model.get()); });
+
+        std::unordered_set<const resources::ModelGeometryDescriptor *> usedGeometry{};
+        for (const auto &model : m_modelDescriptors) {
+            usedGeometry.insert(model->geometryDescriptor());
+            for (const auto &level : model->levelsOfDetail())
+                usedGeometry.insert(level.geometryDescriptor);
+        }
+
+        const auto geometryCount = std::size(m_geometryDescriptors);
+        std::erase_if(m_geometryDescriptors, [&] (const auto &geometry) {
+            if (usedGeometry.contains(geometry.get()))
+                return false;
+
+            if (geometry->arena() != nullptr) {
+                geometry->arena()->free(*geometry);
+                return true;
+            }
+
+            // The buffer objects of standalone geometry may be shared, see
+            // ModelGeometryDescriptor.
+            std::array buffers{geometry->vbo(), geometry->ebo(), geometry->tbo(), geometry->nbo(),
+                               geometry->tangentBufferObject(), geometry->bitangentBufferObject()};
+            std::sort(std::begin(buffers), std::end(buffers));
+            const auto end = std::unique(std::begin(buffers), std::end(buffers));
+            glDeleteBuffers(static_cast<GLsizei>(std::distance(std::begin(buffers), end)), std::data(buffers));
+
+            const auto vao = geometry->vao();
+            glDeleteVertexArrays(1, &vao);
+            return true;
+        });
+
+        std::erase_if(m_geometryArenas, [] (const auto &arena) { return arena->isEmpty(); });
+
+        std::size_t arenaSize{0};
+        for (auto &arena : m_geometryArenas) {
+            if (auto error = arena->defragment())
+                error.displayErrorMessageBox();
+            arenaSize += arena->size();
+        }
+
+        fmt::print("[GL] Unloaded {} models and {} geometries, {} arenas of {} KiB are left\n",
+                   modelCount - std::size(m_modelDescriptors), geometryCount - std::size(m_geometryDescriptors),
+                   std::size(m_geometryArenas), arenaSize / 1024);
+    }
+
+    base::ErrorOr<std::vector<ModelGeometryDescriptor *>>
+    Core::uploadInterleavedMesh(const resources::InterleavedMesh &mesh, const AttributeLocations &attributeLocations) noexcept {
+        auto arena = std::find_if(std::begin(m_geometryArenas), std::end(m_geometryArenas),
+                                  [&] (const auto &candidate) { return candidate->matches(mesh.layout, attributeLocations); });
+        if (arena == std::end(m_geometryArenas)) {
+            m_geometryArenas.push_back(std::make_unique<GeometryArena>(mesh.layout, attributeLocations));
+            arena = std::prev(std::end(m_geometryArenas));
+        }
+
+        TRY_GET_VARIABLE(descriptors, (*arena)->upload(mesh))
+
+        std::vector<ModelGeometryDescriptor *> result{};
+        for (auto &descriptor : descriptors) {
+            result.push_back(descriptor.get());
+            m_geometryDescriptors.push_back(std::move(descriptor));
+        }
+        return result;
+    }
+
     base::ErrorOr<const resources::ModelDescriptor *>
     Core::uploadModelDescriptor(resources::ModelDescriptor &&modelDescriptor) noexcept {
         m_modelDescriptors.push_back(std::make_unique<resources::ModelDescriptor>(std::forward<resources::ModelDescriptor>(modelDescriptor)));
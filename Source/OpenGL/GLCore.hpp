@@ -13,12 +13,15 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include <cstdint>
 
+#include "Source/Base/StageTimings.hpp"
 #include "Source/GraphicsAPI.hpp"
 #include "Source/Math/Size2D.hpp"
+#include "Source/OpenGL/GeometryArena.hpp"
 #include "Source/OpenGL/ModelGeometryDescriptor.hpp"
 #include "Source/OpenGL/Renderer/Renderer.hpp"
 #include "Source/OpenGL/Renderer/SkyBoxRenderer.hpp"
@@ -27,16 +30,29 @@
 #include "Source/OpenGL/Shaders/ShaderProgram.hpp"
 #include "Source/OpenGL/Shaders/Uniform.hpp"
 #include "Source/OpenGL/TextureDescriptor.hpp"
+#include "Source/Resources/MeshOptimizer.hpp"
 #include "Source/Resources/ModelGeometry.hpp"
 
+namespace resources {
+    struct InterleavedMesh;
+} // namespace resources
+
+namespace io::format::gltf {
+    struct Context;
+    struct ImageLoader;
+} // namespace io::format::gltf
+
 namespace gle {
 
+    struct GLTFPrimitiveJobs;
+
     class Core
             : public GraphicsAPI {
         WindowAPI *m_windowAPI{nullptr};
 
         std::vector<std::unique_ptr<resources::MaterialDescriptor>> m_materialDescriptors{};
         std::vector<std::unique_ptr<ModelGeometryDescriptor>> m_geometryDescriptors{};
+        std::vector<std::unique_ptr<GeometryArena>> m_geometryArenas{};
         std::vector<std::unique_ptr<TextureDescriptor>> m_textureDescriptors{};
         std::vector<std::unique_ptr<resources::ModelDescriptor>> m_modelDescriptors{};
         std::vector<std::unique_ptr<SkyboxDescriptor>> m_skyBoxDescriptors{};
@@ -45,6 +61,24 @@ namespace gle {
         std::unique_ptr<Renderer> m_renderer{};
         std::unique_ptr<SkyBoxRenderer> m_skyBoxRenderer{};
 
+        // The models of a scene that is being loaded aren't used by any
+        // entity yet, so they mustn't be unloaded in the meantime.
+        std::size_t m_loadingSceneCount{0};
+
+        // Whether the order of the triangles and vertices of imported meshes
+        // is optimized for the GPU, see MeshOptimization.
+        bool m_optimizeMeshes{true};
+        resources::MeshOptimizationCache m_meshOptimizationCache{};
+
+        // Whether simplified versions of imported meshes are generated, which
+        // are drawn instead when the entity is far away, see DrawList.
+        bool m_generateLevelsOfDetail{true};
+
+        [[nodiscard]] base::ErrorOr<std::unique_ptr<ecs::Scene>>
+        createGLTFScene(io::format::gltf::Context &, io::format::gltf::ImageLoader &, GLTFPrimitiveJobs &,
+                        resources::ModelDescriptor *sphereModel, std::string_view fileName,
+                        base::StageTimings &) noexcept;
+
         [[nodiscard]] std::optional<unsigned int>
         createElementBuffer(const std::vector<resources::ModelGeometry::IndexType> &) const noexcept;
 
@@ -57,6 +91,18 @@ namespace gle {
         [[nodiscard]] static base::Error
         initializeGLEW() noexcept;
 
+        /**
+         * Places a mesh that was interleaved on any thread in the geometry
+         * arena of its vertex layout, so that it shares its buffers and its
+         * vertex array object with the other meshes of that layout. This has
+         * to run on the thread of the GL context.
+         *
+         * Returns the geometry of the mesh, followed by that of its levels of
+         * detail.
+         */
+        [[nodiscard]] base::ErrorOr<std::vector<ModelGeometryDescriptor *>>
+        uploadInterleavedMesh(const resources::InterleavedMesh &, const AttributeLocations &) noexcept;
+
     public:
         [[nodiscard]] explicit
         Core(const ecs::Scene *scene,
@@ -86,6 +132,9 @@ namespace gle {
         [[nodiscard]] base::ErrorOr<std::unique_ptr<ecs::Scene>>
         loadGLTFScene(std::string_view fileName) noexcept override;
 
+        [[nodiscard]] base::Async<base::ErrorOr<std::unique_ptr<ecs::Scene>>>
+        loadGLTFSceneAsync(std::string fileName, event::FunctionQueue &mainThreadQueue) noexcept override;
+
         /**
          * Is called to initialize things that depend on the window size.
          *
@@ -94,8 +143,17 @@ namespace gle {
         void
         onResize(math::Size2D<std::uint32_t>) noexcept override;
 
+        [[nodiscard]] std::optional<math::Matrix4x4<float>>
+        projectionMatrix() const noexcept override;
+
+        [[nodiscard]] float
+        projectionScale() const noexcept override;
+
+        void
+        renderEntities(const resources::DrawList &) noexcept override;
+
         void
-        renderEntities() noexcept override;
+        unloadUnusedModels() noexcept override;
 
         [[nodiscard]] base::ErrorOr<const resources::ModelDescriptor *>
         uploadModelDescriptor(resources::ModelDescriptor &&modelDescriptor) noexcept override;
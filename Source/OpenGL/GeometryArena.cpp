@@ -0,0 +1,317 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "GeometryArena.hpp"
+
+#include <algorithm> // for std::max, std::find_if
+#include <optional>
+#include <span>
+#include <utility> // for std::move
+
+#include <cstdint> // for std::uintptr_t
+
+#include "Source/Resources/InterleavedMesh.hpp"
+
+namespace gle {
+
+    constexpr base::FunctionErrorGenerator errors{ "OpenGLCore", "GeometryArena" };
+
+    // The buffers start at this size, so a typical scene doesn't have to
+    // grow them more than a couple of times.
+    constexpr std::size_t MinimumVertexCapacity = 64 * 1024;
+    constexpr std::size_t MinimumIndexCapacity = 256 * 1024;
+
+    // The offset of the indices has to be a multiple of the size of the
+    // index type, which is at most 4 bytes.
+    constexpr std::size_t IndexAlignment = 4;
+
+    [[nodiscard]] static constexpr std::size_t
+    alignIndexOffset(std::size_t offset) noexcept {
+        return (offset + IndexAlignment - 1) / IndexAlignment * IndexAlignment;
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    grownCapacity(std::size_t capacity, std::size_t required, std::size_t minimum) noexcept {
+        return std::max({minimum, capacity * 2, capacity + required});
+    }
+
+    [[nodiscard]] static constexpr GLenum
+    translateIndexType(resources::DecodedMesh::IndexType indexType) noexcept {
+        switch (indexType) {
+            case resources::DecodedMesh::IndexType::UNSIGNED_BYTE: return GL_UNSIGNED_BYTE;
+            case resources::DecodedMesh::IndexType::UNSIGNED_SHORT: return GL_UNSIGNED_SHORT;
+            case resources::DecodedMesh::IndexType::UNSIGNED_INT: return GL_UNSIGNED_INT;
+            case resources::DecodedMesh::IndexType::NONE: break;
+        }
+        return 0;
+    }
+
+    [[nodiscard]] static constexpr GLuint
+    translateAttributeLocation(resources::VertexAttribute attribute, const AttributeLocations &attributeLocations) noexcept {
+        switch (attribute) {
+            case resources::VertexAttribute::POSITION: return attributeLocations.position;
+            case resources::VertexAttribute::TEXTURE_COORDINATES: return attributeLocations.textureCoordinates;
+            case resources::VertexAttribute::NORMAL: return attributeLocations.normal;
+            case resources::VertexAttribute::TANGENT: return attributeLocations.tangent;
+            case resources::VertexAttribute::BITANGENT: return attributeLocations.bitangent;
+        }
+        return 0;
+    }
+
+    GeometryArena::GeometryArena(const resources::VertexLayout &layout, const AttributeLocations &attributeLocations) noexcept
+            : m_layout(layout)
+            , m_attributeLocations(attributeLocations) {
+        glGenVertexArrays(1, &m_vao);
+    }
+
+    GeometryArena::~GeometryArena() noexcept {
+        glDeleteBuffers(1, &m_vbo);
+        glDeleteBuffers(1, &m_ebo);
+        glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void
+    GeometryArena::bindBuffers() noexcept {
+        glBindVertexArray(m_vao);
+
+        if (m_vbo != 0) {
+            glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+            const auto stride = static_cast<GLsizei>(m_layout.stride());
+            for (const auto &element : m_layout.elements()) {
+                const auto location = translateAttributeLocation(element.attribute, m_attributeLocations);
+                glEnableVertexAttribArray(location);
+                glVertexAttribPointer(location, static_cast<GLint>(element.componentCount), GL_FLOAT, GL_FALSE, stride,
+                                      reinterpret_cast<const void *>(static_cast<std::uintptr_t>(element.offset)));
+            }
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+        glBindVertexArray(0);
+    }
+
+    base::Error
+    GeometryArena::defragment() noexcept {
+        const auto isFragmented = [] (const base::RangeAllocator &allocator) {
+            const auto freeRanges = allocator.freeRanges();
+            if (std::empty(freeRanges))
+                return false;
+            return std::size(freeRanges) > 1 || freeRanges.back().offset + freeRanges.back().size != allocator.capacity();
+        };
+        const auto isOversized = [] (const base::RangeAllocator &allocator) {
+            return allocator.usedSize() * 2 <= allocator.capacity() && allocator.capacity() != 0;
+        };
+
+        if (!isFragmented(m_vertices) && !isFragmented(m_indices) && !isOversized(m_vertices) && !isOversized(m_indices))
+            return base::Error::success();
+
+        std::size_t indexSize{0};
+        for (const auto &entry : m_entries) {
+            if (entry.indexSize != 0)
+                indexSize = alignIndexOffset(indexSize) + entry.indexSize;
+        }
+
+        const auto vertexCapacity = isOversized(m_vertices) ? m_vertices.usedSize() : m_vertices.capacity();
+        const auto indexCapacity = isOversized(m_indices) ? indexSize : std::max(indexSize, m_indices.capacity());
+        return reallocate(vertexCapacity, indexCapacity, true);
+    }
+
+    void
+    GeometryArena::free(const ModelGeometryDescriptor &descriptor) noexcept {
+        const auto it = std::find_if(std::begin(m_entries), std::end(m_entries),
+                                     [&] (const Entry &entry) { return entry.levels.front().descriptor == &descriptor; });
+        if (it == std::end(m_entries))
+            return;
+
+        m_vertices.free(it->firstVertex, it->vertexCount);
+        if (it->indexSize != 0)
+            m_indices.free(it->indexOffset, it->indexSize);
+
+        *it = std::move(m_entries.back());
+        m_entries.pop_back();
+    }
+
+    base::Error
+    GeometryArena::reallocate(std::size_t vertexCapacity, std::size_t indexCapacity, bool compact) noexcept {
+        const auto stride = std::size_t{m_layout.stride()};
+        const bool replacesVertices = compact || vertexCapacity != m_vertices.capacity();
+        const bool replacesIndices = compact || indexCapacity != m_indices.capacity();
+
+        const auto createBuffer = [] (std::size_t size) -> GLuint {
+            if (size == 0)
+                return 0;
+
+            GLuint buffer{};
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STATIC_DRAW);
+            if (glGetError() != GL_NO_ERROR) {
+                glDeleteBuffers(1, &buffer);
+                return 0;
+            }
+            return buffer;
+        };
+
+        const auto copy = [] (GLuint source, GLuint destination, std::size_t sourceOffset, std::size_t destinationOffset, std::size_t size) {
+            glBindBuffer(GL_COPY_READ_BUFFER, source);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, destination);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(sourceOffset),
+                                static_cast<GLintptr>(destinationOffset), static_cast<GLsizeiptr>(size));
+        };
+
+        const auto vbo = replacesVertices ? createBuffer(vertexCapacity * stride) : m_vbo;
+        if (vbo == 0 && vertexCapacity != 0)
+            return errors.error("Reallocate", "Failed to create the vertex buffer");
+
+        const auto ebo = replacesIndices ? createBuffer(indexCapacity) : m_ebo;
+        if (ebo == 0 && indexCapacity != 0) {
+            if (vbo != m_vbo)
+                glDeleteBuffers(1, &vbo);
+            return errors.error("Reallocate", "Failed to create the element buffer");
+        }
+
+        if (compact) {
+            std::size_t firstVertex{0};
+            std::size_t indexOffset{0};
+            for (auto &entry : m_entries) {
+                copy(m_vbo, vbo, entry.firstVertex * stride, firstVertex * stride, entry.vertexCount * stride);
+                entry.firstVertex = firstVertex;
+                firstVertex += entry.vertexCount;
+
+                if (entry.indexSize != 0) {
+                    indexOffset = alignIndexOffset(indexOffset);
+                    copy(m_ebo, ebo, entry.indexOffset, indexOffset, entry.indexSize);
+                    entry.indexOffset = indexOffset;
+                    indexOffset += entry.indexSize;
+                }
+            }
+
+            m_vertices = base::RangeAllocator{vertexCapacity};
+            m_vertices.reset(firstVertex);
+            m_indices = base::RangeAllocator{indexCapacity};
+            m_indices.reset(indexOffset);
+        } else {
+            if (replacesVertices && m_vbo != 0)
+                copy(m_vbo, vbo, 0, 0, m_vertices.capacity() * stride);
+            if (replacesIndices && m_ebo != 0)
+                copy(m_ebo, ebo, 0, 0, m_indices.capacity());
+
+            m_vertices.grow(vertexCapacity);
+            m_indices.grow(indexCapacity);
+        }
+
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        if (vbo != m_vbo) {
+            glDeleteBuffers(1, &m_vbo);
+            m_vbo = vbo;
+        }
+        if (ebo != m_ebo) {
+            glDeleteBuffers(1, &m_ebo);
+            m_ebo = ebo;
+        }
+
+        bindBuffers();
+        for (auto &entry : m_entries)
+            relocate(entry);
+        return base::Error::success();
+    }
+
+    void
+    GeometryArena::relocate(Entry &entry) noexcept {
+        for (const auto &level : entry.levels) {
+            level.descriptor->relocate(this, m_vao, m_vbo, m_ebo, static_cast<GLint>(entry.firstVertex),
+                                       entry.indexOffset + level.indexOffset);
+        }
+    }
+
+    std::size_t
+    GeometryArena::size() const noexcept {
+        return m_vertices.capacity() * m_layout.stride() + m_indices.capacity();
+    }
+
+    base::ErrorOr<std::vector<std::unique_ptr<ModelGeometryDescriptor>>>
+    GeometryArena::upload(const resources::InterleavedMesh &mesh) noexcept {
+        if (mesh.vertexCount == 0)
+            return errors.error("Upload", "The mesh doesn't have any vertices");
+
+        // The indices of the levels are placed after each other, each
+        // aligned like the indices of a separate mesh would be.
+        std::vector<std::span<const std::byte>> levelIndices{mesh.indices};
+        for (const auto &level : mesh.levelsOfDetail)
+            levelIndices.emplace_back(level.indices);
+
+        std::vector<std::size_t> levelOffsets{};
+        std::size_t indexSize{0};
+        for (const auto &indices : levelIndices) {
+            indexSize = alignIndexOffset(indexSize);
+            levelOffsets.push_back(indexSize);
+            indexSize += std::size(indices);
+        }
+
+        auto firstVertex = m_vertices.allocate(mesh.vertexCount);
+        auto indexOffset = indexSize == 0 ? std::optional<std::size_t>{0} : m_indices.allocate(indexSize, IndexAlignment);
+
+        if (!firstVertex.has_value() || !indexOffset.has_value()) {
+            // The end of the grown buffers is free, so the mesh fits there.
+            auto vertexCapacity = m_vertices.capacity();
+            if (firstVertex.has_value())
+                m_vertices.free(*firstVertex, mesh.vertexCount);
+            else
+                vertexCapacity = grownCapacity(vertexCapacity, mesh.vertexCount, MinimumVertexCapacity);
+
+            auto indexCapacity = m_indices.capacity();
+            if (indexOffset.has_value() && indexSize != 0)
+                m_indices.free(*indexOffset, indexSize);
+            else if (!indexOffset.has_value())
+                indexCapacity = grownCapacity(indexCapacity, indexSize + IndexAlignment, MinimumIndexCapacity);
+
+            TRY(reallocate(vertexCapacity, indexCapacity, false))
+
+            firstVertex = m_vertices.allocate(mesh.vertexCount);
+            indexOffset = indexSize == 0 ? std::optional<std::size_t>{0} : m_indices.allocate(indexSize, IndexAlignment);
+            if (!firstVertex.has_value() || !indexOffset.has_value())
+                return errors.error("Upload", "Failed to grow the buffers");
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_vbo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(*firstVertex * m_layout.stride()),
+                        static_cast<GLsizeiptr>(std::size(mesh.vertices)), std::data(mesh.vertices));
+        if (indexSize != 0) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+            for (std::size_t level = 0; level < std::size(levelIndices); ++level) {
+                glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(*indexOffset + levelOffsets[level]),
+                                static_cast<GLsizeiptr>(std::size(levelIndices[level])), std::data(levelIndices[level]));
+            }
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        std::vector<std::unique_ptr<ModelGeometryDescriptor>> descriptors{};
+        Entry entry{{}, *firstVertex, mesh.vertexCount, *indexOffset, indexSize};
+        for (std::size_t level = 0; level < std::size(levelIndices); ++level) {
+            const auto indexCount = mesh.indexType == resources::DecodedMesh::IndexType::NONE ? 0
+                    : std::size(levelIndices[level]) / resources::DecodedMesh::indexTypeSize(mesh.indexType);
+
+            // Every attribute lives in the vertex buffer.
+            auto descriptor = std::make_unique<ModelGeometryDescriptor>(static_cast<GLsizei>(mesh.vertexCount), m_vao,
+                    m_vbo, m_ebo, m_vbo, m_vbo, static_cast<GLsizei>(indexCount), translateIndexType(mesh.indexType));
+            if (m_layout.contains(resources::VertexAttribute::TANGENT))
+                descriptor->setTangentAndBitangentBufferObjects(m_vbo, m_vbo);
+
+            entry.levels.push_back({descriptor.get(), levelOffsets[level]});
+            descriptors.push_back(std::move(descriptor));
+        }
+
+        m_entries.push_back(std::move(entry));
+        relocate(m_entries.back());
+        return descriptors;
+    }
+
+} // namespace gle
@@ -0,0 +1,149 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+
+#include <GL/glew.h>
+
+#include "Source/Base/Error.hpp"
+#include "Source/Base/ErrorOr.hpp"
+#include "Source/Base/RangeAllocator.hpp"
+#include "Source/OpenGL/ModelGeometryDescriptor.hpp"
+#include "Source/OpenGL/Renderer/AttributeLocations.hpp"
+#include "Source/Resources/VertexLayout.hpp"
+
+namespace resources {
+    struct InterleavedMesh;
+} // namespace resources
+
+namespace gle {
+
+    /**
+     * A vertex buffer and an element buffer that are shared by the geometry
+     * of many meshes with the same vertex layout, so that they can all be
+     * drawn from a single vertex array object. The geometry is placed with
+     * a first-fit free list, and is drawn using the base vertex and index
+     * offset of its descriptor.
+     *
+     * The buffers grow when the geometry doesn't fit, and are compacted by
+     * defragment(), which moves the geometry and updates the descriptors.
+     * All of this has to run on the thread of the GL context.
+     *
+     * The levels of detail of a mesh are drawn from its vertices, and have
+     * their indices placed right after those of the mesh.
+     */
+    class GeometryArena {
+    public:
+        [[nodiscard]]
+        GeometryArena(const resources::VertexLayout &, const AttributeLocations &) noexcept;
+
+        GeometryArena(const GeometryArena &) = delete;
+        GeometryArena &operator=(const GeometryArena &) = delete;
+
+        ~GeometryArena() noexcept;
+
+        /**
+         * Moves the geometry to the front of the buffers, and shrinks them
+         * to fit when at least half of the space is unused.
+         */
+        [[nodiscard]] base::Error
+        defragment() noexcept;
+
+        /**
+         * Releases the space of geometry that was uploaded to this arena,
+         * including its levels of detail, so all of their descriptors can
+         * be destroyed afterwards. The descriptors of the levels of detail
+         * themselves are ignored.
+         */
+        void
+        free(const ModelGeometryDescriptor &) noexcept;
+
+        [[nodiscard]] inline bool
+        isEmpty() const noexcept {
+            return std::empty(m_entries);
+        }
+
+        [[nodiscard]] inline bool
+        matches(const resources::VertexLayout &layout, const AttributeLocations &attributeLocations) const noexcept {
+            return m_layout == layout && m_attributeLocations == attributeLocations;
+        }
+
+        /**
+         * The size of the buffers in bytes, e.g. for statistics.
+         */
+        [[nodiscard]] std::size_t
+        size() const noexcept;
+
+        /**
+         * Returns the descriptor of the mesh, followed by those of its
+         * levels of detail.
+         */
+        [[nodiscard]] base::ErrorOr<std::vector<std::unique_ptr<ModelGeometryDescriptor>>>
+        upload(const resources::InterleavedMesh &) noexcept;
+
+    private:
+        struct Level {
+            ModelGeometryDescriptor *descriptor;
+
+            // In bytes, relative to the indices of the entry.
+            std::size_t indexOffset;
+        };
+
+        struct Entry {
+            // The mesh itself first.
+            std::vector<Level> levels;
+
+            // In vertices.
+            std::size_t firstVertex;
+            std::size_t vertexCount;
+
+            // In bytes, of all levels together.
+            std::size_t indexOffset;
+            std::size_t indexSize;
+        };
+
+        resources::VertexLayout m_layout;
+        AttributeLocations m_attributeLocations;
+
+        GLuint m_vao{};
+        GLuint m_vbo{};
+        GLuint m_ebo{};
+
+        // In vertices.
+        base::RangeAllocator m_vertices{};
+
+        // In bytes.
+        base::RangeAllocator m_indices{};
+
+        std::vector<Entry> m_entries{};
+
+        /**
+         * Points the vertex array object to the current buffers.
+         */
+        void
+        bindBuffers() noexcept;
+
+        /**
+         * Replaces the buffers with ones of the given capacities, and copies
+         * the geometry of the entries over. When compact is set, the
+         * geometry is placed at the front, and otherwise it keeps its place.
+         */
+        [[nodiscard]] base::Error
+        reallocate(std::size_t vertexCapacity, std::size_t indexCapacity, bool compact) noexcept;
+
+        void
+        relocate(Entry &) noexcept;
+    };
+
+} // namespace gle
@@ -8,10 +8,14 @@
 
 #include <GL/glew.h>
 
+#include <cstddef> // for std::size_t
+
 #include "Source/Resources/ModelGeometryDescriptor.hpp"
 
 namespace gle {
 
+    class GeometryArena;
+
     class ModelGeometryDescriptor
             : public resources::ModelGeometryDescriptor {
         /**
@@ -32,6 +36,15 @@ namespace gle {
         GLuint m_tangentBufferObject{};
         GLuint m_bitangentBufferObject{};
 
+        /**
+         * When the geometry is sub-allocated from an arena, the buffers are
+         * the ones of the arena, and the vertices and indices start at the
+         * base vertex and the index offset (in bytes).
+         */
+        GeometryArena *m_arena{nullptr};
+        GLint m_baseVertex{0};
+        std::size_t m_indexOffset{0};
+
     public:
         [[nodiscard]] inline constexpr
         ModelGeometryDescriptor(GLsizei vertexCount, GLuint vao, GLuint vbo, GLuint ebo, GLuint tbo, GLuint nbo, GLsizei indexCount, GLenum indexType) noexcept
@@ -45,6 +58,16 @@ namespace gle {
                 , m_indexType(indexType) {
         }
 
+        [[nodiscard]] inline constexpr GeometryArena *
+        arena() const noexcept {
+            return m_arena;
+        }
+
+        [[nodiscard]] inline constexpr GLint
+        baseVertex() const noexcept {
+            return m_baseVertex;
+        }
+
         [[nodiscard]] inline constexpr GLuint
         bitangentBufferObject() const noexcept {
             return m_bitangentBufferObject;
@@ -60,6 +83,11 @@ namespace gle {
             return m_indexCount;
         }
 
+        [[nodiscard]] inline constexpr std::size_t
+        indexOffset() const noexcept {
+            return m_indexOffset;
+        }
+
         [[nodiscard]] inline constexpr GLenum
         indexType() const noexcept {
             return m_indexType;
@@ -70,6 +98,29 @@ namespace gle {
             return m_nbo;
         }
 
+        /**
+         * Moves the geometry into (another place of) an arena. Attributes
+         * that were stored in the vertex buffer move along with it.
+         */
+        inline constexpr void
+        relocate(GeometryArena *arena, GLuint vao, GLuint vbo, GLuint ebo, GLint baseVertex, std::size_t indexOffset) noexcept {
+            const auto moveAlong = [&] (GLuint &bufferObject) {
+                if (bufferObject == m_vbo)
+                    bufferObject = vbo;
+            };
+            moveAlong(m_tbo);
+            moveAlong(m_nbo);
+            moveAlong(m_tangentBufferObject);
+            moveAlong(m_bitangentBufferObject);
+
+            m_arena = arena;
+            m_vao = vao;
+            m_vbo = vbo;
+            m_ebo = ebo;
+            m_baseVertex = baseVertex;
+            m_indexOffset = indexOffset;
+        }
+
         inline constexpr void
         setTangentAndBitangentBufferObjects(GLuint tangentBufferObject, GLuint bitangentBufferObject) noexcept {
             m_tangentBufferObject = tangentBufferObject;
@@ -21,6 +21,9 @@ namespace gle {
         GL::UnsignedIntType bitangent{};
         GL::UnsignedIntType joint{};
         GL::UnsignedIntType weight{};
+
+        [[nodiscard]] constexpr bool
+        operator==(const AttributeLocations &) const noexcept = default;
     };
 
 } // namespace gle
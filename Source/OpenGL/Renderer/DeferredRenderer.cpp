@@ -12,6 +12,7 @@
 #include "Resources/MaterialDescriptor.hpp"
 
 #include <cassert>
+#include <cstdint> // for std::uintptr_t
 #include <cstdio>
 
 #include <GL/glew.h>
@@ -20,6 +21,7 @@
 #include "Source/ECS/PointLight.hpp"
 #include "Source/ECS/Scene.hpp"
 #include "Source/Interface/Camera.hpp"
+#include "Source/Math/Projection.hpp"
 #include "Source/OpenGL/GLCore.hpp"
 #include "Source/OpenGL/ModelGeometryDescriptor.hpp"
 #include "Source/OpenGL/TextureDescriptor.hpp"
@@ -80,46 +82,49 @@ namespace gle {
     }
 
     void
-    DeferredRenderer::drawGBuffer() noexcept {
+    DeferredRenderer::drawGBuffer(const resources::DrawList &drawList) noexcept {
         glBindFramebuffer(GL_FRAMEBUFFER, m_gBuffer.buffer());
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glUseProgram(m_gBufferShader.programID());
 
-        m_gBufferShader.uploadViewMatrix(core()->camera()->viewMatrix());
+        m_gBufferShader.uploadViewProjectionMatrix(math::createViewProjectionMatrix(m_projection, core()->camera()->viewMatrix()));
 
-        for (const auto &entity : std::data(core()->scene()->entityList())) {
-            assert(entity != nullptr);
+        // Geometry that is placed in the same arena shares its vertex array
+        // object, so it is only bound when the next command uses another.
+        GLuint boundVertexArray{0};
+        for (const auto &command : drawList.commands()) {
+            uploadMaterial(command.model->materialDescriptor());
 
-            if (entity->modelDescriptor() == nullptr)
-                continue;
+            m_gBufferShader.uploadTransformationMatrix(*command.transformation);
+            m_gBufferShader.uploadNormalMatrix(*command.normalMatrix);
 
-            uploadMaterial(entity->modelDescriptor()->materialDescriptor());
-
-            m_gBufferShader.uploadTransformationMatrix(entity->transformation().toMatrix());
-
-            const auto *geometry = static_cast<const ModelGeometryDescriptor *>(entity->modelDescriptor()->geometryDescriptor());
+            const auto *geometry = static_cast<const ModelGeometryDescriptor *>(command.geometry);
             assert(geometry != nullptr);
 
-            assert(glIsVertexArray(geometry->vao()));
+            if (geometry->vao() != boundVertexArray) {
+                assert(glIsVertexArray(geometry->vao()));
 
-            glBindVertexArray(geometry->vao());
-            assert(glGetError() == GL_NO_ERROR);
+                glBindVertexArray(geometry->vao());
+                assert(glGetError() == GL_NO_ERROR);
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry->ebo());
-            
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry->ebo());
+                boundVertexArray = geometry->vao();
+            }
 
             if (geometry->indexCount() == 0) {
-                glDrawArrays(GL_TRIANGLES, 0, geometry->vertexCount());
+                glDrawArrays(GL_TRIANGLES, geometry->baseVertex(), geometry->vertexCount());
             } else {
-                glDrawElements(GL_TRIANGLES, geometry->indexCount(), geometry->indexType(), nullptr);
+                glDrawElementsBaseVertex(GL_TRIANGLES, geometry->indexCount(), geometry->indexType(),
+                                         reinterpret_cast<const void *>(static_cast<std::uintptr_t>(geometry->indexOffset())),
+                                         geometry->baseVertex());
             }
         }
 
+        // The element buffer binding is part of the vertex array object.
+        glBindVertexArray(0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-//        glBindVertexArray(0);
-
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
@@ -160,15 +165,17 @@ namespace gle {
             std::abort();
         }
 
-        glUseProgram(m_gBufferShader.programID());
-        m_gBufferShader.uploadProjectionMatrix(math::createPerspectiveProjectionMatrix(
-            70, static_cast<float>(size.width()), static_cast<float>(size.height()), 0.1f, 1000));
+        m_projection = math::createPerspectiveProjectionMatrix(
+            70, static_cast<float>(size.width()), static_cast<float>(size.height()), 0.1f, 1000);
+
+        // The projection maps the height of the view to [-1, 1].
+        m_projectionScale = m_projection[1][1] * static_cast<float>(size.height()) / 2;
     }
 
     void
-    DeferredRenderer::render() noexcept {
-        syncECS();
-        drawGBuffer();
+    DeferredRenderer::render(const resources::DrawList &drawList) noexcept {
+        syncLights(drawList);
+        drawGBuffer(drawList);
         drawLighting();
     }
 
@@ -181,7 +188,7 @@ namespace gle {
 #endif
 
     bool
-    DeferredRenderer::setPointLight(std::size_t index, const ecs::PointLight &pointLight) noexcept {
+    DeferredRenderer::setPointLight(std::size_t index, const resources::PointLightCommand &pointLight) noexcept {
         return m_lightingPassShader.setPointLight(index, pointLight);
     }
 
@@ -216,21 +223,19 @@ namespace gle {
 #endif // LAVENDER_BUILD_DEBUG
 
     void
-    DeferredRenderer::syncECS() noexcept {
-        if (core()->scene()->entityList().updateCount() == m_ecsUpdateCount)
+    DeferredRenderer::syncLights(const resources::DrawList &drawList) noexcept {
+        if (core()->scene()->entityList().updateCount() == m_ecsUpdateCount
+                && drawList.pointLights() == m_uploadedPointLights)
             return;
         m_ecsUpdateCount = core()->scene()->entityList().updateCount();
+        m_uploadedPointLights = drawList.pointLights();
 
-        // TODO this should be optimized in so many ways
+        // The lights are sorted nearest first, so the ones that don't fit
+        // in the shader are the furthest away.
         std::size_t pointLightIndex{0};
-        for (const auto &entity : std::data(core()->scene()->entityList())) {
-            if (!entity->isLight())
-                continue;
-
-            const auto *pointLight = static_cast<const ecs::PointLight *>(entity.get());
-            const auto result = m_lightingPassShader.setPointLight(pointLightIndex++, *pointLight);
-            assert(result);
-            static_cast<void>(result);
+        for (const auto &pointLight : drawList.pointLights()) {
+            if (!m_lightingPassShader.setPointLight(pointLightIndex++, pointLight))
+                break;
         }
 
         // TODO in the future, when we have less lights than the light limit,
@@ -9,8 +9,12 @@
 
 #pragma once
 
+#include <optional>
+#include <vector>
+
 #include "Source/Base/Debug.hpp"
 #include "Source/ECS/Forward.hpp"
+#include "Source/Math/Matrix4x4.hpp"
 #include "Source/OpenGL/Renderer/Renderer.hpp"
 #include "Source/OpenGL/Resources/GBuffer.hpp"
 #include "Source/OpenGL/Resources/RenderQuad.hpp"
@@ -38,21 +42,34 @@ namespace gle {
         void
         onResize(math::Size2D<std::uint32_t>) noexcept override;
 
+        [[nodiscard]] inline std::optional<math::Matrix4x4<float>>
+        projectionMatrix() const noexcept override {
+            // Not set up until the first resize.
+            if (m_projectionScale == 0.0f)
+                return std::nullopt;
+            return m_projection;
+        }
+
+        [[nodiscard]] inline float
+        projectionScale() const noexcept override {
+            return m_projectionScale;
+        }
+
         void
-        render() noexcept override;
+        render(const resources::DrawList &) noexcept override;
 
         [[nodiscard]] bool
-        setPointLight(std::size_t index, const ecs::PointLight &light) noexcept override;
+        setPointLight(std::size_t index, const resources::PointLightCommand &) noexcept override;
 
         [[nodiscard]] base::Error
         setup() noexcept override;
 
         void
-        syncECS() noexcept;
+        syncLights(const resources::DrawList &) noexcept;
 
     private:
         void
-        drawGBuffer() noexcept;
+        drawGBuffer(const resources::DrawList &) noexcept;
 
         void
         drawLighting() noexcept;
@@ -65,7 +82,12 @@ namespace gle {
 
         RenderQuad m_renderQuad;
 
+        // Combined with the view matrix of the camera every frame.
+        math::Matrix4x4<float> m_projection{};
+        float m_projectionScale{0.0f};
+
         std::size_t m_ecsUpdateCount{0};
+        std::vector<resources::PointLightCommand> m_uploadedPointLights{};
 
 #ifdef LAVENDER_BUILD_DEBUG
         LightingPassDebugShader m_lightingPassDebugShader{};
@@ -9,12 +9,17 @@
 
 #pragma once
 
+#include <optional>
+
 #include "Source/Base/Error.hpp"
 #include "Source/ECS/Forward.hpp"
+#include "Source/Math/Matrix4x4.hpp"
 #include "Source/Math/Size2D.hpp"
 #include "Source/Math/Vector.hpp"
 #include "Source/OpenGL/Renderer/AttributeLocations.hpp"
 #include "Source/OpenGL/Renderer/RenderMode.hpp"
+#include "Source/Resources/DrawList.hpp"
+#include "Source/Resources/VertexLayout.hpp"
 
 namespace gle {
 
@@ -24,6 +29,24 @@ namespace gle {
         bool hasSkin{false};
     };
 
+    /**
+     * The interleaved layout of the vertices of meshes. The tangents are only
+     * used for normal mapping, so they're left out of meshes that don't have
+     * them.
+     */
+    [[nodiscard]] inline constexpr resources::VertexLayout
+    vertexLayoutFor(bool hasTangents) noexcept {
+        resources::VertexLayout layout{};
+        layout.add(resources::VertexAttribute::POSITION)
+              .add(resources::VertexAttribute::NORMAL)
+              .add(resources::VertexAttribute::TEXTURE_COORDINATES);
+        if (hasTangents) {
+            layout.add(resources::VertexAttribute::TANGENT)
+                  .add(resources::VertexAttribute::BITANGENT);
+        }
+        return layout;
+    }
+
     class Renderer {
     public:
         enum class ModelType {
@@ -50,11 +73,23 @@ namespace gle {
         virtual void
         onResize(math::Size2D<std::uint32_t>) noexcept = 0;
 
+        /**
+         * See GraphicsAPI::projectionMatrix().
+         */
+        [[nodiscard]] virtual std::optional<math::Matrix4x4<float>>
+        projectionMatrix() const noexcept = 0;
+
+        /**
+         * See GraphicsAPI::projectionScale().
+         */
+        [[nodiscard]] virtual float
+        projectionScale() const noexcept = 0;
+
         virtual void
-        render() noexcept = 0;
+        render(const resources::DrawList &) noexcept = 0;
 
         [[nodiscard]] virtual bool
-        setPointLight(std::size_t index, const ecs::PointLight &light) noexcept = 0;
+        setPointLight(std::size_t index, const resources::PointLightCommand &) noexcept = 0;
 
         [[nodiscard]] virtual base::Error
         setup() noexcept = 0;
@@ -51,9 +51,9 @@ namespace gle {
         uniformLocation = glGetUniformLocation(m_program->programID(), "texNormalMap");
         glUniform1i(uniformLocation, 1); // texture bank 1
 
-        m_uniformProjection = UniformMatrix4(glGetUniformLocation(m_program->programID(), "u_projection"));
         m_uniformTransformation = UniformMatrix4(glGetUniformLocation(m_program->programID(), "u_transform"));
-        m_uniformView = UniformMatrix4(glGetUniformLocation(m_program->programID(), "u_view"));
+        m_uniformNormalMatrix = UniformMatrix4(glGetUniformLocation(m_program->programID(), "u_normalMatrix"));
+        m_uniformViewProjection = UniformMatrix4(glGetUniformLocation(m_program->programID(), "u_viewProjection"));
 
         return glGetError() == GL_NO_ERROR;
     }
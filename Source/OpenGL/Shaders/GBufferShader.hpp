@@ -56,8 +56,8 @@ namespace gle {
         setup() noexcept;
 
         inline void
-        uploadProjectionMatrix(const math::Matrix4x4<float> &value) noexcept {
-            m_uniformProjection.store(value);
+        uploadNormalMatrix(const math::Matrix4x4<float> &value) noexcept {
+            m_uniformNormalMatrix.store(value);
         }
 
         inline void
@@ -66,8 +66,8 @@ namespace gle {
         }
 
         inline void
-        uploadViewMatrix(const math::Matrix4x4<float> &value) noexcept {
-            m_uniformView.store(value);
+        uploadViewProjectionMatrix(const math::Matrix4x4<float> &value) noexcept {
+            m_uniformViewProjection.store(value);
         }
 
     private:
@@ -83,8 +83,8 @@ namespace gle {
         GL::UnsignedIntType m_attribBitangent{};
 
         UniformMatrix4 m_uniformTransformation{-1};
-        UniformMatrix4 m_uniformProjection{-1};
-        UniformMatrix4 m_uniformView{-1};
+        UniformMatrix4 m_uniformNormalMatrix{-1};
+        UniformMatrix4 m_uniformViewProjection{-1};
     };
 
 } // namespace gle
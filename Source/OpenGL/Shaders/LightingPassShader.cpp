@@ -16,7 +16,7 @@
 namespace gle {
 
     bool
-    LightingPassShader::setPointLight(std::size_t index, const ecs::PointLight &pointLight) noexcept {
+    LightingPassShader::setPointLight(std::size_t index, const resources::PointLightCommand &command) noexcept {
         if (!m_program || index >= 32)
             return false;
 
@@ -27,8 +27,9 @@ namespace gle {
         glUseProgram(program);
 
         auto location = glGetUniformLocation(program, ("lights[" + std::to_string(index) + "].m_position").c_str());
-        const auto &position = pointLight.transformation().translation;
-        glUniform3f(location, position.x(), position.y(), position.z());
+        glUniform3f(location, command.position.x(), command.position.y(), command.position.z());
+
+        const auto &pointLight = *command.light;
 
         location = glGetUniformLocation(program, ("lights[" + std::to_string(index) + "].m_color").c_str());
         glUniform3f(location, pointLight.color().x(), pointLight.color().y(), pointLight.color().z());
@@ -14,6 +14,7 @@
 #include "Source/ECS/Forward.hpp"
 #include "Source/Math/Vector.hpp"
 #include "Source/OpenGL/Shaders/ShaderProgram.hpp"
+#include "Source/Resources/DrawList.hpp"
 #include "Source/OpenGL/Types.hpp"
 
 namespace gle {
@@ -28,7 +29,7 @@ namespace gle {
         }
 
         [[nodiscard]] bool
-        setPointLight(std::size_t index, const ecs::PointLight &pointLight) noexcept;
+        setPointLight(std::size_t index, const resources::PointLightCommand &) noexcept;
 
         [[nodiscard]] bool
         setup() noexcept;
@@ -25,17 +25,10 @@
 #   pragma GCC diagnostic pop
 #endif
 
-#include "Source/Resources/FileResourceLocation.hpp"
 #include "Source/Resources/MaterialDescriptor.hpp"
-#include "Source/Resources/MemoryResourceLocation.hpp"
+#include "Source/Resources/ResourceLocation.hpp"
 #include "Source/Resources/TextureInput.hpp"
 
-#if defined(__cpp_rtti) && __cpp_rtti
-#define cast dynamic_cast
-#else
-#define cast static_cast
-#endif
-
 namespace gle {
 
     struct LoadedImage {
@@ -48,36 +41,15 @@ namespace gle {
             int channelCount{3};
             unsigned char *data{nullptr};
 
-            switch (resourceLocation->type()) {
-                case resources::ResourceLocation::Type::FILE: {
-                    auto* fileLocation = cast<resources::FileResourceLocation*>(resourceLocation);
-
-                    auto pathStr = fileLocation->path().string();
-                    if (!std::filesystem::exists(fileLocation->path()))
-                        return errors.error("Load from FileResourceLocation", fmt::format("File does not exist: \"{}\"", pathStr));
-
-                    data = stbi_load(pathStr.c_str(), &width, &height, &channelCount, STBI_default);
-
-                    if (data == nullptr)
-                        return errors.error("stbi_load", fmt::format("Failed to load image: \"{}\"", pathStr));
-                    break;
-                }
-                case resources::ResourceLocation::Type::MEMORY_OWNING:
-                case resources::ResourceLocation::Type::MEMORY_NON_OWNING: {
-                    TRY_GET_VARIABLE(memoryData, cast<resources::MemoryResourceLocation*>(resourceLocation)->dataAsNonBase64())
-                        assert(memoryData.size() != 0);
-                    assert(memoryData.data() != nullptr);
-                    data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(memoryData.data()), static_cast<int>(memoryData.size()), &width, &height, &channelCount, STBI_default);
-
-                    if (data == nullptr)
-                        return errors.error("stbi_load_from_memory", fmt::format("Failed to load from resources::MemoryResourceLocation: {}", stbi_failure_reason()));
-                    break;
-                }
-                default:
-                    if (resourceLocation->type() >= resources::ResourceLocation::Type::VENDOR_SPECIFIC)
-                        return errors.error("ResourceLocation", fmt::format("Vendor-specific type not supported: {}", static_cast<std::size_t>(resourceLocation->type())));
-                    return errors.error("ResourceLocation", fmt::format("Unknown Type: {}", static_cast<std::size_t>(resourceLocation->type())));
-            }
+            // Files are mapped instead of read into a buffer, and memory
+            // locations are decoded from their own storage.
+            TRY_GET_VARIABLE(memoryData, resourceLocation->mapView(io::MappedFile::AccessHint::SEQUENTIAL))
+            if (memoryData.empty())
+                return errors.error("Load image", "Resource is empty");
+
+            data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(memoryData.data()), static_cast<int>(memoryData.size()), &width, &height, &channelCount, STBI_default);
+            if (data == nullptr)
+                return errors.error("stbi_load_from_memory", fmt::format("Failed to load image: {}", stbi_failure_reason()));
 
             if (!data)
                 return errors.error("Verify data", "Illegal Condition: data is still null");
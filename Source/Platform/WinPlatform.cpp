@@ -16,7 +16,7 @@ namespace platform::win32 {
 
 void
 base::Error::displayErrorMessageBox() const noexcept {
-    if (m_success)
+    if (!*this)
         return;
 
     std::stringstream stream;
@@ -0,0 +1,130 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint>
+#include <cstring> // for std::memcpy
+
+#include "Source/Math/Vector.hpp"
+
+namespace resources {
+
+    /**
+     * The geometry of a mesh after it is decoded from a file, but before it
+     * is uploaded to a graphics API. Every attribute is a tightly packed,
+     * aligned array with one element per vertex, so it can be copied to a
+     * buffer as is.
+     *
+     * The arrays are views into the buffers of the file when those are
+     * already laid out like this, which then have to outlive the mesh.
+     * Attributes that had to be gathered or generated live in the storage of
+     * the mesh, which is why it can be moved, but not copied.
+     */
+    struct DecodedMesh {
+        enum class IndexType
+                : std::uint8_t {
+            // The vertices form triangles in order.
+            NONE,
+            UNSIGNED_BYTE,
+            UNSIGNED_SHORT,
+            UNSIGNED_INT,
+        };
+
+        [[nodiscard]] DecodedMesh() noexcept = default;
+        [[nodiscard]] DecodedMesh(DecodedMesh &&) noexcept = default;
+        DecodedMesh &operator=(DecodedMesh &&) noexcept = default;
+
+        DecodedMesh(const DecodedMesh &) = delete;
+        DecodedMesh &operator=(const DecodedMesh &) = delete;
+
+        std::span<const math::Vector3f> positions{};
+        std::span<const math::Vector2f> textureCoordinates{};
+        std::span<const math::Vector3f> normals{};
+
+        // Empty when the material doesn't use them.
+        std::span<const math::Vector3f> tangents{};
+        std::span<const math::Vector3f> bitangents{};
+
+        // Every index is verified to be less than the vertex count.
+        IndexType indexType{IndexType::NONE};
+        std::span<const std::byte> indices{};
+
+        struct Storage {
+            std::vector<math::Vector3f> positions{};
+            std::vector<math::Vector2f> textureCoordinates{};
+            std::vector<math::Vector3f> normals{};
+            std::vector<math::Vector3f> tangents{};
+            std::vector<math::Vector3f> bitangents{};
+        } storage{};
+
+        [[nodiscard]] static inline constexpr std::size_t
+        indexTypeSize(IndexType type) noexcept {
+            switch (type) {
+                case IndexType::NONE: return 0;
+                case IndexType::UNSIGNED_BYTE: return 1;
+                case IndexType::UNSIGNED_SHORT: return 2;
+                case IndexType::UNSIGNED_INT: return 4;
+            }
+            return 0;
+        }
+
+        [[nodiscard]] inline std::size_t
+        indexCount() const noexcept {
+            return indexType == IndexType::NONE ? 0 : std::size(indices) / indexTypeSize(indexType);
+        }
+
+        /**
+         * Returns the i-th vertex of the triangle list, regardless of
+         * whether the mesh is indexed.
+         */
+        [[nodiscard]] inline std::uint32_t
+        index(std::size_t i) const noexcept {
+            switch (indexType) {
+                case IndexType::NONE:
+                    return static_cast<std::uint32_t>(i);
+                case IndexType::UNSIGNED_BYTE:
+                    return std::to_integer<std::uint32_t>(indices[i]);
+                case IndexType::UNSIGNED_SHORT: {
+                    std::uint16_t index;
+                    std::memcpy(&index, &indices[i * sizeof(index)], sizeof(index));
+                    return index;
+                }
+                case IndexType::UNSIGNED_INT: {
+                    std::uint32_t index;
+                    std::memcpy(&index, &indices[i * sizeof(index)], sizeof(index));
+                    return index;
+                }
+            }
+            return 0;
+        }
+
+        [[nodiscard]] inline std::size_t
+        triangleCount() const noexcept {
+            return (indexType == IndexType::NONE ? std::size(positions) : indexCount()) / 3;
+        }
+
+        [[nodiscard]] inline std::size_t
+        vertexCount() const noexcept {
+            return std::size(positions);
+        }
+
+        template<typename Function>
+        inline void
+        forEachTriangle(Function &&function) const noexcept {
+            for (std::size_t i = 0; i < triangleCount(); ++i)
+                function(index(3 * i), index(3 * i + 1), index(3 * i + 2));
+        }
+    };
+
+} // namespace resources
@@ -0,0 +1,222 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "DrawList.hpp"
+
+#include <algorithm>
+#include <functional> // for std::less
+#include <limits>
+#include <unordered_map>
+
+#include <cassert>
+#include <cmath>
+
+#include "Source/ECS/EntityList.hpp"
+#include "Source/ECS/PointLight.hpp"
+
+namespace resources {
+
+    [[nodiscard]] static float
+    distanceSquared(math::Vector3f a, math::Vector3f b) noexcept {
+        const auto difference = a.subtract(b);
+        return difference.x() * difference.x() + difference.y() * difference.y() + difference.z() * difference.z();
+    }
+
+    [[nodiscard]] static math::Vector3f
+    translationOf(const math::Matrix4x4<float> &matrix) noexcept {
+        return math::Vector3f{matrix[0][3], matrix[1][3], matrix[2][3]};
+    }
+
+    /**
+     * The largest factor by which the matrix scales a distance.
+     */
+    [[nodiscard]] static float
+    maximumScale(const math::Matrix4x4<float> &matrix) noexcept {
+        float scale{0.0f};
+        for (std::size_t column = 0; column < 3; ++column) {
+            scale = std::max(scale, matrix[0][column] * matrix[0][column]
+                                  + matrix[1][column] * matrix[1][column]
+                                  + matrix[2][column] * matrix[2][column]);
+        }
+        return std::sqrt(scale);
+    }
+
+    /**
+     * Whether the bounds of the geometry, placed in the world, intersect the
+     * frustum. Scaling the radius by the largest scale keeps the sphere
+     * enclosing the geometry.
+     */
+    [[nodiscard]] static bool
+    isInFrustum(const math::BoundingSphere &bounds, const math::Matrix4x4<float> &world,
+                const std::array<math::Vector4f, 6> &planes) noexcept {
+        const auto &center = bounds.center;
+        const auto transformed = [&] (std::size_t row) {
+            return world[row][0] * center.x() + world[row][1] * center.y() + world[row][2] * center.z() + world[row][3];
+        };
+
+        const math::Vector3f worldCenter{transformed(0), transformed(1), transformed(2)};
+        return math::BoundingSphere{worldCenter, bounds.radius * maximumScale(world)}.intersectsFrustum(planes);
+    }
+
+    /**
+     * Returns the level of detail to draw, where 0 is the geometry itself
+     * and level i is levelsOfDetail()[i - 1].
+     */
+    [[nodiscard]] static std::size_t
+    selectLevelOfDetail(const ModelDescriptor &model, const math::Matrix4x4<float> &world,
+                        const LevelOfDetailSelection &selection, std::size_t previousLevel) noexcept {
+        const auto &levels = model.levelsOfDetail();
+        if (std::empty(levels) || selection.projectionScale <= 0.0f)
+            return 0;
+
+        // The origin of the model stands in for its bounds, which is close
+        // enough for meshes that are small compared to their distance.
+        const auto distance = std::sqrt(distanceSquared(translationOf(world), selection.viewPosition));
+        if (distance <= std::numeric_limits<float>::epsilon())
+            return 0;
+
+        const auto pixelsPerUnit = maximumScale(world) * selection.projectionScale / distance;
+        const auto projectedError = [&] (std::size_t level) {
+            return level == 0 ? 0.0f : levels[level - 1].error * pixelsPerUnit;
+        };
+
+        auto level = std::min(previousLevel, std::size(levels));
+        while (level != 0 && projectedError(level) > selection.maximumError)
+            --level;
+        while (level < std::size(levels) && projectedError(level + 1) <= selection.maximumError * (1.0f - selection.hysteresis))
+            ++level;
+        return level;
+    }
+
+    void
+    DrawList::build(const ecs::EntityList &entityList, math::Vector3f viewPosition) noexcept {
+        reset(entityList);
+        syncTransformations(0, entityCount());
+        prepareTransformations();
+        propagateTransformations(0, transformPartitionCount());
+        determineVisibility(0, entityCount());
+        binLights(viewPosition);
+        buildCommands();
+    }
+
+    void
+    DrawList::reset(const ecs::EntityList &entityList) noexcept {
+        m_entityList = &entityList;
+
+        const auto &entities = entityList.data();
+        m_visible.resize(std::size(entities));
+        m_levelsOfDetail.resize(std::size(entities));
+
+        if (entityList.structureUpdateCount() == m_structureUpdateCount)
+            return;
+        m_structureUpdateCount = entityList.structureUpdateCount();
+
+        // The entities may have moved around in the list.
+        std::fill(std::begin(m_levelsOfDetail), std::end(m_levelsOfDetail), 0);
+
+        std::unordered_map<const ecs::Node *, ecs::TransformGraph::NodeId> nodes{};
+        nodes.reserve(std::size(entities));
+
+        m_transformGraph.clear();
+        for (const auto &entity : entities)
+            nodes.emplace(entity.get(), m_transformGraph.add(entity->transformation()));
+
+        // Entities that aren't parented to another entity (e.g. to the scene)
+        // are roots. The parents are never dangling, since the EntityList
+        // reparents the children of the entities it removes.
+        for (ecs::TransformGraph::NodeId node = 0; node < std::size(entities); ++node) {
+            if (const auto it = nodes.find(entities[node]->parent()); it != std::end(nodes))
+                m_transformGraph.setParent(node, it->second);
+        }
+    }
+
+    void
+    DrawList::syncTransformations(std::size_t begin, std::size_t end) noexcept {
+        assert(end <= entityCount());
+        const auto &entities = m_entityList->data();
+
+        for (auto i = begin; i < end; ++i)
+            static_cast<void>(m_transformGraph.syncLocal(static_cast<ecs::TransformGraph::NodeId>(i), entities[i]->transformation()));
+    }
+
+    void
+    DrawList::prepareTransformations() noexcept {
+        m_transformGraph.updateTop();
+    }
+
+    void
+    DrawList::propagateTransformations(std::size_t begin, std::size_t end) noexcept {
+        m_transformGraph.updatePartitions(begin, end);
+    }
+
+    void
+    DrawList::determineVisibility(std::size_t begin, std::size_t end) noexcept {
+        assert(end <= entityCount());
+        const auto &entities = m_entityList->data();
+
+        for (auto i = begin; i < end; ++i) {
+            const auto *model = entities[i]->modelDescriptor();
+            if (model == nullptr || model->geometryDescriptor() == nullptr) {
+                m_visible[i] = false;
+                continue;
+            }
+
+            const auto &bounds = model->geometryDescriptor()->bounds();
+            m_visible[i] = !m_frustumPlanes || !bounds
+                        || isInFrustum(*bounds, m_transformGraph.world(static_cast<ecs::TransformGraph::NodeId>(i)), *m_frustumPlanes);
+        }
+    }
+
+    void
+    DrawList::binLights(math::Vector3f viewPosition) noexcept {
+        const auto &entities = m_entityList->data();
+
+        m_pointLights.clear();
+        for (std::size_t i = 0; i < entityCount(); ++i) {
+            if (!entities[i]->isLight())
+                continue;
+
+            const auto &world = m_transformGraph.world(static_cast<ecs::TransformGraph::NodeId>(i));
+            m_pointLights.push_back(PointLightCommand{static_cast<const ecs::PointLight *>(entities[i].get()), translationOf(world)});
+        }
+
+        std::stable_sort(std::begin(m_pointLights), std::end(m_pointLights),
+                         [viewPosition](const PointLightCommand &a, const PointLightCommand &b) {
+            return distanceSquared(a.position, viewPosition) < distanceSquared(b.position, viewPosition);
+        });
+    }
+
+    void
+    DrawList::buildCommands(const LevelOfDetailSelection &levelOfDetailSelection) noexcept {
+        const auto &entities = m_entityList->data();
+
+        m_commands.clear();
+        for (std::size_t i = 0; i < entityCount(); ++i) {
+            if (!m_visible[i])
+                continue;
+
+            const auto node = static_cast<ecs::TransformGraph::NodeId>(i);
+            const auto &world = m_transformGraph.world(node);
+            const auto *model = entities[i]->modelDescriptor();
+
+            const auto level = selectLevelOfDetail(*model, world, levelOfDetailSelection, m_levelsOfDetail[i]);
+            m_levelsOfDetail[i] = static_cast<std::uint8_t>(level);
+
+            const auto *geometry = level == 0 ? model->geometryDescriptor() : model->levelsOfDetail()[level - 1].geometryDescriptor;
+            m_commands.push_back(DrawCommand{model, geometry, &world, &m_transformGraph.normalMatrix(node)});
+        }
+
+        std::sort(std::begin(m_commands), std::end(m_commands), [](const DrawCommand &a, const DrawCommand &b) {
+            if (a.model->materialDescriptor() != b.model->materialDescriptor())
+                return std::less{}(a.model->materialDescriptor(), b.model->materialDescriptor());
+            return std::less{}(a.geometry, b.geometry);
+        });
+    }
+
+} // namespace resources
@@ -0,0 +1,190 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+#include "Source/ECS/Forward.hpp"
+#include "Source/ECS/TransformGraph.hpp"
+#include "Source/Math/Matrix4x4.hpp"
+#include "Source/Math/Vector.hpp"
+#include "Source/Resources/ModelDescriptor.hpp"
+
+namespace resources {
+
+    struct DrawCommand {
+        const ModelDescriptor *model;
+
+        // The geometry of the model, or one of its levels of detail.
+        const ModelGeometryDescriptor *geometry;
+
+        const math::Matrix4x4<float> *transformation;
+        const math::Matrix4x4<float> *normalMatrix;
+    };
+
+    /**
+     * A point light, with the position of its entity in the world, which
+     * differs from its local translation when it is parented.
+     */
+    struct PointLightCommand {
+        const ecs::PointLight *light;
+        math::Vector3f position;
+
+        [[nodiscard]] bool
+        operator==(const PointLightCommand &) const noexcept = default;
+    };
+
+    /**
+     * Determines which level of detail of a model is drawn: the coarsest
+     * one of which the error, projected onto the screen at the distance of
+     * the entity, is at most maximumError pixels.
+     *
+     * To prevent entities from switching back and forth at the distance
+     * where the error of two levels is about the same, a coarser level is
+     * only chosen when its error is below (1 - hysteresis) * maximumError.
+     */
+    struct LevelOfDetailSelection {
+        math::Vector3f viewPosition{};
+
+        // See GraphicsAPI::projectionScale(). When zero, the geometry
+        // itself is always drawn.
+        float projectionScale{0.0f};
+
+        float maximumError{1.0f};
+        float hysteresis{0.25f};
+    };
+
+    /**
+     * Everything the graphics API needs to render a frame, prepared on the
+     * CPU beforehand. It is built in stages, and the per-entity stages work
+     * on a range of the entity list, so that they can be split over multiple
+     * jobs that run concurrently (see Lavender::buildFrameGraph).
+     */
+    class DrawList {
+    public:
+        /**
+         * Runs all stages on the calling thread.
+         */
+        void
+        build(const ecs::EntityList &entityList, math::Vector3f viewPosition) noexcept;
+
+        /**
+         * Prepares the per-entity storage for the entities that are currently
+         * in the list, and rebuilds the transform hierarchy when entities
+         * were added or removed. Must precede the other stages.
+         */
+        void
+        reset(const ecs::EntityList &entityList) noexcept;
+
+        /**
+         * Copies the local transformations of the entities in [begin, end)
+         * that changed into the transform hierarchy.
+         */
+        void
+        syncTransformations(std::size_t begin, std::size_t end) noexcept;
+
+        /**
+         * Computes the world matrices of the top of the hierarchy. Must
+         * follow syncTransformations for all entities, and precede
+         * propagateTransformations.
+         */
+        void
+        prepareTransformations() noexcept;
+
+        /**
+         * Computes the world matrices of the transform partitions in
+         * [begin, end), see transformPartitionCount().
+         */
+        void
+        propagateTransformations(std::size_t begin, std::size_t end) noexcept;
+
+        /**
+         * Determines which entities in [begin, end) should be drawn: the ones
+         * with geometry of which the bounds intersect the frustum. Must
+         * follow propagateTransformations.
+         */
+        void
+        determineVisibility(std::size_t begin, std::size_t end) noexcept;
+
+        /**
+         * Collects the point lights, nearest to the viewer first, so that
+         * the nearest ones end up in the limited amount of slots of the
+         * lighting pass. Must follow propagateTransformations.
+         */
+        void
+        binLights(math::Vector3f viewPosition) noexcept;
+
+        /**
+         * Gathers the visible entities into draw commands, sorted by
+         * material and geometry to minimize state changes, with the level of
+         * detail that is selected for them. Must follow
+         * propagateTransformations and determineVisibility.
+         */
+        void
+        buildCommands(const LevelOfDetailSelection & = {}) noexcept;
+
+        [[nodiscard]] inline const std::vector<DrawCommand> &
+        commands() const noexcept {
+            return m_commands;
+        }
+
+        [[nodiscard]] inline std::size_t
+        entityCount() const noexcept {
+            return m_visible.size();
+        }
+
+        [[nodiscard]] inline const std::vector<PointLightCommand> &
+        pointLights() const noexcept {
+            return m_pointLights;
+        }
+
+        /**
+         * The planes of the view frustum that determineVisibility culls
+         * against, see math::extractFrustumPlanes(). Without them, nothing
+         * is culled.
+         */
+        inline void
+        setFrustum(const std::optional<std::array<math::Vector4f, 6>> &planes) noexcept {
+            m_frustumPlanes = planes;
+        }
+
+        [[nodiscard]] inline std::size_t
+        transformPartitionCount() const noexcept {
+            return m_transformGraph.partitionCount();
+        }
+
+    private:
+        const ecs::EntityList *m_entityList{nullptr};
+
+        // Node i is entity i of the list, parented to the node of its parent
+        // entity.
+        ecs::TransformGraph m_transformGraph{};
+        std::size_t m_structureUpdateCount{SIZE_MAX};
+
+        std::optional<std::array<math::Vector4f, 6>> m_frustumPlanes{};
+
+        // Not std::vector<bool>, since separate ranges are written
+        // concurrently.
+        std::vector<std::uint8_t> m_visible{};
+
+        // The level of detail that was selected for each entity during the
+        // previous frame, which the hysteresis is relative to.
+        std::vector<std::uint8_t> m_levelsOfDetail{};
+
+        std::vector<DrawCommand> m_commands{};
+        std::vector<PointLightCommand> m_pointLights{};
+    };
+
+} // namespace resources
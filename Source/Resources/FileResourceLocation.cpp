@@ -12,7 +12,10 @@
 #define FMT_HEADER_ONLY
 #include <fmt/format.h>
 
+#include <memory> // for std::make_shared
+
 #include <Source/IO/FileInput.hpp>
+#include <Source/IO/MappedFile.hpp>
 
 namespace resources {
 
@@ -39,5 +42,22 @@ namespace resources {
         return result;
     }
 
+    base::ErrorOr<ResourceView>
+    FileResourceLocation::mapView(io::MappedFile::AccessHint hint) const noexcept {
+        base::FunctionErrorGenerator errors{"ResourceLibrary", "FileResourceLocation"};
+
+        const auto pathStr = path().string();
+        auto file = std::make_shared<io::MappedFile>(pathStr, hint);
+        if (file->error() == io::Error::MAPPING_FAILED)
+            return ResourceLocation::mapView(hint);
+
+        if (!*file) {
+            const auto description = io::describeError(file->error());
+            return errors.error("Failed to map file", fmt::format("{}: {}: \"{}\"", description.section(), description.code(), pathStr));
+        }
+
+        const auto bytes = file->data();
+        return ResourceView{std::move(file), bytes};
+    }
 
 } // namespace resources
@@ -26,6 +26,13 @@ namespace resources {
         [[nodiscard]] base::ErrorOr<std::string>
         readAllBytes() const noexcept override;
 
+        /**
+         * Maps the file read-only. Files that can't be mapped, e.g. pipes,
+         * are read using readAllBytes() instead.
+         */
+        [[nodiscard]] base::ErrorOr<ResourceView>
+        mapView(io::MappedFile::AccessHint) const noexcept override;
+
         [[nodiscard]] inline constexpr const std::filesystem::path &
         path() const noexcept {
             return m_path;
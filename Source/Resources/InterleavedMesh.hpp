@@ -0,0 +1,182 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include <cstddef> // for std::byte, std::size_t
+#include <cstdint>
+#include <cstring> // for std::memcpy
+
+#include "Source/Math/Vector.hpp"
+#include "Source/Resources/DecodedMesh.hpp"
+#include "Source/Resources/VertexLayout.hpp"
+
+namespace resources {
+
+    /**
+     * A mesh whose vertices are interleaved into a single buffer, which can
+     * be uploaded as one vertex buffer object.
+     *
+     * The indices aren't copied, so they are views into the same storage as
+     * those of the DecodedMesh it was created from, unless they were
+     * rewritten (e.g. by a MeshOptimization), in which case they view the
+     * index storage of the mesh.
+     *
+     * Simplified versions of the mesh can be added as levels of detail,
+     * which are drawn from the same vertices with their own indices.
+     */
+    struct InterleavedMesh {
+        struct LevelOfDetail {
+            // Of the same type as the indices of the mesh.
+            std::vector<std::byte> indices{};
+
+            // How far the surface deviates from that of the mesh at most,
+            // in the units of the positions.
+            float error{0.0f};
+        };
+
+        VertexLayout layout{};
+        std::size_t vertexCount{0};
+
+        // vertexCount vertices of layout.stride() bytes.
+        std::vector<std::byte> vertices{};
+
+        DecodedMesh::IndexType indexType{DecodedMesh::IndexType::NONE};
+        std::span<const std::byte> indices{};
+        std::vector<std::byte> indexStorage{};
+
+        // Ordered from fine to coarse, excluding the mesh itself.
+        std::vector<LevelOfDetail> levelsOfDetail{};
+
+        [[nodiscard]] inline std::size_t
+        indexCount() const noexcept {
+            return indexType == DecodedMesh::IndexType::NONE ? 0 : std::size(indices) / DecodedMesh::indexTypeSize(indexType);
+        }
+
+        [[nodiscard]] inline std::vector<std::uint32_t>
+        readIndices() const noexcept {
+            std::vector<std::uint32_t> result(indexCount());
+            for (std::size_t i = 0; i < std::size(result); ++i) {
+                switch (indexType) {
+                    case DecodedMesh::IndexType::UNSIGNED_BYTE:
+                        result[i] = std::to_integer<std::uint32_t>(indices[i]);
+                        break;
+                    case DecodedMesh::IndexType::UNSIGNED_SHORT: {
+                        std::uint16_t index;
+                        std::memcpy(&index, &indices[i * sizeof(index)], sizeof(index));
+                        result[i] = index;
+                        break;
+                    }
+                    case DecodedMesh::IndexType::UNSIGNED_INT:
+                        std::memcpy(&result[i], &indices[i * sizeof(std::uint32_t)], sizeof(std::uint32_t));
+                        break;
+                    case DecodedMesh::IndexType::NONE:
+                        break;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Returns the position of every vertex, or nothing when the layout
+         * doesn't have positions.
+         */
+        [[nodiscard]] inline std::vector<math::Vector3f>
+        readPositions() const noexcept {
+            std::vector<math::Vector3f> positions{};
+            for (const auto &element : layout.elements()) {
+                if (element.attribute != VertexAttribute::POSITION)
+                    continue;
+
+                positions.resize(vertexCount);
+                for (std::size_t i = 0; i < vertexCount; ++i) {
+                    std::array<float, 3> position;
+                    std::memcpy(position.data(), &vertices[i * layout.stride() + element.offset], sizeof(position));
+                    positions[i] = math::Vector3f{position[0], position[1], position[2]};
+                }
+            }
+            return positions;
+        }
+
+        /**
+         * Converts the indices to the index type of the mesh, which they
+         * have to fit in.
+         */
+        [[nodiscard]] inline std::vector<std::byte>
+        writeIndices(std::span<const std::uint32_t> source) const noexcept {
+            const auto indexSize = DecodedMesh::indexTypeSize(indexType);
+            std::vector<std::byte> result(std::size(source) * indexSize);
+            for (std::size_t i = 0; i < std::size(source); ++i) {
+                if (indexSize == 1) {
+                    result[i] = static_cast<std::byte>(source[i]);
+                } else if (indexSize == 2) {
+                    const auto index = static_cast<std::uint16_t>(source[i]);
+                    std::memcpy(&result[i * indexSize], &index, sizeof(index));
+                } else {
+                    std::memcpy(&result[i * indexSize], &source[i], sizeof(source[i]));
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Writes the attributes of the layout in a single pass over the
+         * vertices. Attributes that the mesh doesn't have are zero.
+         */
+        [[nodiscard]] static InterleavedMesh
+        interleave(const DecodedMesh &mesh, const VertexLayout &layout) noexcept {
+            struct Source {
+                const std::byte *data;
+                std::size_t size;
+                std::size_t offset;
+            };
+
+            std::array<Source, VertexAttributeCount> sources{};
+            std::size_t sourceCount{0};
+            for (const auto &element : layout.elements()) {
+                const auto data = attributeBytes(mesh, element.attribute);
+                if (std::empty(data))
+                    continue;
+                sources[sourceCount++] = {data.data(), element.componentCount * sizeof(float), element.offset};
+            }
+
+            const std::size_t stride = layout.stride();
+            InterleavedMesh result{layout, mesh.vertexCount(), std::vector<std::byte>(mesh.vertexCount() * stride),
+                                   mesh.indexType, mesh.indices};
+
+            auto *vertex = result.vertices.data();
+            for (std::size_t i = 0; i < result.vertexCount; ++i, vertex += stride) {
+                for (std::size_t j = 0; j < sourceCount; ++j) {
+                    const auto &source = sources[j];
+                    std::memcpy(vertex + source.offset, source.data + i * source.size, source.size);
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        [[nodiscard]] static std::span<const std::byte>
+        attributeBytes(const DecodedMesh &mesh, VertexAttribute attribute) noexcept {
+            switch (attribute) {
+                case VertexAttribute::POSITION: return std::as_bytes(mesh.positions);
+                case VertexAttribute::TEXTURE_COORDINATES: return std::as_bytes(mesh.textureCoordinates);
+                case VertexAttribute::NORMAL: return std::as_bytes(mesh.normals);
+                case VertexAttribute::TANGENT: return std::as_bytes(mesh.tangents);
+                case VertexAttribute::BITANGENT: return std::as_bytes(mesh.bitangents);
+            }
+            return {};
+        }
+    };
+
+} // namespace resources
@@ -55,6 +55,23 @@ namespace resources {
         return decodeBase64<std::string>(view);
     }
 
+    base::ErrorOr<ResourceView>
+    MemoryResourceLocation::mapView(io::MappedFile::AccessHint) const noexcept {
+        const auto dataView = data();
+        if (!m_isBase64)
+            return ResourceView{std::as_bytes(std::span{dataView.data(), dataView.size()})};
+
+        TRY_GET_VARIABLE(decoded, decodeBase64(std::string_view{ dataView.data(), dataView.size() }))
+        return ResourceView::adopt(std::move(decoded));
+    }
+
+    base::ErrorOr<ResourceView>
+    MemoryOwningResourceLocation::mapView(io::MappedFile::AccessHint hint) const noexcept {
+        if (isBase64())
+            return MemoryResourceLocation::mapView(hint);
+        return ResourceView{m_data, std::as_bytes(std::span{*m_data})};
+    }
+
     MemoryResourceLocation::~MemoryResourceLocation() noexcept = default;
     MemoryOwningResourceLocation::~MemoryOwningResourceLocation() noexcept = default;
     MemoryNonOwningResourceLocation::~MemoryNonOwningResourceLocation() noexcept = default;
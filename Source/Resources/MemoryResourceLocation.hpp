@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <memory> // for std::shared_ptr
 #include <vector>
 
 #include "Source/Base/ArrayView.hpp"
@@ -27,6 +28,13 @@ namespace resources {
         [[nodiscard]] virtual base::ErrorOr<std::string>
         readAllBytes() const noexcept;
 
+        /**
+         * Views data() in place, without keeping it alive. BASE64 data is
+         * decoded into storage that the view owns.
+         */
+        [[nodiscard]] base::ErrorOr<ResourceView>
+        mapView(io::MappedFile::AccessHint) const noexcept override;
+
         [[nodiscard]] virtual base::ErrorOr<base::ArrayView<const char>>
         dataAsNonBase64() noexcept;
 
@@ -36,6 +44,11 @@ namespace resources {
                 : ResourceLocation(type), m_isBase64(isBase64) {
         }
 
+        [[nodiscard]] inline constexpr bool
+        isBase64() const noexcept {
+            return m_isBase64;
+        }
+
     private:
         bool m_isBase64;
         std::vector<char> m_base64Decoded{};
@@ -46,18 +59,25 @@ namespace resources {
         [[nodiscard]]
         MemoryOwningResourceLocation(std::vector<char> &&data, bool isBase64)
                 : MemoryResourceLocation(Type::MEMORY_OWNING, isBase64)
-                , m_data(std::move(data)) {
+                , m_data(std::make_shared<const std::vector<char>>(std::move(data))) {
         }
 
         ~MemoryOwningResourceLocation() noexcept override;
 
         [[nodiscard]] base::ArrayView<const char>
         data() const noexcept override {
-            return { m_data.data(), m_data.size() };
+            return { m_data->data(), m_data->size() };
         }
 
+        /**
+         * The view shares the data, so it stays valid after the location is
+         * destroyed.
+         */
+        [[nodiscard]] base::ErrorOr<ResourceView>
+        mapView(io::MappedFile::AccessHint) const noexcept override;
+
     private:
-        std::vector<char> m_data;
+        std::shared_ptr<const std::vector<char>> m_data;
     };
 
     struct MemoryNonOwningResourceLocation final
@@ -0,0 +1,469 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "MeshOptimizer.hpp"
+
+#include <algorithm> // for std::copy, std::equal, std::stable_sort
+#include <array>
+#include <limits>
+
+#include <cassert>
+#include <cstring> // for std::memcpy
+
+#include "Source/Resources/InterleavedMesh.hpp"
+
+namespace resources {
+
+    /**
+     * Simulates a FIFO cache of vertices. A vertex is in the cache when it
+     * was one of the last cacheSize vertices that were inserted.
+     */
+    class FIFOVertexCache {
+    public:
+        [[nodiscard]] inline
+        FIFOVertexCache(std::size_t vertexCount, std::size_t cacheSize) noexcept
+                : m_timestamps(vertexCount, 0)
+                , m_cacheSize(cacheSize)
+                , m_time(cacheSize + 1) {
+        }
+
+        [[nodiscard]] inline bool
+        contains(std::uint32_t vertex) const noexcept {
+            return m_time - m_timestamps[vertex] <= m_cacheSize;
+        }
+
+        /**
+         * Returns whether the vertex had to be inserted, i.e. transformed.
+         */
+        inline bool
+        use(std::uint32_t vertex) noexcept {
+            if (contains(vertex))
+                return false;
+            m_timestamps[vertex] = m_time++;
+            return true;
+        }
+
+    private:
+        std::vector<std::size_t> m_timestamps;
+        std::size_t m_cacheSize;
+        std::size_t m_time;
+    };
+
+    VertexCacheStatistics
+    analyzeVertexCache(std::span<const std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize) noexcept {
+        VertexCacheStatistics statistics{};
+        statistics.triangleCount = std::size(indices) / 3;
+
+        FIFOVertexCache cache{vertexCount, cacheSize};
+        std::vector<bool> isUsed(vertexCount);
+        for (const auto index : indices) {
+            if (cache.use(index))
+                ++statistics.transformedVertexCount;
+            if (!isUsed[index]) {
+                isUsed[index] = true;
+                ++statistics.vertexCount;
+            }
+        }
+
+        return statistics;
+    }
+
+    void
+    optimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount, std::size_t cacheSize) noexcept {
+        assert(std::size(indices) % 3 == 0);
+        const auto triangleCount = std::size(indices) / 3;
+        if (triangleCount == 0)
+            return;
+
+        // The triangles that use each vertex, in a single array.
+        std::vector<std::uint32_t> liveTriangleCount(vertexCount, 0);
+        for (const auto index : indices)
+            ++liveTriangleCount[index];
+
+        std::vector<std::size_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+            adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangleCount[vertex];
+
+        std::vector<std::uint32_t> adjacency(std::size(indices));
+        {
+            auto fill = adjacencyOffsets;
+            for (std::size_t i = 0; i < std::size(indices); ++i)
+                adjacency[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+
+        // The same clock as FIFOVertexCache, but the timestamps are needed
+        // for the priorities as well.
+        std::vector<std::size_t> timestamps(vertexCount, 0);
+        std::size_t time = cacheSize + 1;
+
+        std::vector<bool> isEmitted(triangleCount);
+        std::vector<std::uint32_t> deadEnds{};
+        std::vector<std::uint32_t> candidates{};
+        std::vector<std::uint32_t> result{};
+        result.reserve(std::size(indices));
+
+        constexpr auto NoVertex = std::numeric_limits<std::size_t>::max();
+
+        // The cursor over the input, for when there is nothing left around
+        // the last vertices.
+        std::size_t nextVertex = 0;
+        std::size_t fanningVertex = indices[0];
+
+        while (fanningVertex != NoVertex) {
+            candidates.clear();
+
+            for (auto i = adjacencyOffsets[fanningVertex]; i < adjacencyOffsets[fanningVertex + 1]; ++i) {
+                const auto triangle = adjacency[i];
+                if (isEmitted[triangle])
+                    continue;
+                isEmitted[triangle] = true;
+
+                for (std::size_t corner = 0; corner < 3; ++corner) {
+                    const auto vertex = indices[triangle * 3 + corner];
+                    result.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --liveTriangleCount[vertex];
+
+                    if (time - timestamps[vertex] > cacheSize)
+                        timestamps[vertex] = time++;
+                }
+            }
+
+            // The next vertex is one of the candidates that is still in the
+            // cache when its remaining triangles are emitted, preferring the
+            // one that was inserted first.
+            fanningVertex = NoVertex;
+            std::size_t bestPriority = 0;
+            for (const auto vertex : candidates) {
+                if (liveTriangleCount[vertex] == 0)
+                    continue;
+
+                std::size_t priority = 0;
+                if (time - timestamps[vertex] + 2 * liveTriangleCount[vertex] <= cacheSize)
+                    priority = time - timestamps[vertex];
+                if (fanningVertex == NoVertex || priority > bestPriority) {
+                    fanningVertex = vertex;
+                    bestPriority = priority;
+                }
+            }
+
+            if (fanningVertex != NoVertex)
+                continue;
+
+            // Otherwise, a recently used vertex that has triangles left, or
+            // else the next vertex of the input that does.
+            while (!std::empty(deadEnds)) {
+                const auto vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangleCount[vertex] != 0) {
+                    fanningVertex = vertex;
+                    break;
+                }
+            }
+
+            while (fanningVertex == NoVertex && nextVertex < vertexCount) {
+                if (liveTriangleCount[nextVertex] != 0)
+                    fanningVertex = nextVertex;
+                ++nextVertex;
+            }
+        }
+
+        assert(std::size(result) == triangleCount * 3);
+        std::copy(std::begin(result), std::end(result), std::begin(indices));
+    }
+
+    void
+    optimizeOverdraw(std::span<std::uint32_t> indices, std::span<const math::Vector3f> positions,
+                     float threshold, std::size_t cacheSize) noexcept {
+        assert(std::size(indices) % 3 == 0);
+        const auto triangleCount = std::size(indices) / 3;
+        if (triangleCount == 0)
+            return;
+
+        std::vector<std::uint8_t> misses(triangleCount);
+        {
+            FIFOVertexCache cache{std::size(positions), cacheSize};
+            for (std::size_t triangle = 0; triangle < triangleCount; ++triangle) {
+                for (std::size_t corner = 0; corner < 3; ++corner) {
+                    if (cache.use(indices[triangle * 3 + corner]))
+                        ++misses[triangle];
+                }
+            }
+        }
+
+        // A triangle of which every vertex misses the cache starts a hard
+        // cluster, since the order jumped there anyway. A hard cluster is
+        // split further after a triangle at which its ACMR is close enough
+        // to that of the whole hard cluster.
+        std::vector<std::size_t> clusterStarts{};
+        for (std::size_t start = 0; start < triangleCount;) {
+            auto end = start + 1;
+            std::size_t clusterMisses = misses[start];
+            while (end < triangleCount && misses[end] != 3)
+                clusterMisses += misses[end++];
+
+            const auto clusterACMR = static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+            std::size_t softStart = start;
+            std::size_t softMisses = 0;
+            clusterStarts.push_back(start);
+            for (auto triangle = start; triangle + 1 < end; ++triangle) {
+                softMisses += misses[triangle];
+                const auto softACMR = static_cast<float>(softMisses) / static_cast<float>(triangle + 1 - softStart);
+                if (softACMR <= threshold * clusterACMR) {
+                    softStart = triangle + 1;
+                    softMisses = 0;
+                    clusterStarts.push_back(softStart);
+                }
+            }
+
+            start = end;
+        }
+        clusterStarts.push_back(triangleCount);
+
+        const auto clusterCount = std::size(clusterStarts) - 1;
+        if (clusterCount == 1)
+            return;
+
+        struct Cluster {
+            std::size_t start;
+            std::size_t end;
+            math::Vector3f centroid;
+            math::Vector3f normal;
+            float sortKey;
+        };
+
+        // Both the centroids and the normals are weighted by the area of the
+        // triangles, which the length of the cross product is twice of.
+        std::vector<Cluster> clusters(clusterCount);
+        math::Vector3f meshCentroid{0.0f, 0.0f, 0.0f};
+        float meshArea{0.0f};
+        for (std::size_t i = 0; i < clusterCount; ++i) {
+            auto &cluster = clusters[i];
+            cluster = {clusterStarts[i], clusterStarts[i + 1], math::Vector3f{0.0f, 0.0f, 0.0f}, math::Vector3f{0.0f, 0.0f, 0.0f}, 0.0f};
+
+            float clusterArea{0.0f};
+            for (auto triangle = cluster.start; triangle < cluster.end; ++triangle) {
+                const auto &a = positions[indices[triangle * 3]];
+                const auto &b = positions[indices[triangle * 3 + 1]];
+                const auto &c = positions[indices[triangle * 3 + 2]];
+
+                const auto normal = b.subtract(a).cross(c.subtract(a));
+                const auto area = normal.length();
+                cluster.normal = cluster.normal.add(normal);
+                cluster.centroid = cluster.centroid.add(a.add(b).add(c).mul(area / 3.0f));
+                clusterArea += area;
+            }
+
+            meshCentroid = meshCentroid.add(cluster.centroid);
+            meshArea += clusterArea;
+            if (clusterArea > 0.0f)
+                cluster.centroid = cluster.centroid.div(clusterArea);
+
+            const auto normalLength = cluster.normal.length();
+            if (normalLength > 0.0f)
+                cluster.normal = cluster.normal.div(normalLength);
+        }
+
+        if (meshArea > 0.0f)
+            meshCentroid = meshCentroid.div(meshArea);
+
+        for (auto &cluster : clusters)
+            cluster.sortKey = cluster.centroid.subtract(meshCentroid).dot(cluster.normal);
+
+        std::stable_sort(std::begin(clusters), std::end(clusters),
+                         [] (const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+
+        std::vector<std::uint32_t> result{};
+        result.reserve(std::size(indices));
+        for (const auto &cluster : clusters)
+            result.insert(std::end(result), std::begin(indices) + static_cast<std::ptrdiff_t>(cluster.start * 3),
+                          std::begin(indices) + static_cast<std::ptrdiff_t>(cluster.end * 3));
+
+        std::copy(std::begin(result), std::end(result), std::begin(indices));
+    }
+
+    std::vector<std::uint32_t>
+    optimizeVertexFetch(std::span<std::uint32_t> indices, std::size_t vertexCount) noexcept {
+        constexpr auto Unused = std::numeric_limits<std::uint32_t>::max();
+
+        std::vector<std::uint32_t> newIndices(vertexCount, Unused);
+        std::vector<std::uint32_t> vertexOrder{};
+        vertexOrder.reserve(vertexCount);
+
+        for (auto &index : indices) {
+            if (newIndices[index] == Unused) {
+                newIndices[index] = static_cast<std::uint32_t>(std::size(vertexOrder));
+                vertexOrder.push_back(index);
+            }
+            index = newIndices[index];
+        }
+
+        return vertexOrder;
+    }
+
+    void
+    MeshOptimization::apply(InterleavedMesh &mesh) const noexcept {
+        if (std::empty(indices))
+            return;
+
+        assert(std::size(indices) == mesh.indexCount());
+
+        // The levels of detail would have to be remapped as well, so they
+        // are generated afterwards.
+        assert(std::empty(mesh.levelsOfDetail));
+
+        if (!std::empty(vertexOrder)) {
+            const std::size_t stride = mesh.layout.stride();
+            std::vector<std::byte> vertices(std::size(vertexOrder) * stride);
+            for (std::size_t i = 0; i < std::size(vertexOrder); ++i)
+                std::memcpy(&vertices[i * stride], &mesh.vertices[vertexOrder[i] * stride], stride);
+
+            mesh.vertices = std::move(vertices);
+            mesh.vertexCount = std::size(vertexOrder);
+        }
+
+        // There are at most as many vertices as before, so the indices still
+        // fit in their type.
+        mesh.indexStorage = mesh.writeIndices(indices);
+        mesh.indices = mesh.indexStorage;
+    }
+
+    MeshOptimization
+    MeshOptimization::optimize(const InterleavedMesh &mesh, const Options &options) noexcept {
+        MeshOptimization result{};
+        if (mesh.indexType == DecodedMesh::IndexType::NONE || mesh.indexCount() == 0 || mesh.indexCount() % 3 != 0)
+            return result;
+
+        result.indices = mesh.readIndices();
+        result.before = analyzeVertexCache(result.indices, mesh.vertexCount);
+
+        if (options.vertexCache)
+            optimizeVertexCache(result.indices, mesh.vertexCount);
+
+        if (options.overdraw) {
+            const auto positions = mesh.readPositions();
+            if (!std::empty(positions))
+                optimizeOverdraw(result.indices, positions, options.overdrawThreshold);
+        }
+
+        auto vertexCount = mesh.vertexCount;
+        if (options.vertexFetch) {
+            result.vertexOrder = optimizeVertexFetch(result.indices, mesh.vertexCount);
+            vertexCount = std::size(result.vertexOrder);
+        }
+
+        result.after = analyzeVertexCache(result.indices, vertexCount);
+        return result;
+    }
+
+    using MeshHeader = std::array<std::uint64_t, 5>;
+    using MeshParts = std::array<std::span<const std::byte>, 3>;
+
+    /**
+     * Everything besides the vertices and the indices that the optimization
+     * of a mesh depends on.
+     */
+    [[nodiscard]] static MeshHeader
+    describe(const InterleavedMesh &mesh, const MeshOptimization::Options &options) noexcept {
+        std::uint32_t threshold;
+        std::memcpy(&threshold, &options.overdrawThreshold, sizeof(threshold));
+
+        return {
+            mesh.vertexCount, mesh.layout.stride(), static_cast<std::uint64_t>(mesh.indexType),
+            (options.vertexCache ? 1u : 0u) | (options.overdraw ? 2u : 0u) | (options.vertexFetch ? 4u : 0u),
+            threshold
+        };
+    }
+
+    [[nodiscard]] static MeshParts
+    partsOf(const InterleavedMesh &mesh, const MeshHeader &header) noexcept {
+        return {std::as_bytes(std::span{header}), std::span{mesh.vertices}, mesh.indices};
+    }
+
+    [[nodiscard]] static bool
+    hasContents(std::span<const std::byte> contents, const MeshParts &parts) noexcept {
+        for (const auto part : parts) {
+            if (std::size(contents) < std::size(part) || !std::equal(std::begin(part), std::end(part), std::begin(contents)))
+                return false;
+            contents = contents.subspan(std::size(part));
+        }
+        return std::empty(contents);
+    }
+
+    std::uint64_t
+    MeshOptimizationCache::key(const InterleavedMesh &mesh, const MeshOptimization::Options &options) noexcept {
+        // FNV-1a over 8 bytes at a time, which is much faster than per byte,
+        // but doesn't diffuse well, so the contents are compared on a hit.
+        std::uint64_t hash = 0xcbf29ce484222325;
+        const auto header = describe(mesh, options);
+        for (const auto bytes : partsOf(mesh, header)) {
+            std::size_t i = 0;
+            for (; i + sizeof(std::uint64_t) <= std::size(bytes); i += sizeof(std::uint64_t)) {
+                std::uint64_t word;
+                std::memcpy(&word, &bytes[i], sizeof(word));
+                hash = (hash ^ word) * 0x100000001b3;
+            }
+            for (; i < std::size(bytes); ++i)
+                hash = (hash ^ std::to_integer<std::uint64_t>(bytes[i])) * 0x100000001b3;
+        }
+        return hash;
+    }
+
+    std::shared_ptr<const MeshOptimization>
+    MeshOptimizationCache::find(std::uint64_t cacheKey, const InterleavedMesh &mesh,
+                                const MeshOptimization::Options &options) const noexcept {
+        const auto header = describe(mesh, options);
+        const auto parts = partsOf(mesh, header);
+
+        const auto [begin, end] = m_optimizations.equal_range(cacheKey);
+        for (auto it = begin; it != end; ++it) {
+            if (hasContents(it->second.contents, parts))
+                return it->second.optimization;
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<const MeshOptimization>
+    MeshOptimizationCache::optimize(const InterleavedMesh &mesh, const MeshOptimization::Options &options) noexcept {
+        const auto cacheKey = key(mesh, options);
+        {
+            std::lock_guard lock{m_mutex};
+            if (auto optimization = find(cacheKey, mesh, options))
+                return optimization;
+        }
+
+        auto optimization = std::make_shared<const MeshOptimization>(MeshOptimization::optimize(mesh, options));
+
+        const auto header = describe(mesh, options);
+        std::vector<std::byte> contents{};
+        for (const auto part : partsOf(mesh, header))
+            contents.insert(std::end(contents), std::begin(part), std::end(part));
+
+        const auto size = (std::size(optimization->indices) + std::size(optimization->vertexOrder)) * sizeof(std::uint32_t)
+                        + std::size(contents);
+
+        std::lock_guard lock{m_mutex};
+
+        // Another thread may have optimized the same mesh in the meantime.
+        if (auto existing = find(cacheKey, mesh, options))
+            return existing;
+
+        if (m_size + size > MaximumSize) {
+            m_optimizations.clear();
+            m_size = 0;
+        }
+
+        m_optimizations.emplace(cacheKey, Entry{std::move(contents), optimization});
+        m_size += size;
+        return optimization;
+    }
+
+} // namespace resources
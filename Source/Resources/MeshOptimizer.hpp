@@ -0,0 +1,186 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+#include "Source/Math/Vector.hpp"
+
+namespace resources {
+
+    struct InterleavedMesh;
+
+    /**
+     * The number of vertices that the post-transform cache of the GPU is
+     * assumed to hold. The actual size varies per GPU, but the orders that
+     * are optimized for this size do well on all of them.
+     */
+    inline constexpr std::size_t VertexCacheSize = 16;
+
+    /**
+     * How often the vertices of a triangle list are transformed, with a FIFO
+     * post-transform cache of a given size.
+     */
+    struct VertexCacheStatistics {
+        std::size_t transformedVertexCount{0};
+        std::size_t triangleCount{0};
+
+        // The number of distinct vertices that the triangles use.
+        std::size_t vertexCount{0};
+
+        /**
+         * The average cache miss ratio (ACMR): the number of transformed
+         * vertices per triangle. This is at most 3, and is about 0.5 for
+         * a large, regular mesh in an ideal order.
+         */
+        [[nodiscard]] inline float
+        averageCacheMissRatio() const noexcept {
+            return triangleCount == 0 ? 0.0f : static_cast<float>(transformedVertexCount) / static_cast<float>(triangleCount);
+        }
+
+        /**
+         * The average transform to vertex ratio (ATVR): how many times each
+         * vertex is transformed on average. This is at least 1, which is
+         * unlike the ACMR independent of the topology.
+         */
+        [[nodiscard]] inline float
+        averageTransformToVertexRatio() const noexcept {
+            return vertexCount == 0 ? 0.0f : static_cast<float>(transformedVertexCount) / static_cast<float>(vertexCount);
+        }
+
+        inline VertexCacheStatistics &
+        operator+=(const VertexCacheStatistics &other) noexcept {
+            transformedVertexCount += other.transformedVertexCount;
+            triangleCount += other.triangleCount;
+            vertexCount += other.vertexCount;
+            return *this;
+        }
+    };
+
+    [[nodiscard]] VertexCacheStatistics
+    analyzeVertexCache(std::span<const std::uint32_t> indices, std::size_t vertexCount,
+                       std::size_t cacheSize = VertexCacheSize) noexcept;
+
+    /**
+     * Reorders the triangles so that their vertices are reused from the
+     * post-transform cache as much as possible, using Tipsify (Sander, Nehab
+     * and Barczak, 2007), which runs in linear time. The winding of the
+     * triangles is kept.
+     */
+    void
+    optimizeVertexCache(std::span<std::uint32_t> indices, std::size_t vertexCount,
+                        std::size_t cacheSize = VertexCacheSize) noexcept;
+
+    /**
+     * Reorders clusters of triangles so that those that face outwards are
+     * drawn first, which occlude the rest from most directions. The
+     * triangles are split into clusters where the vertex cache order jumps,
+     * and further where that makes the ACMR at most threshold times worse,
+     * so this should run after optimizeVertexCache().
+     */
+    void
+    optimizeOverdraw(std::span<std::uint32_t> indices, std::span<const math::Vector3f> positions,
+                     float threshold = 1.05f, std::size_t cacheSize = VertexCacheSize) noexcept;
+
+    /**
+     * Determines an order of the vertices in which they are used by the
+     * indices, so that the vertex fetch reads memory mostly sequentially,
+     * and rewrites the indices accordingly. Returns the old index of every
+     * vertex in the new order; vertices that aren't used are dropped.
+     */
+    [[nodiscard]] std::vector<std::uint32_t>
+    optimizeVertexFetch(std::span<std::uint32_t> indices, std::size_t vertexCount) noexcept;
+
+    /**
+     * The result of optimizing the order of the triangles and vertices of a
+     * mesh. It depends only on the mesh and the options, and can be applied
+     * to the mesh later on, so it can be cached.
+     */
+    struct MeshOptimization {
+        struct Options {
+            bool vertexCache{true};
+            bool overdraw{true};
+            bool vertexFetch{true};
+            float overdrawThreshold{1.05f};
+        };
+
+        // Empty when the mesh can't be optimized, e.g. when it isn't
+        // indexed.
+        std::vector<std::uint32_t> indices{};
+
+        // The old index of every vertex in the new order, or empty when the
+        // vertices keep their order.
+        std::vector<std::uint32_t> vertexOrder{};
+
+        VertexCacheStatistics before{};
+        VertexCacheStatistics after{};
+
+        /**
+         * Replaces the vertices and the indices of the mesh with the
+         * optimized ones. The indices keep their type, and are stored in the
+         * mesh afterwards.
+         */
+        void
+        apply(InterleavedMesh &) const noexcept;
+
+        [[nodiscard]] static MeshOptimization
+        optimize(const InterleavedMesh &, const Options &) noexcept;
+    };
+
+    /**
+     * Remembers the optimizations of meshes by their contents, so importing
+     * the same file again doesn't have to optimize its meshes again. It can
+     * be used from multiple threads.
+     *
+     * The entries are looked up by key(), and keep a copy of the contents
+     * of their mesh, since different meshes can have the same key.
+     */
+    class MeshOptimizationCache {
+    public:
+        /**
+         * Returns the cached optimization of the mesh, or optimizes it.
+         */
+        [[nodiscard]] std::shared_ptr<const MeshOptimization>
+        optimize(const InterleavedMesh &, const MeshOptimization::Options &) noexcept;
+
+        [[nodiscard]] static std::uint64_t
+        key(const InterleavedMesh &, const MeshOptimization::Options &) noexcept;
+
+    private:
+        struct Entry {
+            // The options, the vertices and the indices of the mesh.
+            std::vector<std::byte> contents;
+            std::shared_ptr<const MeshOptimization> optimization;
+        };
+
+        // All of the optimizations are forgotten when they would take more
+        // memory than this.
+        static constexpr std::size_t MaximumSize = 64 * 1024 * 1024;
+
+        /**
+         * Returns the optimization of the mesh, or null when it isn't
+         * cached. The mutex must be held.
+         */
+        [[nodiscard]] std::shared_ptr<const MeshOptimization>
+        find(std::uint64_t key, const InterleavedMesh &, const MeshOptimization::Options &) const noexcept;
+
+        std::mutex m_mutex{};
+        std::unordered_multimap<std::uint64_t, Entry> m_optimizations{};
+        std::size_t m_size{0};
+    };
+
+} // namespace resources
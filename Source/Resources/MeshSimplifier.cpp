@@ -0,0 +1,392 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "MeshSimplifier.hpp"
+
+#include <algorithm> // for std::sort, std::max, std::min
+#include <limits>
+#include <numeric> // for std::iota
+#include <unordered_set>
+
+#include <cassert>
+#include <cmath>
+
+#include "Source/Resources/InterleavedMesh.hpp"
+#include "Source/Resources/MeshOptimizer.hpp"
+
+namespace resources {
+
+    // The weight of the planes that keep the borders and seams in place,
+    // relative to the weight of the triangles.
+    constexpr double BorderWeight = 10.0;
+
+    using Point = std::array<double, 3>;
+
+    [[nodiscard]] static Point
+    toPoint(const math::Vector3f &vector) noexcept {
+        return {vector.x(), vector.y(), vector.z()};
+    }
+
+    [[nodiscard]] static Point
+    subtract(const Point &a, const Point &b) noexcept {
+        return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    }
+
+    [[nodiscard]] static Point
+    cross(const Point &a, const Point &b) noexcept {
+        return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+    }
+
+    [[nodiscard]] static double
+    dot(const Point &a, const Point &b) noexcept {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    [[nodiscard]] static std::uint64_t
+    edgeKey(std::uint32_t from, std::uint32_t to) noexcept {
+        return static_cast<std::uint64_t>(from) << 32 | to;
+    }
+
+    /**
+     * Adds the plane through the point with the given unit normal.
+     */
+    static void
+    addPlane(std::array<double, 11> &quadric, const Point &normal, const Point &point, double weight) noexcept {
+        const auto [a, b, c] = normal;
+        const auto d = -dot(normal, point);
+        const std::array<double, 11> plane{a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d, 1.0};
+        for (std::size_t i = 0; i < std::size(plane); ++i)
+            quadric[i] += plane[i] * weight;
+    }
+
+    MeshSimplifier::MeshSimplifier(std::span<const std::uint32_t> indices, std::span<const math::Vector3f> positions) noexcept
+            : m_indices(std::begin(indices), std::end(indices))
+            , m_positions(std::begin(positions), std::end(positions))
+            , m_canonical(std::size(positions))
+            , m_quadrics(std::size(positions)) {
+        // Vertices with the same position end up next to each other.
+        std::vector<std::uint32_t> order(std::size(positions));
+        std::iota(std::begin(order), std::end(order), 0);
+        const auto key = [&] (std::uint32_t vertex) {
+            return std::array{m_positions[vertex].x(), m_positions[vertex].y(), m_positions[vertex].z()};
+        };
+        std::sort(std::begin(order), std::end(order), [&] (std::uint32_t a, std::uint32_t b) {
+            return key(a) != key(b) ? key(a) < key(b) : a < b;
+        });
+
+        for (std::size_t i = 0; i < std::size(order); ++i) {
+            const bool startsGroup = i == 0 || key(order[i - 1]) != key(order[i]);
+            m_canonical[order[i]] = startsGroup ? order[i] : m_canonical[order[i - 1]];
+        }
+
+        addQuadrics();
+    }
+
+    void
+    MeshSimplifier::addQuadrics() noexcept {
+        std::unordered_set<std::uint64_t> halfEdges{};
+        halfEdges.reserve(std::size(m_indices));
+        for (std::size_t i = 0; i < std::size(m_indices); i += 3) {
+            for (std::size_t corner = 0; corner < 3; ++corner)
+                halfEdges.insert(edgeKey(m_indices[i + corner], m_indices[i + (corner + 1) % 3]));
+        }
+
+        for (std::size_t i = 0; i < std::size(m_indices); i += 3) {
+            const std::array corners{toPoint(m_positions[m_indices[i]]), toPoint(m_positions[m_indices[i + 1]]),
+                                     toPoint(m_positions[m_indices[i + 2]])};
+            auto normal = cross(subtract(corners[1], corners[0]), subtract(corners[2], corners[0]));
+            const auto length = std::sqrt(dot(normal, normal));
+            if (length == 0.0)
+                continue;
+            for (auto &component : normal)
+                component /= length;
+
+            for (std::size_t corner = 0; corner < 3; ++corner)
+                addPlane(m_quadrics[m_canonical[m_indices[i + corner]]], normal, corners[0], length / 2);
+
+            // An edge without a twin that has the same attributes lies on a
+            // border or a seam, which is kept in place by a plane that is
+            // perpendicular to the triangle.
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                const auto from = m_indices[i + corner];
+                const auto to = m_indices[i + (corner + 1) % 3];
+                if (halfEdges.contains(edgeKey(to, from)))
+                    continue;
+
+                const auto edge = subtract(corners[(corner + 1) % 3], corners[corner]);
+                auto borderNormal = cross(edge, normal);
+                const auto borderLength = std::sqrt(dot(borderNormal, borderNormal));
+                if (borderLength == 0.0)
+                    continue;
+                for (auto &component : borderNormal)
+                    component /= borderLength;
+
+                const auto weight = dot(edge, edge) * BorderWeight;
+                addPlane(m_quadrics[m_canonical[from]], borderNormal, corners[corner], weight);
+                addPlane(m_quadrics[m_canonical[to]], borderNormal, corners[corner], weight);
+            }
+        }
+    }
+
+    double
+    MeshSimplifier::cost(const Quadric &quadric, const math::Vector3f &position) const noexcept {
+        const double x = position.x();
+        const double y = position.y();
+        const double z = position.z();
+        const auto &q = quadric;
+        const auto error = q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+                         + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+                         + q[7] * z * z + 2 * q[8] * z
+                         + q[9];
+        return q[10] == 0.0 ? 0.0 : std::max(error / q[10], 0.0);
+    }
+
+    bool
+    MeshSimplifier::collapseIndependentEdges(std::size_t targetIndexCount, double maximumCost) noexcept {
+        const auto vertexCount = std::size(m_positions);
+        const auto triangleCount = std::size(m_indices) / 3;
+
+        // The triangles around every canonical vertex, the vertices that
+        // are used with its position, and the neighbours of every vertex,
+        // all as offsets into shared arrays.
+        std::vector<std::uint32_t> triangleOffsets(vertexCount + 1);
+        std::vector<std::uint32_t> wedgeOffsets(vertexCount + 1);
+        std::vector<std::uint32_t> neighbourOffsets(vertexCount + 1);
+        std::vector<std::uint8_t> isUsed(vertexCount);
+        for (const auto index : m_indices) {
+            ++triangleOffsets[m_canonical[index] + 1];
+            neighbourOffsets[index + 1] += 2;
+            if (!isUsed[index]) {
+                isUsed[index] = true;
+                ++wedgeOffsets[m_canonical[index] + 1];
+            }
+        }
+        for (std::size_t vertex = 0; vertex < vertexCount; ++vertex) {
+            triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+            wedgeOffsets[vertex + 1] += wedgeOffsets[vertex];
+            neighbourOffsets[vertex + 1] += neighbourOffsets[vertex];
+        }
+
+        std::vector<std::uint32_t> triangles(std::size(m_indices));
+        std::vector<std::uint32_t> wedges(wedgeOffsets.back());
+        std::vector<std::uint32_t> neighbours(neighbourOffsets.back());
+        {
+            auto triangleFill = triangleOffsets;
+            auto wedgeFill = wedgeOffsets;
+            auto neighbourFill = neighbourOffsets;
+            for (std::size_t i = 0; i < std::size(m_indices); ++i) {
+                const auto index = m_indices[i];
+                const auto triangle = i / 3 * 3;
+                triangles[triangleFill[m_canonical[index]]++] = static_cast<std::uint32_t>(i / 3);
+                neighbours[neighbourFill[index]++] = m_indices[triangle + (i - triangle + 1) % 3];
+                neighbours[neighbourFill[index]++] = m_indices[triangle + (i - triangle + 2) % 3];
+                if (isUsed[index]) {
+                    isUsed[index] = false;
+                    wedges[wedgeFill[m_canonical[index]]++] = index;
+                }
+            }
+        }
+
+        std::vector<std::uint64_t> canonicalEdges{};
+        canonicalEdges.reserve(std::size(m_indices));
+        for (std::size_t i = 0; i < std::size(m_indices); i += 3) {
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                const auto a = m_canonical[m_indices[i + corner]];
+                const auto b = m_canonical[m_indices[i + (corner + 1) % 3]];
+                if (a != b)
+                    canonicalEdges.push_back(edgeKey(std::min(a, b), std::max(a, b)));
+            }
+        }
+        std::sort(std::begin(canonicalEdges), std::end(canonicalEdges));
+        canonicalEdges.erase(std::unique(std::begin(canonicalEdges), std::end(canonicalEdges)), std::end(canonicalEdges));
+
+        // Every vertex with the position of from has to be connected to
+        // exactly one of the vertices with the position of to, which takes
+        // its place, so that the attributes stay on their side of a seam.
+        const auto mapWedges = [&] (std::uint32_t from, std::uint32_t to, std::vector<std::uint32_t> *remap) {
+            for (auto i = wedgeOffsets[from]; i < wedgeOffsets[from + 1]; ++i) {
+                const auto wedge = wedges[i];
+                auto counterpart = std::numeric_limits<std::uint32_t>::max();
+                for (auto j = neighbourOffsets[wedge]; j < neighbourOffsets[wedge + 1]; ++j) {
+                    const auto neighbour = neighbours[j];
+                    if (m_canonical[neighbour] != to || neighbour == counterpart)
+                        continue;
+                    if (counterpart != std::numeric_limits<std::uint32_t>::max())
+                        return false;
+                    counterpart = neighbour;
+                }
+                if (counterpart == std::numeric_limits<std::uint32_t>::max())
+                    return false;
+                if (remap != nullptr)
+                    (*remap)[wedge] = counterpart;
+            }
+            return true;
+        };
+
+        const auto collapseCost = [&] (std::uint32_t from, std::uint32_t to) {
+            auto quadric = m_quadrics[from];
+            for (std::size_t i = 0; i < std::size(quadric); ++i)
+                quadric[i] += m_quadrics[to][i];
+            return cost(quadric, m_positions[to]);
+        };
+
+        std::vector<Collapse> collapses{};
+        collapses.reserve(std::size(canonicalEdges));
+        for (const auto key : canonicalEdges) {
+            const auto a = static_cast<std::uint32_t>(key >> 32);
+            const auto b = static_cast<std::uint32_t>(key);
+
+            Collapse collapse{0, 0, std::numeric_limits<double>::infinity()};
+            if (mapWedges(a, b, nullptr))
+                collapse = {a, b, collapseCost(a, b)};
+            if (mapWedges(b, a, nullptr)) {
+                if (const auto reverseCost = collapseCost(b, a); reverseCost < collapse.cost)
+                    collapse = {b, a, reverseCost};
+            }
+            if (collapse.cost <= maximumCost)
+                collapses.push_back(collapse);
+        }
+        std::sort(std::begin(collapses), std::end(collapses),
+                  [] (const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+        // The triangles around a collapsed vertex change, so the vertices
+        // of those triangles aren't touched again during this pass.
+        std::vector<std::uint8_t> isLocked(vertexCount);
+        std::vector<std::uint32_t> remap(vertexCount);
+        std::iota(std::begin(remap), std::end(remap), 0);
+
+        const auto triangleNormal = [&] (const std::array<Point, 3> &corners) {
+            return cross(subtract(corners[1], corners[0]), subtract(corners[2], corners[0]));
+        };
+
+        auto remainingTriangleCount = triangleCount;
+        bool didCollapse{false};
+        for (const auto &collapse : collapses) {
+            if (remainingTriangleCount * 3 <= targetIndexCount)
+                break;
+            if (isLocked[collapse.from] || isLocked[collapse.to])
+                continue;
+
+            std::size_t removedTriangleCount{0};
+            bool flips{false};
+            for (auto i = triangleOffsets[collapse.from]; i < triangleOffsets[collapse.from + 1] && !flips; ++i) {
+                const auto *triangle = &m_indices[triangles[i] * 3];
+                std::array<Point, 3> corners{};
+                std::array<Point, 3> movedCorners{};
+                bool isRemoved{false};
+                for (std::size_t corner = 0; corner < 3; ++corner) {
+                    const auto vertex = m_canonical[triangle[corner]];
+                    isRemoved |= vertex == collapse.to;
+                    corners[corner] = toPoint(m_positions[vertex]);
+                    movedCorners[corner] = toPoint(m_positions[vertex == collapse.from ? collapse.to : vertex]);
+                }
+
+                if (isRemoved)
+                    ++removedTriangleCount;
+                else
+                    flips = dot(triangleNormal(corners), triangleNormal(movedCorners)) <= 0.0;
+            }
+            if (flips)
+                continue;
+
+            [[maybe_unused]] const bool didMap = mapWedges(collapse.from, collapse.to, &remap);
+            assert(didMap);
+
+            for (std::size_t i = 0; i < std::size(m_quadrics[collapse.to]); ++i)
+                m_quadrics[collapse.to][i] += m_quadrics[collapse.from][i];
+            m_error = std::max(m_error, static_cast<float>(std::sqrt(collapse.cost)));
+
+            for (auto i = triangleOffsets[collapse.from]; i < triangleOffsets[collapse.from + 1]; ++i) {
+                for (std::size_t corner = 0; corner < 3; ++corner)
+                    isLocked[m_canonical[m_indices[triangles[i] * 3 + corner]]] = true;
+            }
+
+            remainingTriangleCount -= removedTriangleCount;
+            didCollapse = true;
+        }
+
+        if (!didCollapse)
+            return false;
+
+        // Triangles of which two corners were collapsed onto each other are
+        // dropped.
+        std::size_t indexCount{0};
+        for (std::size_t i = 0; i < std::size(m_indices); i += 3) {
+            const std::array triangle{remap[m_indices[i]], remap[m_indices[i + 1]], remap[m_indices[i + 2]]};
+            const auto a = m_canonical[triangle[0]];
+            const auto b = m_canonical[triangle[1]];
+            const auto c = m_canonical[triangle[2]];
+            if (a == b || b == c || c == a)
+                continue;
+
+            std::copy(std::begin(triangle), std::end(triangle), std::begin(m_indices) + static_cast<std::ptrdiff_t>(indexCount));
+            indexCount += 3;
+        }
+        m_indices.resize(indexCount);
+        return true;
+    }
+
+    void
+    MeshSimplifier::simplify(std::size_t targetIndexCount, float maximumError) noexcept {
+        const auto maximumCost = static_cast<double>(maximumError) * static_cast<double>(maximumError);
+        while (std::size(m_indices) > targetIndexCount) {
+            if (!collapseIndependentEdges(targetIndexCount, maximumCost))
+                break;
+        }
+    }
+
+    void
+    generateLevelsOfDetail(InterleavedMesh &mesh, const LevelOfDetailOptions &options) noexcept {
+        mesh.levelsOfDetail.clear();
+        if (mesh.indexType == DecodedMesh::IndexType::NONE || mesh.indexCount() == 0 || mesh.indexCount() % 3 != 0)
+            return;
+
+        const auto positions = mesh.readPositions();
+        if (std::empty(positions))
+            return;
+
+        const auto indices = mesh.readIndices();
+
+        Point minimum{std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        Point maximum{std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+        for (const auto index : indices) {
+            const auto position = toPoint(positions[index]);
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                minimum[axis] = std::min(minimum[axis], position[axis]);
+                maximum[axis] = std::max(maximum[axis], position[axis]);
+            }
+        }
+        const auto diagonal = subtract(maximum, minimum);
+        const auto radius = static_cast<float>(std::sqrt(dot(diagonal, diagonal)) / 2);
+        if (radius == 0.0f)
+            return;
+
+        MeshSimplifier simplifier{indices, positions};
+        auto previousIndexCount = std::size(indices);
+        while (std::size(mesh.levelsOfDetail) < options.maximumLevelCount) {
+            const auto previousTriangleCount = previousIndexCount / 3;
+            if (previousTriangleCount <= options.minimumTriangleCount)
+                break;
+
+            const auto targetTriangleCount = std::max(options.minimumTriangleCount,
+                    static_cast<std::size_t>(static_cast<float>(previousTriangleCount) * options.reduction));
+            simplifier.simplify(targetTriangleCount * 3, options.maximumError * radius);
+
+            const auto indexCount = std::size(simplifier.indices());
+            if (static_cast<float>(indexCount) > static_cast<float>(previousIndexCount) * options.minimumReduction)
+                break;
+
+            auto levelIndices = simplifier.indices();
+            optimizeVertexCache(levelIndices, mesh.vertexCount);
+            mesh.levelsOfDetail.push_back({mesh.writeIndices(levelIndices), simplifier.error()});
+            previousIndexCount = indexCount;
+        }
+    }
+
+} // namespace resources
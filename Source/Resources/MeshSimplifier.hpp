@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+#include "Source/Math/Vector.hpp"
+
+namespace resources {
+
+    struct InterleavedMesh;
+
+    /**
+     * Reduces the triangles of a mesh by collapsing edges in the order of
+     * their quadric error (Garland and Heckbert, 1997). A vertex is always
+     * collapsed onto one of its neighbours, so the simplified mesh uses a
+     * subset of the vertices, and can share the vertex buffer of the mesh.
+     *
+     * Vertices with the same position are treated as a single vertex with
+     * multiple attribute sets (e.g. on a texture seam), which is only
+     * collapsed when all of its attribute sets have a counterpart in the
+     * other vertex. The borders and seams are kept in place by additional
+     * quadrics, and collapses that would flip a triangle are skipped.
+     *
+     * The simplifier can be run repeatedly to generate increasingly coarse
+     * levels, of which the error is relative to the original mesh.
+     */
+    class MeshSimplifier {
+    public:
+        [[nodiscard]]
+        MeshSimplifier(std::span<const std::uint32_t> indices, std::span<const math::Vector3f> positions) noexcept;
+
+        /**
+         * The distance by which the surface deviates from that of the
+         * original mesh, estimated by the largest quadric error of the
+         * collapses so far.
+         */
+        [[nodiscard]] inline float
+        error() const noexcept {
+            return m_error;
+        }
+
+        [[nodiscard]] inline const std::vector<std::uint32_t> &
+        indices() const noexcept {
+            return m_indices;
+        }
+
+        /**
+         * Collapses edges until at most targetIndexCount indices are left,
+         * or until the error would exceed maximumError.
+         */
+        void
+        simplify(std::size_t targetIndexCount, float maximumError) noexcept;
+
+    private:
+        // The symmetric 4x4 matrix of the sum of the squared distances to a
+        // set of planes, with the summed weight of the planes.
+        using Quadric = std::array<double, 11>;
+
+        struct Collapse {
+            std::uint32_t from;
+            std::uint32_t to;
+            double cost;
+        };
+
+        std::vector<std::uint32_t> m_indices;
+        std::vector<math::Vector3f> m_positions;
+
+        // The first vertex with the same position as vertex i.
+        std::vector<std::uint32_t> m_canonical;
+
+        // Indexed by canonical vertex.
+        std::vector<Quadric> m_quadrics;
+
+        float m_error{0.0f};
+
+        void
+        addQuadrics() noexcept;
+
+        /**
+         * Performs a pass of collapses that don't touch each other's
+         * triangles, cheapest first. Returns whether any collapse was made.
+         */
+        [[nodiscard]] bool
+        collapseIndependentEdges(std::size_t targetIndexCount, double maximumCost) noexcept;
+
+        [[nodiscard]] double
+        cost(const Quadric &, const math::Vector3f &) const noexcept;
+    };
+
+    struct LevelOfDetailOptions {
+        std::size_t maximumLevelCount{4};
+
+        // The targeted number of triangles of a level, relative to the
+        // previous level.
+        float reduction{0.5f};
+
+        // A level is only kept when it has at most this many triangles
+        // relative to the previous level.
+        float minimumReduction{0.9f};
+
+        std::size_t minimumTriangleCount{64};
+
+        // Relative to the radius of the bounding box of the mesh.
+        float maximumError{0.1f};
+    };
+
+    /**
+     * Replaces the levels of detail of the mesh with simplified versions of
+     * it, of which the triangles are ordered for the vertex cache.
+     */
+    void
+    generateLevelsOfDetail(InterleavedMesh &, const LevelOfDetailOptions & = {}) noexcept;
+
+} // namespace resources
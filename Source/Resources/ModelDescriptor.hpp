@@ -9,6 +9,9 @@
 
 #pragma once
 
+#include <utility> // for std::move
+#include <vector>
+
 #include "Source/Resources/ModelGeometryDescriptor.hpp"
 #include "Source/Resources/SkinDescriptor.hpp"
 
@@ -17,10 +20,27 @@ namespace resources {
     class MaterialDescriptor;
 
     class ModelDescriptor {
+    public:
+        /**
+         * A simplified version of the geometry, which is drawn instead when
+         * the difference isn't visible, see DrawList.
+         */
+        struct LevelOfDetail {
+            ModelGeometryDescriptor *geometryDescriptor;
+
+            // How far the surface deviates from that of the geometry at
+            // most, in the units of the model.
+            float error;
+        };
+
+    private:
         ModelGeometryDescriptor *m_geometryDescriptor;
         MaterialDescriptor *m_materialDescriptor;
         SkinDescriptor *m_skinDescriptor;
 
+        // Ordered from fine to coarse, excluding the geometry itself.
+        std::vector<LevelOfDetail> m_levelsOfDetail{};
+
     public:
         [[nodiscard]] inline constexpr explicit
         ModelDescriptor(ModelGeometryDescriptor *geometryDescriptor,
@@ -51,6 +71,16 @@ namespace resources {
             return m_geometryDescriptor;
         }
 
+        [[nodiscard]] inline const std::vector<LevelOfDetail> &
+        levelsOfDetail() const noexcept {
+            return m_levelsOfDetail;
+        }
+
+        inline void
+        setLevelsOfDetail(std::vector<LevelOfDetail> levelsOfDetail) noexcept {
+            m_levelsOfDetail = std::move(levelsOfDetail);
+        }
+
         [[nodiscard]] constexpr SkinDescriptor *
         skinDescriptor() noexcept {
             return m_skinDescriptor;
@@ -6,12 +6,33 @@
 
 #pragma once
 
+#include <optional>
+
+#include "Source/Math/BoundingSphere.hpp"
+
 namespace resources {
 
     class ModelGeometryDescriptor {
     public:
         virtual
         ~ModelGeometryDescriptor() noexcept = default;
+
+        /**
+         * Encloses the vertices of the geometry, in the space of the model.
+         * Entities of which the geometry has no bounds are never culled.
+         */
+        [[nodiscard]] inline const std::optional<math::BoundingSphere> &
+        bounds() const noexcept {
+            return m_bounds;
+        }
+
+        inline void
+        setBounds(const math::BoundingSphere &bounds) noexcept {
+            m_bounds = bounds;
+        }
+
+    private:
+        std::optional<math::BoundingSphere> m_bounds{};
     };
 
 } // namespace resources
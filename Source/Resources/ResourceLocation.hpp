@@ -9,7 +9,12 @@
 
 #pragma once
 
+#include <string>
+
+#include "Source/Base/Async.hpp"
 #include "Source/Base/ErrorOr.hpp"
+#include "Source/IO/MappedFile.hpp"
+#include "Source/Resources/ResourceView.hpp"
 
 namespace resources {
 
@@ -38,6 +43,31 @@ namespace resources {
         [[nodiscard]] virtual base::ErrorOr<std::string>
         readAllBytes() const noexcept = 0;
 
+        /**
+         * Returns a view of the bytes without copying them where possible:
+         * files are mapped and memory locations return their storage. The
+         * hint describes how the bytes will be read, which steers the
+         * read-ahead of mapped files.
+         *
+         * This default implementation wraps readAllBytes(), which stays the
+         * fallback for locations that can't be viewed in place.
+         */
+        [[nodiscard]] virtual base::ErrorOr<ResourceView>
+        mapView(io::MappedFile::AccessHint) const noexcept {
+            TRY_GET_VARIABLE(bytes, readAllBytes())
+            return ResourceView::adopt(std::move(bytes));
+        }
+
+        /**
+         * Reads the bytes on a worker of the pool. The awaiting coroutine
+         * resumes on that worker.
+         */
+        [[nodiscard]] base::Async<base::ErrorOr<std::string>>
+        readAllBytesAsync(base::ThreadPool &pool = base::ThreadPool::global()) const noexcept {
+            co_await base::resumeOn(pool);
+            co_return readAllBytes();
+        }
+
     private:
         Type m_type;
     };
@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <memory> // for std::shared_ptr
+#include <span>
+#include <utility> // for std::move
+
+#include <cstddef> // for std::byte, std::size_t
+
+namespace resources {
+
+    /**
+     * A read-only view of the contents of a resource, e.g. of a mapped file.
+     * Copies of the view share the storage behind it, which is released when
+     * the last copy is destroyed.
+     *
+     * A view without an owner refers to storage that outlives it, like the
+     * data of a MemoryNonOwningResourceLocation.
+     */
+    class ResourceView {
+    public:
+        [[nodiscard]] ResourceView() noexcept = default;
+
+        [[nodiscard]] inline explicit
+        ResourceView(std::span<const std::byte> bytes) noexcept
+                : m_bytes(bytes) {
+        }
+
+        [[nodiscard]] inline
+        ResourceView(std::shared_ptr<const void> owner, std::span<const std::byte> bytes) noexcept
+                : m_owner(std::move(owner))
+                , m_bytes(bytes) {
+        }
+
+        /**
+         * Takes ownership of a contiguous container, e.g. a std::string
+         * that was read or decoded, and views its contents.
+         */
+        template<typename Container>
+        [[nodiscard]] static ResourceView
+        adopt(Container &&container) noexcept {
+            auto owner = std::make_shared<const Container>(std::move(container));
+            const auto bytes = std::as_bytes(std::span{*owner});
+            return {std::move(owner), bytes};
+        }
+
+        [[nodiscard]] inline constexpr std::span<const std::byte>
+        bytes() const noexcept {
+            return m_bytes;
+        }
+
+        [[nodiscard]] inline constexpr const std::byte *
+        data() const noexcept {
+            return m_bytes.data();
+        }
+
+        [[nodiscard]] inline constexpr bool
+        empty() const noexcept {
+            return m_bytes.empty();
+        }
+
+        [[nodiscard]] inline constexpr std::size_t
+        size() const noexcept {
+            return m_bytes.size();
+        }
+
+    private:
+        std::shared_ptr<const void> m_owner{};
+        std::span<const std::byte> m_bytes{};
+    };
+
+} // namespace resources
@@ -0,0 +1,93 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <span>
+
+#include <cstddef> // for std::size_t
+#include <cstdint>
+
+namespace resources {
+
+    enum class VertexAttribute
+            : std::uint8_t {
+        POSITION,
+        TEXTURE_COORDINATES,
+        NORMAL,
+        TANGENT,
+        BITANGENT,
+    };
+
+    inline constexpr std::size_t VertexAttributeCount = 5;
+
+    [[nodiscard]] inline constexpr std::uint32_t
+    vertexAttributeComponentCount(VertexAttribute attribute) noexcept {
+        return attribute == VertexAttribute::TEXTURE_COORDINATES ? 2 : 3;
+    }
+
+    /**
+     * The layout of a vertex in an interleaved vertex buffer, in which every
+     * attribute is a number of floats at a fixed offset of the vertex. The
+     * attributes are laid out in the order in which they're added.
+     */
+    class VertexLayout {
+    public:
+        struct Element {
+            VertexAttribute attribute;
+            std::uint32_t componentCount;
+
+            // In bytes, from the start of the vertex.
+            std::uint32_t offset;
+
+            [[nodiscard]] constexpr bool
+            operator==(const Element &) const noexcept = default;
+        };
+
+        inline constexpr VertexLayout &
+        add(VertexAttribute attribute) noexcept {
+            const auto componentCount = vertexAttributeComponentCount(attribute);
+            m_elements[m_elementCount++] = {attribute, componentCount, m_stride};
+            m_stride += componentCount * static_cast<std::uint32_t>(sizeof(float));
+            return *this;
+        }
+
+        [[nodiscard]] constexpr bool
+        operator==(const VertexLayout &) const noexcept = default;
+
+        [[nodiscard]] inline constexpr bool
+        contains(VertexAttribute attribute) const noexcept {
+            for (const auto &element : elements()) {
+                if (element.attribute == attribute)
+                    return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] inline constexpr std::span<const Element>
+        elements() const noexcept {
+            return std::span{m_elements}.first(m_elementCount);
+        }
+
+        /**
+         * The size of a vertex in bytes.
+         */
+        [[nodiscard]] inline constexpr std::uint32_t
+        stride() const noexcept {
+            return m_stride;
+        }
+
+    private:
+        std::array<Element, VertexAttributeCount> m_elements{};
+        std::size_t m_elementCount{0};
+        std::uint32_t m_stride{0};
+    };
+
+} // namespace resources
@@ -181,7 +181,7 @@ namespace vke {
         }
 
         inline void
-        renderEntities() noexcept override {
+        renderEntities(const resources::DrawList &) noexcept override {
         }
 
         [[nodiscard]] inline decltype(auto)
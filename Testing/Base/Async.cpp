@@ -0,0 +1,123 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "Source/Base/Async.hpp"
+#include "Source/Base/ThreadPool.hpp"
+#include "Source/Event/Async.hpp"
+#include "Source/Event/FunctionQueue.hpp"
+
+using base::Async;
+using base::ThreadPool;
+
+struct Hop {
+    std::thread::id thread{};
+    bool onWorker{};
+};
+
+static Async<int>
+hopBetweenThreads(ThreadPool &pool, event::FunctionQueue &queue, std::array<Hop, 3> &hops) {
+    co_await base::resumeOn(pool);
+    hops[0] = {std::this_thread::get_id(), pool.isWorkerThread()};
+
+    co_await event::resumeOn(queue);
+    hops[1] = {std::this_thread::get_id(), pool.isWorkerThread()};
+
+    co_await base::resumeOn(pool);
+    hops[2] = {std::this_thread::get_id(), pool.isWorkerThread()};
+
+    co_return 42;
+}
+
+static Async<int>
+addOne(Async<int> async) {
+    co_return co_await std::move(async) + 1;
+}
+
+static Async<void>
+signalWhenFinished(ThreadPool &pool, event::FunctionQueue &queue, std::shared_ptr<int> frameOwned,
+                   std::atomic_bool &finished) {
+    static_cast<void>(frameOwned);
+    co_await base::resumeOn(pool);
+    co_await event::resumeOn(queue);
+    finished = true;
+}
+
+TEST(Base_Async, HopsBetweenPoolAndQueue) {
+    ThreadPool pool{2};
+    event::FunctionQueue queue{};
+    std::array<Hop, 3> hops{};
+
+    EXPECT_EQ(event::waitFor(hopBetweenThreads(pool, queue, hops), queue), 42);
+
+    const auto caller = std::this_thread::get_id();
+    EXPECT_NE(hops[0].thread, caller);
+    EXPECT_TRUE(hops[0].onWorker);
+
+    // waitFor() processes the queue on the calling thread.
+    EXPECT_EQ(hops[1].thread, caller);
+    EXPECT_FALSE(hops[1].onWorker);
+
+    EXPECT_NE(hops[2].thread, caller);
+    EXPECT_TRUE(hops[2].onWorker);
+}
+
+TEST(Base_Async, AwaitsOtherAsync) {
+    ThreadPool pool{2};
+    event::FunctionQueue queue{};
+    std::array<Hop, 3> hops{};
+
+    EXPECT_EQ(event::waitFor(addOne(addOne(hopBetweenThreads(pool, queue, hops))), queue), 44);
+    EXPECT_TRUE(hops[2].onWorker);
+}
+
+TEST(Base_Async, DetachedAsyncCompletesAfterHandleIsDropped) {
+    ThreadPool pool{2};
+    event::FunctionQueue queue{};
+    std::atomic_bool finished{false};
+    auto frameOwned = std::make_shared<int>(0);
+
+    {
+        auto async = signalWhenFinished(pool, queue, frameOwned, finished);
+
+        // Lazy, so nothing has run yet.
+        EXPECT_EQ(frameOwned.use_count(), 2);
+        std::move(async).detach();
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!finished && std::chrono::steady_clock::now() < deadline) {
+        EXPECT_FALSE(queue.processAll());
+        std::this_thread::yield();
+    }
+    ASSERT_TRUE(finished);
+
+    // The frame, which holds the parameters, was destroyed when it finished.
+    EXPECT_EQ(frameOwned.use_count(), 1);
+}
+
+TEST(Base_Async, DroppedAsyncDoesNotRun) {
+    ThreadPool pool{2};
+    event::FunctionQueue queue{};
+    std::atomic_bool finished{false};
+    auto frameOwned = std::make_shared<int>(0);
+
+    static_cast<void>(signalWhenFinished(pool, queue, frameOwned, finished));
+
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_FALSE(finished);
+    EXPECT_EQ(frameOwned.use_count(), 1);
+}
@@ -0,0 +1,233 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <algorithm> // for std::find
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Source/Base/Async.hpp"
+#include "Source/Base/JobGraph.hpp"
+#include "Source/Base/ThreadPool.hpp"
+#include "Source/Event/Async.hpp"
+#include "Source/Event/FunctionQueue.hpp"
+
+using base::Async;
+using base::JobGraph;
+using base::ThreadPool;
+
+/**
+ * Records the order in which the jobs finished.
+ */
+struct Recorder {
+    std::mutex mutex{};
+    std::vector<JobGraph::JobId> order{};
+
+    void
+    record(JobGraph::JobId id) {
+        std::lock_guard guard{mutex};
+        order.push_back(id);
+    }
+
+    [[nodiscard]] std::size_t
+    positionOf(JobGraph::JobId id) const {
+        return static_cast<std::size_t>(std::distance(std::begin(order), std::find(std::begin(order), std::end(order), id)));
+    }
+};
+
+TEST(Base_JobGraph, RunsDependenciesFirst) {
+    ThreadPool pool{4};
+    JobGraph graph{};
+    Recorder recorder{};
+
+    // A diamond with a tail: input -> {update, culling} -> draw list -> submit.
+    const auto input = graph.addJob("input", [&] { recorder.record(0); });
+    const auto update = graph.addJob("update", [&] { recorder.record(1); }, {input});
+    const auto culling = graph.addJob("culling", [&] { recorder.record(2); }, {input});
+    const auto drawList = graph.addJob("draw list", [&] { recorder.record(3); }, {update, culling});
+    const auto submit = graph.addJob("submit", [&] { recorder.record(4); }, {drawList});
+    ASSERT_EQ(submit, 4u);
+
+    graph.run(pool);
+
+    ASSERT_EQ(std::size(recorder.order), 5u);
+    EXPECT_EQ(recorder.order.front(), input);
+    EXPECT_LT(recorder.positionOf(update), recorder.positionOf(drawList));
+    EXPECT_LT(recorder.positionOf(culling), recorder.positionOf(drawList));
+    EXPECT_EQ(recorder.order[3], drawList);
+    EXPECT_EQ(recorder.order[4], submit);
+}
+
+TEST(Base_JobGraph, RunsCallingThreadJobsOnCaller) {
+    ThreadPool pool{2};
+    JobGraph graph{};
+
+    const auto caller = std::this_thread::get_id();
+    std::atomic_bool anyOnWorker{false};
+    std::atomic_bool callingOnCaller{true};
+    std::atomic_int callingRuns{0};
+
+    std::vector<JobGraph::JobId> workerJobs{};
+    for (int i = 0; i < 8; ++i) {
+        workerJobs.push_back(graph.addJob("worker", [&] {
+            if (pool.isWorkerThread())
+                anyOnWorker = true;
+        }));
+    }
+
+    // Both a job without dependencies and one that is made ready by a job
+    // on a worker.
+    for (const auto &dependencies : {std::vector<JobGraph::JobId>{}, workerJobs}) {
+        graph.addJob("calling thread", [&] {
+            if (std::this_thread::get_id() != caller)
+                callingOnCaller = false;
+            ++callingRuns;
+        }, dependencies, JobGraph::Affinity::CALLING_THREAD);
+    }
+
+    graph.run(pool);
+
+    EXPECT_TRUE(anyOnWorker);
+    EXPECT_TRUE(callingOnCaller);
+    EXPECT_EQ(callingRuns.load(), 2);
+}
+
+TEST(Base_JobGraph, FansInFromManyChunks) {
+    constexpr std::size_t chunkCount = 256;
+    ThreadPool pool{4};
+    JobGraph graph{};
+
+    std::vector<std::atomic_int> runs(chunkCount);
+    std::atomic_size_t finishedChunks{0};
+    std::atomic_size_t finishedChunksBeforeFanIn{0};
+
+    std::vector<JobGraph::JobId> chunks{};
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        chunks.push_back(graph.addJob("chunk", [&, chunk] {
+            ++runs[chunk];
+            ++finishedChunks;
+        }));
+    }
+
+    graph.addJob("fan in", [&] {
+        finishedChunksBeforeFanIn = finishedChunks.load();
+    }, chunks);
+
+    graph.run(pool);
+
+    EXPECT_EQ(finishedChunksBeforeFanIn.load(), chunkCount);
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+        ASSERT_EQ(runs[chunk].load(), 1) << "chunk " << chunk;
+}
+
+TEST(Base_JobGraph, RunsRepeatedly) {
+    ThreadPool pool{4};
+    JobGraph graph{};
+
+    std::atomic_int value{0};
+    std::atomic_bool inOrder{true};
+
+    // A chain, so that a dependency counter which isn't reset between runs
+    // either starts a job too early or never.
+    JobGraph::JobId previous = graph.addJob("first", [&] { value = 1; });
+    for (int step = 2; step <= 16; ++step) {
+        previous = graph.addJob("step", [&, step] {
+            if (value.load() != step - 1)
+                inOrder = false;
+            value = step;
+        }, {previous});
+    }
+
+    for (int run = 0; run < 100; ++run) {
+        value = 0;
+        graph.run(pool);
+        ASSERT_EQ(value.load(), 16) << "run " << run;
+    }
+    EXPECT_TRUE(inOrder);
+
+    // Declaring a larger graph afterwards reallocates the counters.
+    graph.clear();
+    std::atomic_int runs{0};
+    std::vector<JobGraph::JobId> jobs{};
+    for (int i = 0; i < 64; ++i)
+        jobs.push_back(graph.addJob("job", [&] { ++runs; }));
+    graph.addJob("last", [&] { ++runs; }, jobs, JobGraph::Affinity::CALLING_THREAD);
+
+    graph.run(pool);
+    graph.run(pool);
+    EXPECT_EQ(runs.load(), 2 * 65);
+}
+
+/**
+ * Awaits a graph owned by the coroutine frame, so that it is destroyed right
+ * after the awaiting coroutine is resumed.
+ */
+static Async<int>
+awaitGraphFromPool(ThreadPool &pool, event::FunctionQueue &queue, std::atomic_bool &resumedOnWorker) {
+    co_await base::resumeOn(pool);
+
+    JobGraph graph{};
+    std::atomic_int value{0};
+
+    JobGraph::JobId previous = graph.addJob("first", [&] { value = 1; });
+    for (int step = 2; step <= 8; ++step)
+        previous = graph.addJob("step", [&, step] { value = value.load() == step - 1 ? step : -1; }, {previous});
+    for (int i = 0; i < 8; ++i)
+        graph.addJob("side", [] {});
+
+    co_await graph.runAsync(pool);
+    resumedOnWorker = pool.isWorkerThread();
+
+    const int result = value.load();
+    co_await event::resumeOn(queue);
+    co_return result;
+}
+
+TEST(Base_JobGraph, RunsAsyncFromWorker) {
+    // A single worker, which would deadlock if the awaiting worker blocked.
+    ThreadPool pool{1};
+    event::FunctionQueue queue{};
+
+    for (int run = 0; run < 50; ++run) {
+        std::atomic_bool resumedOnWorker{false};
+        ASSERT_EQ(event::waitFor(awaitGraphFromPool(pool, queue, resumedOnWorker), queue), 8) << "run " << run;
+        EXPECT_TRUE(resumedOnWorker);
+    }
+}
+
+TEST(Base_JobGraph, FindsCriticalPath) {
+    ThreadPool pool{4};
+    JobGraph graph{};
+
+    const auto sleep = [](int milliseconds) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    };
+
+    //     +-> slow (40 ms) --+
+    // a --+                  +-> d -> e
+    //     +-> fast (1 ms) ---+
+    //     +-> side (5 ms)
+    const auto a = graph.addJob("a", [&] { sleep(2); });
+    const auto slow = graph.addJob("slow", [&] { sleep(40); }, {a});
+    const auto fast = graph.addJob("fast", [&] { sleep(1); }, {a});
+    graph.addJob("side", [&] { sleep(5); }, {a});
+    const auto d = graph.addJob("d", [&] { sleep(2); }, {slow, fast});
+    const auto e = graph.addJob("e", [&] { sleep(2); }, {d});
+
+    graph.run(pool);
+
+    EXPECT_EQ(graph.criticalPath(), (std::vector<JobGraph::JobId>{a, slow, d, e}));
+    EXPECT_GE(graph.timing(slow).duration, std::chrono::milliseconds(40));
+    EXPECT_GE(graph.timing(d).start, graph.timing(slow).start + graph.timing(slow).duration);
+    EXPECT_GE(graph.totalDuration(), std::chrono::milliseconds(46));
+}
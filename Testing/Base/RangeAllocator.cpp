@@ -0,0 +1,82 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include "Source/Base/RangeAllocator.hpp"
+
+using base::RangeAllocator;
+
+TEST(Base_RangeAllocator, AllocatesFirstFit) {
+    RangeAllocator allocator{100};
+    EXPECT_EQ(allocator.allocate(10), 0);
+    EXPECT_EQ(allocator.allocate(20), 10);
+    EXPECT_EQ(allocator.allocate(70), 30);
+    EXPECT_EQ(allocator.allocate(1), std::nullopt);
+    EXPECT_EQ(allocator.freeSize(), 0);
+    EXPECT_EQ(allocator.usedSize(), 100);
+}
+
+TEST(Base_RangeAllocator, MergesFreedNeighbours) {
+    RangeAllocator allocator{30};
+    const auto a = allocator.allocate(10).value();
+    const auto b = allocator.allocate(10).value();
+    const auto c = allocator.allocate(10).value();
+
+    allocator.free(a, 10);
+    allocator.free(c, 10);
+    ASSERT_EQ(std::size(allocator.freeRanges()), 2);
+
+    // The freed range in the middle joins both neighbours.
+    allocator.free(b, 10);
+    ASSERT_EQ(std::size(allocator.freeRanges()), 1);
+    EXPECT_EQ(allocator.freeRanges()[0].offset, 0);
+    EXPECT_EQ(allocator.freeRanges()[0].size, 30);
+}
+
+TEST(Base_RangeAllocator, ReusesHoles) {
+    RangeAllocator allocator{40};
+    const auto a = allocator.allocate(10).value();
+    static_cast<void>(allocator.allocate(10));
+    allocator.free(a, 10);
+
+    EXPECT_EQ(allocator.allocate(15), 20);
+    EXPECT_EQ(allocator.allocate(5), 0);
+    EXPECT_EQ(allocator.allocate(5), 5);
+    EXPECT_EQ(allocator.allocate(5), 35);
+    EXPECT_EQ(allocator.allocate(1), std::nullopt);
+}
+
+TEST(Base_RangeAllocator, AlignsAndKeepsPaddingFree) {
+    RangeAllocator allocator{32};
+    EXPECT_EQ(allocator.allocate(3), 0);
+    EXPECT_EQ(allocator.allocate(8, 4), 4);
+
+    // The padding at 3 can still be allocated without alignment.
+    EXPECT_EQ(allocator.allocate(1), 3);
+    EXPECT_EQ(allocator.allocate(4, 8), 16);
+    EXPECT_EQ(allocator.freeSize(), 32 - 3 - 8 - 1 - 4);
+}
+
+TEST(Base_RangeAllocator, GrowsAndResets) {
+    RangeAllocator allocator{};
+    EXPECT_EQ(allocator.allocate(1), std::nullopt);
+
+    allocator.grow(10);
+    EXPECT_EQ(allocator.allocate(6), 0);
+
+    // The new space merges with the free tail.
+    allocator.grow(20);
+    ASSERT_EQ(std::size(allocator.freeRanges()), 1);
+    EXPECT_EQ(allocator.allocate(14), 6);
+
+    allocator.reset(5);
+    EXPECT_EQ(allocator.usedSize(), 5);
+    EXPECT_EQ(allocator.allocate(15), 5);
+}
@@ -0,0 +1,187 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+#include "Testing/Wait.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "Source/Base/Task.hpp"
+#include "Source/Base/ThreadPool.hpp"
+
+using base::Task;
+using base::ThreadPool;
+
+/**
+ * Counts the instances that are alive, so that a test can check that the
+ * states holding them were freed.
+ */
+struct Counted {
+    static inline std::atomic_int s_aliveCount{0};
+
+    int value;
+
+    explicit Counted(int inValue) noexcept : value(inValue) { ++s_aliveCount; }
+    Counted(Counted &&other) noexcept : value(other.value) { ++s_aliveCount; }
+    Counted(const Counted &other) noexcept : value(other.value) { ++s_aliveCount; }
+    ~Counted() noexcept { --s_aliveCount; }
+};
+
+TEST(Base_Task, ContinuationAttachedBeforeResult) {
+    std::atomic_bool attached{false};
+    std::atomic_int result{0};
+
+    {
+        ThreadPool pool{2};
+        auto task = Task<int>::run([&] {
+            // The continuation is attached before this returns, so it is
+            // scheduled by publishing the result.
+            EXPECT_TRUE(Wait::until([&] { return attached.load(); }));
+            return 20;
+        }, pool);
+
+        std::move(task).then([&](int value) {
+            result = value + 1;
+        });
+        attached = true;
+    }
+
+    EXPECT_EQ(result.load(), 21);
+}
+
+TEST(Base_Task, ContinuationAttachedAfterResult) {
+    std::atomic_bool produced{false};
+    std::atomic_bool executed{false};
+    std::atomic_int result{0};
+
+    {
+        ThreadPool pool{1};
+        auto task = Task<int>::run([&] {
+            produced = true;
+            return 20;
+        }, pool);
+
+        // The only worker runs this after it has finished running the
+        // producer, including publishing its result.
+        ASSERT_TRUE(Wait::until([&] { return produced.load(); }));
+        pool.post([&] { executed = true; });
+        ASSERT_TRUE(Wait::until([&] { return executed.load(); }));
+
+        std::move(task).then([&](int value) {
+            result = value + 1;
+        });
+    }
+
+    EXPECT_EQ(result.load(), 21);
+}
+
+TEST(Base_Task, RunsChainsInOrder) {
+    std::atomic_int result{0};
+
+    {
+        ThreadPool pool{4};
+        constexpr int chainCount = 1000;
+        for (int chain = 0; chain < chainCount; ++chain) {
+            Task<int>::run([chain] { return chain; }, pool)
+                .then([](int value) { return std::to_string(value); })
+                .then([](std::string value) { return static_cast<int>(std::size(value)); })
+                .then([&result](int length) { result.fetch_add(length); });
+        }
+    }
+
+    // 10 numbers of one digit, 90 of two and 900 of three.
+    EXPECT_EQ(result.load(), 10 * 1 + 90 * 2 + 900 * 3);
+}
+
+TEST(Base_Task, VoidChain) {
+    std::atomic_int step{0};
+    std::atomic_bool inOrder{true};
+
+    {
+        ThreadPool pool{2};
+        Task<void>::run([&] {
+            if (step.fetch_add(1) != 0)
+                inOrder = false;
+        }, pool)
+            .then([&] {
+                if (step.fetch_add(1) != 1)
+                    inOrder = false;
+            })
+            .then([&] {
+                if (step.fetch_add(1) != 2)
+                    inOrder = false;
+                return 3;
+            })
+            .then([&](int value) {
+                if (step.fetch_add(value) != 3)
+                    inOrder = false;
+            });
+    }
+
+    EXPECT_EQ(step.load(), 6);
+    EXPECT_TRUE(inOrder);
+}
+
+TEST(Base_Task, MoveOnlyResults) {
+    std::atomic_int result{0};
+
+    {
+        ThreadPool pool{2};
+        Task<std::unique_ptr<int>>::run([] { return std::make_unique<int>(20); }, pool)
+            .then([](std::unique_ptr<int> value) {
+                *value += 1;
+                return value;
+            })
+            .then([&](std::unique_ptr<int> value) {
+                result = *value;
+            });
+    }
+
+    EXPECT_EQ(result.load(), 21);
+}
+
+TEST(Base_Task, DroppedHandlesDoNotLeak) {
+    std::atomic_bool release{false};
+    std::atomic_int result{0};
+
+    {
+        ThreadPool pool{2};
+
+        // Dropped before the task has finished.
+        {
+            auto task = Task<Counted>::run([&] {
+                EXPECT_TRUE(Wait::until([&] { return release.load(); }));
+                return Counted{1};
+            }, pool);
+        }
+
+        // Dropped in the middle of a chain, of which the tasks keep each
+        // other alive until they've run.
+        {
+            auto first = Task<Counted>::run([&] {
+                EXPECT_TRUE(Wait::until([&] { return release.load(); }));
+                return Counted{2};
+            }, pool);
+            auto second = std::move(first).then([](Counted value) { return Counted{value.value * 10}; });
+            std::move(second).then([&](Counted value) { result = value.value; });
+        }
+
+        // Never continued.
+        static_cast<void>(Task<Counted>::run([] { return Counted{3}; }, pool));
+
+        release = true;
+    }
+
+    EXPECT_EQ(result.load(), 20);
+
+    // The results are owned by the states, so these are destroyed as well.
+    EXPECT_EQ(Counted::s_aliveCount.load(), 0);
+}
@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+#include "Testing/Wait.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Source/Base/ThreadPool.hpp"
+
+using base::ThreadPool;
+
+TEST(Base_ThreadPool, RunsExternalJobsExactlyOnce) {
+    constexpr std::size_t jobCount = 10'000;
+    std::vector<std::atomic_size_t> runs(jobCount);
+    std::atomic_bool ranOnCaller{false};
+
+    {
+        ThreadPool pool{4};
+        EXPECT_FALSE(pool.isWorkerThread());
+
+        const auto caller = std::this_thread::get_id();
+        for (std::size_t i = 0; i < jobCount; ++i) {
+            pool.post([&, i, caller] {
+                if (std::this_thread::get_id() == caller)
+                    ranOnCaller = true;
+                runs[i].fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    }
+
+    EXPECT_FALSE(ranOnCaller);
+    for (std::size_t i = 0; i < jobCount; ++i)
+        ASSERT_EQ(runs[i].load(), 1u) << "job " << i;
+}
+
+TEST(Base_ThreadPool, RunsJobsPostedFromWorkersExactlyOnce) {
+    constexpr std::size_t parentCount = 100;
+    constexpr std::size_t childCount = 100;
+    std::vector<std::atomic_size_t> runs(parentCount * childCount);
+    std::atomic_size_t workerPosts{0};
+
+    ThreadPool pool{4};
+    for (std::size_t parent = 0; parent < parentCount; ++parent) {
+        pool.post([&, parent] {
+            if (pool.isWorkerThread())
+                workerPosts.fetch_add(1, std::memory_order_relaxed);
+
+            for (std::size_t child = 0; child < childCount; ++child) {
+                pool.post([&runs, index = parent * childCount + child] {
+                    runs[index].fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+
+    ASSERT_TRUE(Wait::until([&] { return pool.statistics().totalExecutedJobs == parentCount * (1 + childCount); }));
+    EXPECT_EQ(workerPosts.load(), parentCount);
+    EXPECT_EQ(pool.queueDepth(), 0u);
+    for (std::size_t i = 0; i < std::size(runs); ++i)
+        ASSERT_EQ(runs[i].load(), 1u) << "job " << i;
+}
+
+TEST(Base_ThreadPool, IdleWorkersStealQueuedJobs) {
+    constexpr std::size_t childCount = 64;
+    std::atomic_size_t finishedChildren{0};
+    std::atomic_bool stolenJobsFinished{false};
+
+    ThreadPool pool{2};
+    pool.post([&] {
+        // Jobs posted from a worker end up in its own deque, and this worker
+        // is occupied until they've finished, so the other worker has to
+        // steal every one of them.
+        for (std::size_t child = 0; child < childCount; ++child) {
+            pool.post([&] {
+                finishedChildren.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+
+        stolenJobsFinished = Wait::until([&] { return finishedChildren.load() == childCount; });
+    });
+
+    ASSERT_TRUE(Wait::until([&] { return pool.statistics().totalExecutedJobs == 1 + childCount; }));
+    EXPECT_TRUE(stolenJobsFinished);
+
+    const auto statistics = pool.statistics();
+    EXPECT_GE(statistics.totalStolenJobs, childCount);
+    EXPECT_EQ(statistics.totalQueueDepth, 0u);
+}
+
+TEST(Base_ThreadPool, DestructionRunsPendingJobs) {
+    constexpr std::size_t jobCount = 1'000;
+    std::atomic_bool started{false};
+    std::atomic_bool release{false};
+    std::atomic_size_t finishedJobs{0};
+    std::atomic_size_t finishedLateJobs{0};
+    auto shared = std::make_shared<int>(0);
+
+    {
+        ThreadPool pool{1};
+
+        // Keeps the only worker busy, so all other jobs are still queued when
+        // the destructor starts.
+        pool.post([&] {
+            started = true;
+            while (!release.load())
+                std::this_thread::yield();
+        });
+        ASSERT_TRUE(Wait::until([&] { return started.load(); }));
+
+        for (std::size_t i = 0; i < jobCount; ++i) {
+            pool.post([&, shared] {
+                finishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+                // Jobs posted by the remaining jobs are run as well.
+                pool.post([&] {
+                    finishedLateJobs.fetch_add(1, std::memory_order_relaxed);
+                });
+            });
+        }
+
+        EXPECT_EQ(pool.queueDepth(), jobCount);
+        release = true;
+    }
+
+    EXPECT_EQ(finishedJobs.load(), jobCount);
+    EXPECT_EQ(finishedLateJobs.load(), jobCount);
+
+    // The captures of the jobs were destroyed.
+    EXPECT_EQ(shared.use_count(), 1);
+}
@@ -0,0 +1,121 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Source/ECS/EntityList.hpp"
+
+TEST(ECS_EntityList, RemoveInvalidatesOnlyThatHandle) {
+    ecs::EntityList list{};
+    const auto first = list.create("first", nullptr)->handle();
+    const auto second = list.create("second", nullptr)->handle();
+    const auto third = list.create("third", nullptr)->handle();
+
+    const auto updateCount = list.updateCount();
+    const auto structureUpdateCount = list.structureUpdateCount();
+    EXPECT_TRUE(list.remove(first));
+    EXPECT_EQ(list.updateCount(), updateCount + 1);
+    EXPECT_EQ(list.structureUpdateCount(), structureUpdateCount + 1);
+
+    // Entities updating doesn't change the structure.
+    list.forceUpdateIncrement();
+    EXPECT_EQ(list.structureUpdateCount(), structureUpdateCount + 1);
+
+    EXPECT_FALSE(list.contains(first));
+    EXPECT_EQ(list.get(first), nullptr);
+    EXPECT_FALSE(list.remove(first));
+
+    // The last entity was moved into the place of the first one.
+    ASSERT_NE(list.get(second), nullptr);
+    ASSERT_NE(list.get(third), nullptr);
+    EXPECT_EQ(list.get(second)->name(), "second");
+    EXPECT_EQ(list.get(third)->name(), "third");
+
+    // The slot is reused, but the stale handle doesn't refer to it.
+    const auto fourth = list.create("fourth", nullptr)->handle();
+    EXPECT_EQ(fourth.index, first.index);
+    EXPECT_EQ(list.get(first), nullptr);
+    EXPECT_EQ(list.get(fourth)->name(), "fourth");
+}
+
+TEST(ECS_EntityList, BulkOperationsAreSingleUpdates) {
+    ecs::EntityList list{};
+    std::vector<std::unique_ptr<ecs::Entity>> entities{};
+    for (int i = 0; i < 10; ++i)
+        entities.push_back(std::make_unique<ecs::Entity>(std::to_string(i), nullptr));
+
+    auto updateCount = list.updateCount();
+    list.insert(std::make_move_iterator(std::begin(entities)), std::make_move_iterator(std::end(entities)));
+    ASSERT_EQ(std::size(list.data()), 10);
+    EXPECT_EQ(list.updateCount(), ++updateCount);
+
+    const auto keep = list.data()[7]->handle();
+    const auto removed = list.removeIf([](const ecs::Entity &entity) {
+        return std::stoi(entity.name()) % 2 == 0;
+    });
+    EXPECT_EQ(removed, 5);
+    EXPECT_EQ(list.updateCount(), ++updateCount);
+
+    // The remaining entities keep their order and their handles.
+    ASSERT_EQ(std::size(list.data()), 5);
+    EXPECT_EQ(list.data()[0]->name(), "1");
+    EXPECT_EQ(list.data()[4]->name(), "9");
+    for (const auto &entity : list.data())
+        EXPECT_EQ(list.get(entity->handle()), entity.get());
+
+    EXPECT_EQ(list.clearExcept({keep}), 4);
+    EXPECT_EQ(list.updateCount(), ++updateCount);
+    ASSERT_EQ(std::size(list.data()), 1);
+    EXPECT_EQ(list.get(keep)->name(), "7");
+}
+
+TEST(ECS_EntityList, RemovalReparentsChildren) {
+    ecs::EntityList list{};
+    auto *root = list.create("root", nullptr);
+    auto *middle = list.create("middle", nullptr);
+    auto *leaf = list.create("leaf", nullptr);
+    auto *sibling = list.create("sibling", nullptr);
+    middle->setParent(root);
+    leaf->setParent(middle);
+    sibling->setParent(middle);
+    EXPECT_EQ(root->childCount(), 1);
+    EXPECT_EQ(middle->childCount(), 2);
+
+    // The children of the removed entity take its parent.
+    EXPECT_TRUE(list.remove(middle->handle()));
+    EXPECT_EQ(leaf->parent(), root);
+    EXPECT_EQ(sibling->parent(), root);
+    EXPECT_EQ(root->childCount(), 2);
+
+    // Removing a childless entity only unparents it.
+    auto *other = list.create("other", nullptr);
+    other->setParent(root);
+    EXPECT_EQ(root->childCount(), 3);
+    EXPECT_TRUE(list.remove(other->handle()));
+    EXPECT_EQ(root->childCount(), 2);
+
+    // A chain of removed ancestors is skipped as a whole.
+    auto *child = list.create("child", nullptr);
+    child->setParent(leaf);
+    const auto rootHandle = root->handle();
+    const auto childHandle = child->handle();
+    EXPECT_EQ(list.removeIf([](const ecs::Entity &entity) {
+        return entity.name() == "root" || entity.name() == "leaf";
+    }), 2);
+    EXPECT_FALSE(list.contains(rootHandle));
+    ASSERT_NE(list.get(childHandle), nullptr);
+    EXPECT_EQ(list.get(childHandle)->parent(), nullptr);
+    EXPECT_EQ(sibling->parent(), nullptr);
+    EXPECT_EQ(sibling->childCount(), 0);
+}
@@ -0,0 +1,105 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <memory>
+#include <string>
+
+#include "Source/ECS/Registry.hpp"
+
+namespace {
+
+    struct Position {
+        float x;
+    };
+
+    struct Velocity {
+        float x;
+    };
+
+    struct Tag {
+        std::unique_ptr<std::string> name;
+    };
+
+} // namespace
+
+TEST(ECS_Registry, IterateExactlyMatchingEntities) {
+    ecs::Registry registry{};
+    for (int i = 0; i < 100; ++i) {
+        if (i % 2 == 0)
+            static_cast<void>(registry.create(Position{1.0f}, Velocity{2.0f}));
+        else
+            static_cast<void>(registry.create(Position{1.0f}));
+    }
+
+    EXPECT_EQ(registry.count<Position>(), 100);
+    EXPECT_EQ((registry.count<Position, Velocity>()), 50);
+
+    registry.each<Position, Velocity>([](Position &position, const Velocity &velocity) {
+        position.x += velocity.x;
+    });
+
+    float sum{};
+    registry.each<Position>([&](Position &position) {
+        sum += position.x;
+    });
+    EXPECT_FLOAT_EQ(sum, 50 * 3.0f + 50 * 1.0f);
+}
+
+TEST(ECS_Registry, AddAndRemoveMoveBetweenArchetypes) {
+    ecs::Registry registry{};
+    const auto first = registry.create(Position{1.0f}, Tag{std::make_unique<std::string>("first")});
+    const auto second = registry.create(Position{2.0f}, Tag{std::make_unique<std::string>("second")});
+
+    registry.add(first, Velocity{3.0f});
+    ASSERT_TRUE(registry.has<Velocity>(first));
+    EXPECT_FALSE(registry.has<Velocity>(second));
+    EXPECT_FLOAT_EQ(registry.get<Position>(first)->x, 1.0f);
+    EXPECT_EQ(*registry.get<Tag>(first)->name, "first");
+
+    // The second entity was moved into the row the first one left behind.
+    EXPECT_FLOAT_EQ(registry.get<Position>(second)->x, 2.0f);
+    EXPECT_EQ(*registry.get<Tag>(second)->name, "second");
+
+    registry.remove<Tag>(first);
+    EXPECT_EQ(registry.get<Tag>(first), nullptr);
+    EXPECT_FLOAT_EQ(registry.get<Velocity>(first)->x, 3.0f);
+    EXPECT_EQ(registry.count<Tag>(), 1);
+}
+
+TEST(ECS_Registry, DestroyKeepsOtherEntitiesIntact) {
+    ecs::Registry registry{};
+    const auto first = registry.create(Position{1.0f});
+    const auto second = registry.create(Position{2.0f});
+    const auto third = registry.create(Position{3.0f});
+
+    registry.destroy(first);
+    EXPECT_EQ(registry.size(), 2);
+    EXPECT_FLOAT_EQ(registry.get<Position>(second)->x, 2.0f);
+    EXPECT_FLOAT_EQ(registry.get<Position>(third)->x, 3.0f);
+
+    std::size_t visited{};
+    registry.each<Position>([&](ecs::EntityId entity, Position &) {
+        EXPECT_NE(entity, first);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 2);
+
+    // The index of the destroyed entity is reused, with a new generation.
+    const auto fourth = registry.create(Position{4.0f});
+    EXPECT_EQ(fourth.index, first.index);
+    EXPECT_NE(fourth, first);
+    EXPECT_EQ(registry.size(), 3);
+
+    EXPECT_FALSE(registry.contains(first));
+    EXPECT_FALSE(registry.has<Position>(first));
+    EXPECT_EQ(registry.get<Position>(first), nullptr);
+    EXPECT_FLOAT_EQ(registry.get<Position>(fourth)->x, 4.0f);
+}
@@ -0,0 +1,131 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include "Source/ECS/TransformGraph.hpp"
+
+namespace {
+
+    [[nodiscard]] math::Transformation
+    translation(float x, float y, float z) noexcept {
+        return math::Transformation{{x, y, z}};
+    }
+
+    [[nodiscard]] math::Vector3f
+    worldTranslation(const ecs::TransformGraph &graph, ecs::TransformGraph::NodeId node) noexcept {
+        const auto &world = graph.world(node);
+        return {world[0][3], world[1][3], world[2][3]};
+    }
+
+} // namespace
+
+TEST(ECS_TransformGraph, ComposesParentTransformations) {
+    ecs::TransformGraph graph{};
+    const auto root = graph.add(translation(1.0f, 0.0f, 0.0f));
+    const auto child = graph.add(translation(0.0f, 2.0f, 0.0f), root);
+    const auto grandChild = graph.add(translation(0.0f, 0.0f, 3.0f), child);
+
+    graph.update();
+    EXPECT_EQ(worldTranslation(graph, grandChild), (math::Vector3f{1.0f, 2.0f, 3.0f}));
+
+    graph.setLocal(root, translation(5.0f, 0.0f, 0.0f));
+    graph.update();
+    EXPECT_EQ(worldTranslation(graph, child), (math::Vector3f{5.0f, 2.0f, 0.0f}));
+    EXPECT_EQ(worldTranslation(graph, grandChild), (math::Vector3f{5.0f, 2.0f, 3.0f}));
+}
+
+TEST(ECS_TransformGraph, NormalMatricesFollowWorldMatrices) {
+    ecs::TransformGraph graph{};
+    const auto root = graph.add(math::Transformation{{1.0f, 0.0f, 0.0f}, math::Quaternion<float>::identity(), {2.0f, 1.0f, 1.0f}});
+    const auto child = graph.add(math::Transformation{{0.0f, 1.0f, 0.0f}, math::Quaternion<float>::identity(), {1.0f, 4.0f, 1.0f}}, root);
+    graph.update();
+
+    EXPECT_FLOAT_EQ(graph.normalMatrix(child)[0][0], 0.5f);
+    EXPECT_FLOAT_EQ(graph.normalMatrix(child)[1][1], 0.25f);
+    EXPECT_FLOAT_EQ(graph.normalMatrix(child)[0][3], 0.0f);
+
+    graph.setLocal(root, math::Transformation{{1.0f, 0.0f, 0.0f}, math::Quaternion<float>::identity(), {8.0f, 1.0f, 1.0f}});
+    graph.update();
+    EXPECT_FLOAT_EQ(graph.normalMatrix(child)[0][0], 0.125f);
+    EXPECT_FLOAT_EQ(graph.normalMatrix(child)[1][1], 0.25f);
+}
+
+TEST(ECS_TransformGraph, ParentsMayBeReparentedAfterTheirChildren) {
+    ecs::TransformGraph graph{};
+    const auto child = graph.add(translation(0.0f, 1.0f, 0.0f));
+    const auto parent = graph.add(translation(1.0f, 0.0f, 0.0f));
+    graph.update();
+
+    graph.setParent(child, parent);
+    graph.update();
+    EXPECT_EQ(worldTranslation(graph, child), (math::Vector3f{1.0f, 1.0f, 0.0f}));
+    EXPECT_EQ(graph.parent(child), parent);
+}
+
+TEST(ECS_TransformGraph, BreaksParentCycles) {
+    ecs::TransformGraph graph{};
+    const auto a = graph.add(translation(1.0f, 0.0f, 0.0f));
+    const auto b = graph.add(translation(0.0f, 1.0f, 0.0f), a);
+    const auto c = graph.add(translation(0.0f, 0.0f, 1.0f), b);
+    const auto below = graph.add(translation(2.0f, 0.0f, 0.0f), c);
+    const auto self = graph.add(translation(3.0f, 0.0f, 0.0f));
+    graph.setParent(a, c);
+    graph.setParent(self, self);
+
+    graph.update();
+
+    // One node of each cycle became a root, and the others still compose
+    // their parent transformations.
+    EXPECT_EQ(graph.parent(self), ecs::TransformGraph::s_noParent);
+    EXPECT_EQ(worldTranslation(graph, self), (math::Vector3f{3.0f, 0.0f, 0.0f}));
+
+    std::size_t rootCount{0};
+    for (const auto node : {a, b, c}) {
+        if (graph.parent(node) == ecs::TransformGraph::s_noParent)
+            ++rootCount;
+    }
+    ASSERT_EQ(rootCount, 1u);
+    EXPECT_EQ(graph.parent(below), c);
+
+    auto expected = graph.local(below).translation();
+    for (auto node = c; node != ecs::TransformGraph::s_noParent; node = graph.parent(node))
+        expected = expected.add(graph.local(node).translation());
+    EXPECT_EQ(worldTranslation(graph, below), expected);
+}
+
+TEST(ECS_TransformGraph, PartitionsMatchSerialUpdate) {
+    ecs::TransformGraph graph{};
+
+    // A wide tree of depth 3, large enough to be partitioned.
+    const auto root = graph.add(translation(1.0f, 0.0f, 0.0f));
+    for (int i = 0; i < 128; ++i) {
+        const auto child = graph.add(translation(0.0f, static_cast<float>(i), 0.0f), root);
+        for (int j = 0; j < 64; ++j)
+            static_cast<void>(graph.add(translation(0.0f, 0.0f, static_cast<float>(j)), child));
+    }
+
+    graph.updateTop();
+    ASSERT_GT(graph.partitionCount(), 1);
+
+    // In reverse, to show that the partitions don't depend on each other.
+    for (auto partition = graph.partitionCount(); partition-- > 0;)
+        graph.updatePartitions(partition, partition + 1);
+
+    // The first grandchild of the last child.
+    const auto node = static_cast<ecs::TransformGraph::NodeId>(graph.size() - 64);
+    EXPECT_EQ(worldTranslation(graph, node), (math::Vector3f{1.0f, 127.0f, 0.0f}));
+
+    // Only the changed subtree is recomputed, so moving it doesn't affect
+    // the others.
+    graph.setLocal(graph.parent(node), translation(0.0f, -1.0f, 0.0f));
+    graph.update();
+    EXPECT_EQ(worldTranslation(graph, node), (math::Vector3f{1.0f, -1.0f, 0.0f}));
+    EXPECT_EQ(worldTranslation(graph, 2), (math::Vector3f{1.0f, 0.0f, 0.0f}));
+}
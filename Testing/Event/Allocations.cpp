@@ -0,0 +1,255 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Checks that the event hot paths don't allocate, by counting the calls to
+ * the global operator new. This is a separate executable, since replacing
+ * operator new affects the whole program.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <cstdlib>
+
+#include "Source/Base/InplaceFunction.hpp"
+#include "Source/Event/Event.hpp"
+#include "Source/Event/EventHandler.hpp"
+#include "Source/Event/EventHandlerQueue.hpp"
+#include "Source/Event/FunctionQueue.hpp"
+#include "Source/Input/MouseUpdate.hpp"
+
+static std::atomic_size_t s_allocationCount{0};
+
+void *
+operator new(std::size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto *pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void
+operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+// The amount of allocations done by the function.
+template<typename Function>
+[[nodiscard]] std::size_t
+countAllocations(Function &&function) {
+    const auto before = s_allocationCount.load(std::memory_order_relaxed);
+    function();
+    return s_allocationCount.load(std::memory_order_relaxed) - before;
+}
+
+struct CountingEvent : event::Event {
+    std::size_t value{};
+};
+
+TEST(Base_InplaceFunction, InlineCallableDoesNotAllocate) {
+    int a = 1;
+    int b = 2;
+    int c = 3;
+
+    std::size_t result{};
+    const auto count = countAllocations([&] {
+        base::InplaceFunction<int(int), 32> function{[&a, &b, &c](int d) { return a + b + c + d; }};
+        auto moved = std::move(function);
+        result = static_cast<std::size_t>(moved(4));
+    });
+
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(result, 10u);
+}
+
+TEST(Base_InplaceFunction, HeapFallback) {
+    struct Large {
+        std::size_t values[8]{1, 2, 3, 4, 5, 6, 7, 8};
+    };
+
+    std::size_t result{};
+    const auto count = countAllocations([&] {
+        base::InplaceFunction<std::size_t(), 16, base::InplaceFunctionStorage::HEAP_FALLBACK> function{
+            [large = Large{}] { return large.values[7]; }
+        };
+        auto moved = std::move(function);
+        EXPECT_FALSE(function);
+        result = moved();
+    });
+
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(result, 8u);
+}
+
+TEST(Base_InplaceFunction, MoveOnlyCallable) {
+    auto value = std::make_unique<int>(42);
+
+    base::InplaceFunction<int()> function{[value = std::move(value)] { return *value; }};
+    base::InplaceFunction<int()> other{};
+    other = std::move(function);
+
+    EXPECT_FALSE(function);
+    ASSERT_TRUE(other);
+    EXPECT_EQ(other(), 42);
+}
+
+TEST(Base_InplaceFunction, DestroysCallable) {
+    auto shared = std::make_shared<int>(0);
+
+    {
+        base::InplaceFunction<void()> function{[shared] {}};
+        EXPECT_EQ(shared.use_count(), 2);
+
+        function = nullptr;
+        EXPECT_EQ(shared.use_count(), 1);
+
+        function = [shared] {};
+        EXPECT_EQ(shared.use_count(), 2);
+    }
+
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(Event_EventHandler, InvokeDoesNotAllocate) {
+    event::EventHandler<CountingEvent> handler{};
+
+    std::size_t sum{};
+    handler += [&sum](CountingEvent &event) {
+        sum += event.value;
+        return base::Error::success();
+    };
+    handler += [&sum](CountingEvent &) {
+        ++sum;
+        return base::Error::success();
+    };
+
+    const auto count = countAllocations([&] {
+        for (std::size_t i = 0; i < 1000; ++i) {
+            CountingEvent event{};
+            event.value = i;
+            if (handler.invoke(event))
+                std::abort();
+        }
+    });
+
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(sum, 999u * 1000u / 2u + 1000u);
+    EXPECT_EQ(handler.firedEventsCount(), 1000u);
+}
+
+TEST(Event_FunctionQueue, PostAndProcessDoNotAllocate) {
+    event::FunctionQueue queue{64};
+
+    std::size_t sum{};
+    const auto count = countAllocations([&] {
+        for (std::size_t round = 0; round < 100; ++round) {
+            for (std::size_t i = 0; i < 64; ++i) {
+                queue.post([&sum, i] {
+                    sum += i;
+                    return base::Error::success();
+                });
+            }
+
+            if (queue.processAll())
+                std::abort();
+        }
+    });
+
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(sum, 100u * (63u * 64u / 2u));
+    EXPECT_EQ(queue.fullCount(), 0u);
+}
+
+TEST(Event_EventHandlerQueue, DispatchDoesNotAllocate) {
+    event::EventHandlerQueue<CountingEvent> queue{16};
+
+    std::size_t sum{};
+    std::size_t batches{};
+    queue += [&sum](CountingEvent &event) {
+        sum += event.value;
+        return base::Error::success();
+    };
+    queue.addBatchHandler([&batches](base::ArrayView<CountingEvent>) {
+        ++batches;
+        return base::Error::success();
+    });
+
+    const auto count = countAllocations([&] {
+        for (std::size_t round = 0; round < 100; ++round) {
+            // Ten events per round, so the ring wraps around every so often.
+            for (std::size_t i = 0; i < 10; ++i) {
+                CountingEvent event{};
+                event.value = i;
+                queue.invokeLater(std::move(event));
+            }
+
+            if (queue.processAll())
+                std::abort();
+        }
+    });
+
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(sum, 100u * 45u);
+    EXPECT_GE(batches, 100u);
+    EXPECT_LT(batches, 200u);
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_EQ(queue.droppedCount(), 0u);
+}
+
+TEST(Event_EventHandlerQueue, DropsWhenFull) {
+    event::EventHandlerQueue<CountingEvent> queue{4};
+
+    for (std::size_t i = 0; i < 6; ++i) {
+        CountingEvent event{};
+        event.value = i;
+        EXPECT_EQ(queue.invokeLater(std::move(event)), i < 4);
+    }
+
+    std::size_t sum{};
+    queue += [&sum](CountingEvent &event) {
+        sum += event.value;
+        return base::Error::success();
+    };
+
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(sum, 0u + 1u + 2u + 3u);
+    EXPECT_EQ(queue.droppedCount(), 2u);
+    EXPECT_EQ(queue.firedEventsCount(), 6u);
+}
+
+TEST(Event_EventHandlerQueue, CoalescesMouseMoves) {
+    event::EventHandlerQueue<input::MouseUpdate, input::CoalesceMouseMoves> queue{};
+
+    queue.invokeLater({input::MouseButton::NONE, false, 1.0f, 2.0f});
+    queue.invokeLater({input::MouseButton::NONE, false, 3.0f, 4.0f});
+    queue.invokeLater({input::MouseButton::LEFT, true});
+    queue.invokeLater({input::MouseButton::NONE, false, 5.0f, 6.0f});
+    queue.invokeLater({input::MouseButton::NONE, false, 7.0f, 8.0f});
+
+    std::vector<input::MouseUpdate> updates{};
+    queue += [&updates](input::MouseUpdate &update) {
+        updates.push_back(update);
+        return base::Error::success();
+    };
+
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(queue.coalescedCount(), 2u);
+
+    ASSERT_EQ(updates.size(), 3u);
+    EXPECT_EQ(updates[0].moveX, 4.0f);
+    EXPECT_EQ(updates[0].moveY, 6.0f);
+    EXPECT_EQ(updates[1].button, input::MouseButton::LEFT);
+    EXPECT_EQ(updates[2].moveX, 12.0f);
+    EXPECT_EQ(updates[2].moveY, 14.0f);
+}
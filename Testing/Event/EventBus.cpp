@@ -0,0 +1,219 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Source/Event/EventBus.hpp"
+#include "Source/Event/FunctionQueue.hpp"
+
+struct TestEvent {
+    int value{};
+};
+
+using Bus = event::EventBus<TestEvent>;
+
+TEST(Event_EventBus, UnsubscribesWithToken) {
+    Bus bus{};
+    int first{0};
+    int second{0};
+
+    auto firstToken = bus.subscribe([&first](TestEvent &event) {
+        first += event.value;
+        return base::Error::success();
+    });
+    auto secondToken = bus.subscribe([&second](TestEvent &event) {
+        second += event.value;
+        return base::Error::success();
+    });
+    EXPECT_TRUE(firstToken);
+    EXPECT_TRUE(secondToken);
+
+    TestEvent event{1};
+    EXPECT_FALSE(bus.invoke(event));
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 1);
+
+    bus.unsubscribe(firstToken);
+    EXPECT_FALSE(firstToken);
+
+    // Unsubscribing twice does nothing.
+    bus.unsubscribe(firstToken);
+
+    event.value = 2;
+    EXPECT_FALSE(bus.invoke(event));
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 3);
+    EXPECT_EQ(bus.firedEventsCount(), 2u);
+}
+
+TEST(Event_EventBus, RepublishesWhenMostAreInactive) {
+    Bus bus{};
+    int count{0};
+
+    std::vector<Bus::Token> tokens{};
+    for (int i = 0; i < 4; ++i) {
+        tokens.push_back(bus.subscribe([&count](TestEvent &) {
+            ++count;
+            return base::Error::success();
+        }));
+    }
+    ASSERT_EQ(bus.publishedSize(), 4u);
+
+    // Removing is O(1) until more than half of the list is inactive.
+    bus.unsubscribe(tokens[0]);
+    EXPECT_EQ(bus.publishedSize(), 4u);
+    bus.unsubscribe(tokens[1]);
+    EXPECT_EQ(bus.publishedSize(), 4u);
+
+    TestEvent event{};
+    EXPECT_FALSE(bus.invoke(event));
+    EXPECT_EQ(count, 2);
+
+    bus.unsubscribe(tokens[2]);
+    EXPECT_EQ(bus.publishedSize(), 1u);
+
+    // Subscribing publishes a new list as well, without the inactive ones.
+    bus.unsubscribe(tokens[3]);
+    auto token = bus.subscribe([&count](TestEvent &) {
+        count += 10;
+        return base::Error::success();
+    });
+    EXPECT_EQ(bus.publishedSize(), 1u);
+
+    EXPECT_FALSE(bus.invoke(event));
+    EXPECT_EQ(count, 12);
+}
+
+TEST(Event_EventBus, UnsubscribesDuringInvoke) {
+    Bus bus{};
+    Bus::Token selfToken{};
+    Bus::Token laterToken{};
+    int selfCount{0};
+    int laterCount{0};
+
+    selfToken = bus.subscribe([&](TestEvent &) {
+        ++selfCount;
+
+        // Republishes the list, whilst the old one is still being walked.
+        bus.unsubscribe(selfToken);
+        bus.unsubscribe(laterToken);
+        return base::Error::success();
+    });
+    laterToken = bus.subscribe([&laterCount](TestEvent &) {
+        ++laterCount;
+        return base::Error::success();
+    });
+
+    TestEvent event{};
+    EXPECT_FALSE(bus.invoke(event));
+    EXPECT_FALSE(bus.invoke(event));
+
+    EXPECT_EQ(selfCount, 1);
+    EXPECT_EQ(laterCount, 0);
+    EXPECT_EQ(bus.publishedSize(), 0u);
+}
+
+TEST(Event_EventBus, DeliversThroughQueue) {
+    Bus bus{};
+    event::FunctionQueue queue{};
+
+    const auto consumer = std::this_thread::get_id();
+    int sum{0};
+    bool onConsumer{true};
+
+    auto token = bus.subscribe([&](TestEvent &event) {
+        sum += event.value;
+        onConsumer = onConsumer && std::this_thread::get_id() == consumer;
+        return base::Error::success();
+    }, queue);
+
+    std::thread producer{[&bus] {
+        for (int i = 1; i <= 100; ++i) {
+            TestEvent event{i};
+            EXPECT_FALSE(bus.invoke(event));
+
+            // The handler gets a copy.
+            event.value = 0;
+        }
+    }};
+    producer.join();
+
+    EXPECT_EQ(sum, 0);
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(sum, 100 * 101 / 2);
+    EXPECT_TRUE(onConsumer);
+
+    // Events that are still queued when unsubscribing are skipped.
+    TestEvent event{1000};
+    EXPECT_FALSE(bus.invoke(event));
+    bus.unsubscribe(token);
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(sum, 100 * 101 / 2);
+}
+
+TEST(Event_EventBus, PublishesAndUnsubscribesConcurrently) {
+    constexpr int publisherCount = 3;
+    constexpr int eventsPerPublisher = 20'000;
+
+    Bus bus{};
+    std::atomic_int permanentCount{0};
+    std::atomic_int temporaryCount{0};
+
+    bus += [&permanentCount](TestEvent &) {
+        permanentCount.fetch_add(1, std::memory_order_relaxed);
+        return base::Error::success();
+    };
+
+    std::atomic_bool publishing{true};
+    std::vector<std::thread> publishers{};
+    for (int publisher = 0; publisher < publisherCount; ++publisher) {
+        publishers.emplace_back([&] {
+            for (int i = 0; i < eventsPerPublisher; ++i) {
+                TestEvent event{i};
+                EXPECT_FALSE(bus.invoke(event));
+            }
+        });
+    }
+
+    // Churns the list whilst the publishers are reading it.
+    std::thread subscriber{[&] {
+        std::vector<Bus::Token> tokens{};
+        while (publishing.load()) {
+            for (int i = 0; i < 8; ++i) {
+                tokens.push_back(bus.subscribe([&temporaryCount](TestEvent &) {
+                    temporaryCount.fetch_add(1, std::memory_order_relaxed);
+                    return base::Error::success();
+                }));
+            }
+            for (auto &token : tokens)
+                bus.unsubscribe(token);
+            tokens.clear();
+            std::this_thread::yield();
+        }
+    }};
+
+    for (auto &publisher : publishers)
+        publisher.join();
+    publishing = false;
+    subscriber.join();
+
+    EXPECT_EQ(permanentCount.load(), publisherCount * eventsPerPublisher);
+    EXPECT_EQ(bus.firedEventsCount(), static_cast<std::size_t>(publisherCount * eventsPerPublisher));
+    EXPECT_LE(bus.publishedSize(), 1u + 8u);
+
+    // Nothing is subscribed anymore except the permanent handler.
+    const auto temporaryBefore = temporaryCount.load();
+    TestEvent event{};
+    EXPECT_FALSE(bus.invoke(event));
+    EXPECT_EQ(temporaryCount.load(), temporaryBefore);
+}
@@ -0,0 +1,153 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Source/Event/FunctionQueue.hpp"
+
+using event::FunctionQueue;
+
+[[nodiscard]] static base::Error
+failure() {
+    return base::Error("Testing", "FunctionQueue", "Run function", "Failed on purpose.");
+}
+
+TEST(Event_FunctionQueue, ConsumerPostsKeepOrderThroughOverflow) {
+    FunctionQueue queue{4};
+    std::vector<int> order{};
+
+    for (int i = 0; i < 10; ++i) {
+        queue.post([&order, i] {
+            order.push_back(i);
+            return base::Error::success();
+        });
+    }
+
+    // The posts after the first one that found the ring full go straight to
+    // the overflow.
+    EXPECT_EQ(queue.fullCount(), 1u);
+
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(Event_FunctionQueue, PostsDuringProcessingKeepOrder) {
+    FunctionQueue queue{4};
+    std::vector<int> order{};
+
+    const auto record = [&order](int value) {
+        return [&order, value] {
+            order.push_back(value);
+            return base::Error::success();
+        };
+    };
+
+    // The first function finds the ring full, so its post ends up in the
+    // overflow. The second one finds a free slot, but must still run after
+    // that.
+    queue.post([&] {
+        queue.post(record(10));
+        return base::Error::success();
+    });
+    queue.post([&] {
+        queue.post(record(11));
+        return base::Error::success();
+    });
+    queue.post(record(2));
+    queue.post(record(3));
+
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(order, (std::vector<int>{2, 3}));
+
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(order, (std::vector<int>{2, 3, 10, 11}));
+
+    // The overflow is empty again, so the ring is used.
+    queue.post(record(12));
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(order, (std::vector<int>{2, 3, 10, 11, 12}));
+    EXPECT_EQ(queue.fullCount(), 1u);
+}
+
+TEST(Event_FunctionQueue, FailedOverflowKeepsOrder) {
+    FunctionQueue queue{2};
+    std::vector<int> order{};
+
+    for (int i = 0; i < 5; ++i) {
+        queue.post([&order, i] {
+            order.push_back(i);
+            return i == 2 ? failure() : base::Error::success();
+        });
+    }
+
+    EXPECT_TRUE(queue.processAll());
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+
+    // Posted after the remaining functions of the overflow, so it runs
+    // after them, even though there is room in the ring now.
+    queue.post([&order] {
+        order.push_back(5);
+        return base::Error::success();
+    });
+
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+}
+
+TEST(Event_FunctionQueue, KeepsOrderOfEveryProducer) {
+    constexpr std::size_t producerCount = 4;
+    constexpr std::size_t postsPerProducer = 20'000;
+
+    // Small, so the ring wraps around many times and the producers have to
+    // wait for room.
+    FunctionQueue queue{16};
+
+    std::vector<std::size_t> received(producerCount);
+    std::size_t receivedTotal{0};
+    std::size_t outOfOrder{0};
+
+    std::vector<std::thread> producers{};
+    for (std::size_t producer = 0; producer < producerCount; ++producer) {
+        producers.emplace_back([&, producer] {
+            for (std::size_t i = 0; i < postsPerProducer; ++i) {
+                // Only touched by the consumer.
+                queue.post([&, producer, i] {
+                    if (received[producer] != i)
+                        ++outOfOrder;
+                    received[producer] = i + 1;
+                    ++receivedTotal;
+                    return base::Error::success();
+                });
+            }
+        });
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (receivedTotal != producerCount * postsPerProducer && std::chrono::steady_clock::now() < deadline) {
+        EXPECT_FALSE(queue.processAll());
+        std::this_thread::yield();
+    }
+
+    for (auto &producer : producers)
+        producer.join();
+
+    EXPECT_EQ(receivedTotal, producerCount * postsPerProducer);
+    EXPECT_EQ(outOfOrder, 0u);
+    for (std::size_t producer = 0; producer < producerCount; ++producer)
+        EXPECT_EQ(received[producer], postsPerProducer);
+
+    // Nothing is left behind.
+    EXPECT_FALSE(queue.processAll());
+    EXPECT_EQ(receivedTotal, producerCount * postsPerProducer);
+}
@@ -0,0 +1,124 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <algorithm> // for std::equal
+#include <cstdio>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <cstdint>
+
+#include "Source/IO/Format/GLTF/Binary.hpp"
+#include "Source/IO/Format/GLTF/Document.hpp"
+#include "Source/IO/MappedFile.hpp"
+
+using namespace io::format::gltf;
+
+constexpr std::string_view Json = R"({"nodes": [{"name": "Cube"}], "buffers": [{"byteLength": 6}]})";
+constexpr std::uint32_t ChunkTypeJSON = 0x4E4F534A;
+constexpr std::uint32_t ChunkTypeBIN = 0x004E4942;
+
+static void
+appendUInt32(std::vector<std::byte> &data, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+        data.push_back(static_cast<std::byte>(value >> (8 * i)));
+}
+
+static void
+appendChunk(std::vector<std::byte> &data, std::uint32_t type, std::span<const std::byte> contents, std::byte padding) {
+    const auto paddedLength = (std::size(contents) + 3) & ~std::size_t{3};
+    appendUInt32(data, static_cast<std::uint32_t>(paddedLength));
+    appendUInt32(data, type);
+    data.insert(std::end(data), std::begin(contents), std::end(contents));
+    data.resize(std::size(data) + paddedLength - std::size(contents), padding);
+}
+
+[[nodiscard]] static std::vector<std::byte>
+createContainer(std::uint32_t version = 2, std::uint32_t firstChunkType = ChunkTypeJSON) {
+    const std::vector<std::byte> binary{std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}, std::byte{6}};
+
+    std::vector<std::byte> chunks{};
+    appendChunk(chunks, firstChunkType, std::as_bytes(std::span{Json}), std::byte{' '});
+    appendChunk(chunks, ChunkTypeBIN, binary, std::byte{0});
+
+    std::vector<std::byte> data{};
+    appendUInt32(data, 0x46546C67);
+    appendUInt32(data, version);
+    appendUInt32(data, static_cast<std::uint32_t>(12 + std::size(chunks)));
+    data.insert(std::end(data), std::begin(chunks), std::end(chunks));
+    return data;
+}
+
+TEST(IO_GLTFBinary, ParsesChunksInPlace) {
+    const auto data = createContainer();
+    ASSERT_TRUE(isBinaryContainer(data));
+
+    const auto container = parseBinaryContainer(data);
+    ASSERT_FALSE(container.failed()) << container.error().description();
+
+    // The JSON chunk is padded with spaces, which the parser skips.
+    EXPECT_EQ(container->json.substr(0, std::size(Json)), Json);
+    EXPECT_EQ(reinterpret_cast<const std::byte *>(container->json.data()), data.data() + 20);
+
+    ASSERT_EQ(std::size(container->binary), 8);
+    EXPECT_EQ(container->binary[0], std::byte{1});
+    EXPECT_EQ(container->binary[5], std::byte{6});
+
+    const auto document = Document::parseInPlace(container->json);
+    ASSERT_FALSE(document.failed()) << document.error().description();
+    EXPECT_EQ(document->nodes()[0].name, "Cube");
+    EXPECT_EQ(document->buffers()[0].uri, "");
+    EXPECT_EQ(document->buffers()[0].byteLength, 6);
+}
+
+TEST(IO_GLTFBinary, RejectsInvalidContainers) {
+    const std::string_view text{"{\"nodes\": []}"};
+    EXPECT_FALSE(isBinaryContainer(std::as_bytes(std::span{text})));
+    EXPECT_TRUE(parseBinaryContainer(std::as_bytes(std::span{text})).failed());
+
+    EXPECT_TRUE(parseBinaryContainer(createContainer(1)).failed());
+    EXPECT_TRUE(parseBinaryContainer(createContainer(2, ChunkTypeBIN)).failed());
+
+    auto truncated = createContainer();
+    truncated.resize(std::size(truncated) - 4);
+    EXPECT_TRUE(parseBinaryContainer(truncated).failed());
+}
+
+TEST(IO_MappedFile, MapsFileContents) {
+    const auto data = createContainer();
+    const char *fileName = "GLTFBinaryTest.glb";
+    {
+        auto *file = std::fopen(fileName, "wb");
+        ASSERT_NE(file, nullptr);
+        ASSERT_EQ(std::fwrite(data.data(), 1, std::size(data), file), std::size(data));
+        std::fclose(file);
+    }
+
+    io::MappedFile mappedFile{fileName};
+    ASSERT_TRUE(mappedFile);
+    ASSERT_EQ(mappedFile.size(), std::size(data));
+    EXPECT_TRUE(std::equal(std::begin(data), std::end(data), std::begin(mappedFile.data())));
+
+    // Moving doesn't move the mapping.
+    const auto *address = mappedFile.data().data();
+    io::MappedFile moved{std::move(mappedFile)};
+    EXPECT_EQ(moved.data().data(), address);
+    EXPECT_TRUE(std::empty(mappedFile.data()));
+
+    std::remove(fileName);
+}
+
+TEST(IO_MappedFile, ReportsMissingFile) {
+    io::MappedFile mappedFile{"ThisFileDoesNotExist.glb"};
+    EXPECT_FALSE(mappedFile);
+    EXPECT_EQ(mappedFile.error(), io::Error::FILE_NOT_FOUND);
+}
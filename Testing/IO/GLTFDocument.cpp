@@ -0,0 +1,131 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <string_view>
+#include <vector>
+
+#include "Source/IO/Format/GLTF/Document.hpp"
+
+using namespace io::format::gltf;
+
+[[nodiscard]] static base::ErrorOr<Document>
+parse(std::string_view text) {
+    return Document::parse(std::vector<char>(std::begin(text), std::end(text)));
+}
+
+constexpr std::string_view TriangleDocument = R"({
+    "asset": {"version": "2.0", "generator": "Testing"},
+    "scene": 0,
+    "scenes": [{"nodes": [0]}],
+    "nodes": [
+        {"name": "Root", "children": [1, 2], "translation": [1.0, 2.0, 3.0]},
+        {"name": "Triangle", "mesh": 0, "scale": [2, 2, 2]},
+        {"name": "Light", "extensions": {"KHR_lights_punctual": {"light": 0}}}
+    ],
+    "meshes": [{"name": "Triangle", "primitives": [
+        {"attributes": {"POSITION": 0, "TEXCOORD_0": 1}, "indices": 2, "material": 0, "extras": {"ignored": [true, null]}}
+    ]}],
+    "materials": [{"name": "Red", "pbrMetallicRoughness": {"baseColorTexture": {"index": 0}}}],
+    "textures": [{"source": 0}],
+    "images": [{"uri": "red.png"}],
+    "accessors": [
+        {"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"},
+        {"bufferView": 0, "byteOffset": 36, "componentType": 5126, "count": 3, "type": "VEC2"},
+        {"bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR"}
+    ],
+    "bufferViews": [
+        {"buffer": 0, "byteLength": 60},
+        {"buffer": 0, "byteOffset": 60, "byteLength": 6, "target": 34963}
+    ],
+    "buffers": [{"uri": "triangle.bin", "byteLength": 66}],
+    "extensions": {"KHR_lights_punctual": {"lights": [{"type": "point", "color": [1, 0.5, 0], "intensity": 4}]}}
+})";
+
+TEST(IO_GLTFDocument, ParsesTriangleDocument) {
+    const auto document = parse(TriangleDocument);
+    ASSERT_FALSE(document.failed()) << document.error().description();
+
+    ASSERT_EQ(std::size(document->nodes()), 3);
+    const auto &root = document->nodes()[0];
+    EXPECT_EQ(root.name, "Root");
+    EXPECT_EQ(root.mesh, NoIndex);
+    EXPECT_EQ(root.translation.z(), 3.0f);
+    ASSERT_EQ(std::size(document->children(root)), 2);
+    EXPECT_EQ(document->children(root)[0], 1);
+    EXPECT_EQ(document->children(root)[1], 2);
+
+    const auto &triangle = document->nodes()[1];
+    EXPECT_EQ(triangle.mesh, 0);
+    EXPECT_EQ(triangle.scale.x(), 2.0f);
+    EXPECT_EQ(document->nodes()[2].light, 0);
+
+    ASSERT_EQ(std::size(document->meshes()), 1);
+    const auto primitives = document->primitives(document->meshes()[0]);
+    ASSERT_EQ(std::size(primitives), 1);
+    EXPECT_EQ(primitives[0].position, 0);
+    EXPECT_EQ(primitives[0].textureCoordinates, 1);
+    EXPECT_EQ(primitives[0].normal, NoIndex);
+    EXPECT_EQ(primitives[0].indices, 2);
+    EXPECT_EQ(primitives[0].mode, 4);
+
+    const auto &indices = document->accessors()[2];
+    EXPECT_EQ(indices.componentType, ComponentType::UNSIGNED_SHORT);
+    EXPECT_EQ(indices.type, AccessorType::SCALAR);
+    EXPECT_EQ(document->accessors()[1].byteOffset, 36);
+    EXPECT_EQ(document->bufferViews()[1].target, 34963);
+    EXPECT_EQ(document->buffers()[0].uri, "triangle.bin");
+
+    EXPECT_EQ(document->materials()[0].baseColorTexture, 0);
+    EXPECT_EQ(document->materials()[0].normalTexture, NoIndex);
+    EXPECT_EQ(document->textures()[0].source, 0);
+    EXPECT_EQ(document->images()[0].uri, "red.png");
+
+    ASSERT_EQ(std::size(document->lights()), 1);
+    EXPECT_EQ(document->lights()[0].type, "point");
+    EXPECT_EQ(document->lights()[0].color.y(), 0.5f);
+    EXPECT_EQ(document->lights()[0].intensity, 4.0f);
+}
+
+TEST(IO_GLTFDocument, DecodesEscapedStrings) {
+    const auto document = parse(R"({"nodes": [{"name": "Tab\tQuote\"Snowman\u2603Clef\uD834\uDD1E"}]})");
+    ASSERT_FALSE(document.failed()) << document.error().description();
+    EXPECT_EQ(document->nodes()[0].name, "Tab\tQuote\"Snowman\xE2\x98\x83" "Clef\xF0\x9D\x84\x9E");
+}
+
+TEST(IO_GLTFDocument, RejectsIndicesOutOfBounds) {
+    EXPECT_TRUE(parse(R"({"nodes": [{"mesh": 0}]})").failed());
+    EXPECT_TRUE(parse(R"({"nodes": [{"children": [1]}]})").failed());
+    EXPECT_TRUE(parse(R"({"accessors": [{"bufferView": 0, "componentType": 5126, "count": 1, "type": "VEC3"}]})").failed());
+    EXPECT_TRUE(parse(R"({"meshes": [{"primitives": [{"attributes": {}}]}]})").failed());
+}
+
+TEST(IO_GLTFDocument, RejectsInvalidHierarchies) {
+    // A node that is its own child, and a cycle below a root.
+    EXPECT_TRUE(parse(R"({"nodes": [{"children": [0]}]})").failed());
+    EXPECT_TRUE(parse(R"({"nodes": [{"children": [1]}, {"children": [2]}, {"children": [1]}]})").failed());
+
+    // A node with multiple parents, or listed twice by the same parent.
+    EXPECT_TRUE(parse(R"({"nodes": [{"children": [2]}, {"children": [2]}, {}]})").failed());
+    EXPECT_TRUE(parse(R"({"nodes": [{"children": [1, 1]}, {}]})").failed());
+
+    const auto forest = parse(R"({"nodes": [{"children": [2]}, {"children": [3]}, {}, {"children": [4]}, {}]})");
+    EXPECT_FALSE(forest.failed()) << forest.error().description();
+}
+
+TEST(IO_GLTFDocument, RejectsMalformedJSON) {
+    EXPECT_TRUE(parse("").failed());
+    EXPECT_TRUE(parse("[]").failed());
+    EXPECT_TRUE(parse(R"({"nodes": [{"name": "Unterminated}]})").failed());
+    EXPECT_TRUE(parse(R"({"nodes": [{"name": "Root"},]})").failed());
+    EXPECT_TRUE(parse(R"({"nodes": []} trailing)").failed());
+    EXPECT_TRUE(parse(R"({"accessors": [{"componentType": 1234, "count": 1, "type": "VEC3"}]})").failed());
+    EXPECT_TRUE(parse(R"({"accessors": [{"componentType": 5126, "count": -1, "type": "VEC3"}]})").failed());
+}
@@ -0,0 +1,191 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Floats.hpp"
+#include "Testing/Include.hpp"
+
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <cstdint>
+#include <cstring> // for std::memcpy
+
+#include "Source/IO/Format/GLTF/Document.hpp"
+#include "Source/IO/Format/GLTF/MeshDecoder.hpp"
+
+using namespace io::format::gltf;
+
+[[nodiscard]] static Document
+parse(std::string_view text) {
+    auto document = Document::parse(std::vector<char>(std::begin(text), std::end(text)));
+    EXPECT_FALSE(document.failed()) << document.error().description();
+    return std::move(document.get());
+}
+
+template<typename T>
+static void
+append(std::vector<std::byte> &buffer, std::initializer_list<T> values) {
+    for (const auto value : values) {
+        buffer.resize(std::size(buffer) + sizeof(value));
+        std::memcpy(&buffer[std::size(buffer) - sizeof(value)], &value, sizeof(value));
+    }
+}
+
+static void
+expectVector(std::string_view explanation, const math::Vector3f &actual, const math::Vector3f &expected) {
+    Compare::floats(explanation, actual.x(), expected.x());
+    Compare::floats(explanation, actual.y(), expected.y());
+    Compare::floats(explanation, actual.z(), expected.z());
+}
+
+// A textured unit quad in the XY plane, made of two indexed triangles.
+constexpr std::string_view QuadDocument = R"({
+    "meshes": [{"primitives": [
+        {"attributes": {"POSITION": 0, "TEXCOORD_0": 1}, "indices": 2, "material": 0}
+    ]}],
+    "materials": [{"pbrMetallicRoughness": {"baseColorTexture": {"index": 0}}}],
+    "textures": [{"source": 0}],
+    "images": [{"uri": "quad.png"}],
+    "accessors": [
+        {"bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3"},
+        {"bufferView": 0, "byteOffset": 48, "componentType": 5126, "count": 4, "type": "VEC2"},
+        {"bufferView": 1, "componentType": 5123, "count": 6, "type": "SCALAR"}
+    ],
+    "bufferViews": [
+        {"buffer": 0, "byteLength": 80},
+        {"buffer": 0, "byteOffset": 80, "byteLength": 12}
+    ],
+    "buffers": [{"uri": "quad.bin", "byteLength": 92}]
+})";
+
+[[nodiscard]] static std::vector<std::byte>
+createQuadBuffer(std::uint16_t lastIndex = 3) {
+    std::vector<std::byte> buffer{};
+    append<float>(buffer, {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0});
+    append<float>(buffer, {0, 0, 1, 0, 1, 1, 0, 1});
+    append<std::uint16_t>(buffer, {0, 1, 2, 0, 2, lastIndex});
+    return buffer;
+}
+
+TEST(IO_MeshDecoder, DecodesQuadInPlace) {
+    const auto document = parse(QuadDocument);
+    const auto buffer = createQuadBuffer();
+    const std::span<const std::byte> buffers[]{buffer};
+
+    const MeshDecoder decoder{document, buffers};
+    auto mesh = decoder.decode(document.primitives()[0]);
+    ASSERT_FALSE(mesh.failed()) << mesh.error().description();
+
+    // Tightly packed and aligned attributes aren't copied.
+    EXPECT_EQ(reinterpret_cast<const std::byte *>(mesh->positions.data()), buffer.data());
+    EXPECT_EQ(reinterpret_cast<const std::byte *>(mesh->textureCoordinates.data()), buffer.data() + 48);
+    EXPECT_TRUE(std::empty(mesh->storage.positions));
+
+    EXPECT_EQ(mesh->vertexCount(), 4);
+    EXPECT_EQ(mesh->indexType, resources::DecodedMesh::IndexType::UNSIGNED_SHORT);
+    EXPECT_EQ(mesh->indexCount(), 6);
+    EXPECT_EQ(mesh->triangleCount(), 2);
+    EXPECT_EQ(mesh->index(5), 3);
+
+    ASSERT_EQ(std::size(mesh->normals), 4);
+    ASSERT_EQ(std::size(mesh->tangents), 4);
+    ASSERT_EQ(std::size(mesh->bitangents), 4);
+    for (std::size_t i = 0; i < 4; ++i) {
+        expectVector("normal", mesh->normals[i], math::Vector3f{0.0f, 0.0f, 1.0f});
+        expectVector("tangent", mesh->tangents[i], math::Vector3f{1.0f, 0.0f, 0.0f});
+        expectVector("bitangent", mesh->bitangents[i], math::Vector3f{0.0f, 1.0f, 0.0f});
+    }
+}
+
+TEST(IO_MeshDecoder, RejectsIndexOutOfBounds) {
+    const auto document = parse(QuadDocument);
+    const auto buffer = createQuadBuffer(4);
+    const std::span<const std::byte> buffers[]{buffer};
+
+    const MeshDecoder decoder{document, buffers};
+    EXPECT_TRUE(decoder.decode(document.primitives()[0]).failed());
+}
+
+TEST(IO_MeshDecoder, RejectsBufferViewOutOfBounds) {
+    const auto document = parse(QuadDocument);
+    auto buffer = createQuadBuffer();
+    buffer.resize(64);
+    const std::span<const std::byte> buffers[]{buffer};
+
+    const MeshDecoder decoder{document, buffers};
+    EXPECT_TRUE(decoder.decode(document.primitives()[0]).failed());
+}
+
+// A triangle with interleaved positions and texture coordinates, and
+// tangents with a negative handedness.
+constexpr std::string_view InterleavedDocument = R"({
+    "meshes": [{"primitives": [
+        {"attributes": {"POSITION": 0, "TEXCOORD_0": 1, "NORMAL": 2, "TANGENT": 3}, "material": 0}
+    ]}],
+    "materials": [{"pbrMetallicRoughness": {"baseColorTexture": {"index": 0}}}],
+    "textures": [{"source": 0}],
+    "images": [{"uri": "triangle.png"}],
+    "accessors": [
+        {"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"},
+        {"bufferView": 0, "byteOffset": 12, "componentType": 5126, "count": 3, "type": "VEC2"},
+        {"bufferView": 1, "componentType": 5126, "count": 3, "type": "VEC3"},
+        {"bufferView": 2, "componentType": 5126, "count": 3, "type": "VEC4"}
+    ],
+    "bufferViews": [
+        {"buffer": 0, "byteLength": 60, "byteStride": 20},
+        {"buffer": 0, "byteOffset": 60, "byteLength": 36},
+        {"buffer": 0, "byteOffset": 96, "byteLength": 48}
+    ],
+    "buffers": [{"uri": "triangle.bin", "byteLength": 144}]
+})";
+
+TEST(IO_MeshDecoder, GathersInterleavedAttributes) {
+    const auto document = parse(InterleavedDocument);
+
+    std::vector<std::byte> buffer{};
+    append<float>(buffer, {0, 0, 0, 0, 0});
+    append<float>(buffer, {1, 0, 0, 1, 0});
+    append<float>(buffer, {0, 1, 0, 0, 1});
+    append<float>(buffer, {0, 0, 1, 0, 0, 1, 0, 0, 1});
+    append<float>(buffer, {1, 0, 0, -1, 1, 0, 0, -1, 1, 0, 0, -1});
+    const std::span<const std::byte> buffers[]{buffer};
+
+    const MeshDecoder decoder{document, buffers};
+    auto mesh = decoder.decode(document.primitives()[0]);
+    ASSERT_FALSE(mesh.failed()) << mesh.error().description();
+
+    EXPECT_EQ(mesh->positions.data(), mesh->storage.positions.data());
+    EXPECT_EQ(mesh->textureCoordinates.data(), mesh->storage.textureCoordinates.data());
+    EXPECT_EQ(mesh->indexType, resources::DecodedMesh::IndexType::NONE);
+    EXPECT_EQ(mesh->triangleCount(), 1);
+
+    ASSERT_EQ(std::size(mesh->positions), 3);
+    expectVector("position", mesh->positions[1], math::Vector3f{1.0f, 0.0f, 0.0f});
+    Compare::floats("texture coordinate", mesh->textureCoordinates[2].y(), 1);
+
+    ASSERT_EQ(std::size(mesh->bitangents), 3);
+    expectVector("tangent", mesh->tangents[0], math::Vector3f{1.0f, 0.0f, 0.0f});
+    expectVector("bitangent", mesh->bitangents[0], math::Vector3f{0.0f, -1.0f, 0.0f});
+}
+
+TEST(IO_MeshDecoder, RejectsNonTriangles) {
+    const auto document = parse(R"({
+        "meshes": [{"primitives": [{"attributes": {"POSITION": 0}, "mode": 1}]}],
+        "accessors": [{"bufferView": 0, "componentType": 5126, "count": 2, "type": "VEC3"}],
+        "bufferViews": [{"buffer": 0, "byteLength": 24}],
+        "buffers": [{"uri": "lines.bin", "byteLength": 24}]
+    })");
+    const std::vector<std::byte> buffer(24);
+    const std::span<const std::byte> buffers[]{buffer};
+
+    const MeshDecoder decoder{document, buffers};
+    EXPECT_TRUE(decoder.decode(document.primitives()[0]).failed());
+}
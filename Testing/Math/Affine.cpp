@@ -0,0 +1,101 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+#include "Testing/Random.hpp"
+
+#include <vector>
+
+#include "Source/Math/Affine.hpp"
+#include "Source/Math/Batch.hpp"
+
+[[nodiscard]] static math::Vector3f
+randomVector(float min, float max) {
+    return {Random::getFloat(min, max), Random::getFloat(min, max), Random::getFloat(min, max)};
+}
+
+[[nodiscard]] static math::Matrix4x4<float>
+randomAffineMatrix() {
+    math::Matrix4x4<float> matrix{};
+    math::composeTRS(randomVector(-100.0f, 100.0f), math::Quaternion<float>::fromEulerAngles(randomVector(-180.0f, 180.0f)),
+                     randomVector(0.25f, 4.0f), matrix);
+    return matrix;
+}
+
+[[nodiscard]] static math::Vector3f
+transformDirection(const math::Matrix4x4<float> &matrix, const math::Vector3f &direction) {
+    const auto row = [&] (std::size_t i) {
+        return math::Vector3f{matrix[i][0], matrix[i][1], matrix[i][2]}.dot(direction);
+    };
+    return {row(0), row(1), row(2)};
+}
+
+static void
+expectNear(const math::Matrix4x4<float> &a, const math::Matrix4x4<float> &b, float tolerance) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j)
+            EXPECT_NEAR(a[i][j], b[i][j], tolerance) << "i=" << i << " j=" << j;
+    }
+}
+
+TEST(Math_Affine, InverseMatchesGeneralInverse) {
+    RANDOM_FOREACH() {
+        const auto matrix = randomAffineMatrix();
+        const auto inverse = math::affineInverse(matrix);
+
+        expectNear(inverse, matrix.scalarInverse(), 0.001f);
+
+        math::Matrix4x4<float> identity{};
+        identity.identity();
+        expectNear(inverse.scalarMul(matrix), identity, 0.0001f);
+        EXPECT_EQ(inverse[3], (std::array<float, 4>{0, 0, 0, 1}));
+    }
+}
+
+TEST(Math_Affine, NormalMatrixIsInverseTranspose) {
+    RANDOM_FOREACH() {
+        const auto matrix = randomAffineMatrix();
+        auto expected = matrix.scalarInverse().scalarTranspose();
+        for (std::size_t i = 0; i < 3; ++i) {
+            expected[i][3] = 0;
+            expected[3][i] = 0;
+        }
+        expected[3][3] = 1;
+
+        expectNear(math::normalMatrix(matrix), expected, 0.0001f);
+    }
+}
+
+TEST(Math_Affine, NormalMatrixKeepsNormalsPerpendicular) {
+    math::Matrix4x4<float> matrix{};
+    math::composeTRS({1.0f, 2.0f, 3.0f}, math::Quaternion<float>::identity(), {4.0f, 1.0f, 1.0f}, matrix);
+
+    // The normal of the plane x + y = 0, and a direction within it.
+    const math::Vector3f normal{1.0f, 1.0f, 0.0f};
+    const math::Vector3f tangent{1.0f, -1.0f, 0.0f};
+
+    const auto transformedNormal = transformDirection(math::normalMatrix(matrix), normal);
+    const auto transformedTangent = transformDirection(matrix, tangent);
+    EXPECT_FLOAT_EQ(transformedNormal.dot(transformedTangent), 0.0f);
+
+    // The model matrix itself doesn't.
+    EXPECT_NE(transformDirection(matrix, normal).dot(transformedTangent), 0.0f);
+}
+
+TEST(Math_Affine, NormalMatricesMatchesSingle) {
+    std::vector<math::Matrix4x4<float>> matrices{};
+    for (std::size_t i = 0; i < 17; ++i)
+        matrices.push_back(randomAffineMatrix());
+
+    std::vector<math::Matrix4x4<float>> result(std::size(matrices));
+    math::normalMatrices(matrices, result);
+
+    for (std::size_t i = 0; i < std::size(matrices); ++i)
+        EXPECT_EQ(result[i].m_data, math::normalMatrix(matrices[i]).m_data) << "index=" << i;
+}
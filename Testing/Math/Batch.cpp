@@ -0,0 +1,116 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+#include "Testing/Random.hpp"
+
+#include <vector>
+
+#include "Source/Math/Batch.hpp"
+
+// Enough for a few full AVX2 blocks and a tail.
+constexpr std::size_t Count = 37;
+
+[[nodiscard]] static std::vector<const math::simd::MatrixKernels *>
+allKernels() {
+    std::vector<const math::simd::MatrixKernels *> kernels{};
+    for (const auto isa : {math::simd::Isa::SCALAR, math::simd::Isa::SSE2, math::simd::Isa::AVX2, math::simd::Isa::NEON}) {
+        if (const auto *isaKernels = math::simd::matrixKernelsFor(isa))
+            kernels.push_back(isaKernels);
+    }
+    return kernels;
+}
+
+[[nodiscard]] static math::Vector3f
+randomVector(float min, float max) {
+    return {Random::getFloat(min, max), Random::getFloat(min, max), Random::getFloat(min, max)};
+}
+
+static void
+expectNear(const math::Matrix4x4<float> &a, const math::Matrix4x4<float> &b, std::string_view isa, std::size_t index) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j)
+            EXPECT_NEAR(a[i][j], b[i][j], 0.00001f) << isa << " index=" << index << " i=" << i << " j=" << j;
+    }
+}
+
+TEST(Math_Batch, ComposeTRSMatchesSingle) {
+    std::vector<math::Vector3f> translations{};
+    std::vector<math::Quaternion<float>> rotations{};
+    std::vector<math::Vector3f> scalings{};
+    for (std::size_t i = 0; i < Count; ++i) {
+        translations.push_back(randomVector(-100.0f, 100.0f));
+        rotations.push_back(math::Quaternion<float>::fromEulerAngles(randomVector(-180.0f, 180.0f)));
+        scalings.push_back(randomVector(0.1f, 4.0f));
+    }
+
+    for (const auto *kernels : allKernels()) {
+        std::vector<math::Matrix4x4<float>> result(Count);
+        kernels->composeTRS(reinterpret_cast<const float *>(translations.data()), reinterpret_cast<const float *>(rotations.data()),
+                            reinterpret_cast<const float *>(scalings.data()), result.data(), Count);
+
+        for (std::size_t i = 0; i < Count; ++i) {
+            math::Matrix4x4<float> expected{};
+            math::composeTRS(translations[i], rotations[i], scalings[i], expected);
+
+            // Only the AVX2 kernel may fuse multiplications and additions.
+            if (kernels->isa == math::simd::Isa::AVX2)
+                expectNear(result[i], expected, math::simd::toString(kernels->isa), i);
+            else
+                EXPECT_EQ(result[i].m_data, expected.m_data) << math::simd::toString(kernels->isa) << " index=" << i;
+        }
+    }
+}
+
+TEST(Math_Batch, ComposeTRSSpans) {
+    const std::vector<math::Vector3f> translations(Count, math::Vector3f{1.0f, 2.0f, 3.0f});
+    const std::vector<math::Quaternion<float>> rotations(Count, math::Quaternion<float>::identity());
+    const std::vector<math::Vector3f> scalings(Count, math::Vector3f{2.0f, 2.0f, 2.0f});
+    std::vector<math::Matrix4x4<float>> result(Count);
+
+    math::composeTRS(translations, rotations, scalings, result);
+
+    math::Matrix4x4<float> expected{};
+    expected.identity();
+    for (std::size_t i = 0; i < 3; ++i)
+        expected[i][i] = 2.0f;
+    expected[0][3] = 1.0f;
+    expected[1][3] = 2.0f;
+    expected[2][3] = 3.0f;
+
+    for (const auto &matrix : result)
+        EXPECT_EQ(matrix.m_data, expected.m_data);
+}
+
+TEST(Math_Batch, MultiplyManyMatchesMul) {
+    std::vector<math::Matrix4x4<float>> a(Count);
+    std::vector<math::Matrix4x4<float>> b(Count);
+    for (std::size_t i = 0; i < Count; ++i) {
+        math::composeTRS(randomVector(-10.0f, 10.0f), math::Quaternion<float>::fromEulerAngles(randomVector(-180.0f, 180.0f)),
+                         randomVector(0.5f, 2.0f), a[i]);
+        math::composeTRS(randomVector(-10.0f, 10.0f), math::Quaternion<float>::fromEulerAngles(randomVector(-180.0f, 180.0f)),
+                         randomVector(0.5f, 2.0f), b[i]);
+    }
+
+    for (const auto *kernels : allKernels()) {
+        std::vector<math::Matrix4x4<float>> result(Count);
+        kernels->multiplyMany(a.data(), b.data(), result.data(), Count);
+
+        for (std::size_t i = 0; i < Count; ++i) {
+            math::Matrix4x4<float> expected{};
+            kernels->multiply(a[i], b[i], expected);
+            EXPECT_EQ(result[i].m_data, expected.m_data) << math::simd::toString(kernels->isa) << " index=" << i;
+        }
+    }
+
+    std::vector<math::Matrix4x4<float>> result(Count);
+    math::multiplyMany(a, b, result);
+    for (std::size_t i = 0; i < Count; ++i)
+        expectNear(result[i], a[i].scalarMul(b[i]), "selected", i);
+}
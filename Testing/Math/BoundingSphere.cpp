@@ -0,0 +1,49 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+#include "Testing/Random.hpp"
+
+#include <vector>
+
+#include "Source/Math/BoundingSphere.hpp"
+#include "Source/Math/Projection.hpp"
+
+TEST(Math_BoundingSphere, EnclosesAllPoints) {
+    RANDOM_FOREACH() {
+        std::vector<math::Vector3f> points(Random::sizeDistribution(Random::device));
+        for (auto &point : points)
+            point = {Random::getFloat(-50.0f, 50.0f), Random::getFloat(-50.0f, 50.0f), Random::getFloat(-50.0f, 50.0f)};
+
+        const auto sphere = math::BoundingSphere::enclosing(points);
+        for (const auto &point : points)
+            EXPECT_LE(point.subtract(sphere.center).length(), sphere.radius * 1.0001f);
+    }
+
+    const std::vector<math::Vector3f> box{{-1.0f, 2.0f, 0.0f}, {3.0f, 2.0f, 0.0f}};
+    const auto sphere = math::BoundingSphere::enclosing(box);
+    EXPECT_EQ(sphere.center, (math::Vector3f{1.0f, 2.0f, 0.0f}));
+    EXPECT_FLOAT_EQ(sphere.radius, 2.0f);
+}
+
+TEST(Math_BoundingSphere, IntersectsFrustumOfProjection) {
+    // The camera looks down +Z from the origin, with the near plane at 0.1
+    // and the far plane at 1000.
+    const auto projection = math::createPerspectiveProjectionMatrix(70, 1280.0f, 720.0f, 0.1f, 1000.0f);
+    const auto view = math::createCameraViewMatrix({0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f});
+    const auto planes = math::extractFrustumPlanes(math::createViewProjectionMatrix(projection, view));
+
+    EXPECT_TRUE((math::BoundingSphere{{0.0f, 0.0f, 10.0f}, 1.0f}.intersectsFrustum(planes)));
+    EXPECT_FALSE((math::BoundingSphere{{0.0f, 0.0f, -10.0f}, 1.0f}.intersectsFrustum(planes)));
+    EXPECT_FALSE((math::BoundingSphere{{0.0f, 0.0f, 1010.0f}, 1.0f}.intersectsFrustum(planes)));
+    EXPECT_FALSE((math::BoundingSphere{{100.0f, 0.0f, 10.0f}, 1.0f}.intersectsFrustum(planes)));
+
+    // Partly inside.
+    EXPECT_TRUE((math::BoundingSphere{{0.0f, 0.0f, -10.0f}, 11.0f}.intersectsFrustum(planes)));
+}
@@ -8,8 +8,48 @@
 #include "Testing/Include.hpp"
 #include "Testing/Random.hpp"
 
+#include <bit> // for std::bit_cast
+#include <vector>
+
 #include "Source/Math/Matrix4x4.hpp"
 
+[[nodiscard]] static math::Matrix4x4<float>
+randomMatrix(float min, float max) {
+    math::Matrix4x4<float> matrix{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j)
+            matrix[i][j] = Random::getFloat(min, max);
+    }
+    return matrix;
+}
+
+// Diagonally dominant, so it is invertible and well-conditioned.
+[[nodiscard]] static math::Matrix4x4<float>
+randomInvertibleMatrix() {
+    auto matrix = randomMatrix(-1.0f, 1.0f);
+    for (std::size_t i = 0; i < 4; ++i)
+        matrix[i][i] += matrix[i][i] < 0.0f ? -4.0f : 4.0f;
+    return matrix;
+}
+
+// The distance in units in the last place, for floats of the same sign.
+[[nodiscard]] static std::uint32_t
+ulpDistance(float a, float b) {
+    const auto bitsA = std::bit_cast<std::int32_t>(a);
+    const auto bitsB = std::bit_cast<std::int32_t>(b);
+    return static_cast<std::uint32_t>(bitsA > bitsB ? bitsA - bitsB : bitsB - bitsA);
+}
+
+[[nodiscard]] static std::vector<const math::simd::MatrixKernels *>
+supportedKernels() {
+    std::vector<const math::simd::MatrixKernels *> kernels{};
+    for (const auto isa : {math::simd::Isa::SSE2, math::simd::Isa::AVX2, math::simd::Isa::NEON}) {
+        if (const auto *isaKernels = math::simd::matrixKernelsFor(isa))
+            kernels.push_back(isaKernels);
+    }
+    return kernels;
+}
+
 TEST(Math_Matrix4x4, Identity) {
     math::Matrix4x4<float> matrix{};
     matrix.identity();
@@ -78,3 +118,98 @@ TEST(Math_Matrix4x4, CameraViewMatrixPredetermined) {
     Compare::floats("forward-y", matrix[2][1], forward.y());
     Compare::floats("forward-z", matrix[2][2], forward.z());
 }
+
+TEST(Math_Matrix4x4, KernelsAreSelected) {
+    const auto *detected = math::simd::matrixKernelsFor(math::simd::detectIsa());
+    ASSERT_NE(detected, nullptr);
+    EXPECT_EQ(&math::simd::matrixKernels(), detected);
+    EXPECT_NE(math::simd::matrixKernelsFor(math::simd::Isa::SCALAR), nullptr);
+}
+
+TEST(Math_Matrix4x4, MultiplyMatchesScalar) {
+    for (const auto *kernels : supportedKernels()) {
+        RANDOM_FOREACH() {
+            // Positive, so no cancellation can blow up the ULP distance of
+            // the fused kernels.
+            const auto a = randomMatrix(0.1f, 10.0f);
+            const auto b = randomMatrix(0.1f, 10.0f);
+            const auto expected = a.scalarMul(b);
+
+            math::Matrix4x4<float> result{};
+            kernels->multiply(a, b, result);
+
+            for (std::size_t i = 0; i < 4; ++i) {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    if (kernels->isa == math::simd::Isa::AVX2) {
+                        EXPECT_LE(ulpDistance(result[i][j], expected[i][j]), 4u)
+                            << math::simd::toString(kernels->isa) << " i=" << i << " j=" << j;
+                    } else {
+                        EXPECT_EQ(result[i][j], expected[i][j])
+                            << math::simd::toString(kernels->isa) << " i=" << i << " j=" << j;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(Math_Matrix4x4, TransposeMatchesScalar) {
+    for (const auto *kernels : supportedKernels()) {
+        const auto matrix = randomMatrix(-10.0f, 10.0f);
+        const auto expected = matrix.scalarTranspose();
+
+        math::Matrix4x4<float> result{};
+        kernels->transpose(matrix, result);
+        EXPECT_EQ(result.m_data, expected.m_data) << math::simd::toString(kernels->isa);
+    }
+}
+
+TEST(Math_Matrix4x4, InverseMatchesScalar) {
+    for (const auto *kernels : supportedKernels()) {
+        RANDOM_FOREACH() {
+            const auto matrix = randomInvertibleMatrix();
+            const auto expected = matrix.scalarInverse();
+
+            math::Matrix4x4<float> result{};
+            kernels->inverse(matrix, result);
+
+            for (std::size_t i = 0; i < 4; ++i) {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    EXPECT_NEAR(result[i][j], expected[i][j], 0.00001f)
+                        << math::simd::toString(kernels->isa) << " i=" << i << " j=" << j;
+                }
+            }
+        }
+    }
+}
+
+TEST(Math_Matrix4x4, InverseTimesMatrixIsIdentity) {
+    RANDOM_FOREACH() {
+        const auto matrix = randomInvertibleMatrix();
+        const auto product = matrix.mul(matrix.inverse());
+
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = 0; j < 4; ++j)
+                EXPECT_NEAR(product[i][j], i == j ? 1.0f : 0.0f, 0.0001f) << "i=" << i << " j=" << j;
+        }
+    }
+}
+
+TEST(Math_Vector4f, MatchesScalar) {
+    RANDOM_FOREACH() {
+        math::Vector4f vector{Random::getFloat(-10.0f, 10.0f), Random::getFloat(-10.0f, 10.0f),
+                              Random::getFloat(-10.0f, 10.0f), Random::getFloat(-10.0f, 10.0f)};
+        const math::Vector4f other{Random::getFloat(-10.0f, 10.0f), Random::getFloat(-10.0f, 10.0f),
+                                   Random::getFloat(-10.0f, 10.0f), Random::getFloat(-10.0f, 10.0f)};
+
+        const auto dot = vector.x() * other.x() + vector.y() * other.y() + vector.z() * other.z() + vector.w() * other.w();
+        EXPECT_EQ(vector.dot(other), dot);
+
+        const auto length = std::sqrt(vector.x() * vector.x() + vector.y() * vector.y()
+                                    + vector.z() * vector.z() + vector.w() * vector.w());
+        EXPECT_EQ(vector.length(), length);
+
+        const math::Vector4f normalized{vector.x() / length, vector.y() / length, vector.z() / length, vector.w() / length};
+        EXPECT_EQ(vector.normalize(), normalized);
+    }
+}
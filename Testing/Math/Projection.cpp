@@ -0,0 +1,100 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+#include "Testing/Random.hpp"
+
+#include <algorithm> // for std::min
+
+#include "Source/Math/Projection.hpp"
+
+[[nodiscard]] static math::Vector3f
+randomVector(float min, float max) {
+    return {Random::getFloat(min, max), Random::getFloat(min, max), Random::getFloat(min, max)};
+}
+
+[[nodiscard]] static math::Matrix4x4<float>
+randomViewMatrix() {
+    auto forward = randomVector(-1.0f, 1.0f);
+    if (forward.length() < 0.1f)
+        forward = {0.0f, 0.0f, 1.0f};
+    return math::createCameraViewMatrix(forward, {0.0f, 1.0f, 0.0f}, randomVector(-100.0f, 100.0f));
+}
+
+[[nodiscard]] static float
+distance(const math::Vector4f &plane, const math::Vector3f &point) {
+    return plane.xyz().dot(point) + plane.w();
+}
+
+TEST(Math_Projection, ViewMatrixWithPositionMatchesTranslation) {
+    RANDOM_FOREACH() {
+        const auto forward = randomVector(0.1f, 1.0f);
+        const math::Vector3f up{0.0f, 1.0f, 0.0f};
+        const auto position = randomVector(-100.0f, 100.0f);
+
+        const auto expected = math::createCameraViewMatrix(forward, up)
+                .scalarMul(math::Matrix4x4<float>{}.translate({-position.x(), -position.y(), -position.z()}));
+        const auto view = math::createCameraViewMatrix(forward, up, position);
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = 0; j < 4; ++j)
+                EXPECT_NEAR(view[i][j], expected[i][j], 0.0001f) << "i=" << i << " j=" << j;
+        }
+    }
+}
+
+TEST(Math_Projection, ViewProjectionMatchesMul) {
+    const auto projection = math::createPerspectiveProjectionMatrix(70, 1280, 720, 0.1f, 1000);
+
+    RANDOM_FOREACH() {
+        const auto view = randomViewMatrix();
+        const auto expected = projection.scalarMul(view);
+        const auto viewProjection = math::createViewProjectionMatrix(projection, view);
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = 0; j < 4; ++j)
+                EXPECT_NEAR(viewProjection[i][j], expected[i][j], 0.0001f) << "i=" << i << " j=" << j;
+        }
+    }
+}
+
+TEST(Math_Projection, FrustumPlanesAreNormalized) {
+    const auto projection = math::createPerspectiveProjectionMatrix(70, 1280, 720, 0.1f, 1000);
+
+    RANDOM_FOREACH() {
+        for (const auto &plane : math::extractFrustumPlanes(math::createViewProjectionMatrix(projection, randomViewMatrix())))
+            EXPECT_NEAR(plane.xyz().length(), 1.0f, 0.0001f);
+    }
+}
+
+TEST(Math_Projection, FrustumPlanesClassifyPoints) {
+    const auto projection = math::createPerspectiveProjectionMatrix(90, 100, 100, 1, 100);
+    const math::Vector3f position{10.0f, 0.0f, 0.0f};
+    const auto view = math::createCameraViewMatrix({0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, position);
+    const auto planes = math::extractFrustumPlanes(math::createViewProjectionMatrix(projection, view));
+
+    const auto plane = [&] (math::FrustumPlane index) {
+        return planes[static_cast<std::size_t>(index)];
+    };
+
+    // Straight ahead, within the near and far plane.
+    for (const auto &p : planes)
+        EXPECT_GT(distance(p, position.add({0.0f, 0.0f, 50.0f})), 0.0f);
+
+    EXPECT_LT(distance(plane(math::FrustumPlane::NEAR), position.add({0.0f, 0.0f, 0.5f})), 0.0f);
+    EXPECT_LT(distance(plane(math::FrustumPlane::FAR), position.add({0.0f, 0.0f, 150.0f})), 0.0f);
+
+    // A field of view of 90 degrees spans 45 degrees to either side.
+    EXPECT_NEAR(distance(plane(math::FrustumPlane::TOP), position.add({0.0f, 10.0f, 10.0f})), 0.0f, 0.0001f);
+    EXPECT_LT(distance(plane(math::FrustumPlane::TOP), position.add({0.0f, 20.0f, 10.0f})), 0.0f);
+    EXPECT_LT(distance(plane(math::FrustumPlane::BOTTOM), position.add({0.0f, -20.0f, 10.0f})), 0.0f);
+
+    EXPECT_LT(std::min(distance(plane(math::FrustumPlane::LEFT), position.add({20.0f, 0.0f, 10.0f})),
+                       distance(plane(math::FrustumPlane::RIGHT), position.add({20.0f, 0.0f, 10.0f}))), 0.0f);
+    EXPECT_LT(std::min(distance(plane(math::FrustumPlane::LEFT), position.add({-20.0f, 0.0f, 10.0f})),
+                       distance(plane(math::FrustumPlane::RIGHT), position.add({-20.0f, 0.0f, 10.0f}))), 0.0f);
+}
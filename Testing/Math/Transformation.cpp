@@ -0,0 +1,68 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+#include "Testing/Random.hpp"
+
+#include "Source/Math/Transformation.hpp"
+
+// The composition that Transformation used before it stored quaternions.
+[[nodiscard]] static math::Matrix4x4<float>
+eulerMatrix(const math::Vector3f &translation, const math::Vector3f &degrees, const math::Vector3f &scaling) noexcept {
+    const auto translationMatrix = math::Matrix4x4<float>().translate(translation);
+    const auto rotationMatrix = math::Matrix4x4<float>().rotate(degrees);
+    const auto scalingMatrix = math::Matrix4x4<float>().scale(scaling);
+    return translationMatrix.mul(rotationMatrix.mul(scalingMatrix));
+}
+
+static void
+expectNear(const math::Matrix4x4<float> &a, const math::Matrix4x4<float> &b) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j)
+            EXPECT_NEAR(a[i][j], b[i][j], 0.0001f) << "i=" << i << " j=" << j;
+    }
+}
+
+TEST(Math_Transformation, DefaultIsIdentity) {
+    expectNear(math::Transformation{}.toMatrix(), math::Matrix4x4<float>().identity());
+}
+
+TEST(Math_Transformation, MatchesEulerComposition) {
+    RANDOM_FOREACH() {
+        const math::Vector3f translation{Random::getFloat(-10.0f, 10.0f), Random::getFloat(-10.0f, 10.0f), Random::getFloat(-10.0f, 10.0f)};
+        const math::Vector3f degrees{Random::getFloat(-180.0f, 180.0f), Random::getFloat(-180.0f, 180.0f), Random::getFloat(-180.0f, 180.0f)};
+        const math::Vector3f scaling{Random::getFloat(0.1f, 2.0f), Random::getFloat(0.1f, 2.0f), Random::getFloat(0.1f, 2.0f)};
+
+        const auto transformation = math::Transformation::fromEulerAngles(translation, degrees, scaling);
+        expectNear(transformation.toMatrix(), eulerMatrix(translation, degrees, scaling));
+    }
+}
+
+TEST(Math_Transformation, MutationInvalidatesMatrix) {
+    auto transformation = math::Transformation{{1.0f, 2.0f, 3.0f}};
+    EXPECT_EQ(transformation.toMatrix()[0][3], 1.0f);
+
+    transformation.setTranslation({4.0f, 5.0f, 6.0f});
+    EXPECT_EQ(transformation.toMatrix()[0][3], 4.0f);
+
+    transformation.setScaling({2.0f, 2.0f, 2.0f});
+    EXPECT_EQ(transformation.toMatrix()[1][1], 2.0f);
+
+    transformation.setEulerRotation({0.0f, 0.0f, 90.0f});
+    expectNear(transformation.toMatrix(), eulerMatrix({4.0f, 5.0f, 6.0f}, {0.0f, 0.0f, 90.0f}, {2.0f, 2.0f, 2.0f}));
+}
+
+TEST(Math_Transformation, EqualityIgnoresCache) {
+    const math::Transformation a{{1.0f, 0.0f, 0.0f}};
+    const math::Transformation b{{1.0f, 0.0f, 0.0f}};
+    static_cast<void>(a.toMatrix());
+
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a == math::Transformation{});
+}
@@ -0,0 +1,114 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <algorithm> // for std::sort
+#include <array>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <cmath>
+
+#include "Source/ECS/EntityList.hpp"
+#include "Source/ECS/PointLight.hpp"
+#include "Source/Resources/DrawList.hpp"
+
+using resources::DrawList;
+
+[[nodiscard]] static std::unique_ptr<ecs::PointLight>
+createLight(math::Vector3f position) {
+    return std::make_unique<ecs::PointLight>(position, math::Vector3f{1.0f, 1.0f, 1.0f}, 10.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+}
+
+TEST(Resources_DrawList, PlacesLightsInTheWorld) {
+    ecs::EntityList list{};
+    auto *parent = list.create("parent", nullptr, math::Transformation{math::Vector3f{10.0f, 0.0f, 0.0f}});
+    auto *child = list.add(createLight(math::Vector3f{0.0f, 1.0f, 0.0f}));
+    child->setParent(parent);
+    const auto *root = list.add(createLight(math::Vector3f{4.0f, 0.0f, 0.0f}));
+
+    DrawList drawList{};
+    drawList.build(list, math::Vector3f{0.0f, 0.0f, 0.0f});
+
+    // The parented light is at (10, 1, 0), so further away than the other
+    // one, although its own translation is closer to the viewer.
+    const auto &lights = drawList.pointLights();
+    ASSERT_EQ(std::size(lights), 2);
+    EXPECT_EQ(lights[0].light, root);
+    EXPECT_EQ(lights[0].position, (math::Vector3f{4.0f, 0.0f, 0.0f}));
+    EXPECT_EQ(lights[1].light, child);
+    EXPECT_EQ(lights[1].position, (math::Vector3f{10.0f, 1.0f, 0.0f}));
+
+    // Moving the parent moves the light.
+    parent->transformation().setTranslation(math::Vector3f{-2.0f, 0.0f, 0.0f});
+    drawList.build(list, math::Vector3f{0.0f, 0.0f, 0.0f});
+    ASSERT_EQ(std::size(lights), 2);
+    EXPECT_EQ(lights[0].light, child);
+    EXPECT_EQ(lights[0].position, (math::Vector3f{-2.0f, 1.0f, 0.0f}));
+}
+
+TEST(Resources_DrawList, CullsEntitiesOutsideOfFrustum) {
+    resources::ModelGeometryDescriptor geometry{};
+    geometry.setBounds(math::BoundingSphere{math::Vector3f{0.0f, 0.0f, 0.0f}, 1.0f});
+    const resources::ModelDescriptor model{&geometry};
+
+    resources::ModelGeometryDescriptor unboundedGeometry{};
+    const resources::ModelDescriptor unboundedModel{&unboundedGeometry};
+
+    // Looking down +Z from the origin, with a near plane at 1 and a far
+    // plane at 10.
+    const std::array<math::Vector4f, 6> frustum{
+        math::Vector4f{1.0f, 0.0f, 1.0f, 0.0f}.div(std::sqrt(2.0f)),
+        math::Vector4f{-1.0f, 0.0f, 1.0f, 0.0f}.div(std::sqrt(2.0f)),
+        math::Vector4f{0.0f, 1.0f, 1.0f, 0.0f}.div(std::sqrt(2.0f)),
+        math::Vector4f{0.0f, -1.0f, 1.0f, 0.0f}.div(std::sqrt(2.0f)),
+        math::Vector4f{0.0f, 0.0f, 1.0f, -1.0f},
+        math::Vector4f{0.0f, 0.0f, -1.0f, 10.0f},
+    };
+
+    ecs::EntityList list{};
+    list.create("in front", &model, math::Transformation{math::Vector3f{0.0f, 0.0f, 5.0f}});
+    list.create("behind", &model, math::Transformation{math::Vector3f{0.0f, 0.0f, -5.0f}});
+    list.create("touching the side", &model, math::Transformation{math::Vector3f{5.5f, 0.0f, 5.0f}});
+    list.create("unbounded", &unboundedModel, math::Transformation{math::Vector3f{0.0f, 0.0f, -5.0f}});
+
+    // The child is behind the viewer in its own space, but in front of it
+    // in the world.
+    auto *parent = list.create("parent", nullptr, math::Transformation{math::Vector3f{0.0f, 0.0f, 20.0f}});
+    list.create("child", &model, math::Transformation{math::Vector3f{0.0f, 0.0f, -14.0f}})->setParent(parent);
+
+    DrawList drawList{};
+    drawList.setFrustum(frustum);
+    drawList.build(list, math::Vector3f{0.0f, 0.0f, 0.0f});
+
+    // The commands are told apart by the positions of the entities.
+    std::vector<math::Vector3f> drawn{};
+    for (const auto &command : drawList.commands()) {
+        const auto &world = *command.transformation;
+        drawn.push_back(math::Vector3f{world[0][3], world[1][3], world[2][3]});
+    }
+    std::sort(std::begin(drawn), std::end(drawn), [](math::Vector3f a, math::Vector3f b) {
+        return std::tuple{a.x(), a.y(), a.z()} < std::tuple{b.x(), b.y(), b.z()};
+    });
+
+    EXPECT_EQ(drawn, (std::vector<math::Vector3f>{
+        math::Vector3f{0.0f, 0.0f, -5.0f},
+        math::Vector3f{0.0f, 0.0f, 5.0f},
+        math::Vector3f{0.0f, 0.0f, 6.0f},
+        math::Vector3f{5.5f, 0.0f, 5.0f},
+    }));
+
+    // Without a frustum, nothing is culled.
+    drawList.setFrustum(std::nullopt);
+    drawList.build(list, math::Vector3f{0.0f, 0.0f, 0.0f});
+    EXPECT_EQ(std::size(drawList.commands()), 5);
+}
@@ -0,0 +1,81 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <array>
+#include <vector>
+
+#include <cstring> // for std::memcpy
+
+#include "Source/Resources/InterleavedMesh.hpp"
+#include "Source/Resources/VertexLayout.hpp"
+
+using namespace resources;
+
+[[nodiscard]] static float
+readFloat(const InterleavedMesh &mesh, std::size_t vertex, std::size_t offset) {
+    float value;
+    std::memcpy(&value, &mesh.vertices[vertex * mesh.layout.stride() + offset], sizeof(value));
+    return value;
+}
+
+TEST(Resources_VertexLayout, ComputesOffsetsAndStride) {
+    VertexLayout layout{};
+    layout.add(VertexAttribute::POSITION)
+          .add(VertexAttribute::TEXTURE_COORDINATES)
+          .add(VertexAttribute::TANGENT);
+
+    ASSERT_EQ(std::size(layout.elements()), 3);
+    EXPECT_EQ(layout.elements()[0].offset, 0);
+    EXPECT_EQ(layout.elements()[1].offset, 12);
+    EXPECT_EQ(layout.elements()[1].componentCount, 2);
+    EXPECT_EQ(layout.elements()[2].offset, 20);
+    EXPECT_EQ(layout.stride(), 32);
+
+    EXPECT_TRUE(layout.contains(VertexAttribute::TANGENT));
+    EXPECT_FALSE(layout.contains(VertexAttribute::NORMAL));
+}
+
+TEST(Resources_InterleavedMesh, InterleavesInLayoutOrder) {
+    const std::array positions{math::Vector3f{1.0f, 2.0f, 3.0f}, math::Vector3f{4.0f, 5.0f, 6.0f}};
+    const std::array normals{math::Vector3f{0.0f, 0.0f, 1.0f}, math::Vector3f{0.0f, 1.0f, 0.0f}};
+    const std::array textureCoordinates{math::Vector2f{0.25f, 0.5f}, math::Vector2f{0.75f, 1.0f}};
+    const std::array<std::uint16_t, 3> indices{0, 1, 1};
+
+    DecodedMesh decoded{};
+    decoded.positions = positions;
+    decoded.normals = normals;
+    decoded.textureCoordinates = textureCoordinates;
+    decoded.indexType = DecodedMesh::IndexType::UNSIGNED_SHORT;
+    decoded.indices = std::as_bytes(std::span{indices});
+
+    VertexLayout layout{};
+    layout.add(VertexAttribute::NORMAL)
+          .add(VertexAttribute::TEXTURE_COORDINATES)
+          .add(VertexAttribute::POSITION)
+          .add(VertexAttribute::TANGENT);
+
+    const auto mesh = InterleavedMesh::interleave(decoded, layout);
+    ASSERT_EQ(mesh.vertexCount, 2);
+    ASSERT_EQ(std::size(mesh.vertices), 2 * 44);
+    EXPECT_EQ(mesh.indexCount(), 3);
+    EXPECT_EQ(mesh.indices.data(), decoded.indices.data());
+
+    EXPECT_EQ(readFloat(mesh, 0, 8), 1.0f);
+    EXPECT_EQ(readFloat(mesh, 0, 12), 0.25f);
+    EXPECT_EQ(readFloat(mesh, 0, 20), 1.0f);
+    EXPECT_EQ(readFloat(mesh, 1, 4), 1.0f);
+    EXPECT_EQ(readFloat(mesh, 1, 16), 1.0f);
+    EXPECT_EQ(readFloat(mesh, 1, 28), 6.0f);
+
+    // The mesh has no tangents, so they're zero.
+    EXPECT_EQ(readFloat(mesh, 1, 32), 0.0f);
+    EXPECT_EQ(readFloat(mesh, 1, 40), 0.0f);
+}
@@ -0,0 +1,215 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <cstring> // for std::memcpy
+
+#include "Source/Resources/InterleavedMesh.hpp"
+#include "Source/Resources/MeshOptimizer.hpp"
+
+using namespace resources;
+
+using Triangle = std::array<std::array<float, 3>, 3>;
+
+/**
+ * A grid of quads in the XY plane, of which the triangles are shuffled like
+ * an exporter that doesn't care might do.
+ */
+struct Grid {
+    std::vector<math::Vector3f> positions{};
+    std::vector<std::uint32_t> indices{};
+};
+
+[[nodiscard]] static Grid
+createScrambledGrid(std::uint32_t size) {
+    Grid grid{};
+    for (std::uint32_t y = 0; y <= size; ++y) {
+        for (std::uint32_t x = 0; x <= size; ++x)
+            grid.positions.push_back(math::Vector3f{static_cast<float>(x), static_cast<float>(y), 0.0f});
+    }
+
+    std::vector<std::array<std::uint32_t, 3>> triangles{};
+    for (std::uint32_t y = 0; y < size; ++y) {
+        for (std::uint32_t x = 0; x < size; ++x) {
+            const auto corner = y * (size + 1) + x;
+            triangles.push_back({corner, corner + 1, corner + size + 1});
+            triangles.push_back({corner + 1, corner + size + 2, corner + size + 1});
+        }
+    }
+
+    std::shuffle(std::begin(triangles), std::end(triangles), std::mt19937{42});
+    for (const auto &triangle : triangles)
+        grid.indices.insert(std::end(grid.indices), std::begin(triangle), std::end(triangle));
+    return grid;
+}
+
+/**
+ * Returns the triangles by their positions, each starting at its smallest
+ * position without changing the winding, so that they can be compared
+ * regardless of the order of the triangles and vertices.
+ */
+[[nodiscard]] static std::vector<Triangle>
+canonicalTriangles(std::span<const std::uint32_t> indices, std::span<const math::Vector3f> positions) {
+    std::vector<Triangle> triangles{};
+    for (std::size_t i = 0; i < std::size(indices); i += 3) {
+        Triangle triangle{};
+        for (std::size_t corner = 0; corner < 3; ++corner) {
+            const auto &position = positions[indices[i + corner]];
+            triangle[corner] = {position.x(), position.y(), position.z()};
+        }
+        std::rotate(std::begin(triangle), std::min_element(std::begin(triangle), std::end(triangle)), std::end(triangle));
+        triangles.push_back(triangle);
+    }
+    std::sort(std::begin(triangles), std::end(triangles));
+    return triangles;
+}
+
+TEST(Resources_MeshOptimizer, AnalyzesFIFOCache) {
+    const std::array<std::uint32_t, 6> quad{0, 1, 2, 0, 2, 3};
+    const auto quadStatistics = analyzeVertexCache(quad, 4);
+    EXPECT_EQ(quadStatistics.transformedVertexCount, 4);
+    EXPECT_FLOAT_EQ(quadStatistics.averageCacheMissRatio(), 2.0f);
+    EXPECT_FLOAT_EQ(quadStatistics.averageTransformToVertexRatio(), 1.0f);
+
+    // The second triangle pushes the first out of a cache of 3 vertices.
+    const std::array<std::uint32_t, 9> evicting{0, 1, 2, 3, 4, 5, 0, 1, 2};
+    const auto evictingStatistics = analyzeVertexCache(evicting, 6, 3);
+    EXPECT_EQ(evictingStatistics.transformedVertexCount, 9);
+    EXPECT_EQ(evictingStatistics.vertexCount, 6);
+    EXPECT_FLOAT_EQ(evictingStatistics.averageTransformToVertexRatio(), 1.5f);
+}
+
+TEST(Resources_MeshOptimizer, ImprovesVertexCacheOfScrambledGrid) {
+    auto grid = createScrambledGrid(64);
+    const auto expectedTriangles = canonicalTriangles(grid.indices, grid.positions);
+    const auto before = analyzeVertexCache(grid.indices, std::size(grid.positions));
+
+    optimizeVertexCache(grid.indices, std::size(grid.positions));
+    const auto after = analyzeVertexCache(grid.indices, std::size(grid.positions));
+
+    EXPECT_GT(before.averageCacheMissRatio(), 2.0f);
+    EXPECT_LT(after.averageCacheMissRatio(), 0.8f);
+    EXPECT_LT(after.averageTransformToVertexRatio(), 1.6f);
+    EXPECT_EQ(canonicalTriangles(grid.indices, grid.positions), expectedTriangles);
+}
+
+TEST(Resources_MeshOptimizer, DrawsOutwardFacingClustersFirst) {
+    // Two quads that face +Z, of which the one in front is given last.
+    const std::vector<math::Vector3f> positions{
+        math::Vector3f{0.0f, 0.0f, -1.0f}, math::Vector3f{1.0f, 0.0f, -1.0f},
+        math::Vector3f{1.0f, 1.0f, -1.0f}, math::Vector3f{0.0f, 1.0f, -1.0f},
+        math::Vector3f{0.0f, 0.0f, 1.0f}, math::Vector3f{1.0f, 0.0f, 1.0f},
+        math::Vector3f{1.0f, 1.0f, 1.0f}, math::Vector3f{0.0f, 1.0f, 1.0f},
+    };
+    std::vector<std::uint32_t> indices{0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7};
+
+    optimizeOverdraw(indices, positions);
+    EXPECT_EQ(indices, (std::vector<std::uint32_t>{4, 5, 6, 4, 6, 7, 0, 1, 2, 0, 2, 3}));
+}
+
+TEST(Resources_MeshOptimizer, OptimizesAndRemapsInterleavedMesh) {
+    auto grid = createScrambledGrid(16);
+
+    // A vertex that no triangle uses, which is dropped.
+    grid.positions.push_back(math::Vector3f{-1.0f, -1.0f, -1.0f});
+
+    std::vector<std::uint16_t> indices(std::begin(grid.indices), std::end(grid.indices));
+    DecodedMesh decoded{};
+    decoded.positions = grid.positions;
+    decoded.indexType = DecodedMesh::IndexType::UNSIGNED_SHORT;
+    decoded.indices = std::as_bytes(std::span{indices});
+
+    VertexLayout layout{};
+    layout.add(VertexAttribute::NORMAL)
+          .add(VertexAttribute::POSITION);
+    auto mesh = InterleavedMesh::interleave(decoded, layout);
+
+    const auto optimization = MeshOptimization::optimize(mesh, {});
+    EXPECT_LT(optimization.after.averageCacheMissRatio(), optimization.before.averageCacheMissRatio());
+    EXPECT_EQ(optimization.after.vertexCount, std::size(grid.positions) - 1);
+
+    optimization.apply(mesh);
+    ASSERT_EQ(mesh.vertexCount, std::size(grid.positions) - 1);
+    ASSERT_EQ(mesh.indexCount(), std::size(indices));
+    EXPECT_EQ(mesh.indices.data(), mesh.indexStorage.data());
+
+    std::vector<std::uint32_t> newIndices(mesh.indexCount());
+    std::vector<math::Vector3f> newPositions(mesh.vertexCount);
+    std::uint32_t nextVertex = 0;
+    for (std::size_t i = 0; i < std::size(newIndices); ++i) {
+        std::uint16_t index;
+        std::memcpy(&index, &mesh.indices[i * sizeof(index)], sizeof(index));
+        newIndices[i] = index;
+
+        // The vertices are in the order in which they're first used.
+        EXPECT_LE(index, nextVertex);
+        if (index == nextVertex)
+            ++nextVertex;
+    }
+    for (std::size_t i = 0; i < mesh.vertexCount; ++i) {
+        std::array<float, 3> position;
+        std::memcpy(position.data(), &mesh.vertices[i * layout.stride() + 12], sizeof(position));
+        newPositions[i] = math::Vector3f{position[0], position[1], position[2]};
+    }
+
+    EXPECT_EQ(canonicalTriangles(newIndices, newPositions), canonicalTriangles(grid.indices, grid.positions));
+}
+
+TEST(Resources_MeshOptimizer, CachesOptimizationsByContents) {
+    const auto grid = createScrambledGrid(4);
+    std::vector<std::uint32_t> indices = grid.indices;
+
+    DecodedMesh decoded{};
+    decoded.positions = grid.positions;
+    decoded.indexType = DecodedMesh::IndexType::UNSIGNED_INT;
+    decoded.indices = std::as_bytes(std::span{indices});
+
+    VertexLayout layout{};
+    layout.add(VertexAttribute::POSITION);
+    const auto mesh = InterleavedMesh::interleave(decoded, layout);
+    const auto copy = InterleavedMesh::interleave(decoded, layout);
+
+    MeshOptimizationCache cache{};
+    const auto optimization = cache.optimize(mesh, {});
+    EXPECT_EQ(cache.optimize(copy, {}), optimization);
+    EXPECT_NE(cache.optimize(mesh, {.overdraw = false}), optimization);
+}
+
+TEST(Resources_MeshOptimizer, CacheComparesContentsOnHit) {
+    const auto grid = createScrambledGrid(4);
+    std::vector<std::uint32_t> indices = grid.indices;
+
+    DecodedMesh decoded{};
+    decoded.positions = grid.positions;
+    decoded.indexType = DecodedMesh::IndexType::UNSIGNED_INT;
+    decoded.indices = std::as_bytes(std::span{indices});
+
+    VertexLayout layout{};
+    layout.add(VertexAttribute::POSITION);
+    const auto mesh = InterleavedMesh::interleave(decoded, layout);
+
+    // Flipping the top bit of two 8-byte words, i.e. the signs of the Y of
+    // the first vertex and the X of the second, cancels out in the key.
+    auto flipped = mesh;
+    flipped.vertices[7] ^= std::byte{0x80};
+    flipped.vertices[15] ^= std::byte{0x80};
+
+    MeshOptimizationCache cache{};
+    const auto optimization = cache.optimize(mesh, {});
+    const auto flippedOptimization = cache.optimize(flipped, {});
+    EXPECT_NE(flippedOptimization, optimization);
+    EXPECT_EQ(cache.optimize(mesh, {}), optimization);
+    EXPECT_EQ(cache.optimize(flipped, {}), flippedOptimization);
+}
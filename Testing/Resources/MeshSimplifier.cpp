@@ -0,0 +1,201 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <array>
+#include <numbers>
+#include <utility> // for std::pair
+#include <vector>
+
+#include <cmath>
+#include <cstring> // for std::memcpy
+
+#include "Source/Resources/InterleavedMesh.hpp"
+#include "Source/Resources/MeshSimplifier.hpp"
+
+using namespace resources;
+
+struct Mesh {
+    std::vector<math::Vector3f> positions{};
+    std::vector<std::uint32_t> indices{};
+};
+
+/**
+ * A flat grid of quads in the XY plane. When seamColumn is given, the
+ * vertices of that column are duplicated, like a texture seam would.
+ */
+[[nodiscard]] static Mesh
+createGrid(std::uint32_t size, std::uint32_t seamColumn = 0) {
+    Mesh grid{};
+    const auto rowLength = size + 1 + (seamColumn != 0 ? 1 : 0);
+    const auto vertexAt = [&] (std::uint32_t x, std::uint32_t y, bool rightOfSeam) {
+        const auto column = x + (seamColumn != 0 && (x > seamColumn || (x == seamColumn && rightOfSeam)) ? 1 : 0);
+        return y * rowLength + column;
+    };
+
+    for (std::uint32_t y = 0; y <= size; ++y) {
+        for (std::uint32_t x = 0; x <= size; ++x) {
+            grid.positions.push_back(math::Vector3f{static_cast<float>(x), static_cast<float>(y), 0.0f});
+            if (seamColumn != 0 && x == seamColumn)
+                grid.positions.push_back(math::Vector3f{static_cast<float>(x), static_cast<float>(y), 0.0f});
+        }
+    }
+
+    for (std::uint32_t y = 0; y < size; ++y) {
+        for (std::uint32_t x = 0; x < size; ++x) {
+            const bool isRight = seamColumn != 0 && x >= seamColumn;
+            const std::array quad{vertexAt(x, y, isRight), vertexAt(x + 1, y, isRight),
+                                  vertexAt(x + 1, y + 1, isRight), vertexAt(x, y + 1, isRight)};
+            grid.indices.insert(std::end(grid.indices), {quad[0], quad[1], quad[2], quad[0], quad[2], quad[3]});
+        }
+    }
+    return grid;
+}
+
+/**
+ * A sphere of stacks and sectors, of which the first and last sector meet
+ * at a seam, like the spheres that are created for point lights.
+ */
+[[nodiscard]] static Mesh
+createSphere(std::uint32_t stackCount, std::uint32_t sectorCount, float radius) {
+    Mesh sphere{};
+    for (std::uint32_t stack = 0; stack <= stackCount; ++stack) {
+        const auto stackAngle = std::numbers::pi_v<float> * (0.5f - static_cast<float>(stack) / static_cast<float>(stackCount));
+        for (std::uint32_t sector = 0; sector <= sectorCount; ++sector) {
+            const auto sectorAngle = 2 * std::numbers::pi_v<float> * static_cast<float>(sector) / static_cast<float>(sectorCount);
+            sphere.positions.push_back(math::Vector3f{radius * std::cos(stackAngle) * std::cos(sectorAngle),
+                                                      radius * std::cos(stackAngle) * std::sin(sectorAngle),
+                                                      radius * std::sin(stackAngle)});
+        }
+    }
+
+    for (std::uint32_t stack = 0; stack < stackCount; ++stack) {
+        for (std::uint32_t sector = 0; sector < sectorCount; ++sector) {
+            const auto top = stack * (sectorCount + 1) + sector;
+            const auto bottom = top + sectorCount + 1;
+            if (stack != 0)
+                sphere.indices.insert(std::end(sphere.indices), {top, bottom, top + 1});
+            if (stack != stackCount - 1)
+                sphere.indices.insert(std::end(sphere.indices), {top + 1, bottom, bottom + 1});
+        }
+    }
+    return sphere;
+}
+
+[[nodiscard]] static float
+signedArea(std::span<const std::uint32_t> indices, std::span<const math::Vector3f> positions) {
+    float area{0.0f};
+    for (std::size_t i = 0; i < std::size(indices); i += 3) {
+        const auto a = positions[indices[i]];
+        const auto b = positions[indices[i + 1]];
+        const auto c = positions[indices[i + 2]];
+        area += ((b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x())) / 2;
+    }
+    return area;
+}
+
+TEST(Resources_MeshSimplifier, SimplifiesFlatGridWithoutError) {
+    const auto grid = createGrid(32);
+
+    MeshSimplifier simplifier{grid.indices, grid.positions};
+    simplifier.simplify(std::size(grid.indices) / 10, 0.01f);
+
+    EXPECT_LE(std::size(simplifier.indices()), std::size(grid.indices) / 10);
+    EXPECT_LT(simplifier.error(), 0.01f);
+
+    // The border stays in place and no triangle is flipped, so the area is
+    // still covered exactly once.
+    EXPECT_FLOAT_EQ(signedArea(simplifier.indices(), grid.positions), 32.0f * 32.0f);
+}
+
+TEST(Resources_MeshSimplifier, KeepsAttributesOnTheirSideOfSeams) {
+    constexpr std::uint32_t seamColumn = 8;
+    const auto grid = createGrid(16, seamColumn);
+
+    MeshSimplifier simplifier{grid.indices, grid.positions};
+    simplifier.simplify(std::size(grid.indices) / 8, 0.01f);
+    ASSERT_LT(std::size(simplifier.indices()), std::size(grid.indices) / 4);
+
+    // The vertices of the seam are the left one of each pair, so every
+    // vertex of a triangle is on the same side.
+    const auto isRight = [&] (std::uint32_t index) {
+        const auto x = grid.positions[index].x();
+        return x > seamColumn || (x == seamColumn && index % (16 + 2) == seamColumn + 1);
+    };
+    const auto &indices = simplifier.indices();
+    for (std::size_t i = 0; i < std::size(indices); i += 3) {
+        EXPECT_EQ(isRight(indices[i]), isRight(indices[i + 1]));
+        EXPECT_EQ(isRight(indices[i]), isRight(indices[i + 2]));
+    }
+    EXPECT_FLOAT_EQ(signedArea(indices, grid.positions), 16.0f * 16.0f);
+}
+
+TEST(Resources_MeshSimplifier, DoesNotCollapseCubeWithSplitNormals) {
+    // Every face has its own vertices, so no vertex can be collapsed
+    // without moving attributes onto another face.
+    Mesh cube{};
+    for (std::uint32_t axis = 0; axis < 3; ++axis) {
+        for (float side : {-1.0f, 1.0f}) {
+            const auto first = static_cast<std::uint32_t>(std::size(cube.positions));
+            for (const auto &[u, v] : {std::pair{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}}) {
+                std::array<float, 3> position{};
+                position[axis] = side;
+                position[(axis + 1) % 3] = u * side;
+                position[(axis + 2) % 3] = v;
+                cube.positions.push_back(math::Vector3f{position[0], position[1], position[2]});
+            }
+            cube.indices.insert(std::end(cube.indices), {first, first + 1, first + 2, first, first + 2, first + 3});
+        }
+    }
+
+    MeshSimplifier simplifier{cube.indices, cube.positions};
+    simplifier.simplify(0, 1.0f);
+    EXPECT_EQ(std::size(simplifier.indices()), std::size(cube.indices));
+}
+
+TEST(Resources_MeshSimplifier, GeneratesLevelsOfDetailOfSphere) {
+    constexpr float radius = 2.0f;
+    const auto sphere = createSphere(32, 64, radius);
+
+    DecodedMesh decoded{};
+    decoded.positions = sphere.positions;
+    decoded.indexType = DecodedMesh::IndexType::UNSIGNED_INT;
+    decoded.indices = std::as_bytes(std::span{sphere.indices});
+
+    VertexLayout layout{};
+    layout.add(VertexAttribute::POSITION);
+    auto mesh = InterleavedMesh::interleave(decoded, layout);
+    generateLevelsOfDetail(mesh);
+
+    ASSERT_GE(std::size(mesh.levelsOfDetail), 3);
+
+    auto previousIndexCount = std::size(sphere.indices);
+    auto previousError = 0.0f;
+    for (const auto &level : mesh.levelsOfDetail) {
+        const auto indexCount = std::size(level.indices) / sizeof(std::uint32_t);
+        EXPECT_LE(indexCount, previousIndexCount * 6 / 10);
+        EXPECT_GE(level.error, previousError);
+        EXPECT_LT(level.error, radius * 0.1f);
+
+        // The vertices of the simplified sphere are still on its surface,
+        // and the triangles don't cut through the middle too much.
+        std::vector<std::uint32_t> indices(indexCount);
+        std::memcpy(indices.data(), level.indices.data(), std::size(level.indices));
+        for (std::size_t i = 0; i < std::size(indices); i += 3) {
+            const auto center = sphere.positions[indices[i]]
+                    .add(sphere.positions[indices[i + 1]])
+                    .add(sphere.positions[indices[i + 2]]);
+            EXPECT_GT(center.length() / 3, radius * 0.6f);
+        }
+
+        previousIndexCount = indexCount;
+        previousError = level.error;
+    }
+}
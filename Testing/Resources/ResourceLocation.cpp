@@ -0,0 +1,83 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2022 Tristan Gerritsen <tristan@thewoosh.org>
+ * All Rights Reserved.
+ */
+
+#include "Testing/Include.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Source/Resources/FileResourceLocation.hpp"
+#include "Source/Resources/MemoryResourceLocation.hpp"
+
+using namespace resources;
+
+constexpr std::string_view Contents = "The quick brown fox jumps over the lazy dog";
+constexpr auto Hint = io::MappedFile::AccessHint::SEQUENTIAL;
+
+[[nodiscard]] static std::string_view
+asStringView(const ResourceView &view) noexcept {
+    return {reinterpret_cast<const char *>(view.data()), view.size()};
+}
+
+TEST(Resources_ResourceLocation, FileViewOutlivesLocation) {
+    const char *fileName = "ResourceLocationTest.bin";
+    {
+        auto *file = std::fopen(fileName, "wb");
+        ASSERT_NE(file, nullptr);
+        ASSERT_EQ(std::fwrite(std::data(Contents), 1, std::size(Contents), file), std::size(Contents));
+        std::fclose(file);
+    }
+
+    auto location = std::make_unique<FileResourceLocation>(fileName);
+    const auto bytes = location->readAllBytes();
+    ASSERT_FALSE(bytes.failed()) << bytes.error().description();
+
+    auto view = location->mapView(Hint);
+    ASSERT_FALSE(view.failed()) << view.error().description();
+    location.reset();
+
+    EXPECT_EQ(asStringView(view.get()), bytes.get());
+    EXPECT_EQ(asStringView(view.get()), Contents);
+
+    std::remove(fileName);
+}
+
+TEST(Resources_ResourceLocation, MissingFileFails) {
+    FileResourceLocation location{"ThisFileDoesNotExist.bin"};
+    EXPECT_TRUE(location.mapView(Hint).failed());
+}
+
+TEST(Resources_ResourceLocation, MemoryViewsDontCopy) {
+    MemoryNonOwningResourceLocation nonOwning{{std::data(Contents), std::size(Contents)}, false};
+    const auto nonOwningView = nonOwning.mapView(Hint);
+    ASSERT_FALSE(nonOwningView.failed());
+    EXPECT_EQ(reinterpret_cast<const char *>(nonOwningView->data()), std::data(Contents));
+    EXPECT_EQ(nonOwningView->size(), std::size(Contents));
+
+    auto owning = std::make_unique<MemoryOwningResourceLocation>(std::vector<char>(std::begin(Contents), std::end(Contents)), false);
+    const auto *storage = owning->data().data();
+    const auto owningView = owning->mapView(Hint);
+    owning.reset();
+
+    ASSERT_FALSE(owningView.failed());
+    EXPECT_EQ(reinterpret_cast<const char *>(owningView->data()), storage);
+    EXPECT_EQ(asStringView(owningView.get()), Contents);
+}
+
+TEST(Resources_ResourceLocation, MemoryViewDecodesBase64) {
+    constexpr std::string_view Encoded = "SGVsbG8sIFdvcmxkIQ==";
+    MemoryNonOwningResourceLocation location{{std::data(Encoded), std::size(Encoded)}, true};
+
+    const auto view = location.mapView(Hint);
+    ASSERT_FALSE(view.failed()) << view.error().description();
+    EXPECT_EQ(asStringView(view.get()), "Hello, World!");
+}